@@ -76,6 +76,7 @@ function(iree_create_configuration CONFIG_NAME)
 
   # LINT.IfChange(iree_cross_compile_options)
   iree_to_bool(_CONFIG_ENABLE_RUNTIME_TRACING "${IREE_${CONFIG_NAME}_ENABLE_RUNTIME_TRACING}")
+  iree_to_bool(_CONFIG_ENABLE_VM_PROFILING "${IREE_${CONFIG_NAME}_ENABLE_VM_PROFILING}")
   iree_to_bool(_CONFIG_ENABLE_MLIR "${IREE_${CONFIG_NAME}_ENABLE_MLIR}")
   iree_to_bool(_CONFIG_ENABLE_EMITC "${IREE_${CONFIG_NAME}_ENABLE_EMITC}")
 
@@ -107,6 +108,7 @@ function(iree_create_configuration CONFIG_NAME)
         -DCMAKE_CXX_COMPILER="${_CONFIG_CXX_COMPILER}"
         # LINT.IfChange(iree_cross_compile_invoke)
         -DIREE_ENABLE_RUNTIME_TRACING=${_CONFIG_ENABLE_RUNTIME_TRACING}
+        -DIREE_ENABLE_VM_PROFILING=${_CONFIG_ENABLE_VM_PROFILING}
         -DIREE_ENABLE_MLIR=${_CONFIG_ENABLE_MLIR}
         -DIREE_ENABLE_EMITC=${_CONFIG_ENABLE_EMITC}
         -DIREE_BUILD_COMPILER=${_CONFIG_BUILD_COMPILER}
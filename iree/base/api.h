@@ -430,6 +430,9 @@ typedef enum {
   IREE_STATUS_UNAVAILABLE = 14,
   IREE_STATUS_DATA_LOSS = 15,
   IREE_STATUS_UNAUTHENTICATED = 16,
+  // The operation could not make progress without blocking and has been
+  // deferred. It must be retried at a later time.
+  IREE_STATUS_DEFERRED = 17,
 
   IREE_STATUS_CODE_MASK = 0x1Fu,
 } iree_status_code_t;
@@ -490,6 +493,8 @@ typedef void* iree_status_t;
   (iree_status_code(value) == IREE_STATUS_DATA_LOSS)
 #define iree_status_is_unauthenticated(value) \
   (iree_status_code(value) == IREE_STATUS_UNAUTHENTICATED)
+#define iree_status_is_deferred(value) \
+  (iree_status_code(value) == IREE_STATUS_DEFERRED)
 
 #define IREE_STATUS_IMPL_CONCAT_INNER_(x, y) x##y
 #define IREE_STATUS_IMPL_CONCAT_(x, y) IREE_STATUS_IMPL_CONCAT_INNER_(x, y)
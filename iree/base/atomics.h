@@ -48,6 +48,8 @@ typedef _Atomic intptr_t iree_atomic_intptr_t;
   __c11_atomic_fetch_add(object, operand, __ATOMIC_SEQ_CST)
 #define iree_atomic_fetch_sub(object, operand) \
   __c11_atomic_fetch_sub(object, operand, __ATOMIC_SEQ_CST)
+#define iree_atomic_exchange(object, desired) \
+  __c11_atomic_exchange(object, desired, __ATOMIC_SEQ_CST)
 
 #elif defined(IREE_COMPILER_MSVC)
 // Emulate C11 atomics with Interlocked win32 APIs.
@@ -65,6 +67,8 @@ typedef struct {
   InterlockedExchangeAdd64((volatile LONGLONG*)object, operand)
 #define iree_atomic_fetch_sub(object, operand) \
   InterlockedExchangeAdd64((volatile LONGLONG*)object, -(operand))
+#define iree_atomic_exchange(object, desired) \
+  InterlockedExchange64((volatile LONGLONG*)object, desired)
 
 #elif defined(IREE_COMPILER_GCC)
 // Emulate atomics for GCC in a way that is compatible for inclusion in
@@ -79,7 +83,7 @@ typedef struct {
 typedef __INTPTR_TYPE__ iree_atomic_intptr_t;
 #define IREE_ATOMIC_VAR_INIT(value) (value)
 #define iree_atomic_load(object)                                              \
-  __atomic_load_ptr(object, __ATOMIC_SEQ_CST) __extension__({                 \
+  __extension__({                                                             \
     __iree_auto_type __atomic_load_ptr = (object);                            \
     __typeof__(*__atomic_load_ptr) __atomic_load_tmp;                         \
     __atomic_load(__atomic_load_ptr, &__atomic_load_tmp, (__ATOMIC_SEQ_CST)); \
@@ -96,6 +100,8 @@ typedef __INTPTR_TYPE__ iree_atomic_intptr_t;
   __atomic_fetch_add((object), (operand), __ATOMIC_SEQ_CST)
 #define iree_atomic_fetch_sub(object, operand) \
   __atomic_fetch_sub((object), (operand), __ATOMIC_SEQ_CST)
+#define iree_atomic_exchange(object, desired) \
+  __atomic_exchange_n((object), (desired), __ATOMIC_SEQ_CST)
 
 #else
 #error "compiler does not have supported C11-style atomics"
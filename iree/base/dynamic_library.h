@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
 
@@ -53,6 +54,13 @@ class DynamicLibrary {
   static StatusOr<std::unique_ptr<DynamicLibrary>> Load(
       absl::Span<const char* const> search_file_names);
 
+  // Loads the library image in |file_data| directly from memory without
+  // writing it to the filesystem. |file_name| is only used for diagnostics.
+  // Not all platforms support this; callers should fall back to writing the
+  // image to a file and using |Load| if an error is returned.
+  static StatusOr<std::unique_ptr<DynamicLibrary>> LoadFromMemory(
+      absl::string_view file_name, absl::Span<const uint8_t> file_data);
+
   // Gets the name of the library file that is loaded.
   const std::string& file_name() const { return file_name_; }
 
@@ -0,0 +1,80 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "iree/base/dynamic_library.h"
+#include "iree/base/dynamic_library_test_library_embed.h"
+#include "iree/base/file_io.h"
+#include "iree/base/status.h"
+#include "iree/base/target_platform.h"
+
+namespace iree {
+namespace {
+
+absl::Span<const uint8_t> GetTestLibraryData() {
+  const auto* file_toc = dynamic_library_test_library_create();
+  return absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(file_toc->data),
+                             file_toc->size);
+}
+
+// Measures the startup cost of loading an embedded library by writing it to a
+// temp file first, as required when in-memory loading is unavailable.
+static void BM_LoadFromTempFile(benchmark::State& state) {
+  auto library_data = GetTestLibraryData();
+  absl::string_view library_contents(
+      reinterpret_cast<const char*>(library_data.data()), library_data.size());
+  while (state.KeepRunning()) {
+    auto temp_path_or = file_io::GetTempFile("dynamic_library_benchmark");
+    IREE_CHECK_OK(temp_path_or.status());
+    std::string temp_path = std::move(temp_path_or.value());
+#if defined(IREE_PLATFORM_WINDOWS)
+    temp_path += ".dll";
+#else
+    temp_path += ".so";
+#endif
+    IREE_CHECK_OK(file_io::SetFileContents(temp_path, library_contents));
+    {
+      auto library_or = DynamicLibrary::Load(temp_path.c_str());
+      IREE_CHECK_OK(library_or.status());
+      benchmark::DoNotOptimize(library_or.value()->GetSymbol("times_two"));
+    }
+    IREE_CHECK_OK(file_io::DeleteFile(temp_path));
+  }
+}
+BENCHMARK(BM_LoadFromTempFile);
+
+// Measures the startup cost of loading an embedded library from memory.
+static void BM_LoadFromMemory(benchmark::State& state) {
+  auto library_data = GetTestLibraryData();
+  if (!DynamicLibrary::LoadFromMemory("dynamic_library_benchmark", library_data)
+           .ok()) {
+    state.SkipWithError("Loading from memory is unsupported");
+    return;
+  }
+  while (state.KeepRunning()) {
+    auto library_or = DynamicLibrary::LoadFromMemory(
+        "dynamic_library_benchmark", library_data);
+    IREE_CHECK_OK(library_or.status());
+    benchmark::DoNotOptimize(library_or.value()->GetSymbol("times_two"));
+  }
+}
+BENCHMARK(BM_LoadFromMemory);
+
+}  // namespace
+}  // namespace iree
@@ -21,6 +21,22 @@
     defined(IREE_PLATFORM_LINUX)
 
 #include <dlfcn.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+
+// memfd_create is only exposed by newer libc versions so we go through the
+// syscall directly when the kernel headers define it.
+#if defined(__NR_memfd_create)
+#define IREE_HAVE_MEMFD_CREATE 1
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif  // MFD_CLOEXEC
+#endif  // __NR_memfd_create
 
 namespace iree {
 
@@ -31,6 +47,7 @@ class DynamicLibraryPosix : public DynamicLibrary {
     //   Sometimes closing the library can prevent proper symbolization on
     //   crashes or in sampling profilers.
     ::dlclose(library_);
+    if (memfd_ != -1) ::close(memfd_);
   }
 
   static StatusOr<std::unique_ptr<DynamicLibrary>> Load(
@@ -48,15 +65,63 @@ class DynamicLibraryPosix : public DynamicLibrary {
            << "Unable to open dynamic library:'" << dlerror() << "'";
   }
 
+  static StatusOr<std::unique_ptr<DynamicLibrary>> LoadFromMemory(
+      absl::string_view file_name, absl::Span<const uint8_t> file_data) {
+    IREE_TRACE_SCOPE0("DynamicLibraryPosix::LoadFromMemory");
+
+#if defined(IREE_HAVE_MEMFD_CREATE)
+    // Copy the image into an anonymous in-memory file and have the loader open
+    // it through procfs.
+    std::string name(file_name);
+    int memfd =
+        static_cast<int>(::syscall(__NR_memfd_create, name.c_str(),
+                                   static_cast<unsigned int>(MFD_CLOEXEC)));
+    if (memfd == -1) {
+      return UnavailableErrorBuilder(IREE_LOC)
+             << "Unable to create in-memory file: " << ::strerror(errno);
+    }
+    size_t offset = 0;
+    while (offset < file_data.size()) {
+      ssize_t written = ::write(memfd, file_data.data() + offset,
+                                file_data.size() - offset);
+      if (written == -1 && errno == EINTR) continue;
+      if (written <= 0) {
+        int write_errno = errno;
+        ::close(memfd);
+        return UnavailableErrorBuilder(IREE_LOC)
+               << "Unable to write in-memory file: " << ::strerror(write_errno);
+      }
+      offset += written;
+    }
+
+    std::string fd_path = "/proc/self/fd/" + std::to_string(memfd);
+    void* library = ::dlopen(fd_path.c_str(), RTLD_LAZY | RTLD_LOCAL);
+    if (!library) {
+      ::close(memfd);
+      return UnavailableErrorBuilder(IREE_LOC)
+             << "Unable to open in-memory dynamic library:'" << dlerror()
+             << "'";
+    }
+    // The loader identifies libraries by path so the fd must stay open (and
+    // its number reserved) for as long as the library is loaded.
+    return absl::WrapUnique(new DynamicLibraryPosix(name, library, memfd));
+#else
+    return UnimplementedErrorBuilder(IREE_LOC)
+           << "Loading dynamic libraries from memory is not supported";
+#endif  // IREE_HAVE_MEMFD_CREATE
+  }
+
   void* GetSymbol(const char* symbol_name) const override {
     return ::dlsym(library_, symbol_name);
   }
 
  private:
-  DynamicLibraryPosix(std::string file_name, void* library)
-      : DynamicLibrary(file_name), library_(library) {}
+  DynamicLibraryPosix(std::string file_name, void* library, int memfd = -1)
+      : DynamicLibrary(file_name), library_(library), memfd_(memfd) {}
 
   void* library_;
+  // In-memory file backing the library when loaded with LoadFromMemory.
+  int memfd_;
 };
 
 // static
@@ -65,6 +130,12 @@ StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::Load(
   return DynamicLibraryPosix::Load(search_file_names);
 }
 
+// static
+StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::LoadFromMemory(
+    absl::string_view file_name, absl::Span<const uint8_t> file_data) {
+  return DynamicLibraryPosix::LoadFromMemory(file_name, file_data);
+}
+
 }  // namespace iree
 
 #endif  // IREE_PLATFORM_*
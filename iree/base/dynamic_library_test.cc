@@ -15,6 +15,7 @@
 #include "iree/base/dynamic_library.h"
 
 #include <string>
+#include <utility>
 
 #include "iree/base/dynamic_library_test_library_embed.h"
 #include "iree/base/file_io.h"
@@ -96,5 +97,36 @@ TEST_F(DynamicLibraryTest, GetSymbolFailure) {
   EXPECT_EQ(nullptr, unknown_fn);
 }
 
+TEST_F(DynamicLibraryTest, LoadLibraryFromMemory) {
+  const auto* file_toc = dynamic_library_test_library_create();
+  auto library_or = DynamicLibrary::LoadFromMemory(
+      "dynamic_library_test_library",
+      absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(file_toc->data),
+                          file_toc->size));
+  if (IsUnimplemented(library_or.status()) ||
+      IsUnavailable(library_or.status())) {
+    // Unavailable when the platform supports it but the environment does not
+    // (such as sandboxes without memfd_create or /proc).
+    IREE_LOG(WARNING) << "Loading from memory unsupported; skipping test: "
+                      << library_or.status();
+    return;
+  }
+  IREE_ASSERT_OK(library_or.status());
+  auto library = std::move(library_or.value());
+
+  auto times_two_fn = library->GetSymbol<int (*)(int)>("times_two");
+  ASSERT_NE(nullptr, times_two_fn);
+  EXPECT_EQ(246, times_two_fn(123));
+
+  // Multiple in-memory libraries must be independently loadable.
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto library2,
+      DynamicLibrary::LoadFromMemory(
+          "dynamic_library_test_library",
+          absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(file_toc->data),
+                              file_toc->size)));
+  EXPECT_NE(nullptr, library2->GetSymbol<int (*)(int)>("times_two"));
+}
+
 }  // namespace
 }  // namespace iree
@@ -63,6 +63,13 @@ StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::Load(
   return DynamicLibraryWin::Load(search_file_names);
 }
 
+// static
+StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::LoadFromMemory(
+    absl::string_view file_name, absl::Span<const uint8_t> file_data) {
+  return UnimplementedErrorBuilder(IREE_LOC)
+         << "Loading dynamic libraries from memory is not supported";
+}
+
 }  // namespace iree
 
 #endif  // IREE_PLATFORM_*
@@ -18,6 +18,7 @@
 #include "iree/compiler/Dialect/IREE/IR/IREEOps.h"
 #include "iree/compiler/Dialect/Shape/IR/ShapeOps.h"
 #include "iree/compiler/Dialect/Shape/IR/ShapeTypes.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "mlir/Conversion/AffineToStandard/AffineToStandard.h"
 #include "mlir/Conversion/LinalgToLLVM/LinalgToLLVM.h"
 #include "mlir/Conversion/SCFToStandard/SCFToStandard.h"
@@ -25,6 +26,7 @@
 #include "mlir/Conversion/StandardToLLVM/ConvertStandardToLLVMPass.h"
 #include "mlir/Conversion/VectorToLLVM/ConvertVectorToLLVM.h"
 #include "mlir/Conversion/VectorToSCF/VectorToSCF.h"
+#include "mlir/Dialect/GPU/GPUDialect.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
 #include "mlir/Dialect/StandardOps/Transforms/Passes.h"
@@ -136,11 +138,21 @@ bool operator<(IREE::HAL::InterfaceBindingOp aOp,
   return aOp.set() < bOp.set();
 }
 
+/// Returns the index of the workgroup grid dimension named by |dimension|.
+static int64_t getWorkgroupDimIndex(StringRef dimension) {
+  return llvm::StringSwitch<int64_t>(dimension)
+      .Case("y", 1)
+      .Case("z", 2)
+      .Default(0);
+}
+
 // Change signature of entry function to func
 // entry_func(%packed_buffers_arg_ptr:
-// !<llvm.int8**>, %push_constant: !<llvm.int64*>) and lower IREE and HAL ops to
-// corresponding LLVMIR ops to construct memref descriptors and load
-// push_constant values.
+// !<llvm.int8**>, %push_constant: !<llvm.int64*>, %workgroup_id:
+// !<llvm.int32*>, %workgroup_count: !<llvm.int32*>) and lower IREE and HAL ops
+// to corresponding LLVMIR ops to construct memref descriptors and load
+// push_constant values. gpu.block_id and gpu.grid_dim ops produced when tiling
+// to workgroups are lowered to loads of the workgroup XYZ id and count.
 class ConvertFuncWithHALInterface : public ConvertToLLVMPattern {
  public:
   explicit ConvertFuncWithHALInterface(MLIRContext *context,
@@ -163,6 +175,8 @@ class ConvertFuncWithHALInterface : public ConvertToLLVMPattern {
     // Get interface buffers from all the blocks.
     SmallVector<IREE::PlaceholderOp, 8> bufferOps;
     SmallVector<IREE::HAL::InterfaceLoadConstantOp, 8> loadOps;
+    SmallVector<gpu::BlockIdOp, 3> workgroupIdOps;
+    SmallVector<gpu::GridDimOp, 3> workgroupCountOps;
     for (Block &block : funcOp.getBlocks()) {
       for (Operation &op : block) {
         if (auto phOp = dyn_cast<IREE::PlaceholderOp>(op))
@@ -170,6 +184,12 @@ class ConvertFuncWithHALInterface : public ConvertToLLVMPattern {
         if (auto phOp = dyn_cast<IREE::HAL::InterfaceLoadConstantOp>(op)) {
           loadOps.push_back(phOp);
         }
+        if (auto idOp = dyn_cast<gpu::BlockIdOp>(op)) {
+          workgroupIdOps.push_back(idOp);
+        }
+        if (auto countOp = dyn_cast<gpu::GridDimOp>(op)) {
+          workgroupCountOps.push_back(countOp);
+        }
       }
     }
 
@@ -218,13 +238,17 @@ class ConvertFuncWithHALInterface : public ConvertToLLVMPattern {
 
     TypeConverter::SignatureConversion signatureConverter(/*numOrigInputs=*/0);
 
-    // func foo(%packed_buffer_args: !llvm<i8**>, %push_constant: !llvm<i32*>)
+    // func foo(%packed_buffer_args: !llvm<i8**>, %push_constant: !llvm<i32*>,
+    //          %workgroup_id: !llvm<i32*>, %workgroup_count: !llvm<i32*>)
     MLIRContext *context = rewriter.getContext();
     auto packedBuffersArgsTy =
         LLVM::LLVMType::getInt8PtrTy(context).getPointerTo();
     auto pushConstantArgTy = LLVM::LLVMType::getInt32Ty(context).getPointerTo();
+    auto workgroupArgTy = LLVM::LLVMType::getInt32Ty(context).getPointerTo();
     signatureConverter.addInputs(packedBuffersArgsTy);
     signatureConverter.addInputs(pushConstantArgTy);
+    signatureConverter.addInputs(workgroupArgTy);
+    signatureConverter.addInputs(workgroupArgTy);
 
     // Create the new function's signature.
     Location loc = funcOp.getLoc();
@@ -284,6 +308,28 @@ class ConvertFuncWithHALInterface : public ConvertToLLVMPattern {
       rewriter.replaceOp(loadOp, dimConstantCasted);
     }
 
+    // Lower gpu.block_id and gpu.grid_dim ops into llvm.getelementptr,
+    // llvm.load of the workgroup id and count arguments.
+    auto loadWorkgroupDim = [&](Operation *op, StringRef dimension,
+                                Value workgroupArg) {
+      Value offset = builder.create<LLVM::ConstantOp>(
+          loc, LLVM::LLVMType::getInt64Ty(context),
+          builder.getI64IntegerAttr(getWorkgroupDimIndex(dimension)));
+      Value dimPtr = builder.create<LLVM::GEPOp>(
+          loc, workgroupArgTy, workgroupArg, ArrayRef<Value>({offset}));
+      Value dimValue = builder.create<LLVM::LoadOp>(loc, dimPtr);
+      Value dimValueCasted = builder.create<LLVM::ZExtOp>(
+          loc, typeConverter.convertType(op->getResult(0).getType()),
+          dimValue);
+      rewriter.replaceOp(op, dimValueCasted);
+    };
+    for (auto idOp : workgroupIdOps) {
+      loadWorkgroupDim(idOp, idOp.dimension(), newFuncOp.getArgument(2));
+    }
+    for (auto countOp : workgroupCountOps) {
+      loadWorkgroupDim(countOp, countOp.dimension(), newFuncOp.getArgument(3));
+    }
+
     rewriter.eraseOp(funcOp);
     return success();
   }
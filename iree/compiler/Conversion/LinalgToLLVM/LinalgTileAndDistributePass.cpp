@@ -0,0 +1,289 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//===- LinalgTileAndDistributePass.cpp - Tile linalg ops to workgroups ----===//
+//
+// Implements a pass to tile linalg operations on buffers and distribute the
+// tiles across the workgroups of a dispatch.
+//
+//===----------------------------------------------------------------------===//
+#include "iree/compiler/Conversion/LinalgToLLVM/Passes.h"
+#include "mlir/Dialect/GPU/GPUDialect.h"
+#include "mlir/Dialect/Linalg/IR/LinalgOps.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/Linalg/Utils/Utils.h"
+#include "mlir/Dialect/SCF/SCF.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/Dialect/Utils/StructuredOpsUtils.h"
+#include "mlir/IR/Function.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-linalg-to-llvm-tile-and-distribute"
+
+namespace mlir {
+namespace iree_compiler {
+
+//===----------------------------------------------------------------------===//
+// Utility functions
+//===----------------------------------------------------------------------===//
+
+/// Returns true if the linalg op has padding attribute, and that it has
+/// non-zero entries.
+template <typename OpTy>
+static bool hasPadding(OpTy op) {
+  Optional<DenseIntElementsAttr> padding = op.padding();
+  if (!padding) return false;
+  return llvm::any_of(padding.getValue(),
+                      [](APInt v) -> bool { return !v.isNullValue(); });
+}
+
+/// Returns true if |op| can be tiled to workgroups.
+static bool isTileable(linalg::LinalgOp op) {
+  Operation *operation = op.getOperation();
+  if (auto convOp = dyn_cast<linalg::ConvOp>(operation)) {
+    return !hasPadding(convOp);
+  }
+  if (auto poolingOp = dyn_cast<linalg::PoolingMaxOp>(operation)) {
+    return !hasPadding(poolingOp);
+  }
+  if (auto poolingOp = dyn_cast<linalg::PoolingMinOp>(operation)) {
+    return !hasPadding(poolingOp);
+  }
+  if (auto poolingOp = dyn_cast<linalg::PoolingSumOp>(operation)) {
+    return !hasPadding(poolingOp);
+  }
+  return isa<linalg::BatchMatmulOp, linalg::CopyOp, linalg::FillOp,
+             linalg::GenericOp, linalg::IndexedGenericOp, linalg::MatmulOp>(
+      operation);
+}
+
+/// Returns true if the tiles of all |linalgOps| can be distributed across
+/// workgroups without synchronization between the workgroups.
+///
+/// Distribution assigns tiles to workgroups independently for each op. That is
+/// only safe when a workgroup never needs data produced by a tile owned by a
+/// different workgroup. This is guaranteed for a single op, and for a single op
+/// preceded by linalg.fill ops that initialize its outputs (e.g. the zero fill
+/// emitted for matmul, convolution and pooling): both are tiled along the same
+/// leading output dimensions and so every output tile is filled and then
+/// updated by the same workgroup.
+static bool canDistribute(ArrayRef<linalg::LinalgOp> linalgOps) {
+  if (linalgOps.empty()) return false;
+  if (!llvm::all_of(linalgOps, isTileable)) return false;
+  linalg::LinalgOp rootOp = linalgOps.back();
+  for (linalg::LinalgOp op : linalgOps.drop_back()) {
+    auto fillOp = dyn_cast<linalg::FillOp>(op.getOperation());
+    if (!fillOp) return false;
+    if (!llvm::is_contained(rootOp.getOutputBuffers(), fillOp.output())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Returns the workgroup id and count linearized over the x, y and z
+/// dimensions of the dispatch grid.
+static std::pair<Value, Value> getLinearWorkgroupIdAndCount(OpBuilder &builder,
+                                                            Location loc) {
+  Type indexType = builder.getIndexType();
+  Value id, count;
+  for (StringRef dim : {"z", "y", "x"}) {
+    StringAttr attr = builder.getStringAttr(dim);
+    Value dimId = builder.create<gpu::BlockIdOp>(loc, indexType, attr);
+    Value dimCount = builder.create<gpu::GridDimOp>(loc, indexType, attr);
+    if (!id) {
+      id = dimId;
+      count = dimCount;
+      continue;
+    }
+    id = builder.create<AddIOp>(loc, builder.create<MulIOp>(loc, id, dimCount),
+                                dimId);
+    count = builder.create<MulIOp>(loc, count, dimCount);
+  }
+  return {id, count};
+}
+
+/// Distributes the workgroups of the dispatch across the tiled parallel loops.
+///
+/// The workgroup count is chosen by the host from the flattened workload and
+/// in general is not the product of the number of tiles along each loop. The
+/// linearized workgroup id is therefore delinearized over the loops starting
+/// from the innermost one: every loop but the outermost gets at most as many
+/// workgroups as it has tiles and the outermost one gets what remains. Each
+/// loop then steps cyclically through its tiles. Workgroups left over after
+/// forming that grid are given an id past the last tile of the outermost loop
+/// so that they do not recompute (and race on) tiles owned by others.
+static SmallVector<linalg::ProcInfo, 2> getWorkgroupIdsAndCounts(
+    OpBuilder &builder, Location loc, ArrayRef<Range> parallelLoopRanges) {
+  unsigned numLoops = parallelLoopRanges.size();
+  SmallVector<linalg::ProcInfo, 2> procInfo(numLoops);
+  if (numLoops == 0) return procInfo;
+
+  Value id, count;
+  std::tie(id, count) = getLinearWorkgroupIdAndCount(builder, loc);
+  Value one = builder.create<ConstantIndexOp>(loc, 1);
+  for (int i = numLoops - 1; i >= 0; --i) {
+    const Range &range = parallelLoopRanges[i];
+    Value extent = builder.create<SubIOp>(loc, range.size, range.offset);
+    Value numTiles =
+        builder.create<SignedCeilDivIOp>(loc, extent, range.stride);
+    Value isEmpty =
+        builder.create<CmpIOp>(loc, CmpIPredicate::slt, numTiles, one);
+    numTiles = builder.create<SelectOp>(loc, isEmpty, one, numTiles);
+    if (i == 0) {
+      Value isActive =
+          builder.create<CmpIOp>(loc, CmpIPredicate::slt, id, count);
+      procInfo[i] = {builder.create<SelectOp>(loc, isActive, id, numTiles),
+                     count};
+      break;
+    }
+    Value isSmaller =
+        builder.create<CmpIOp>(loc, CmpIPredicate::slt, numTiles, count);
+    Value numProcs = builder.create<SelectOp>(loc, isSmaller, numTiles, count);
+    procInfo[i] = {builder.create<SignedRemIOp>(loc, id, numProcs), numProcs};
+    id = builder.create<SignedDivIOp>(loc, id, numProcs);
+    count = builder.create<SignedDivIOp>(loc, count, numProcs);
+  }
+  return procInfo;
+}
+
+/// Distribution options for targeting workgroups.
+static linalg::LinalgLoopDistributionOptions workgroupDistributionOptions = {
+    getWorkgroupIdsAndCounts,
+    {linalg::DistributionMethod::Cyclic, linalg::DistributionMethod::Cyclic,
+     linalg::DistributionMethod::Cyclic}};
+
+/// Moves all operations from |firstOp| up to the terminator of its block into
+/// an scf.if that only workgroup (0, 0, 0) enters.
+static void guardWithFirstWorkgroup(Operation *firstOp) {
+  Block *block = firstOp->getBlock();
+  OpBuilder builder(firstOp);
+  Location loc = firstOp->getLoc();
+  Value id = getLinearWorkgroupIdAndCount(builder, loc).first;
+  Value zero = builder.create<ConstantIndexOp>(loc, 0);
+  Value isFirst = builder.create<CmpIOp>(loc, CmpIPredicate::eq, id, zero);
+  auto ifOp = builder.create<scf::IfOp>(loc, isFirst,
+                                        /*withElseRegion=*/false);
+  Block *thenBlock = &ifOp.thenRegion().front();
+  thenBlock->getOperations().splice(
+      std::prev(thenBlock->end()), block->getOperations(),
+      Block::iterator(firstOp), Block::iterator(block->getTerminator()));
+}
+
+//===----------------------------------------------------------------------===//
+// Pass
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// Function pass that tiles linalg operations on buffers and distributes the
+/// tiles across workgroups.
+struct LinalgTileAndDistributePass
+    : public PassWrapper<LinalgTileAndDistributePass, FunctionPass> {
+  LinalgTileAndDistributePass() = default;
+  LinalgTileAndDistributePass(const LinalgTileAndDistributePass &pass) {}
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<gpu::GPUDialect, linalg::LinalgDialect, scf::SCFDialect>();
+  }
+  void runOnFunction() override;
+
+ private:
+  ListOption<int64_t> tileSizes{
+      *this, "tile-sizes",
+      llvm::cl::desc("Tile sizes for the (at most three) leading parallel "
+                     "loops that are distributed across workgroups"),
+      llvm::cl::ZeroOrMore, llvm::cl::MiscFlags::CommaSeparated};
+};
+}  // namespace
+
+void LinalgTileAndDistributePass::runOnFunction() {
+  FuncOp funcOp = getFunction();
+  if (SymbolTable::getSymbolVisibility(funcOp) !=
+      SymbolTable::Visibility::Public) {
+    return;
+  }
+
+  Region &body = funcOp.getBody();
+  if (!llvm::hasSingleElement(body.getBlocks())) {
+    funcOp.emitError("unhandled dispatch function with multiple blocks");
+    return signalPassFailure();
+  }
+  Block &block = body.front();
+  SmallVector<linalg::LinalgOp, 4> linalgOps(
+      block.getOps<linalg::LinalgOp>());
+  if (linalgOps.empty()) return;
+
+  // Ops we can't distribute are run in their entirety by a single workgroup
+  // so that the result is independent of the workgroup count.
+  if (!canDistribute(linalgOps)) {
+    guardWithFirstWorkgroup(linalgOps.front().getOperation());
+    return;
+  }
+
+  SmallVector<int64_t, 3> workgroupTileSizes(tileSizes.begin(),
+                                             tileSizes.end());
+  if (workgroupTileSizes.empty()) {
+    workgroupTileSizes.assign(kNumWorkgroupDims, kDefaultWorkgroupTileSize);
+  }
+  workgroupTileSizes.resize(
+      std::min<size_t>(workgroupTileSizes.size(), kNumWorkgroupDims));
+
+  // Only parallel loops are tiled; reduction loops are left for each workgroup
+  // to iterate over completely.
+  auto getTileSizesFn = [&workgroupTileSizes](OpBuilder &builder,
+                                              Operation *operation) {
+    auto linalgOp = cast<linalg::LinalgOp>(operation);
+    auto iteratorTypes = linalgOp.iterator_types().getValue();
+    SmallVector<Value, 4> tileSizesVal;
+    for (auto iteratorType : llvm::enumerate(iteratorTypes)) {
+      if (iteratorType.index() >= workgroupTileSizes.size()) break;
+      int64_t tileSize = isParallelIterator(iteratorType.value())
+                             ? workgroupTileSizes[iteratorType.index()]
+                             : 0;
+      tileSizesVal.push_back(
+          builder.create<ConstantIndexOp>(operation->getLoc(), tileSize));
+    }
+    return tileSizesVal;
+  };
+  auto tilingOptions =
+      linalg::LinalgTilingOptions()
+          .setTileSizeComputationFunction(getTileSizesFn)
+          .setLoopType(linalg::LinalgTilingLoopType::ParallelLoops)
+          .setDistributionOptions(workgroupDistributionOptions);
+
+  for (linalg::LinalgOp op : linalgOps) {
+    OpBuilder builder(op.getOperation());
+    if (!linalg::tileLinalgOp(builder, op, tilingOptions)) {
+      op.emitError("failed to tile to workgroups");
+      return signalPassFailure();
+    }
+    op.getOperation()->erase();
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Pass entry point and registration
+//===----------------------------------------------------------------------===//
+
+std::unique_ptr<FunctionPass> createLinalgTileAndDistributePass() {
+  return std::make_unique<LinalgTileAndDistributePass>();
+}
+
+static PassRegistration<LinalgTileAndDistributePass> pass(
+    "iree-codegen-linalg-to-llvm-tile-and-distribute",
+    "Tile and distribute linalg operations across workgroups",
+    [] { return std::make_unique<LinalgTileAndDistributePass>(); });
+
+}  // namespace iree_compiler
+}  // namespace mlir
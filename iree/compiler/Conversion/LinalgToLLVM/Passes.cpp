@@ -37,6 +37,9 @@ void addLinalgToLLVMPasses(OpPassManager &passManager) {
   if (convImg2ColConversion) {
     passManager.addPass(createConvImg2ColMatmulConversionPass());
   }
+  // Tile and distribute to workgroups.
+  passManager.addPass(createLinalgTileAndDistributePass());
+  passManager.addPass(createCanonicalizerPass());
   // Linalg -> Vectors Ops.
   passManager.addPass(createMatMulTileAndVectorizePass());
   // Linalg -> SCF
@@ -20,6 +20,18 @@
 namespace mlir {
 namespace iree_compiler {
 
+/// Maximum number of parallel loops of a linalg op that are distributed across
+/// workgroups.
+constexpr int kNumWorkgroupDims = 3;
+
+/// Default tile size of each distributed loop when tiling to workgroups.
+constexpr int64_t kDefaultWorkgroupTileSize = 32;
+
+/// Tiles linalg ops on buffers and distributes the tiles across workgroups.
+/// Dispatch functions whose ops can't be distributed are executed entirely by
+/// the first workgroup.
+std::unique_ptr<FunctionPass> createLinalgTileAndDistributePass();
+
 /// Converts linalg::MatmulOp into LLVM dialect
 std::unique_ptr<FunctionPass> createMatMulTileAndVectorizePass();
 
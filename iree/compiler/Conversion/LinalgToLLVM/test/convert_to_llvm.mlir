@@ -14,7 +14,7 @@ func @convert_dynamic_shape() -> f32 {
 hal.interface @legacy_io attributes {push_constants = 2 : i32, sym_visibility = "private"} {
     hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
 }
-// CHECK: llvm.func @convert_dynamic_shape(%[[ARG0:.+]]: !llvm.ptr<ptr<i8>>, %[[ARG1:.+]]: !llvm.ptr<i32>)
+// CHECK: llvm.func @convert_dynamic_shape(%[[ARG0:.+]]: !llvm.ptr<ptr<i8>>, %[[ARG1:.+]]: !llvm.ptr<i32>, %{{.+}}: !llvm.ptr<i32>, %{{.+}}: !llvm.ptr<i32>)
 // CHECK: %[[PACKED_ARGS_PTR:.+]] = llvm.bitcast %[[ARG0]] : !llvm.ptr<ptr<i8>> to !llvm.ptr<struct<(ptr<float>)>>
 // CHECK: %[[PACKED_ARGS:.+]] = llvm.load %[[PACKED_ARGS_PTR]] : !llvm.ptr<struct<(ptr<float>)>>
 // CHECK: %[[MEMREF0_DATA_PTR:.+]] = llvm.extractvalue %[[PACKED_ARGS]][0] : !llvm.struct<(ptr<float>)>
@@ -52,7 +52,7 @@ hal.interface @legacy_io2 attributes {push_constants = 1 : i32, sym_visibility =
     hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
 }
 
-// CHECK: llvm.func @convert_dynamic_shape2(%[[ARG0:.+]]: !llvm.ptr<ptr<i8>>, %[[ARG1:.+]]: !llvm.ptr<i32>)
+// CHECK: llvm.func @convert_dynamic_shape2(%[[ARG0:.+]]: !llvm.ptr<ptr<i8>>, %[[ARG1:.+]]: !llvm.ptr<i32>, %{{.+}}: !llvm.ptr<i32>, %{{.+}}: !llvm.ptr<i32>)
 // CHECK: %[[PACKED_ARGS_PTR:.+]] = llvm.bitcast %[[ARG0]] : !llvm.ptr<ptr<i8>> to !llvm.ptr<struct<(ptr<float>)>>
 // CHECK: %[[PACKED_ARGS:.+]] = llvm.load %[[PACKED_ARGS_PTR]] : !llvm.ptr<struct<(ptr<float>)>>
 // CHECK: %[[MEMREF0_DATA_PTR:.+]] = llvm.extractvalue %[[PACKED_ARGS]][0] : !llvm.struct<(ptr<float>)>
@@ -84,3 +84,26 @@ hal.interface @legacy_io2 attributes {push_constants = 1 : i32, sym_visibility =
 // CHECK: %[[GET_PTR:.+]] = llvm.getelementptr %[[EXTRACT1:.+]][%[[ADD2:.+]]] : (!llvm.ptr<float>, !llvm.i64) -> !llvm.ptr<float>
 // CHECK: %[[LOAD:.+]] = llvm.load %[[GET_PTR:.+]] : !llvm.ptr<float>
 
+// CHECK_LABEL: @convert_workgroup_id_and_count
+func @convert_workgroup_id_and_count() {
+  %0 = iree.placeholder for "interface buffer" {binding = @legacy_io3::@ret0} : memref<?xindex>
+  %c0 = constant 0 : index
+  %c1 = constant 1 : index
+  %1 = "gpu.block_id"() {dimension = "y"} : () -> index
+  %2 = "gpu.grid_dim"() {dimension = "x"} : () -> index
+  store %1, %0[%c0] : memref<?xindex>
+  store %2, %0[%c1] : memref<?xindex>
+  return
+}
+hal.interface @legacy_io3 attributes {sym_visibility = "private"} {
+    hal.interface.binding @ret0, set=0, binding=0, type="StorageBuffer", access="Write"
+}
+// CHECK: llvm.func @convert_workgroup_id_and_count(%{{.+}}: !llvm.ptr<ptr<i8>>, %{{.+}}: !llvm.ptr<i32>, %[[WORKGROUP_ID:.+]]: !llvm.ptr<i32>, %[[WORKGROUP_COUNT:.+]]: !llvm.ptr<i32>)
+// CHECK: %[[CONST1:.+]] = llvm.mlir.constant(1 : i64) : !llvm.i64
+// CHECK: %[[ID_Y_PTR:.+]] = llvm.getelementptr %[[WORKGROUP_ID]][%[[CONST1]]] : (!llvm.ptr<i32>, !llvm.i64) -> !llvm.ptr<i32>
+// CHECK: %[[ID_Y:.+]] = llvm.load %[[ID_Y_PTR]] : !llvm.ptr<i32>
+// CHECK: %[[ID_Y_CASTED:.+]] = llvm.zext %[[ID_Y]] : !llvm.i32 to !llvm.i64
+// CHECK: %[[CONST0:.+]] = llvm.mlir.constant(0 : i64) : !llvm.i64
+// CHECK: %[[COUNT_X_PTR:.+]] = llvm.getelementptr %[[WORKGROUP_COUNT]][%[[CONST0]]] : (!llvm.ptr<i32>, !llvm.i64) -> !llvm.ptr<i32>
+// CHECK: %[[COUNT_X:.+]] = llvm.load %[[COUNT_X_PTR]] : !llvm.ptr<i32>
+// CHECK: %[[COUNT_X_CASTED:.+]] = llvm.zext %[[COUNT_X]] : !llvm.i32 to !llvm.i64
@@ -0,0 +1,120 @@
+// RUN: iree-opt -split-input-file -iree-codegen-linalg-to-llvm-tile-and-distribute %s | IreeFileCheck %s
+
+func @matmul() {
+  %cst = constant 0.000000e+00 : f32
+  %0 = iree.placeholder for "interace buffer" {binding = @legacy_io::@arg0} : memref<128x64xf32>
+  %1 = iree.placeholder for "interace buffer" {binding = @legacy_io::@arg1} : memref<64x256xf32>
+  %2 = iree.placeholder for "interace buffer" {binding = @legacy_io::@ret0} : memref<128x256xf32>
+  linalg.fill(%2, %cst) : memref<128x256xf32>, f32
+  linalg.matmul ins(%0, %1 : memref<128x64xf32>, memref<64x256xf32>)
+               outs(%2 : memref<128x256xf32>)
+  return
+}
+hal.interface @legacy_io attributes {sym_visibility = "private"} {
+  hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+  hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+}
+//       CHECK: func @matmul()
+//   CHECK-DAG:   %[[ARG0:.+]] = iree.placeholder {{.*}} {binding = @legacy_io::@arg0
+//   CHECK-DAG:   %[[ARG1:.+]] = iree.placeholder {{.*}} {binding = @legacy_io::@arg1
+//   CHECK-DAG:   %[[RET0:.+]] = iree.placeholder {{.*}} {binding = @legacy_io::@ret0
+//   CHECK-DAG:   "gpu.block_id"() {dimension = "x"}
+//   CHECK-DAG:   "gpu.grid_dim"() {dimension = "x"}
+//       CHECK:   scf.parallel (%[[IV0:.+]], %[[IV1:.+]]) =
+//       CHECK:     %[[FILL_VIEW:.+]] = subview %[[RET0]][%[[IV0]], %[[IV1]]]
+//       CHECK:     linalg.fill(%[[FILL_VIEW]]
+//       CHECK:   scf.parallel (%[[IV2:.+]], %[[IV3:.+]]) =
+//       CHECK:     %[[LHS_VIEW:.+]] = subview %[[ARG0]][%[[IV2]], 0]
+//       CHECK:     %[[RHS_VIEW:.+]] = subview %[[ARG1]][0, %[[IV3]]]
+//       CHECK:     %[[RES_VIEW:.+]] = subview %[[RET0]][%[[IV2]], %[[IV3]]]
+//       CHECK:     linalg.matmul
+//  CHECK-SAME:       ins(%[[LHS_VIEW]], %[[RHS_VIEW]]
+//  CHECK-SAME:       outs(%[[RES_VIEW]]
+
+// -----
+
+func @conv() {
+  %0 = iree.placeholder for "interace buffer" {binding = @legacy_io::@arg0} : memref<3x3x4x16xf32>
+  %1 = iree.placeholder for "interace buffer" {binding = @legacy_io::@arg1} : memref<2x66x66x4xf32>
+  %2 = iree.placeholder for "interace buffer" {binding = @legacy_io::@ret0} : memref<2x64x64x16xf32>
+  linalg.conv(%0, %1, %2) {dilations = [1, 1], strides = [1, 1]} :
+    memref<3x3x4x16xf32>, memref<2x66x66x4xf32>, memref<2x64x64x16xf32>
+  return
+}
+hal.interface @legacy_io attributes {sym_visibility = "private"} {
+  hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+  hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+}
+//       CHECK: func @conv()
+//   CHECK-DAG:   %[[ARG0:.+]] = iree.placeholder {{.*}} {binding = @legacy_io::@arg0
+//   CHECK-DAG:   %[[RET0:.+]] = iree.placeholder {{.*}} {binding = @legacy_io::@ret0
+//   CHECK-DAG:   "gpu.block_id"() {dimension = "x"}
+//   CHECK-DAG:   "gpu.grid_dim"() {dimension = "x"}
+//       CHECK:   scf.parallel (%[[IV0:.+]], %[[IV1:.+]], %[[IV2:.+]]) =
+//       CHECK:     %[[RES_VIEW:.+]] = subview %[[RET0]][%[[IV0]], %[[IV1]], %[[IV2]], 0]
+//       CHECK:     linalg.conv(%[[ARG0]], %{{.+}}, %[[RES_VIEW]])
+
+// -----
+
+#map0 = affine_map<(d0, d1) -> (d0, d1)>
+func @elementwise() {
+  %0 = iree.placeholder for "interace buffer" {binding = @legacy_io::@arg0} : memref<?x?xf32>
+  %1 = iree.placeholder for "interace buffer" {binding = @legacy_io::@arg1} : memref<?x?xf32>
+  %2 = iree.placeholder for "interace buffer" {binding = @legacy_io::@ret0} : memref<?x?xf32>
+  linalg.generic {
+     indexing_maps = [#map0, #map0, #map0],
+     iterator_types = ["parallel", "parallel"]}
+    ins(%0, %1 : memref<?x?xf32>, memref<?x?xf32>)
+   outs(%2 : memref<?x?xf32>) {
+  ^bb0(%arg0 : f32, %arg1 : f32, %arg2 : f32):
+    %3 = addf %arg0, %arg1 : f32
+    linalg.yield %3 : f32
+  }
+  return
+}
+hal.interface @legacy_io attributes {sym_visibility = "private"} {
+  hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+  hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+}
+//       CHECK: func @elementwise()
+//   CHECK-DAG:   %[[RET0:.+]] = iree.placeholder {{.*}} {binding = @legacy_io::@ret0
+//   CHECK-DAG:   "gpu.block_id"() {dimension = "x"}
+//   CHECK-DAG:   "gpu.grid_dim"() {dimension = "x"}
+//       CHECK:   ceildivi_signed
+//       CHECK:   scf.parallel (%[[IV0:.+]], %[[IV1:.+]]) =
+//       CHECK:     %[[RES_VIEW:.+]] = subview %[[RET0]][%[[IV0]], %[[IV1]]]
+//       CHECK:     linalg.generic
+//  CHECK-SAME:       outs(%[[RES_VIEW]]
+
+// -----
+
+#map0 = affine_map<(d0) -> (d0)>
+func @not_distributable() {
+  %0 = iree.placeholder for "interace buffer" {binding = @legacy_io::@arg0} : memref<?xf32>
+  %1 = iree.placeholder for "interace buffer" {binding = @legacy_io::@ret0} : memref<?xf32>
+  %2 = iree.placeholder for "interace buffer" {binding = @legacy_io::@ret1} : memref<?xf32>
+  linalg.generic {indexing_maps = [#map0, #map0], iterator_types = ["parallel"]}
+    ins(%0 : memref<?xf32>)
+   outs(%1 : memref<?xf32>) {
+  ^bb0(%arg0 : f32, %arg1 : f32):
+    %3 = addf %arg0, %arg0 : f32
+    linalg.yield %3 : f32
+  }
+  linalg.copy(%1, %2) : memref<?xf32>, memref<?xf32>
+  return
+}
+hal.interface @legacy_io attributes {sym_visibility = "private"} {
+  hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @ret0, set=0, binding=1, type="StorageBuffer", access="Write|Discard"
+  hal.interface.binding @ret1, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+}
+//       CHECK: func @not_distributable()
+//   CHECK-DAG:   %[[C0:.+]] = constant 0 : index
+//       CHECK:   %[[IS_FIRST:.+]] = cmpi "eq", %{{.+}}, %[[C0]]
+//       CHECK:   scf.if %[[IS_FIRST]]
+//   CHECK-NOT:     scf.parallel
+//       CHECK:     linalg.generic
+//       CHECK:     linalg.copy
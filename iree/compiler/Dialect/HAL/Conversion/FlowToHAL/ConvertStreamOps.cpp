@@ -23,6 +23,7 @@
 #include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
 #include "iree/compiler/Dialect/Shape/IR/ShapeOps.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Debug.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
 #include "mlir/IR/Attributes.h"
@@ -41,8 +42,14 @@ namespace {
 struct BufferRange {
   BufferRange() = default;
   explicit BufferRange(Value buffer) : buffer(buffer) {}
+  BufferRange(Value buffer, Value offset) : buffer(buffer), offset(offset) {}
 
   Value buffer = nullptr;
+  // Byte offset of the range within |buffer| or nullptr if it starts at 0.
+  Value offset = nullptr;
+  // [begin, end) byte range within |buffer| if known at compile time. When
+  // unset the range is conservatively assumed to cover the entire buffer.
+  Optional<std::pair<int64_t, int64_t>> staticRange;
 };
 
 // Allocated buffers used within the stream.
@@ -133,7 +140,10 @@ static Value allocateTransientBuffer(Value streamValue, Value allocator,
                                      ConversionPatternRewriter &rewriter) {
   Location loc = streamValue.getLoc();
   // TODO(benvanik): compute from SSA use-def chain uses.
+  // Transient marks the buffer as only used by this submission so that the
+  // runtime may suballocate it from storage recycled across submissions.
   IREE::HAL::MemoryTypeBitfield memoryTypes =
+      IREE::HAL::MemoryTypeBitfield::Transient |
       IREE::HAL::MemoryTypeBitfield::DeviceLocal;
   IREE::HAL::BufferUsageBitfield bufferUsage =
       IREE::HAL::BufferUsageBitfield::Dispatch |
@@ -166,8 +176,120 @@ static Value allocateTransientBuffer(Value streamValue, Value allocator,
   return buffer;
 }
 
+// Allocates a transient buffer of |byteLength| bytes that is suballocated to
+// store multiple values entirely within the command buffer.
+static Value allocateTransientSlab(Location loc, int64_t byteLength,
+                                   Value allocator,
+                                   ConversionPatternRewriter &rewriter) {
+  IREE::HAL::MemoryTypeBitfield memoryTypes =
+      IREE::HAL::MemoryTypeBitfield::Transient |
+      IREE::HAL::MemoryTypeBitfield::DeviceLocal;
+  IREE::HAL::BufferUsageBitfield bufferUsage =
+      IREE::HAL::BufferUsageBitfield::Dispatch |
+      IREE::HAL::BufferUsageBitfield::Transfer;
+  auto allocationSize =
+      rewriter.createOrFold<mlir::ConstantIndexOp>(loc, byteLength);
+  auto buffer =
+      rewriter
+          .create<IREE::HAL::AllocatorAllocateOp>(loc, allocator, memoryTypes,
+                                                  bufferUsage, allocationSize)
+          .getResult();
+
+  // TODO(benvanik): implement resource sets.
+  rewriter.create<IREE::HAL::ExDeferReleaseOp>(loc, buffer);
+
+  return buffer;
+}
+
+// Byte alignment of values suballocated from a transient slab. This is the
+// largest minStorageBufferOffsetAlignment Vulkan allows an implementation to
+// require and is sufficient for binding offsets on all other targets.
+static constexpr int64_t kTransientValueAlignment = 256;
+
+// A value produced within the stream that needs transient storage.
+struct TransientValue {
+  // The value produced by a non-identity op. Identity-op results are aliased
+  // to the same storage.
+  Value value;
+
+  // Inclusive range of op ordinals within the stream block over which the
+  // value (or any of its aliases) is live.
+  int start = 0;
+  int end = 0;
+
+  // Aligned size of the value in bytes if statically shaped.
+  Optional<int64_t> byteLength;
+
+  // Assigned byte offset within the transient slab.
+  int64_t offset = 0;
+};
+
+// Returns the size in bytes of the storage for |streamValue| padded to
+// kTransientValueAlignment or None if the size is only known at runtime.
+static Optional<int64_t> computeStaticByteLength(Value streamValue) {
+  auto shapedType = streamValue.getType().cast<ShapedType>();
+  if (!shapedType.hasStaticShape() ||
+      !shapedType.getElementType().isIntOrFloat()) {
+    return llvm::None;
+  }
+  int64_t byteLength =
+      shapedType.getNumElements() *
+      IREE::HAL::getRoundedElementByteWidth(shapedType.getElementType());
+  return llvm::alignTo(byteLength, kTransientValueAlignment);
+}
+
+// Assigns slab offsets to all statically-sized |transientValues| such that
+// values with overlapping live ranges never overlap in memory and returns the
+// total slab size required.
+//
+// Values are placed largest-first at the lowest offset that fits between the
+// values already placed that are live at the same time. This greedy
+// by-size strategy tends to land close to the peak live memory in practice.
+static int64_t packTransientValues(
+    MutableArrayRef<TransientValue> transientValues) {
+  SmallVector<TransientValue *, 8> worklist;
+  for (auto &transientValue : transientValues) {
+    if (transientValue.byteLength.hasValue()) {
+      worklist.push_back(&transientValue);
+    }
+  }
+  llvm::stable_sort(worklist, [](TransientValue *lhs, TransientValue *rhs) {
+    return lhs->byteLength.getValue() > rhs->byteLength.getValue();
+  });
+
+  int64_t slabLength = 0;
+  SmallVector<TransientValue *, 8> placedValues;
+  for (auto *transientValue : worklist) {
+    int64_t byteLength = transientValue->byteLength.getValue();
+    SmallVector<std::pair<int64_t, int64_t>, 8> liveRanges;
+    for (auto *placedValue : placedValues) {
+      if (placedValue->start <= transientValue->end &&
+          transientValue->start <= placedValue->end) {
+        liveRanges.push_back(
+            {placedValue->offset,
+             placedValue->offset + placedValue->byteLength.getValue()});
+      }
+    }
+    llvm::sort(liveRanges);
+    int64_t offset = 0;
+    for (auto &liveRange : liveRanges) {
+      if (offset + byteLength <= liveRange.first) break;
+      offset = std::max(offset, liveRange.second);
+    }
+    transientValue->offset = offset;
+    slabLength = std::max(slabLength, offset + byteLength);
+    placedValues.push_back(transientValue);
+  }
+  return slabLength;
+}
+
 // Allocates transient buffers to store the intra-stream results and populates
 // the |bufferSet| with the new mappings.
+//
+// Statically-sized values are suballocated from a single slab with storage
+// reused between values whose live ranges within the stream do not overlap.
+// The static ranges of the values are recorded so that recordStreamCommands
+// can order the reuse with barriers.
 static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
                                      BufferSet &bufferSet,
                                      ConversionPatternRewriter &rewriter) {
@@ -186,8 +308,7 @@ static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
           LLVM_DEBUG(llvm::dbgs() << "  + PROPAGATE IDENTITY RESULT->OPERAND: "
                                   << op << "\n");
           madeChange = true;
-          bufferSet.rangeMap[operand].buffer =
-              bufferSet.rangeMap[result].buffer;
+          bufferSet.rangeMap[operand] = bufferSet.rangeMap[result];
         }
       }
     }
@@ -202,8 +323,7 @@ static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
           LLVM_DEBUG(llvm::dbgs() << "  + PROPAGATE IDENTITY OPERAND->RESULT: "
                                   << op << "\n");
           madeChange = true;
-          bufferSet.rangeMap[result].buffer =
-              bufferSet.rangeMap[operand].buffer;
+          bufferSet.rangeMap[result] = bufferSet.rangeMap[operand];
         }
       }
     }
@@ -222,8 +342,26 @@ static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
   // changes are made.
   while (propagateIdentityBuffers()) {
   }
-  for (auto &op : streamOp.body().front()) {
-    if (isNoOp(&op) || isIdentityOp(&op)) continue;
+
+  // Gather the transient values along with the identity-op results aliasing
+  // them and compute the range of ops over which each is live.
+  auto &streamBlock = streamOp.body().front();
+  DenseMap<Operation *, int> opOrdinals;
+  for (auto it : llvm::enumerate(streamBlock)) {
+    opOrdinals[&it.value()] = it.index();
+  }
+  SmallVector<TransientValue, 8> transientValues;
+  DenseMap<Value, unsigned> transientAliases;
+  for (auto &op : streamBlock) {
+    if (isNoOp(&op)) continue;
+    if (isIdentityOp(&op)) {
+      auto result = op.getResult(0);
+      auto it = transientAliases.find(op.getOperand(0));
+      if (!bufferSet.rangeMap[result].buffer && it != transientAliases.end()) {
+        transientAliases[result] = it->second;
+      }
+      continue;
+    }
     for (auto it : llvm::enumerate(op.getResults())) {
       auto result = it.value();
       // If the result is an output buffer we can just use that directly.
@@ -232,13 +370,57 @@ static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
                                 << it.index() << "): " << op << "\n");
         continue;
       }
-      LLVM_DEBUG(llvm::dbgs() << "    -- ALLOCATE BUFFER FOR RESULT("
-                              << it.index() << "): " << op << "\n");
-      auto buffer =
-          allocateTransientBuffer(result, bufferSet.allocator, rewriter);
-      bufferSet.rangeMap[result] = BufferRange{buffer};
+      TransientValue transientValue;
+      transientValue.value = result;
+      transientValue.start = transientValue.end = opOrdinals[&op];
+      transientValue.byteLength = computeStaticByteLength(result);
+      transientAliases[result] = transientValues.size();
+      transientValues.push_back(transientValue);
+    }
+  }
+  for (auto alias : transientAliases) {
+    auto &transientValue = transientValues[alias.second];
+    for (auto *user : alias.first.getUsers()) {
+      transientValue.end = std::max(transientValue.end, opOrdinals[user]);
+    }
+  }
+
+  // Statically-sized values are packed into a single allocation while values
+  // with dynamic shapes each get their own.
+  int64_t slabLength = packTransientValues(transientValues);
+  Value slabBuffer = nullptr;
+  if (slabLength > 0) {
+    LLVM_DEBUG(llvm::dbgs() << "    -- ALLOCATE TRANSIENT SLAB OF "
+                            << slabLength << " BYTES\n");
+    slabBuffer = allocateTransientSlab(streamOp.getLoc(), slabLength,
+                                       bufferSet.allocator, rewriter);
+  }
+  SmallVector<BufferRange, 8> transientRanges;
+  for (auto &transientValue : transientValues) {
+    if (transientValue.byteLength.hasValue()) {
+      LLVM_DEBUG(llvm::dbgs()
+                 << "    -- ASSIGN SLAB OFFSET " << transientValue.offset
+                 << " LIVE [" << transientValue.start << ", "
+                 << transientValue.end << "] FOR " << transientValue.value
+                 << "\n");
+      auto offset = rewriter.createOrFold<mlir::ConstantIndexOp>(
+          transientValue.value.getLoc(), transientValue.offset);
+      BufferRange bufferRange{slabBuffer, offset};
+      bufferRange.staticRange = std::make_pair(
+          transientValue.offset,
+          transientValue.offset + transientValue.byteLength.getValue());
+      transientRanges.push_back(bufferRange);
+    } else {
+      LLVM_DEBUG(llvm::dbgs() << "    -- ALLOCATE BUFFER FOR "
+                              << transientValue.value << "\n");
+      auto buffer = allocateTransientBuffer(transientValue.value,
+                                            bufferSet.allocator, rewriter);
+      transientRanges.push_back(BufferRange{buffer});
     }
   }
+  for (auto alias : transientAliases) {
+    bufferSet.rangeMap[alias.first] = transientRanges[alias.second];
+  }
   while (propagateIdentityBuffers()) {
   }
 }
@@ -318,8 +500,9 @@ static LogicalResult recordPushBindings(Value device, Value commandBuffer,
     auto byteLength = value->getByteLength();
     if (!byteLength) return failure();
 
-    bindings.push_back(std::make_tuple(bindingOrdinal++, value->getBuffer(),
-                                       zeroOffset, byteLength));
+    bindings.push_back(std::make_tuple(
+        bindingOrdinal++, value->getBuffer(),
+        bufferRange.offset ? bufferRange.offset : zeroOffset, byteLength));
     return success();
   };
   for (auto it : llvm::enumerate(dispatchOp.operands())) {
@@ -447,11 +630,6 @@ static LogicalResult recordDispatch(Value device, Value commandBuffer,
     }
   }
   switchBuilder.build();
-
-  // Full barriers for now as we aren't scheduling things.
-  // TODO(benvanik): don't add at the end of the command buffer (we could
-  // also do a canonicalization step that removed trailing barriers).
-  recordFullExecutionBarrier(commandBuffer, dispatchOp.getLoc(), rewriter);
   return success();
 }
 
@@ -493,14 +671,26 @@ static LogicalResult recordTensorUpdate(Value device, Value commandBuffer,
   auto targetByteLength = target->getByteLength();
   if (!targetByteLength) return failure();
 
+  auto getRangeOffset = [&](const BufferRange &bufferRange) {
+    return bufferRange.offset ? bufferRange.offset : zeroOffset;
+  };
+  auto resultOffset = getRangeOffset(resultBuffer);
+  auto updateOffset = resultBuffer.offset
+                          ? rewriter.createOrFold<mlir::AddIOp>(
+                                updateOp.getLoc(), resultOffset,
+                                targetRange->offset)
+                          : targetRange->offset;
+
   rewriter.create<IREE::HAL::CommandBufferCopyBufferOp>(
-      updateOp.getLoc(), commandBuffer, target->getBuffer(), zeroOffset,
-      result->getBuffer(), zeroOffset, targetByteLength);
+      updateOp.getLoc(), commandBuffer, target->getBuffer(),
+      getRangeOffset(targetBuffer), result->getBuffer(), resultOffset,
+      targetByteLength);
   // TODO(benvanik): slice left/mid/right, but really just don't do this.
   recordFullExecutionBarrier(commandBuffer, updateOp.getLoc(), rewriter);
   rewriter.create<IREE::HAL::CommandBufferCopyBufferOp>(
-      updateOp.getLoc(), commandBuffer, update->getBuffer(), zeroOffset,
-      result->getBuffer(), targetRange->offset, targetRange->length);
+      updateOp.getLoc(), commandBuffer, update->getBuffer(),
+      getRangeOffset(updateBuffer), result->getBuffer(), updateOffset,
+      targetRange->length);
 
   // TODO(benvanik): implement resource sets.
   rewriter.create<IREE::HAL::ExDeferReleaseOp>(updateOp.getLoc(),
@@ -509,19 +699,75 @@ static LogicalResult recordTensorUpdate(Value device, Value commandBuffer,
                                                update->getBuffer());
   rewriter.create<IREE::HAL::ExDeferReleaseOp>(updateOp.getLoc(),
                                                result->getBuffer());
-
-  // Full barriers for now as we aren't scheduling things.
-  // TODO(benvanik): don't add at the end of the command buffer (we could
-  // also do a canonicalization step that removed trailing barriers).
-  recordFullExecutionBarrier(commandBuffer, updateOp.getLoc(), rewriter);
   return success();
 }
 
+// A read or write of a buffer range by a stream command.
+struct BufferAccess {
+  BufferRange bufferRange;
+  bool isWrite = false;
+};
+
+// Returns true if |lhs| and |rhs| may touch the same bytes.
+static bool mayOverlap(const BufferRange &lhs, const BufferRange &rhs) {
+  if (lhs.buffer != rhs.buffer) return false;
+  if (!lhs.staticRange || !rhs.staticRange) return true;
+  return lhs.staticRange->first < rhs.staticRange->second &&
+         rhs.staticRange->first < lhs.staticRange->second;
+}
+
+// Returns true if |op| has to wait for any of the |pendingAccesses| recorded
+// since the last barrier to complete before it can execute. This is the case
+// for read-after-write, write-after-read, and write-after-write hazards.
+static bool hasHazard(ArrayRef<BufferAccess> opAccesses,
+                      ArrayRef<BufferAccess> pendingAccesses) {
+  for (auto &opAccess : opAccesses) {
+    for (auto &pendingAccess : pendingAccesses) {
+      if (!opAccess.isWrite && !pendingAccess.isWrite) continue;
+      if (mayOverlap(opAccess.bufferRange, pendingAccess.bufferRange)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Gathers the buffer ranges read and written by the stream command |op|.
+static SmallVector<BufferAccess, 4> getBufferAccesses(Operation *op,
+                                                      BufferSet &bufferSet) {
+  SmallVector<BufferAccess, 4> accesses;
+  for (auto operand : op->getOperands()) {
+    if (!operand.getType().isa<TensorType>()) continue;
+    accesses.push_back({bufferSet.rangeMap[operand], /*isWrite=*/false});
+  }
+  for (auto result : op->getResults()) {
+    if (!result.getType().isa<TensorType>()) continue;
+    accesses.push_back({bufferSet.rangeMap[result], /*isWrite=*/true});
+  }
+  return accesses;
+}
+
+// Records all commands in the stream. Execution barriers are only inserted
+// where a command depends on the results of (or overwrites the inputs to) a
+// command recorded since the previous barrier so that runs of independent
+// commands may execute concurrently.
 static LogicalResult recordStreamCommands(Value device, Value commandBuffer,
                                           Block &streamBlock,
                                           BufferSet &bufferSet,
                                           ConversionPatternRewriter &rewriter) {
+  SmallVector<BufferAccess, 8> pendingAccesses;
   for (auto &op : streamBlock) {
+    if (isa<IREE::Flow::DispatchOp>(op) ||
+        isa<IREE::Flow::TensorUpdateOp>(op)) {
+      auto opAccesses = getBufferAccesses(&op, bufferSet);
+      if (hasHazard(opAccesses, pendingAccesses)) {
+        LLVM_DEBUG(llvm::dbgs() << "  + BARRIER BEFORE: " << op << "\n");
+        recordFullExecutionBarrier(commandBuffer, op.getLoc(), rewriter);
+        pendingAccesses.clear();
+      }
+      pendingAccesses.append(opAccesses.begin(), opAccesses.end());
+    }
+
     if (auto dispatchOp = dyn_cast<IREE::Flow::DispatchOp>(op)) {
       if (failed(recordDispatch(device, commandBuffer, dispatchOp, bufferSet,
                                 rewriter))) {
@@ -22,19 +22,19 @@ func @multipleDispatches(%arg0: tensor<128xf32>) -> tensor<128xf32> {
   %cst = constant 128 : index
   // CHECK: %[[RET_BUF:.+]] = hal.allocator.allocate {{.+}}, "HostVisible|DeviceVisible|DeviceLocal", "Constant|Transfer|Mapping|Dispatch"
   // CHECK-NEXT: hal.ex.defer_release %[[RET_BUF]]
-  // CHECK: %[[TMP_BUF:.+]] = hal.allocator.allocate {{.+}}, "DeviceVisible|DeviceLocal", "Transfer|Dispatch"
+  // CHECK: %[[TMP_BUF:.+]] = hal.allocator.allocate {{.+}}, "Transient|DeviceVisible|DeviceLocal", "Transfer|Dispatch", %c512
   // CHECK-NEXT: hal.ex.defer_release %[[TMP_BUF]]
   // CHECK: %[[CMD:.+]] = hal.command_buffer.create {{.+}}, "OneShot", "Transfer|Dispatch"
   // CHECK-NEXT: hal.command_buffer.begin %[[CMD]]
   %0 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %arg0 : tensor<128xf32>) -> tensor<128xf32> {
     //  CHECK-DAG: %[[EXE_LAYOUT:.+]] = hal.executable_layout.lookup
-    //      CHECK: hal.command_buffer.push_descriptor_set %[[CMD]], %[[EXE_LAYOUT]], set=0, bindings=[0 = (%arg0, %c0, %sz_3), 1 = (%buffer_1, %c0, %sz_4)]
+    //      CHECK: hal.command_buffer.push_descriptor_set %[[CMD]], %[[EXE_LAYOUT]], set=0, bindings=[0 = (%arg0, %c0, %{{.+}}), 1 = (%[[TMP_BUF]], %c0, %{{.+}})]
     //      CHECK: hal.command_buffer.dispatch.symbol {{.+}}, @ex0::@vmla::@entry0, workgroup_xyz
     //      CHECK: hal.command_buffer.execution_barrier
     %1 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
     //      CHECK: hal.command_buffer.push_descriptor_set
     //      CHECK: hal.command_buffer.dispatch.symbol {{.+}}, @ex0::@vmla::@entry0, workgroup_xyz
-    //      CHECK: hal.command_buffer.execution_barrier
+    //  CHECK-NOT: hal.command_buffer.execution_barrier
     %2 = flow.dispatch @ex0::@entry0[%arg1 : index](%1) : (tensor<128xf32>) -> tensor<128xf32>
     flow.return %2 : tensor<128xf32>
   }
@@ -46,6 +46,81 @@ func @multipleDispatches(%arg0: tensor<128xf32>) -> tensor<128xf32> {
 
 // -----
 
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.target @vmla, filter="vmla" {
+    hal.executable.entry_point @entry0 attributes {
+      interface = @interface,
+      ordinal = 0 : i32,
+      signature = (tensor<128xf32>) -> tensor<128xf32>
+    }
+    module {}
+  }
+}
+
+// Transient values with disjoint live ranges share the same slab storage.
+// CHECK-LABEL: func @transientReuse
+func @transientReuse(%arg0: tensor<128xf32>) -> tensor<128xf32> {
+  %cst = constant 128 : index
+  // CHECK: %[[RET_BUF:.+]] = hal.allocator.allocate {{.+}}, "HostVisible|DeviceVisible|DeviceLocal", "Constant|Transfer|Mapping|Dispatch"
+  // CHECK: %[[SLAB:.+]] = hal.allocator.allocate {{.+}}, "Transient|DeviceVisible|DeviceLocal", "Transfer|Dispatch", %c1024
+  // CHECK-NOT: hal.allocator.allocate
+  %0 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %arg0 : tensor<128xf32>) -> tensor<128xf32> {
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%arg0, %c0, %{{.+}}), 1 = (%[[SLAB]], %c0, %{{.+}})]
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%[[SLAB]], %c0, %{{.+}}), 1 = (%[[SLAB]], %c512, %{{.+}})]
+    %2 = flow.dispatch @ex0::@entry0[%arg1 : index](%1) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%[[SLAB]], %c512, %{{.+}}), 1 = (%[[SLAB]], %c0, %{{.+}})]
+    %3 = flow.dispatch @ex0::@entry0[%arg1 : index](%2) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%[[SLAB]], %c0, %{{.+}}), 1 = (%[[RET_BUF]], %c0, %{{.+}})]
+    %4 = flow.dispatch @ex0::@entry0[%arg1 : index](%3) : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %4 : tensor<128xf32>
+  }
+  return %0 : tensor<128xf32>
+}
+
+// -----
+
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.target @vmla, filter="vmla" {
+    hal.executable.entry_point @entry0 attributes {
+      interface = @interface,
+      ordinal = 0 : i32,
+      signature = (tensor<128xf32>) -> tensor<128xf32>
+    }
+    module {}
+  }
+}
+
+// Dispatches without dependencies between them are not separated by barriers.
+// CHECK-LABEL: func @independentDispatches
+func @independentDispatches(%arg0: tensor<128xf32>) -> (tensor<128xf32>, tensor<128xf32>) {
+  %cst = constant 128 : index
+  %0:2 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %arg0 : tensor<128xf32>) -> (tensor<128xf32>, tensor<128xf32>) {
+    //      CHECK: hal.command_buffer.dispatch.symbol
+    //  CHECK-NOT: hal.command_buffer.execution_barrier
+    //      CHECK: hal.command_buffer.dispatch.symbol
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    %2 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    //      CHECK: hal.command_buffer.execution_barrier
+    //      CHECK: hal.command_buffer.dispatch.symbol
+    //  CHECK-NOT: hal.command_buffer.execution_barrier
+    //      CHECK: hal.command_buffer.end
+    %3 = flow.dispatch @ex0::@entry0[%arg1 : index](%1) : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %2, %3 : tensor<128xf32>, tensor<128xf32>
+  }
+  return %0#0, %0#1 : tensor<128xf32>, tensor<128xf32>
+}
+
+// -----
+
 // CHECK-LABEL: @tensorUpdate
 // CHECK-SAME: (%[[UBUF:.+]]:{{.+}}, %[[TBUF:.+]]:{{.+}})
 func @tensorUpdate(%arg0 : tensor<1x1x10xf32>, %arg1 : tensor<5x1x10xf32>) -> tensor<5x1x10xf32> {
@@ -190,6 +190,10 @@ void populateHALCommandBufferToVMPatterns(MLIRContext *context,
   patterns.insert<CommandBufferPushDescriptorSetOpConversion>(
       context, importSymbols, typeConverter,
       "hal.command_buffer.push_descriptor_set");
+  patterns.insert<VMImportOpConversion<
+      IREE::HAL::CommandBufferPushDescriptorSetIndirectOp>>(
+      context, importSymbols, typeConverter,
+      "hal.command_buffer.push_descriptor_set.indirect");
   patterns.insert<
       VMImportOpConversion<IREE::HAL::CommandBufferBindDescriptorSetOp>>(
       context, importSymbols, typeConverter,
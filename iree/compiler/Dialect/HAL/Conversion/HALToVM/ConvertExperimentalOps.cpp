@@ -29,6 +29,8 @@ void populateHALExperimentalToVMPatterns(MLIRContext *context,
       context, importSymbols, typeConverter, "hal.ex.defer_release");
   patterns.insert<VMImportOpConversion<IREE::HAL::ExSubmitAndWaitOp>>(
       context, importSymbols, typeConverter, "hal.ex.submit_and_wait");
+  patterns.insert<VMImportOpConversion<IREE::HAL::ExSubmitAndWaitIndirectOp>>(
+      context, importSymbols, typeConverter, "hal.ex.submit_and_wait.indirect");
 }
 
 }  // namespace iree_compiler
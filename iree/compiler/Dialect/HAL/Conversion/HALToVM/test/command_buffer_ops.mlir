@@ -74,6 +74,19 @@ func @command_buffer_bind_descriptor_set(
 
 // -----
 
+// CHECK-LABEL: @command_buffer_push_descriptor_set_indirect
+func @command_buffer_push_descriptor_set_indirect(
+    %arg0 : !hal.command_buffer,
+    %arg1 : !hal.executable_layout) {
+  %c16 = constant 16 : index
+  %c32 = constant 32 : index
+  // CHECK: vm.call.variadic @hal.command_buffer.push_descriptor_set.indirect(%arg0, %arg1, %zero, [%{{.+}}, %{{.+}}], [%{{.+}}, %{{.+}}], [%c16, %c16], [%c32, %c32]) : (!vm.ref<!hal.command_buffer>, !vm.ref<!hal.executable_layout>, i32, i32 ..., i32 ..., i32 ..., i32 ...)
+  hal.command_buffer.push_descriptor_set.indirect %arg0, %arg1, set = 0 : i32, bindings = [0 : i32, 1 : i32], binding_slots = [0 : i32, 1 : i32], offsets = [%c16, %c16], lengths = [%c32, %c32]
+  return
+}
+
+// -----
+
 // CHECK-LABEL: @command_buffer_dispatch
 func @command_buffer_dispatch(%arg0 : !hal.command_buffer, %arg1 : !hal.executable) {
   %c100 = constant 100 : index
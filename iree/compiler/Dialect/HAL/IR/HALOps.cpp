@@ -831,6 +831,22 @@ static void printCommandBufferPushDescriptorSetOp(
                           });
 }
 
+//===----------------------------------------------------------------------===//
+// hal.command_buffer.push_descriptor_set.indirect
+//===----------------------------------------------------------------------===//
+
+static LogicalResult verifyCommandBufferPushDescriptorSetIndirectOp(
+    CommandBufferPushDescriptorSetIndirectOp &op) {
+  auto bindingCount = op.bindings().size();
+  if (op.binding_slots().size() != bindingCount ||
+      op.binding_offsets().size() != bindingCount) {
+    return op.emitOpError() << "binding, slot, offset, and length counts must "
+                               "match (have "
+                            << bindingCount << " bindings)";
+  }
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // hal.command_buffer.bind_descriptor_set
 //===----------------------------------------------------------------------===//
@@ -115,6 +115,18 @@ func @command_buffer_bind_descriptor_set(%arg0 : !hal.command_buffer) {
 
 // -----
 
+// CHECK-LABEL: @command_buffer_push_descriptor_set_indirect
+func @command_buffer_push_descriptor_set_indirect(%arg0 : !hal.command_buffer) {
+  %0 = "test_hal.executable_layout"() : () -> !hal.executable_layout
+  %1 = "test_hal.offset"() : () -> index
+  %2 = "test_hal.length"() : () -> index
+  // CHECK: hal.command_buffer.push_descriptor_set.indirect %arg0, %0, set = 0 : i32, bindings = [0 : i32, 1 : i32], binding_slots = [1 : i32, 0 : i32], offsets = [%1, %1], lengths = [%2, %2]
+  hal.command_buffer.push_descriptor_set.indirect %arg0, %0, set = 0 : i32, bindings = [0 : i32, 1 : i32], binding_slots = [1 : i32, 0 : i32], offsets = [%1, %1], lengths = [%2, %2]
+  return
+}
+
+// -----
+
 // CHECK-LABEL: @command_buffer_dispatch
 func @command_buffer_dispatch(%arg0 : !hal.command_buffer) {
   hal.executable @ex {
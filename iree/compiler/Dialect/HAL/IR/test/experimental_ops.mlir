@@ -19,3 +19,16 @@ func @submit_and_wait() {
   hal.ex.submit_and_wait %0, %1
   return
 }
+
+// -----
+
+// CHECK-LABEL: @submit_and_wait_indirect
+func @submit_and_wait_indirect() {
+  %0 = "test_hal.device"() : () -> !hal.device
+  %1 = "test_hal.command_buffer"() : () -> !hal.command_buffer
+  %2 = "test_hal.buffer"() : () -> !hal.buffer
+  %3 = "test_hal.buffer"() : () -> !hal.buffer
+  // CHECK: hal.ex.submit_and_wait.indirect %0, %1, binding_table = [%2, %3]
+  hal.ex.submit_and_wait.indirect %0, %1, binding_table = [%2, %3]
+  return
+}
@@ -46,6 +46,9 @@ class LLVMAOTTargetBackend final : public TargetBackend {
   std::string name() const override { return "llvm_aot"; }
   std::string filter_pattern() const override { return "dylib*"; }
 
+  // Dispatched through the host command buffer (see iree/hal/dylib/).
+  bool supportsIndirectBindings() const override { return true; }
+
   void getDependentDialects(DialectRegistry& registry) const override {
     // clang-format off
     registry.insert<AffineDialect,
@@ -148,13 +151,18 @@ class LLVMAOTTargetBackend final : public TargetBackend {
     return success();
   }
 
-  std::array<Value, 3> calculateDispatchWorkgroupCount(
+  std::array<Value, 3> calculateDispatchWorkgroupSize(
       Location loc, IREE::HAL::ExecutableOp executableOp,
       IREE::HAL::ExecutableEntryPointOp entryPointOp, Value workload,
       OpBuilder& builder) override {
-    // For now we are not tiling and just dispatch everything as 1,1,1.
+    // Linalg ops are tiled along their leading parallel loops and the kernel
+    // distributes the tiles across however many workgroups are dispatched.
+    // The workload is the flattened result size so we aim for roughly one 2-D
+    // tile per workgroup.
+    auto workgroupSizeX = builder.createOrFold<mlir::ConstantIndexOp>(
+        loc, kDefaultWorkgroupTileSize * kDefaultWorkgroupTileSize);
     auto constantOne = builder.createOrFold<mlir::ConstantIndexOp>(loc, 1);
-    return {constantOne, constantOne, constantOne};
+    return {workgroupSizeX, constantOne, constantOne};
   }
 
  private:
@@ -162,6 +162,12 @@ class TargetBackend {
   // registration.
   virtual void getDependentDialects(DialectRegistry &registry) const {}
 
+  // Returns true if the runtime HAL driver for the backend supports indirect
+  // descriptor set bindings (hal.command_buffer.push_descriptor_set.indirect)
+  // resolved against a binding table at submission time. Command buffers that
+  // only vary in the buffers they bind may then be recorded once and reused.
+  virtual bool supportsIndirectBindings() const { return false; }
+
   // Captured state from the point at which a dispatch is to be recorded.
   struct DispatchState {
     // The original flow.dispatch op.
@@ -50,6 +50,10 @@ class VMLATargetBackend final : public TargetBackend {
   std::string name() const override { return "vmla"; }
   std::string filter_pattern() const override { return "vmla"; }
 
+  // The VMLA driver records into host command buffers that resolve indirect
+  // bindings when replayed.
+  bool supportsIndirectBindings() const override { return true; }
+
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<VM::VMDialect, VMLA::VMLADialect>();
   }
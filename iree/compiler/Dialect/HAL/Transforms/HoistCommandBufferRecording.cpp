@@ -0,0 +1,353 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <utility>
+
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
+#include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringSet.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/IR/BlockAndValueMapping.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace HAL {
+
+// Returns true if |op| only records commands into a command buffer.
+static bool isCommandBufferRecordingOp(Operation *op) {
+  return isa<CommandBufferBeginOp, CommandBufferEndOp,
+             CommandBufferExecutionBarrierOp, CommandBufferFillBufferOp,
+             CommandBufferCopyBufferOp, CommandBufferPushConstantsOp,
+             CommandBufferPushDescriptorSetOp,
+             CommandBufferBindDescriptorSetOp, CommandBufferDispatchOp,
+             CommandBufferDispatchSymbolOp, CommandBufferDispatchIndirectOp,
+             CommandBufferDispatchIndirectSymbolOp>(op);
+}
+
+// Hoists command buffers that record the same commands on every invocation
+// into initializers and replaces their per-invocation recording with a
+// submission of the cached command buffer.
+//
+// Only the buffers bound with hal.command_buffer.push_descriptor_set may vary
+// between invocations; they are rewritten to indirect bindings that are
+// resolved from the binding table passed to
+// hal.ex.submit_and_wait.indirect. All other operands of the recorded commands
+// (layouts, executables, offsets, lengths, push constants, workloads) must be
+// computable at initialization time.
+//
+// Example:
+//   %cmd = hal.command_buffer.create %dev, OneShot, "Transfer|Dispatch"
+//   hal.command_buffer.begin %cmd
+//   hal.command_buffer.push_descriptor_set %cmd, %layout, set=0, bindings=[
+//     0 = (%buffer, %c0, %c16)
+//   ]
+//   ...
+//   hal.command_buffer.end %cmd
+//   hal.ex.submit_and_wait %dev, %cmd
+// ->
+//   hal.variable @_command_buffer_0 init(@_command_buffer_0_initializer)
+//   func @_command_buffer_0_initializer() -> !hal.command_buffer {
+//     %cmd = hal.command_buffer.create %dev, None, "Transfer|Dispatch"
+//     hal.command_buffer.begin %cmd
+//     hal.command_buffer.push_descriptor_set.indirect %cmd, %layout,
+//         set = 0 : i32, bindings = [0 : i32], binding_slots = [0 : i32],
+//         offsets = [%c0], lengths = [%c16]
+//     ...
+//     hal.command_buffer.end %cmd
+//     return %cmd
+//   }
+//   %cmd = hal.variable.load @_command_buffer_0
+//   hal.ex.submit_and_wait.indirect %dev, %cmd, binding_table = [%buffer]
+//
+// This is only performed if all target backends support indirect bindings.
+class HoistCommandBufferRecordingPass
+    : public PassWrapper<HoistCommandBufferRecordingPass,
+                         OperationPass<ModuleOp>> {
+ public:
+  HoistCommandBufferRecordingPass()
+      : targetOptions_(getTargetOptionsFromFlags()) {}
+  explicit HoistCommandBufferRecordingPass(TargetOptions targetOptions)
+      : targetOptions_(targetOptions) {}
+
+  void runOnOperation() override {
+    auto targetBackends = matchTargetBackends(targetOptions_.targets);
+    if (targetBackends.empty()) return;
+    for (auto &targetBackend : targetBackends) {
+      if (!targetBackend->supportsIndirectBindings()) return;
+    }
+
+    auto moduleOp = getOperation();
+    findStableVariables(moduleOp);
+
+    SmallVector<ExSubmitAndWaitOp, 4> submitOps;
+    for (auto funcOp : moduleOp.getOps<FuncOp>()) {
+      funcOp.walk([&](ExSubmitAndWaitOp op) { submitOps.push_back(op); });
+    }
+
+    // Command buffer variables are appended to the end of the module so that
+    // their initializers run after those of any resources they reference
+    // (such as the executables prepared by the executable cache).
+    moduleBuilder = OpBuilder(moduleOp.getBody()->getTerminator());
+    for (auto submitOp : submitOps) {
+      SmallVector<Operation *, 16> recordingOps;
+      auto createOp = matchStaticCommandBuffer(submitOp, recordingOps);
+      if (!createOp) continue;
+      hoistCommandBuffer(createOp, recordingOps, submitOp);
+    }
+  }
+
+ private:
+  // Finds all variables whose value is fixed after initialization: those that
+  // are immutable or only stored from variable initializers.
+  void findStableVariables(ModuleOp moduleOp) {
+    llvm::StringSet<> initializerNames;
+    for (auto variableOp : moduleOp.getOps<VariableOp>()) {
+      if (auto initializer = variableOp.initializer()) {
+        initializerNames.insert(*initializer);
+      }
+    }
+
+    llvm::StringSet<> storedVariableNames;
+    bool hasIndirectStores = false;
+    for (auto funcOp : moduleOp.getOps<FuncOp>()) {
+      if (initializerNames.count(funcOp.getName())) continue;
+      funcOp.walk([&](Operation *op) {
+        if (auto storeOp = dyn_cast<VariableStoreOp>(op)) {
+          storedVariableNames.insert(storeOp.variable());
+        } else if (isa<VariableStoreIndirectOp>(op)) {
+          hasIndirectStores = true;
+        }
+      });
+    }
+
+    for (auto variableOp : moduleOp.getOps<VariableOp>()) {
+      if (variableOp.is_mutable() &&
+          (hasIndirectStores ||
+           storedVariableNames.count(variableOp.sym_name()) ||
+           SymbolTable::getSymbolVisibility(variableOp) ==
+               SymbolTable::Visibility::Public)) {
+        continue;
+      }
+      stableVariableNames_.insert(variableOp.sym_name());
+    }
+  }
+
+  // Returns true if |value| has the same value on every invocation and can be
+  // recomputed at initialization time.
+  bool isInvariant(Value value) {
+    auto *op = value.getDefiningOp();
+    if (!op) return false;
+    if (auto loadOp = dyn_cast<VariableLoadOp>(op)) {
+      return stableVariableNames_.count(loadOp.variable()) > 0;
+    }
+    if (op->getNumRegions() != 0 ||
+        !MemoryEffectOpInterface::hasNoEffect(op)) {
+      return false;
+    }
+    return llvm::all_of(op->getOperands(),
+                        [&](Value operand) { return isInvariant(operand); });
+  }
+
+  // Returns true if the ops nested within |op| (such as hal.device.switch
+  // regions) do nothing but record commands or compute invariant values.
+  bool hasOnlyRecordingRegions(Operation *op) {
+    bool isRecordingOnly = true;
+    op->walk([&](Operation *nestedOp) {
+      if (nestedOp == op) return;
+      if (isa<ReturnOp, DeviceSwitchOp>(nestedOp) ||
+          isCommandBufferRecordingOp(nestedOp) ||
+          MemoryEffectOpInterface::hasNoEffect(nestedOp)) {
+        return;
+      }
+      if (auto loadOp = dyn_cast<VariableLoadOp>(nestedOp)) {
+        if (stableVariableNames_.count(loadOp.variable())) return;
+      }
+      isRecordingOnly = false;
+    });
+    return isRecordingOnly;
+  }
+
+  // Returns the hal.command_buffer.create op of the command buffer submitted
+  // by |submitOp| if all commands recorded into it are invariant. The
+  // recording ops are returned in |recordingOps| in program order.
+  CommandBufferCreateOp matchStaticCommandBuffer(
+      ExSubmitAndWaitOp submitOp, SmallVectorImpl<Operation *> &recordingOps) {
+    auto *block = submitOp.getOperation()->getBlock();
+    auto createOp = dyn_cast_or_null<CommandBufferCreateOp>(
+        submitOp.command_buffer().getDefiningOp());
+    if (!createOp || createOp.getOperation()->getBlock() != block ||
+        !isInvariant(createOp.device())) {
+      return {};
+    }
+
+    auto commandBuffer = createOp.result();
+    for (auto *user : commandBuffer.getUsers()) {
+      if (user == submitOp.getOperation()) continue;
+      if (user->getBlock() != block ||
+          !createOp.getOperation()->isBeforeInBlock(user) ||
+          !user->isBeforeInBlock(submitOp.getOperation())) {
+        return {};
+      }
+      if (user->getNumResults() != 0 ||
+          !(isCommandBufferRecordingOp(user) || isa<DeviceSwitchOp>(user))) {
+        return {};
+      }
+      for (auto &operand : user->getOpOperands()) {
+        if (operand.get() == commandBuffer) continue;
+        if (auto pushOp = dyn_cast<CommandBufferPushDescriptorSetOp>(user)) {
+          // Bound buffers are provided in the binding table on submission.
+          if (llvm::is_contained(pushOp.binding_buffers(), operand.get())) {
+            continue;
+          }
+        }
+        if (!isInvariant(operand.get())) return {};
+      }
+      if (!hasOnlyRecordingRegions(user)) return {};
+      recordingOps.push_back(user);
+    }
+    llvm::sort(recordingOps, [](Operation *lhs, Operation *rhs) {
+      return lhs->isBeforeInBlock(rhs);
+    });
+    return createOp;
+  }
+
+  // Clones the ops producing the invariant |value| into the initializer.
+  Value cloneInvariant(Value value, OpBuilder &builder,
+                       BlockAndValueMapping &mapping) {
+    if (auto mappedValue = mapping.lookupOrNull(value)) return mappedValue;
+    auto *op = value.getDefiningOp();
+    for (auto operand : op->getOperands()) {
+      cloneInvariant(operand, builder, mapping);
+    }
+    builder.clone(*op, mapping);
+    return mapping.lookup(value);
+  }
+
+  void hoistCommandBuffer(CommandBufferCreateOp createOp,
+                          ArrayRef<Operation *> recordingOps,
+                          ExSubmitAndWaitOp submitOp) {
+    auto loc = createOp.getLoc();
+    auto symbolName = (StringRef("_command_buffer_") +
+                       std::to_string(nextUniqueCommandBufferId++))
+                          .str();
+    auto initializerName = symbolName + "_initializer";
+
+    auto commandBufferType = CommandBufferType::get(loc.getContext());
+    auto variableOp = moduleBuilder.create<VariableOp>(
+        loc, symbolName,
+        /*isMutable=*/false, commandBufferType, StringRef(initializerName),
+        llvm::None);
+    SymbolTable::setSymbolVisibility(variableOp,
+                                     SymbolTable::Visibility::Private);
+
+    auto initializerOp = moduleBuilder.create<FuncOp>(
+        loc, initializerName,
+        moduleBuilder.getFunctionType({}, {commandBufferType}));
+    SymbolTable::setSymbolVisibility(initializerOp,
+                                     SymbolTable::Visibility::Private);
+    auto *block = initializerOp.addEntryBlock();
+    OpBuilder blockBuilder = OpBuilder::atBlockEnd(block);
+    BlockAndValueMapping mapping;
+
+    // Reusable command buffers omit the OneShot mode.
+    auto deviceValue = cloneInvariant(createOp.device(), blockBuilder, mapping);
+    auto commandBufferValue = blockBuilder.createOrFold<CommandBufferCreateOp>(
+        loc, deviceValue, CommandBufferModeBitfield::None,
+        createOp.command_categories());
+    mapping.map(createOp.result(), commandBufferValue);
+
+    // Re-record all commands, assigning each unique buffer bound by a push
+    // descriptor set a slot in the binding table.
+    SmallVector<Value, 4> bindingTable;
+    llvm::DenseMap<Value, int32_t> bindingSlots;
+    for (auto *op : recordingOps) {
+      auto pushOp = dyn_cast<CommandBufferPushDescriptorSetOp>(op);
+      if (!pushOp) {
+        for (auto operand : op->getOperands()) {
+          cloneInvariant(operand, blockBuilder, mapping);
+        }
+        blockBuilder.clone(*op, mapping);
+        continue;
+      }
+
+      SmallVector<Attribute, 4> slotAttrs;
+      for (auto buffer : pushOp.binding_buffers()) {
+        auto it = bindingSlots.try_emplace(buffer, bindingTable.size());
+        if (it.second) bindingTable.push_back(buffer);
+        slotAttrs.push_back(blockBuilder.getI32IntegerAttr(it.first->second));
+      }
+      SmallVector<Value, 4> offsets;
+      for (auto offset : pushOp.binding_offsets()) {
+        offsets.push_back(cloneInvariant(offset, blockBuilder, mapping));
+      }
+      SmallVector<Value, 4> lengths;
+      for (auto length : pushOp.binding_lengths()) {
+        lengths.push_back(cloneInvariant(length, blockBuilder, mapping));
+      }
+      blockBuilder.create<CommandBufferPushDescriptorSetIndirectOp>(
+          pushOp.getLoc(), commandBufferValue,
+          cloneInvariant(pushOp.executable_layout(), blockBuilder, mapping),
+          pushOp.setAttr(), pushOp.bindingsAttr(),
+          blockBuilder.getArrayAttr(slotAttrs), offsets, lengths);
+    }
+    blockBuilder.create<mlir::ReturnOp>(loc, commandBufferValue);
+
+    // Submit the cached command buffer with the buffers of this invocation.
+    OpBuilder builder(submitOp);
+    auto loadedValue = builder.createOrFold<VariableLoadOp>(
+        loc, commandBufferType, variableOp.sym_name());
+    if (bindingTable.empty()) {
+      builder.create<ExSubmitAndWaitOp>(submitOp.getLoc(), submitOp.device(),
+                                        loadedValue);
+    } else {
+      builder.create<ExSubmitAndWaitIndirectOp>(
+          submitOp.getLoc(), submitOp.device(), loadedValue, bindingTable);
+    }
+    submitOp.erase();
+    for (auto *op : llvm::reverse(recordingOps)) {
+      op->erase();
+    }
+    createOp.erase();
+  }
+
+  TargetOptions targetOptions_;
+
+  OpBuilder moduleBuilder{static_cast<MLIRContext *>(nullptr)};
+  llvm::StringSet<> stableVariableNames_;
+  int nextUniqueCommandBufferId = 0;
+};
+
+std::unique_ptr<OperationPass<ModuleOp>> createHoistCommandBufferRecordingPass(
+    TargetOptions targetOptions) {
+  return std::make_unique<HoistCommandBufferRecordingPass>(
+      targetOptions);  // NOLINT
+}
+
+static PassRegistration<HoistCommandBufferRecordingPass> pass(
+    "iree-hal-hoist-command-buffer-recording",
+    "Hoists invariant command buffer recording into initializers");
+
+}  // namespace HAL
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
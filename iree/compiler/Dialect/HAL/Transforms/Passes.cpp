@@ -86,6 +86,12 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   // cache them at initialization-time.
   passManager.addPass(createMaterializeResourceCachesPass(targetOptions));
 
+  // Record command buffers that do not vary across invocations once at
+  // initialization-time. This must run after resource caching so that the
+  // executables and layouts referenced by the commands are loaded from
+  // variables.
+  passManager.addPass(createHoistCommandBufferRecordingPass(targetOptions));
+
   // Inline hal.device.switch ops and memoize their queries such that we can
   // better CSE/fold dispatch logic.
   passManager.addPass(createInlineDeviceSwitchesPass());
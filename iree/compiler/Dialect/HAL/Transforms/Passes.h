@@ -102,6 +102,12 @@ std::unique_ptr<OperationPass<ModuleOp>> createPublicABIGenerationPass();
 std::unique_ptr<OperationPass<ModuleOp>> createMaterializeResourceCachesPass(
     TargetOptions executableOptions);
 
+// Hoists the recording of command buffers that are identical on every
+// invocation into initializers and submits the cached command buffers with a
+// binding table of the buffers used by each invocation.
+std::unique_ptr<OperationPass<ModuleOp>> createHoistCommandBufferRecordingPass(
+    TargetOptions executableOptions);
+
 //===----------------------------------------------------------------------===//
 // Register all Passes
 //===----------------------------------------------------------------------===//
@@ -118,6 +124,7 @@ inline void registerHALPasses() {
   createSerializeExecutablesPass(executableOptions);
   createPublicABIGenerationPass();
   createMaterializeResourceCachesPass(executableOptions);
+  createHoistCommandBufferRecordingPass(executableOptions);
 }
 
 }  // namespace HAL
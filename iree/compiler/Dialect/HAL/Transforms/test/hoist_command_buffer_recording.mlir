@@ -0,0 +1,100 @@
+// RUN: iree-opt -split-input-file -iree-hal-hoist-command-buffer-recording -iree-hal-target-backends=vmla %s | IreeFileCheck %s
+
+hal.variable @_executable_layout_0 init(@_executable_layout_0_initializer) : !hal.executable_layout
+func @_executable_layout_0_initializer() -> !hal.executable_layout attributes {sym_visibility = "private"}
+hal.variable @_executable_exe mutable : !hal.executable attributes {sym_visibility = "private"}
+hal.variable @_executable_cache init(@_executable_cache_initializer) : !hal.executable_cache
+func @_executable_cache_initializer() -> !hal.executable_cache {
+  %dev = hal.ex.shared_device : !hal.device
+  %cache = hal.executable_cache.create %dev, identifier = "default" : !hal.executable_cache
+  %exe = "test_hal.executable"() : () -> !hal.executable
+  hal.variable.store %exe, @_executable_exe : !hal.executable
+  return %cache : !hal.executable_cache
+}
+
+// CHECK-LABEL: func @staticCommandBuffer
+// CHECK-SAME: (%[[ARG0:.+]]: !hal.buffer, %[[ARG1:.+]]: !hal.buffer)
+func @staticCommandBuffer(%arg0 : !hal.buffer, %arg1 : !hal.buffer) {
+  %c0 = constant 0 : index
+  %c1 = constant 1 : index
+  %c16 = constant 16 : index
+  %dev = hal.ex.shared_device : !hal.device
+  %cmd = hal.command_buffer.create %dev, "OneShot", "Transfer|Dispatch" : !hal.command_buffer
+  hal.command_buffer.begin %cmd
+  %layout = hal.variable.load @_executable_layout_0 : !hal.executable_layout
+  hal.command_buffer.push_descriptor_set %cmd, %layout, set=0, bindings=[0 = (%arg0, %c0, %c16), 1 = (%arg1, %c0, %c16)]
+  %exe = hal.variable.load @_executable_exe : !hal.executable
+  hal.command_buffer.dispatch %cmd, %exe, entry_point = 0, workgroup_xyz = [%c1, %c1, %c1]
+  hal.command_buffer.push_descriptor_set %cmd, %layout, set=0, bindings=[0 = (%arg1, %c0, %c16), 1 = (%arg1, %c16, %c16)]
+  hal.command_buffer.dispatch %cmd, %exe, entry_point = 0, workgroup_xyz = [%c1, %c1, %c1]
+  hal.command_buffer.end %cmd
+  //  CHECK-NOT: hal.command_buffer
+  //      CHECK: %[[DEV:.+]] = hal.ex.shared_device : !hal.device
+  //  CHECK-NOT: hal.command_buffer
+  //      CHECK: %[[CMD:.+]] = hal.variable.load @_command_buffer_0 : !hal.command_buffer
+  // CHECK-NEXT: hal.ex.submit_and_wait.indirect %[[DEV]], %[[CMD]], binding_table = [%[[ARG0]], %[[ARG1]]]
+  hal.ex.submit_and_wait %dev, %cmd
+  return
+}
+
+//      CHECK: hal.variable @_command_buffer_0 init(@_command_buffer_0_initializer) : !hal.command_buffer
+// CHECK-NEXT: func @_command_buffer_0_initializer() -> !hal.command_buffer attributes {sym_visibility = "private"} {
+//  CHECK-DAG:   %[[DEV:.+]] = hal.ex.shared_device : !hal.device
+//      CHECK:   %[[CMD:.+]] = hal.command_buffer.create %[[DEV]], "None", "Transfer|Dispatch" : !hal.command_buffer
+// CHECK-NEXT:   hal.command_buffer.begin %[[CMD]]
+//      CHECK:   %[[LAYOUT:.+]] = hal.variable.load @_executable_layout_0 : !hal.executable_layout
+//      CHECK:   hal.command_buffer.push_descriptor_set.indirect %[[CMD]], %[[LAYOUT]], set = 0 : i32, bindings = [0 : i32, 1 : i32], binding_slots = [0 : i32, 1 : i32]
+//      CHECK:   %[[EXE:.+]] = hal.variable.load @_executable_exe : !hal.executable
+//      CHECK:   hal.command_buffer.dispatch %[[CMD]], %[[EXE]], entry_point = 0
+// CHECK-NEXT:   hal.command_buffer.push_descriptor_set.indirect %[[CMD]], %[[LAYOUT]], set = 0 : i32, bindings = [0 : i32, 1 : i32], binding_slots = [1 : i32, 1 : i32]
+// CHECK-NEXT:   hal.command_buffer.dispatch %[[CMD]], %[[EXE]], entry_point = 0
+// CHECK-NEXT:   hal.command_buffer.end %[[CMD]]
+// CHECK-NEXT:   return %[[CMD]] : !hal.command_buffer
+
+// -----
+
+hal.variable @_executable_layout_0 init(@_executable_layout_0_initializer) : !hal.executable_layout
+func @_executable_layout_0_initializer() -> !hal.executable_layout attributes {sym_visibility = "private"}
+
+// CHECK-LABEL: func @dynamicOffset
+func @dynamicOffset(%arg0 : !hal.buffer, %arg1 : index) {
+  %c16 = constant 16 : index
+  %dev = hal.ex.shared_device : !hal.device
+  // CHECK: %[[CMD:.+]] = hal.command_buffer.create
+  %cmd = hal.command_buffer.create %dev, "OneShot", "Transfer|Dispatch" : !hal.command_buffer
+  hal.command_buffer.begin %cmd
+  %layout = hal.variable.load @_executable_layout_0 : !hal.executable_layout
+  // NOTE: offsets must be known at initialization time so cannot hoist.
+  // CHECK: hal.command_buffer.push_descriptor_set %[[CMD]]
+  hal.command_buffer.push_descriptor_set %cmd, %layout, set=0, bindings=[0 = (%arg0, %arg1, %c16)]
+  hal.command_buffer.end %cmd
+  // CHECK: hal.ex.submit_and_wait %{{.+}}, %[[CMD]]
+  hal.ex.submit_and_wait %dev, %cmd
+  return
+}
+
+// CHECK-NOT: @_command_buffer_0
+
+// -----
+
+hal.variable @_executable_layout_0 mutable : !hal.executable_layout
+
+// CHECK-LABEL: func @mutableLayout
+func @mutableLayout(%arg0 : !hal.buffer, %arg1 : !hal.executable_layout) {
+  %c0 = constant 0 : index
+  %c16 = constant 16 : index
+  hal.variable.store %arg1, @_executable_layout_0 : !hal.executable_layout
+  %dev = hal.ex.shared_device : !hal.device
+  // CHECK: %[[CMD:.+]] = hal.command_buffer.create
+  %cmd = hal.command_buffer.create %dev, "OneShot", "Transfer|Dispatch" : !hal.command_buffer
+  hal.command_buffer.begin %cmd
+  // NOTE: the layout variable is stored outside of initializers so may change.
+  %layout = hal.variable.load @_executable_layout_0 : !hal.executable_layout
+  hal.command_buffer.push_descriptor_set %cmd, %layout, set=0, bindings=[0 = (%arg0, %c0, %c16)]
+  hal.command_buffer.end %cmd
+  // CHECK: hal.ex.submit_and_wait %{{.+}}, %[[CMD]]
+  hal.ex.submit_and_wait %dev, %cmd
+  return
+}
+
+// CHECK-NOT: @_command_buffer_0
@@ -20,6 +20,14 @@ vm.import @ex.submit_and_wait(
   %command_buffer : !vm.ref<!hal.command_buffer>
 )
 
+// Submits a reusable command buffer with the buffers referenced by its indirect
+// bindings and waits for it to complete.
+vm.import @ex.submit_and_wait.indirect(
+  %device : !vm.ref<!hal.device>,
+  %command_buffer : !vm.ref<!hal.command_buffer>,
+  %binding_table : !vm.ref<!hal.buffer>...
+)
+
 //===----------------------------------------------------------------------===//
 // iree::hal::Allocator
 //===----------------------------------------------------------------------===//
@@ -291,6 +299,18 @@ vm.import @command_buffer.push_descriptor_set(
   %binding_lengths : i32 ...
 )
 
+// Pushes a descriptor set to the given set number with buffers resolved from
+// the binding table at submission time.
+vm.import @command_buffer.push_descriptor_set.indirect(
+  %command_buffer : !vm.ref<!hal.command_buffer>,
+  %executable_layout : !vm.ref<!hal.executable_layout>,
+  %set : i32,
+  %bindings : i32 ...,
+  %binding_slots : i32 ...,
+  %binding_offsets : i32 ...,
+  %binding_lengths : i32 ...
+)
+
 // Binds a descriptor set to the given set number.
 vm.import @command_buffer.bind_descriptor_set(
   %command_buffer : !vm.ref<!hal.command_buffer>,
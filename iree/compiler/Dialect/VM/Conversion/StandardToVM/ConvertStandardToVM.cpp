@@ -172,13 +172,27 @@ class ConstantOpConversion : public OpConversionPattern<ConstantOp> {
   LogicalResult matchAndRewrite(
       ConstantOp srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
+    // Types not supported by the target (such as f32 without the f32
+    // extension) have no conversion.
+    auto targetType = getTypeConverter()->convertType(srcOp.getType());
+    if (!targetType) {
+      return srcOp.emitRemark() << "unsupported const type for target";
+    }
+    if (auto floatAttr = srcOp.getValue().dyn_cast<FloatAttr>()) {
+      if (!targetType.isF32()) {
+        return srcOp.emitRemark() << "unsupported const float type for dialect";
+      }
+      if (floatAttr.getValue().isPosZero()) {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstF32ZeroOp>(srcOp);
+      } else {
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstF32Op>(srcOp, floatAttr);
+      }
+      return success();
+    }
     auto integerAttr = srcOp.getValue().dyn_cast<IntegerAttr>();
     if (!integerAttr) {
       return srcOp.emitRemark() << "unsupported const type for dialect";
     }
-    // TODO(#2878): use getTypeConverter() when we pass it upon creation.
-    IREE::VM::TypeConverter typeConverter;
-    auto targetType = typeConverter.convertType(srcOp.getType());
     switch (targetType.getIntOrFloatBitWidth()) {
       case 1:
       case 32:
@@ -260,6 +274,62 @@ class CmpIOpConversion : public OpConversionPattern<CmpIOp> {
   }
 };
 
+class CmpFOpConversion : public OpConversionPattern<CmpFOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      CmpFOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    CmpFOp::Adaptor srcAdapter(operands);
+    if (!srcAdapter.lhs().getType().isF32()) return failure();
+    auto returnType = rewriter.getIntegerType(32);
+    // Only the predicates that map directly onto the VM NaN semantics are
+    // supported: eq/lt/lte/gt/gte are ordered and ne is unordered.
+    switch (srcOp.getPredicate()) {
+      case CmpFPredicate::OEQ:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpEQF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::UNE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpNEF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OLT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OLE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpLTEF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OGT:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpGTF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      case CmpFPredicate::OGE:
+        rewriter.replaceOpWithNewOp<IREE::VM::CmpGTEF32Op>(
+            srcOp, returnType, srcAdapter.lhs(), srcAdapter.rhs());
+        return success();
+      default:
+        return failure();
+    }
+  }
+};
+
+template <typename SrcOpTy, typename DstOpTy>
+class UnaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    typename SrcOpTy::Adaptor srcAdapter(operands);
+    rewriter.replaceOpWithNewOp<DstOpTy>(
+        srcOp, srcAdapter.operand().getType(), srcAdapter.operand());
+    return success();
+  }
+};
+
 template <typename SrcOpTy, typename DstOpTy>
 class BinaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
   using OpConversionPattern<SrcOpTy>::OpConversionPattern;
@@ -313,6 +383,21 @@ class CastingOpConversion : public OpConversionPattern<StdOp> {
   }
 };
 
+template <typename SrcOpTy, typename DstOpTy>
+class ConvertingCastOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto resultType =
+        this->getTypeConverter()->convertType(srcOp.getResult().getType());
+    if (!resultType) return failure();
+    rewriter.replaceOpWithNewOp<DstOpTy>(srcOp, resultType, operands[0]);
+    return success();
+  }
+};
+
 class SelectI32OpConversion : public OpConversionPattern<SelectOp> {
   using OpConversionPattern::OpConversionPattern;
   LogicalResult matchAndRewrite(
@@ -330,6 +415,7 @@ class SelectI32OpConversion : public OpConversionPattern<SelectOp> {
     if (actualType != requiredType && actualType.isa<IndexType>()) {
       return failure();
     }
+    if (actualType.isa<FloatType>()) return failure();
 
     rewriter.replaceOpWithNewOp<IREE::VM::SelectI32Op>(
         srcOp, requiredType, srcAdaptor.condition(), srcAdaptor.true_value(),
@@ -338,6 +424,21 @@ class SelectI32OpConversion : public OpConversionPattern<SelectOp> {
   }
 };
 
+class SelectF32OpConversion : public OpConversionPattern<SelectOp> {
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult matchAndRewrite(
+      SelectOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    SelectOp::Adaptor srcAdaptor(operands);
+    auto actualType = srcAdaptor.true_value().getType();
+    if (!actualType.isF32()) return failure();
+    rewriter.replaceOpWithNewOp<IREE::VM::SelectF32Op>(
+        srcOp, actualType, srcAdaptor.condition(), srcAdaptor.true_value(),
+        srcAdaptor.false_value());
+    return success();
+  }
+};
+
 class BranchOpConversion : public OpConversionPattern<BranchOp> {
   using OpConversionPattern::OpConversionPattern;
 
@@ -400,8 +501,9 @@ void populateStandardToVMPatterns(MLIRContext *context,
                   ReturnOpConversion, CastingOpConversion<IndexCastOp>,
                   CastingOpConversion<TruncateIOp>, SelectI32OpConversion>(
       typeConverter, context);
-  // TODO(#2878): pass typeConverter here.
-  patterns.insert<ConstantOpConversion>(context);
+  patterns.insert<CmpFOpConversion, SelectF32OpConversion>(typeConverter,
+                                                           context);
+  patterns.insert<ConstantOpConversion>(typeConverter, context);
 
   // Binary arithmetic ops
   patterns
@@ -417,6 +519,22 @@ void populateStandardToVMPatterns(MLIRContext *context,
               BinaryArithmeticOpConversion<XOrOp, IREE::VM::XorI32Op>>(
           typeConverter, context);
 
+  // Floating-point arithmetic ops
+  patterns.insert<BinaryArithmeticOpConversion<AddFOp, IREE::VM::AddF32Op>,
+                  BinaryArithmeticOpConversion<SubFOp, IREE::VM::SubF32Op>,
+                  BinaryArithmeticOpConversion<MulFOp, IREE::VM::MulF32Op>,
+                  BinaryArithmeticOpConversion<DivFOp, IREE::VM::DivF32Op>,
+                  BinaryArithmeticOpConversion<RemFOp, IREE::VM::RemF32Op>,
+                  UnaryArithmeticOpConversion<AbsFOp, IREE::VM::AbsF32Op>,
+                  UnaryArithmeticOpConversion<NegFOp, IREE::VM::NegF32Op>>(
+      typeConverter, context);
+
+  // Floating-point conversion ops
+  patterns.insert<
+      ConvertingCastOpConversion<SIToFPOp, IREE::VM::CastSI32F32Op>,
+      ConvertingCastOpConversion<FPToSIOp, IREE::VM::CastF32SI32Op>>(
+      typeConverter, context);
+
   // Shift ops
   // TODO(laurenzo): The standard dialect is missing shr ops. Add once in place.
   patterns.insert<ShiftArithmeticOpConversion<ShiftLeftOp, IREE::VM::ShlI32Op>>(
@@ -0,0 +1,121 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='test-iree-convert-std-to-vm' -iree-vm-target-extensions=f32 %s | IreeFileCheck %s
+
+// -----
+// CHECK-LABEL: @t001_const_f32
+module @t001_const_f32 {
+
+module {
+  // CHECK: func @my_fn
+  func @my_fn() -> (f32, f32) {
+    // CHECK: vm.const.f32.zero : f32
+    %0 = constant 0.0 : f32
+    // CHECK: vm.const.f32 1.500000e+00 : f32
+    %1 = constant 1.5 : f32
+    return %0, %1 : f32, f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t002_addf
+module @t002_addf {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1: f32) -> (f32) {
+    // CHECK: vm.add.f32 %[[ARG0]], %[[ARG1]]
+    %0 = addf %arg0, %arg1 : f32
+    return %0 : f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t003_mulf
+module @t003_mulf {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1: f32) -> (f32) {
+    // CHECK: vm.mul.f32 %[[ARG0]], %[[ARG1]]
+    %0 = mulf %arg0, %arg1 : f32
+    return %0 : f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t004_negf
+module @t004_negf {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32) -> (f32) {
+    // CHECK: vm.neg.f32 %[[ARG0]]
+    %0 = negf %arg0 : f32
+    return %0 : f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t005_cmpf
+module @t005_cmpf {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1: f32) -> (i1) {
+    // CHECK: vm.cmp.lt.f32 %[[ARG0]], %[[ARG1]] : f32
+    %0 = cmpf "olt", %arg0, %arg1 : f32
+    return %0 : i1
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t006_select_f32
+module @t006_select_f32 {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[COND:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%cond: i1, %arg0: f32, %arg1: f32) -> (f32) {
+    // CHECK: vm.select.f32 %[[COND]], %[[ARG0]], %[[ARG1]] : f32
+    %0 = select %cond, %arg0, %arg1 : f32
+    return %0 : f32
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t007_casts
+module @t007_casts {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: i32) -> (i32) {
+    // CHECK: %[[F:.+]] = vm.cast.si32.f32 %[[ARG0]] : i32 -> f32
+    %0 = sitofp %arg0 : i32 to f32
+    // CHECK: vm.cast.f32.si32 %[[F]] : f32 -> i32
+    %1 = fptosi %0 : f32 to i32
+    return %1 : i32
+  }
+}
+
+}
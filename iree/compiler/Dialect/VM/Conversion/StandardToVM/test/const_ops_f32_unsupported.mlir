@@ -0,0 +1,16 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='test-iree-convert-std-to-vm' %s -verify-diagnostics
+
+// -----
+// f32 constants are not converted unless the f32 extension is enabled.
+module @t001_const_f32_unsupported {
+
+module {
+  func @const_f32() {
+    // expected-remark @+2 {{unsupported const type for target}}
+    // expected-error @+1 {{failed to legalize operation 'std.constant'}}
+    %0 = constant 1.5 : f32
+    return
+  }
+}
+
+}
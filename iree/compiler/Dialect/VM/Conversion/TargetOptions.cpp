@@ -37,7 +37,8 @@ TargetOptions getTargetOptionsFromFlags() {
       llvm::cl::desc("Supported target opcode extensions"),
       llvm::cl::cat(vmTargetOptionsCategory),
       llvm::cl::values(
-          clEnumValN(OpcodeExtension::kI64, "i64", "i64 type support")),
+          clEnumValN(OpcodeExtension::kI64, "i64", "i64 type support"),
+          clEnumValN(OpcodeExtension::kF32, "f32", "f32 type support")),
   };
   static auto *truncateUnsupportedIntegersFlag = new llvm::cl::opt<bool>{
       "iree-vm-target-truncate-unsupported-integers",
@@ -53,6 +54,9 @@ TargetOptions getTargetOptionsFromFlags() {
       case OpcodeExtension::kI64:
         targetOptions.i64Extension = true;
         break;
+      case OpcodeExtension::kF32:
+        targetOptions.f32Extension = true;
+        break;
     }
   }
   targetOptions.truncateUnsupportedIntegers = *truncateUnsupportedIntegersFlag;
@@ -72,6 +72,15 @@ TypeConverter::TypeConverter(TargetOptions targetOptions)
     return llvm::None;
   });
 
+  // Convert floating-point types.
+  addConversion([this](FloatType floatType) -> Optional<Type> {
+    if (floatType.isF32() && targetOptions_.f32Extension) {
+      // f32 is supported by the VM, use directly.
+      return floatType;
+    }
+    return llvm::None;
+  });
+
   // Convert index types to the target bit width.
   addConversion([this](IndexType indexType) -> Optional<Type> {
     return IntegerType::get(targetOptions_.indexBits, indexType.getContext());
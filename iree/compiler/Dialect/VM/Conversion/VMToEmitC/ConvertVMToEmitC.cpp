@@ -25,45 +25,113 @@ namespace iree_compiler {
 
 namespace {
 
-// Taken over from StandardToVM.
-// We need to replace the Op depending on the operand.
-// We could start with a conversion for IREE::VM::AddI32Op
-template <typename SrcOpTy, typename DstOpTy>
-class BinaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
+// Converts a VM op to a call of the function implementing it in
+// iree/vm/vm_c_funcs.h. All operands are passed in order followed by the
+// values of |attrNames|, which are emitted as literals.
+template <typename SrcOpTy>
+class CallOpConversion : public OpConversionPattern<SrcOpTy> {
   using OpConversionPattern<SrcOpTy>::OpConversionPattern;
 
  public:
-  BinaryArithmeticOpConversion(MLIRContext *context, StringRef funcName)
-      : OpConversionPattern<SrcOpTy>(context), funcName(funcName) {}
+  CallOpConversion(MLIRContext *context, StringRef funcName,
+                   ArrayRef<StringRef> attrNames = {})
+      : OpConversionPattern<SrcOpTy>(context),
+        funcName(funcName),
+        attrNames(attrNames.begin(), attrNames.end()) {}
 
  private:
   LogicalResult matchAndRewrite(
       SrcOpTy srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
-    typename SrcOpTy::Adaptor srcAdapter(operands);
-
     StringAttr callee = rewriter.getStringAttr(funcName);
-    ArrayAttr args =
-        rewriter.getArrayAttr({IntegerAttr::get(rewriter.getIndexType(), 0),
-                               IntegerAttr::get(rewriter.getIndexType(), 1)});
-    ValueRange dstOperands{srcAdapter.lhs(), srcAdapter.rhs()};
 
-    rewriter.replaceOpWithNewOp<DstOpTy>(srcOp, srcAdapter.lhs().getType(),
-                                         callee, args, dstOperands);
+    SmallVector<Attribute, 4> argAttrs;
+    for (unsigned i = 0; i < operands.size(); ++i) {
+      argAttrs.push_back(IntegerAttr::get(rewriter.getIndexType(), i));
+    }
+    for (StringRef attrName : attrNames) {
+      Attribute attr = srcOp.getAttr(attrName);
+      if (!attr) {
+        return rewriter.notifyMatchFailure(srcOp, "missing attribute");
+      }
+      argAttrs.push_back(attr);
+    }
+    ArrayAttr args = rewriter.getArrayAttr(argAttrs);
+
+    rewriter.replaceOpWithNewOp<mlir::emitc::CallOp>(
+        srcOp, srcOp.getOperation()->getResultTypes(), callee, args, operands);
 
     return success();
   }
 
   StringRef funcName;
+  SmallVector<StringRef, 1> attrNames;
 };
 
 }  // namespace
 
 void populateVMToCPatterns(MLIRContext *context,
                            OwningRewritePatternList &patterns) {
-  patterns.insert<
-      BinaryArithmeticOpConversion<IREE::VM::AddI32Op, mlir::emitc::CallOp>>(
-      context, "vm_add_i32");
+  // Constants
+  patterns.insert<CallOpConversion<IREE::VM::ConstI32Op>>(
+      context, "vm_const_i32", ArrayRef<StringRef>{"value"});
+  patterns.insert<CallOpConversion<IREE::VM::ConstI32ZeroOp>>(
+      context, "vm_const_i32_zero");
+
+  // Conditional assignment
+  patterns.insert<CallOpConversion<IREE::VM::SelectI32Op>>(context,
+                                                           "vm_select_i32");
+
+  // Native integer arithmetic
+  patterns.insert<CallOpConversion<IREE::VM::AddI32Op>>(context, "vm_add_i32");
+  patterns.insert<CallOpConversion<IREE::VM::SubI32Op>>(context, "vm_sub_i32");
+  patterns.insert<CallOpConversion<IREE::VM::MulI32Op>>(context, "vm_mul_i32");
+  patterns.insert<CallOpConversion<IREE::VM::DivI32SOp>>(context,
+                                                         "vm_div_i32s");
+  patterns.insert<CallOpConversion<IREE::VM::DivI32UOp>>(context,
+                                                         "vm_div_i32u");
+  patterns.insert<CallOpConversion<IREE::VM::RemI32SOp>>(context,
+                                                         "vm_rem_i32s");
+  patterns.insert<CallOpConversion<IREE::VM::RemI32UOp>>(context,
+                                                         "vm_rem_i32u");
+  patterns.insert<CallOpConversion<IREE::VM::NotI32Op>>(context, "vm_not_i32");
+  patterns.insert<CallOpConversion<IREE::VM::AndI32Op>>(context, "vm_and_i32");
+  patterns.insert<CallOpConversion<IREE::VM::OrI32Op>>(context, "vm_or_i32");
+  patterns.insert<CallOpConversion<IREE::VM::XorI32Op>>(context, "vm_xor_i32");
+
+  // Casting and type conversion/emulation
+  patterns.insert<CallOpConversion<IREE::VM::TruncI32I8Op>>(context,
+                                                            "vm_trunc_i32_i8");
+  patterns.insert<CallOpConversion<IREE::VM::TruncI32I16Op>>(
+      context, "vm_trunc_i32_i16");
+  patterns.insert<CallOpConversion<IREE::VM::ExtI8I32SOp>>(context,
+                                                           "vm_ext_i8_i32s");
+  patterns.insert<CallOpConversion<IREE::VM::ExtI8I32UOp>>(context,
+                                                           "vm_ext_i8_i32u");
+  patterns.insert<CallOpConversion<IREE::VM::ExtI16I32SOp>>(context,
+                                                            "vm_ext_i16_i32s");
+  patterns.insert<CallOpConversion<IREE::VM::ExtI16I32UOp>>(context,
+                                                            "vm_ext_i16_i32u");
+
+  // Native bitwise shift and rotate ops
+  patterns.insert<CallOpConversion<IREE::VM::ShlI32Op>>(
+      context, "vm_shl_i32", ArrayRef<StringRef>{"amount"});
+  patterns.insert<CallOpConversion<IREE::VM::ShrI32SOp>>(
+      context, "vm_shr_i32s", ArrayRef<StringRef>{"amount"});
+  patterns.insert<CallOpConversion<IREE::VM::ShrI32UOp>>(
+      context, "vm_shr_i32u", ArrayRef<StringRef>{"amount"});
+
+  // Comparison ops
+  patterns.insert<CallOpConversion<IREE::VM::CmpEQI32Op>>(context,
+                                                          "vm_cmp_eq_i32");
+  patterns.insert<CallOpConversion<IREE::VM::CmpNEI32Op>>(context,
+                                                          "vm_cmp_ne_i32");
+  patterns.insert<CallOpConversion<IREE::VM::CmpLTI32SOp>>(context,
+                                                           "vm_cmp_lt_i32s");
+  patterns.insert<CallOpConversion<IREE::VM::CmpLTI32UOp>>(context,
+                                                           "vm_cmp_lt_i32u");
+  patterns.insert<CallOpConversion<IREE::VM::CmpNZI32Op>>(context,
+                                                          "vm_cmp_nz_i32");
 }
 
 namespace IREE {
@@ -87,7 +155,17 @@ class ConvertVMToEmitCPass
 
     target.addLegalDialect<mlir::emitc::EmitCDialect>();
     target.addLegalDialect<IREE::VM::VMDialect>();
-    target.addIllegalOp<IREE::VM::AddI32Op>();
+    target.addIllegalOp<
+        IREE::VM::ConstI32Op, IREE::VM::ConstI32ZeroOp, IREE::VM::SelectI32Op,
+        IREE::VM::AddI32Op, IREE::VM::SubI32Op, IREE::VM::MulI32Op,
+        IREE::VM::DivI32SOp, IREE::VM::DivI32UOp, IREE::VM::RemI32SOp,
+        IREE::VM::RemI32UOp, IREE::VM::NotI32Op, IREE::VM::AndI32Op,
+        IREE::VM::OrI32Op, IREE::VM::XorI32Op, IREE::VM::TruncI32I8Op,
+        IREE::VM::TruncI32I16Op, IREE::VM::ExtI8I32SOp, IREE::VM::ExtI8I32UOp,
+        IREE::VM::ExtI16I32SOp, IREE::VM::ExtI16I32UOp, IREE::VM::ShlI32Op,
+        IREE::VM::ShrI32SOp, IREE::VM::ShrI32UOp, IREE::VM::CmpEQI32Op,
+        IREE::VM::CmpNEI32Op, IREE::VM::CmpLTI32SOp, IREE::VM::CmpLTI32UOp,
+        IREE::VM::CmpNZI32Op>();
 
     if (failed(applyFullConversion(getOperation(), target, patterns))) {
       return signalPassFailure();
@@ -0,0 +1,37 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='iree-convert-vm-to-emitc' %s | IreeFileCheck %s
+
+// CHECK-LABEL: vm.module @const_module
+vm.module @const_module {
+  // CHECK: vm.func @const_i32
+  vm.func @const_i32() -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_const_i32"() {args = [42 : i32]} : () -> i32
+    %0 = vm.const.i32 42 : i32
+    vm.return %0 : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: vm.module @shift_module
+vm.module @shift_module {
+  // CHECK: vm.func @shl_i32
+  vm.func @shl_i32(%arg0 : i32) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_shl_i32"(%arg0) {args = [0 : index, 2 : i8]} : (i32) -> i32
+    %0 = vm.shl.i32 %arg0, 2 : i32
+    vm.return %0 : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: vm.module @cmp_module
+vm.module @cmp_module {
+  // CHECK: vm.func @cmp_select_i32
+  vm.func @cmp_select_i32(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_lt_i32s"(%arg0, %arg1) {args = [0 : index, 1 : index]} : (i32, i32) -> i32
+    %0 = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    // CHECK-NEXT: %1 = emitc.call "vm_select_i32"(%0, %arg0, %arg1) {args = [0 : index, 1 : index, 2 : index]} : (i32, i32, i32) -> i32
+    %1 = vm.select.i32 %0, %arg0, %arg1 : i32
+    vm.return %1 : i32
+  }
+}
@@ -16,6 +16,7 @@
 
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
 #include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "llvm/ADT/APSInt.h"
 #include "llvm/ADT/StringExtras.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -105,8 +106,7 @@ struct DropDefaultConstGlobalOpInitializer : public OpRewritePattern<T> {
   LogicalResult matchAndRewrite(T op,
                                 PatternRewriter &rewriter) const override {
     if (!op.initial_value().hasValue()) return failure();
-    auto value = op.initial_valueAttr().template cast<IntegerAttr>();
-    if (value.getValue() != 0) return failure();
+    if (op.initial_valueAttr() != zeroOfType(op.type())) return failure();
     rewriter.replaceOpWithNewOp<T>(op, op.sym_name(), op.is_mutable(),
                                    op.type(),
                                    llvm::to_vector<4>(op.getDialectAttrs()));
@@ -128,6 +128,12 @@ void GlobalI64Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
                  DropDefaultConstGlobalOpInitializer<GlobalI64Op>>(context);
 }
 
+void GlobalF32Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<InlineConstGlobalOpInitializer<GlobalF32Op>,
+                 DropDefaultConstGlobalOpInitializer<GlobalF32Op>>(context);
+}
+
 void GlobalRefOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                               MLIRContext *context) {
   results.insert<InlineConstGlobalOpInitializer<GlobalRefOp>>(context);
@@ -138,7 +144,7 @@ namespace {
 /// Inlines immutable global constants into their loads.
 template <typename LOAD_OP, typename GLOBAL_OP, typename CONST_OP,
           typename CONST_ZERO_OP>
-struct InlineConstGlobalLoadIntegerOp : public OpRewritePattern<LOAD_OP> {
+struct InlineConstGlobalLoadPrimitiveOp : public OpRewritePattern<LOAD_OP> {
   using OpRewritePattern<LOAD_OP>::OpRewritePattern;
   LogicalResult matchAndRewrite(LOAD_OP op,
                                 PatternRewriter &rewriter) const override {
@@ -162,15 +168,22 @@ struct InlineConstGlobalLoadIntegerOp : public OpRewritePattern<LOAD_OP> {
 
 void GlobalLoadI32Op::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
-  results.insert<InlineConstGlobalLoadIntegerOp<GlobalLoadI32Op, GlobalI32Op,
-                                                ConstI32Op, ConstI32ZeroOp>>(
+  results.insert<InlineConstGlobalLoadPrimitiveOp<GlobalLoadI32Op, GlobalI32Op,
+                                                  ConstI32Op, ConstI32ZeroOp>>(
       context);
 }
 
 void GlobalLoadI64Op::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
-  results.insert<InlineConstGlobalLoadIntegerOp<GlobalLoadI64Op, GlobalI64Op,
-                                                ConstI64Op, ConstI64ZeroOp>>(
+  results.insert<InlineConstGlobalLoadPrimitiveOp<GlobalLoadI64Op, GlobalI64Op,
+                                                  ConstI64Op, ConstI64ZeroOp>>(
+      context);
+}
+
+void GlobalLoadF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<InlineConstGlobalLoadPrimitiveOp<GlobalLoadF32Op, GlobalF32Op,
+                                                  ConstF32Op, ConstF32ZeroOp>>(
       context);
 }
 
@@ -234,6 +247,13 @@ void GlobalLoadIndirectI64Op::getCanonicalizationPatterns(
       context);
 }
 
+void GlobalLoadIndirectF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<
+      PropagateGlobalLoadAddress<GlobalLoadIndirectF32Op, GlobalLoadF32Op>>(
+      context);
+}
+
 void GlobalLoadIndirectRefOp::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
   results.insert<
@@ -275,6 +295,13 @@ void GlobalStoreIndirectI64Op::getCanonicalizationPatterns(
       context);
 }
 
+void GlobalStoreIndirectF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<
+      PropagateGlobalStoreAddress<GlobalStoreIndirectF32Op, GlobalStoreF32Op>>(
+      context);
+}
+
 void GlobalStoreIndirectRefOp::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
   results.insert<
@@ -290,6 +317,8 @@ OpFoldResult ConstI32Op::fold(ArrayRef<Attribute> operands) { return value(); }
 
 OpFoldResult ConstI64Op::fold(ArrayRef<Attribute> operands) { return value(); }
 
+OpFoldResult ConstF32Op::fold(ArrayRef<Attribute> operands) { return value(); }
+
 OpFoldResult ConstI32ZeroOp::fold(ArrayRef<Attribute> operands) {
   return IntegerAttr::get(getResult().getType(), 0);
 }
@@ -298,6 +327,10 @@ OpFoldResult ConstI64ZeroOp::fold(ArrayRef<Attribute> operands) {
   return IntegerAttr::get(getResult().getType(), 0);
 }
 
+OpFoldResult ConstF32ZeroOp::fold(ArrayRef<Attribute> operands) {
+  return FloatAttr::get(getResult().getType(), 0.0);
+}
+
 OpFoldResult ConstRefZeroOp::fold(ArrayRef<Attribute> operands) {
   // TODO(b/144027097): relace unit attr with a proper null ref_ptr attr.
   return UnitAttr::get(getContext());
@@ -334,6 +367,10 @@ OpFoldResult SelectI64Op::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
 
+OpFoldResult SelectF32Op::fold(ArrayRef<Attribute> operands) {
+  return foldSelectOp(*this);
+}
+
 OpFoldResult SelectRefOp::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
@@ -679,6 +716,49 @@ OpFoldResult XorI64Op::fold(ArrayRef<Attribute> operands) {
   return foldXorOp(*this, operands);
 }
 
+//===----------------------------------------------------------------------===//
+// Native floating-point arithmetic
+//===----------------------------------------------------------------------===//
+// NOTE: identities such as x + 0 = x do not hold for all IEEE values (-0, NaN)
+// so only fully-constant operands are folded.
+
+OpFoldResult AddF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a + b; });
+}
+
+OpFoldResult SubF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a - b; });
+}
+
+OpFoldResult MulF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a * b; });
+}
+
+OpFoldResult DivF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](APFloat a, APFloat b) { return a / b; });
+}
+
+OpFoldResult RemF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(operands, [](APFloat a, APFloat b) {
+    a.mod(b);
+    return a;
+  });
+}
+
+OpFoldResult AbsF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryOp<FloatAttr>(operands,
+                                     [](APFloat a) { return llvm::abs(a); });
+}
+
+OpFoldResult NegF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryOp<FloatAttr>(operands,
+                                     [](APFloat a) { return llvm::neg(a); });
+}
+
 //===----------------------------------------------------------------------===//
 // Native bitwise shifts and rotates
 //===----------------------------------------------------------------------===//
@@ -909,6 +989,53 @@ void ExtI16I64UOp::getCanonicalizationPatterns(
       ExtI16I64UOp, ExtI16I32UOp, 32, ExtI32I64UOp>>(context);
 }
 
+namespace {
+
+/// Performs const folding of an int->float cast if the operand is constant.
+Attribute constFoldIntToFloatCast(ArrayRef<Attribute> operands, Type type,
+                                  bool isSigned) {
+  auto operand = operands[0].dyn_cast_or_null<IntegerAttr>();
+  if (!operand) return {};
+  auto &semantics = type.cast<FloatType>().getFloatSemantics();
+  APFloat value(semantics);
+  value.convertFromAPInt(operand.getValue(), isSigned,
+                         APFloat::rmNearestTiesToEven);
+  return FloatAttr::get(type, value);
+}
+
+/// Performs const folding of a float->int cast if the operand is constant and
+/// exactly representable (after truncation) in the result type.
+Attribute constFoldFloatToIntCast(ArrayRef<Attribute> operands, Type type,
+                                  bool isSigned) {
+  auto operand = operands[0].dyn_cast_or_null<FloatAttr>();
+  if (!operand) return {};
+  unsigned bitWidth = type.getIntOrFloatBitWidth();
+  APSInt result(bitWidth, /*isUnsigned=*/!isSigned);
+  bool isExact = false;
+  auto status = operand.getValue().convertToInteger(
+      result, APFloat::rmTowardZero, &isExact);
+  if (status & APFloat::opInvalidOp) return {};
+  return IntegerAttr::get(type, result);
+}
+
+}  // namespace
+
+OpFoldResult CastSI32F32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldIntToFloatCast(operands, getType(), /*isSigned=*/true);
+}
+
+OpFoldResult CastUI32F32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldIntToFloatCast(operands, getType(), /*isSigned=*/false);
+}
+
+OpFoldResult CastF32SI32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatToIntCast(operands, getType(), /*isSigned=*/true);
+}
+
+OpFoldResult CastF32UI32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldFloatToIntCast(operands, getType(), /*isSigned=*/false);
+}
+
 //===----------------------------------------------------------------------===//
 // Native reduction (horizontal) arithmetic
 //===----------------------------------------------------------------------===//
@@ -1319,6 +1446,83 @@ OpFoldResult CmpNZI64Op::fold(ArrayRef<Attribute> operands) {
       operands, [&](APInt a) { return APInt(64, a.getBoolValue()); });
 }
 
+namespace {
+
+/// Performs const folding of a floating-point comparison if both operands are
+/// constant. |predicate| receives the IEEE comparison result.
+template <typename T>
+OpFoldResult constFoldCmpFloatOp(
+    T op, ArrayRef<Attribute> operands,
+    llvm::function_ref<bool(APFloat::cmpResult)> predicate) {
+  auto lhs = operands[0].dyn_cast_or_null<FloatAttr>();
+  auto rhs = operands[1].dyn_cast_or_null<FloatAttr>();
+  if (!lhs || !rhs) return {};
+  bool result = predicate(lhs.getValue().compare(rhs.getValue()));
+  return IntegerAttr::get(op.getType(), result ? 1 : 0);
+}
+
+}  // namespace
+
+OpFoldResult CmpEQF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpFloatOp(*this, operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpEqual;
+  });
+}
+
+OpFoldResult CmpNEF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpFloatOp(*this, operands, [](APFloat::cmpResult r) {
+    return r != APFloat::cmpEqual;
+  });
+}
+
+void CmpNEF32Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                             MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpNEF32Op, CmpEQF32Op>>(context);
+}
+
+OpFoldResult CmpLTF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpFloatOp(*this, operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpLessThan;
+  });
+}
+
+OpFoldResult CmpLTEF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpFloatOp(*this, operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpLessThan || r == APFloat::cmpEqual;
+  });
+}
+
+OpFoldResult CmpGTF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpFloatOp(*this, operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpGreaterThan;
+  });
+}
+
+void CmpGTF32Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                             MLIRContext *context) {
+  // NOTE: unlike integers we cannot rewrite to !(lhs <= rhs) as that would
+  // return true for unordered (NaN) operands.
+  results.insert<RewritePseudoCmpGTToLT<CmpGTF32Op, CmpLTF32Op>>(context);
+}
+
+OpFoldResult CmpGTEF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCmpFloatOp(*this, operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpGreaterThan || r == APFloat::cmpEqual;
+  });
+}
+
+void CmpGTEF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  // rhs <= lhs; the operand swap is the same as for the GT->LT rewrite.
+  results.insert<RewritePseudoCmpGTToLT<CmpGTEF32Op, CmpLTEF32Op>>(context);
+}
+
+OpFoldResult CmpNZF32Op::fold(ArrayRef<Attribute> operands) {
+  auto operand = operands[0].dyn_cast_or_null<FloatAttr>();
+  if (!operand) return {};
+  return IntegerAttr::get(getType(), operand.getValue().isZero() ? 0 : 1);
+}
+
 OpFoldResult CmpEQRefOp::fold(ArrayRef<Attribute> operands) {
   if (lhs() == rhs()) {
     // x == x = true
@@ -1529,6 +1733,20 @@ struct SimplifyConstCondBranchPred : public OpRewritePattern<CondBranchOp> {
   }
 };
 
+/// Removes a vm.cmp.nz.i32 feeding a cond_br as the branch already tests for a
+/// non-zero condition.
+struct ElideCmpNZCondBranchPred : public OpRewritePattern<CondBranchOp> {
+  using OpRewritePattern<CondBranchOp>::OpRewritePattern;
+  LogicalResult matchAndRewrite(CondBranchOp op,
+                                PatternRewriter &rewriter) const override {
+    auto cmpOp = dyn_cast_or_null<CmpNZI32Op>(op.condition().getDefiningOp());
+    if (!cmpOp) return failure();
+    rewriter.updateRootInPlace(
+        op, [&]() { op.setOperand(0, cmpOp.operand()); });
+    return success();
+  }
+};
+
 /// Simplifies a cond_br with both targets (including operands) being equal to
 /// an unconditional branch.
 struct SimplifySameTargetCondBranchOp : public OpRewritePattern<CondBranchOp> {
@@ -1581,7 +1799,8 @@ struct SwapInvertedCondBranchOpTargets : public OpRewritePattern<CondBranchOp> {
 
 void CondBranchOp::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
-  results.insert<SimplifyConstCondBranchPred, SimplifySameTargetCondBranchOp,
+  results.insert<SimplifyConstCondBranchPred, ElideCmpNZCondBranchPred,
+                 SimplifySameTargetCondBranchOp,
                  SwapInvertedCondBranchOpTargets>(context);
 }
 
@@ -1699,7 +1918,7 @@ namespace {
 
 /// Rewrites a check op to a cmp and a cond_fail.
 template <typename CheckOp, typename CmpI32Op, typename CmpI64Op,
-          typename CmpRefOp>
+          typename CmpF32Op, typename CmpRefOp>
 struct RewriteCheckToCondFail : public OpRewritePattern<CheckOp> {
   using OpRewritePattern<CheckOp>::OpRewritePattern;
   LogicalResult matchAndRewrite(CheckOp op,
@@ -1719,6 +1938,10 @@ struct RewriteCheckToCondFail : public OpRewritePattern<CheckOp> {
       condValue = rewriter.template createOrFold<CmpI32Op>(
           op.getLoc(), ArrayRef<Type>{condType},
           op.getOperation()->getOperands());
+    } else if (operandType.isF32()) {
+      condValue = rewriter.template createOrFold<CmpF32Op>(
+          op.getLoc(), ArrayRef<Type>{condType},
+          op.getOperation()->getOperands());
     } else {
       return failure();
     }
@@ -1737,23 +1960,20 @@ struct RewriteCheckToCondFail : public OpRewritePattern<CheckOp> {
 
 void CheckEQOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                             MLIRContext *context) {
-  results.insert<
-      RewriteCheckToCondFail<CheckEQOp, CmpEQI32Op, CmpEQI64Op, CmpEQRefOp>>(
-      context);
+  results.insert<RewriteCheckToCondFail<CheckEQOp, CmpEQI32Op, CmpEQI64Op,
+                                        CmpEQF32Op, CmpEQRefOp>>(context);
 }
 
 void CheckNEOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                             MLIRContext *context) {
-  results.insert<
-      RewriteCheckToCondFail<CheckNEOp, CmpNEI32Op, CmpNEI64Op, CmpNERefOp>>(
-      context);
+  results.insert<RewriteCheckToCondFail<CheckNEOp, CmpNEI32Op, CmpNEI64Op,
+                                        CmpNEF32Op, CmpNERefOp>>(context);
 }
 
 void CheckNZOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                             MLIRContext *context) {
-  results.insert<
-      RewriteCheckToCondFail<CheckNZOp, CmpNZI32Op, CmpNZI64Op, CmpNZRefOp>>(
-      context);
+  results.insert<RewriteCheckToCondFail<CheckNZOp, CmpNZI32Op, CmpNZI64Op,
+                                        CmpNZF32Op, CmpNZRefOp>>(context);
 }
 
 //===----------------------------------------------------------------------===//
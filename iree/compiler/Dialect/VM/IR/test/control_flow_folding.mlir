@@ -26,6 +26,15 @@ vm.module @cond_br_folds {
     vm.return %1 : i32
   }
 
+  // CHECK-LABEL: @cmp_nz_cond_br
+  vm.func @cmp_nz_cond_br(%arg0 : i32, %arg1 : i32, %arg2 : i32) -> i32 {
+    // CHECK-NEXT: vm.cond_br %arg0, ^bb1(%arg1 : i32), ^bb1(%arg2 : i32)
+    %nz = vm.cmp.nz.i32 %arg0 : i32
+    vm.cond_br %nz, ^bb1(%arg1 : i32), ^bb1(%arg2 : i32)
+  ^bb1(%0 : i32):
+    vm.return %0 : i32
+  }
+
   // CHECK-LABEL: @same_target_same_args_cond_br
   vm.func @same_target_same_args_cond_br(%arg0 : i32, %arg1 : i32) -> i32 {
     // CHECK-NEXT: vm.return %arg1 : i32
@@ -224,3 +224,17 @@ vm.module @my_module {
     vm.return
   }
 }
+
+// -----
+
+// CHECK-LABEL: @cond_branch_lt_i32_s
+vm.module @my_module {
+  vm.func @cond_branch_lt_i32_s(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK: vm.cond_br.lt.i32.s %arg0, %arg1, ^bb1(%arg0 : i32), ^bb2 : i32
+    vm.cond_br.lt.i32.s %arg0, %arg1, ^bb1(%arg0 : i32), ^bb2 : i32
+  ^bb1(%0 : i32):
+    vm.return %0 : i32
+  ^bb2:
+    vm.return %arg1 : i32
+  }
+}
@@ -188,6 +188,13 @@ static LogicalResult canonicalizeModule(BytecodeTargetOptions targetOptions,
     modulePasses.addPass(mlir::createCanonicalizerPass());
   }
 
+  // Fuse superinstructions after canonicalization (which may expose more
+  // fusion opportunities) and before dropping compiler hints so that values
+  // marked as not to be optimized are left alone.
+  if (targetOptions.fuseSuperinstructions) {
+    modulePasses.addPass(IREE::VM::createSuperinstructionFusionPass());
+  }
+
   modulePasses.addPass(createDropCompilerHintsPass());
 
   // Mark up the module with ordinals for each top-level op (func, etc).
@@ -222,6 +229,7 @@ static Optional<Offset<Vector<T>>> createOptionalVector(
 //
 // Examples:
 //  i32              -> i
+//  f32              -> f
 //  !vm.ref<...>     -> r
 //  tuple<i32, i64>  -> iI
 static LogicalResult encodeCallingConventionType(Operation *op, Type type,
@@ -239,6 +247,9 @@ static LogicalResult encodeCallingConventionType(Operation *op, Type type,
         s.push_back('I');
         return success();
     }
+  } else if (type.isF32()) {
+    s.push_back('f');
+    return success();
   } else if (auto tupleType = type.dyn_cast<TupleType>()) {
     // Flatten tuple (so tuple<i32, i64> -> `...iI...`).
     SmallVector<Type, 4> flattenedTypes;
@@ -47,6 +47,10 @@ struct BytecodeTargetOptions {
   // Run basic CSE/inlining/etc passes prior to serialization.
   bool optimize = true;
 
+  // Fuses common op sequences into superinstructions to reduce the number of
+  // ops dispatched at runtime.
+  bool fuseSuperinstructions = true;
+
   // Strips all internal symbol names. Import and export names will remain.
   bool stripSymbols = false;
   // Strips source map information.
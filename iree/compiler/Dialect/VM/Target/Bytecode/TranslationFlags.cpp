@@ -48,6 +48,13 @@ static llvm::cl::opt<bool> optimizeFlag{
     llvm::cl::init(true),
 };
 
+static llvm::cl::opt<bool> fuseSuperinstructionsFlag{
+    "iree-vm-bytecode-module-fuse-superinstructions",
+    llvm::cl::desc("Fuses common op sequences into superinstructions prior to "
+                   "serialization"),
+    llvm::cl::init(true),
+};
+
 static llvm::cl::opt<bool> stripSymbolsFlag{
     "iree-vm-bytecode-module-strip-symbols",
     llvm::cl::desc("Strips all internal symbol names from the module"),
@@ -70,6 +77,7 @@ BytecodeTargetOptions getBytecodeTargetOptionsFromFlags() {
   BytecodeTargetOptions targetOptions;
   targetOptions.outputFormat = outputFormatFlag;
   targetOptions.optimize = optimizeFlag;
+  targetOptions.fuseSuperinstructions = fuseSuperinstructionsFlag;
   targetOptions.stripSymbols = stripSymbolsFlag;
   targetOptions.stripSourceMap = stripSourceMapFlag;
   targetOptions.stripDebugOps = stripDebugOpsFlag;
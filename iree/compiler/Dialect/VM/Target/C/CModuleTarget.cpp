@@ -14,24 +14,150 @@
 
 #include "iree/compiler/Dialect/VM/Target/C/CModuleTarget.h"
 
+#include <algorithm>
+
+#include "emitc/Dialect/EmitC/EmitCDialect.h"
 #include "emitc/Target/Cpp.h"
+#include "iree/compiler/Dialect/IREE/IR/IREEOps.h"
+#include "iree/compiler/Dialect/IREE/Transforms/Passes.h"
 #include "iree/compiler/Dialect/VM/Conversion/VMToEmitC/ConvertVMToEmitC.h"
+#include "iree/compiler/Dialect/VM/IR/VMDialect.h"
+#include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "iree/compiler/Dialect/VM/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/Format.h"
+#include "mlir/IR/SymbolTable.h"
 #include "mlir/Pass/PassManager.h"
+#include "mlir/Transforms/DialectConversion.h"
 
 namespace mlir {
 namespace iree_compiler {
 namespace IREE {
 namespace VM {
 
+// Returns |name| with all characters that are not valid in C identifiers
+// replaced with underscores.
+static std::string sanitizeName(StringRef name) {
+  std::string result = name.str();
+  for (char &c : result) {
+    if (!llvm::isAlnum(c) && c != '_') c = '_';
+  }
+  return result;
+}
+
+static std::string buildModuleName(IREE::VM::ModuleOp &moduleOp) {
+  return sanitizeName(moduleOp.getName());
+}
+
 static std::string buildFunctionName(IREE::VM::ModuleOp &moduleOp,
                                      IREE::VM::FuncOp &funcOp,
                                      bool implSuffix) {
   std::string functionName =
-      std::string(moduleOp.getName()) + "_" + std::string(funcOp.getName());
+      buildModuleName(moduleOp) + "_" + sanitizeName(funcOp.getName());
 
   return implSuffix ? functionName + "_impl" : functionName;
 }
 
+static bool isRefType(Type type) { return type.isa<IREE::VM::RefType>(); }
+
+static bool isSupportedType(Type type) {
+  return isRefType(type) || type.isInteger(32);
+}
+
+// Verifies that all arguments and results of |functionType| are supported by
+// the C target.
+static LogicalResult verifySupportedFunctionType(Operation *op,
+                                                 FunctionType functionType) {
+  for (Type type : llvm::concat<const Type>(functionType.getInputs(),
+                                            functionType.getResults())) {
+    if (!isSupportedType(type)) {
+      return op->emitError()
+             << "type " << type << " is not yet supported by the C target";
+    }
+  }
+  return success();
+}
+
+static LogicalResult emitTypeToC(mlir::emitc::CppEmitter &emitter, Type type,
+                                 llvm::raw_ostream &output) {
+  if (isRefType(type)) {
+    output << "iree_vm_ref_t";
+    return success();
+  }
+  return emitter.emitType(type);
+}
+
+// Prints |str| as a C string literal. Non-printable characters are escaped as
+// octal so that they cannot run on into following characters.
+static void printCStringLiteral(StringRef str, llvm::raw_ostream &output) {
+  output << "\"";
+  for (unsigned char c : str) {
+    if (c == '\\' || c == '"') {
+      output << '\\' << c;
+    } else if (llvm::isPrint(c)) {
+      output << c;
+    } else {
+      output << '\\' << char('0' + ((c >> 6) & 7)) << char('0' + ((c >> 3) & 7))
+             << char('0' + (c & 7));
+    }
+  }
+  output << "\"";
+}
+
+// Prints |str| as an iree_string_view_t initializer. Unlike
+// iree_make_cstring_view this is a constant expression in C and may be used to
+// initialize the static descriptor tables.
+static void printStringViewInitializer(StringRef str,
+                                       llvm::raw_ostream &output) {
+  output << "{";
+  printCStringLiteral(str, output);
+  output << ", " << str.size() << "}";
+}
+
+// Generates a string encoding the function type for the calling convention
+// of exported and imported functions (see iree/vm/module.h).
+static std::string makeCallingConventionString(FunctionType functionType) {
+  if (functionType.getNumInputs() == 0 && functionType.getNumResults() == 0) {
+    return std::string{};  // Valid but empty.
+  }
+  std::string s = "0";
+  for (Type type : functionType.getInputs()) {
+    s.push_back(isRefType(type) ? 'r' : 'i');
+  }
+  if (functionType.getNumResults() > 0) {
+    s.push_back('.');
+    for (Type type : functionType.getResults()) {
+      s.push_back(isRefType(type) ? 'r' : 'i');
+    }
+  }
+  return s;
+}
+
+// Returns a C expression for the size in bytes of |types| when marshaled
+// using the VM calling convention.
+static std::string buildABISizeExpr(TypeRange types) {
+  int i32Count = 0;
+  int refCount = 0;
+  for (Type type : types) {
+    isRefType(type) ? ++refCount : ++i32Count;
+  }
+  std::string expr = std::to_string(i32Count * 4);
+  if (refCount > 0) {
+    expr += " + " + std::to_string(refCount) + " * sizeof(iree_vm_ref_t)";
+  }
+  return expr;
+}
+
+// Returns C expressions for the byte offset of each of |types| when marshaled
+// using the VM calling convention.
+static std::vector<std::string> buildABIOffsetExprs(TypeRange types) {
+  std::vector<std::string> offsets;
+  for (unsigned i = 0; i < types.size(); ++i) {
+    offsets.push_back(buildABISizeExpr(types.take_front(i)));
+  }
+  return offsets;
+}
+
 static void printModuleComment(IREE::VM::ModuleOp &moduleOp,
                                llvm::raw_ostream &output) {
   output << "//" << std::string(77, '=') << "\n"
@@ -52,40 +178,628 @@ static void printSeparatingComment(llvm::raw_ostream &output) {
          << std::string(77, '=') << "\n";
 }
 
+//===----------------------------------------------------------------------===//
+// Functions
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+// State used while translating the body of a single function.
+struct FunctionContext {
+  IREE::VM::ModuleOp moduleOp;
+  IREE::VM::FuncOp funcOp;
+  std::vector<std::string> resultNames;
+  llvm::DenseMap<Block *, std::string> blockLabels;
+  // Ref-typed values owned by the function. These must be released on all
+  // paths out of the function so all exits branch to a shared cleanup label
+  // instead of returning directly.
+  SmallVector<Value, 8> refLocals;
+};
+
+}  // namespace
+
+// Returns a C expression for a pointer to the ref |value|. Entry block
+// arguments are passed by pointer and borrowed from the caller while all other
+// refs are owned locals.
+static std::string getRefPointer(mlir::emitc::CppEmitter &emitter,
+                                 Value value) {
+  if (auto arg = value.dyn_cast<BlockArgument>()) {
+    if (arg.getOwner()->isEntryBlock()) {
+      return emitter.getOrCreateName(value).str();
+    }
+  }
+  return "&" + emitter.getOrCreateName(value).str();
+}
+
+// Emits a call to a function returning iree_status_t that exits the function
+// on failure.
+static void emitCheckedCall(FunctionContext &context, StringRef expr,
+                            llvm::raw_ostream &output) {
+  if (context.refLocals.empty()) {
+    output << "IREE_RETURN_IF_ERROR(" << expr << ");\n";
+  } else {
+    output << "status = " << expr << ";\n"
+           << "if (IREE_UNLIKELY(!iree_status_is_ok(status))) goto cleanup;\n";
+  }
+}
+
+// Emits an exit from the function returning the iree_status_t |expr|.
+static void emitReturnStatus(FunctionContext &context, StringRef expr,
+                             llvm::raw_ostream &output) {
+  if (context.refLocals.empty()) {
+    output << "return " << expr << ";\n";
+  } else {
+    output << "status = " << expr << ";\n"
+           << "goto cleanup;\n";
+  }
+}
+
+static std::string buildCheckedExpr(StringRef callee,
+                                    ArrayRef<std::string> args) {
+  std::string expr = callee.str() + "(";
+  for (auto arg : llvm::enumerate(args)) {
+    if (arg.index() > 0) expr += ", ";
+    expr += arg.value();
+  }
+  return expr + ")";
+}
+
+static LogicalResult translateEmitCCallOpToC(mlir::emitc::CppEmitter &emitter,
+                                             mlir::emitc::CallOp callOp,
+                                             llvm::raw_ostream &output) {
+  Operation *op = callOp.getOperation();
+  if (op->getNumResults() > 1) {
+    return callOp.emitError() << "calls with multiple results are not "
+                                 "supported by the C target";
+  }
+  if (op->getNumResults() == 1) {
+    output << emitter.getOrCreateName(op->getResult(0)) << " = ";
+  }
+  output << callOp.getAttrOfType<StringAttr>("callee").getValue() << "(";
+
+  auto args = callOp.getAttrOfType<ArrayAttr>("args");
+  if (!args) {
+    llvm::interleaveComma(op->getOperands(), output, [&](Value operand) {
+      output << emitter.getOrCreateName(operand);
+    });
+  } else {
+    auto result = mlir::emitc::interleaveCommaWithError(
+        args, output, [&](Attribute attr) -> LogicalResult {
+          if (auto indexAttr = attr.dyn_cast<IntegerAttr>()) {
+            if (indexAttr.getType().isIndex()) {
+              int64_t index = indexAttr.getInt();
+              if (index < 0 || index >= op->getNumOperands()) {
+                return callOp.emitError() << "operand index out of range";
+              }
+              output << emitter.getOrCreateName(op->getOperand(index));
+              return success();
+            }
+          }
+          return emitter.emitAttribute(attr);
+        });
+    if (failed(result)) return failure();
+  }
+
+  output << ");\n";
+  return success();
+}
+
+// Assigns |operands| to the arguments of |dest| and branches to it.
+static LogicalResult emitBranchToC(mlir::emitc::CppEmitter &emitter,
+                                   FunctionContext &context, Block *dest,
+                                   OperandRange operands,
+                                   llvm::raw_ostream &output) {
+  auto emitAssign = [&](StringRef src, Value dst) {
+    StringRef dstName = emitter.getOrCreateName(dst);
+    if (isRefType(dst.getType())) {
+      output << "iree_vm_ref_retain(" << src << ", &" << dstName << ");\n";
+    } else {
+      output << dstName << " = " << src << ";\n";
+    }
+  };
+
+  if (operands.size() == 1) {
+    Value src = operands[0];
+    Value dst = dest->getArgument(0);
+    if (src != dst) {
+      emitAssign(isRefType(src.getType())
+                     ? getRefPointer(emitter, src)
+                     : emitter.getOrCreateName(src).str(),
+                 dst);
+    }
+  } else if (!operands.empty()) {
+    // Block arguments may be passed to themselves in a different order so all
+    // values are copied to temporaries before any are assigned.
+    output << "{\n";
+    for (auto operand : llvm::enumerate(operands)) {
+      std::string tempName = "t" + std::to_string(operand.index());
+      Value src = operand.value();
+      if (isRefType(src.getType())) {
+        output << "iree_vm_ref_t " << tempName << " = {0};\n"
+               << "iree_vm_ref_retain(" << getRefPointer(emitter, src) << ", &"
+               << tempName << ");\n";
+      } else {
+        output << "int32_t " << tempName << " = "
+               << emitter.getOrCreateName(src) << ";\n";
+      }
+    }
+    for (auto operand : llvm::enumerate(operands)) {
+      std::string tempName = "t" + std::to_string(operand.index());
+      Value dst = dest->getArgument(operand.index());
+      if (isRefType(dst.getType())) {
+        output << "iree_vm_ref_move(&" << tempName << ", &"
+               << emitter.getOrCreateName(dst) << ");\n";
+      } else {
+        output << emitter.getOrCreateName(dst) << " = " << tempName << ";\n";
+      }
+    }
+    output << "}\n";
+  }
+
+  output << "goto " << context.blockLabels[dest] << ";\n";
+  return success();
+}
+
+// Returns the imports of |moduleOp| sorted by name. Native modules require
+// imports in this order and resolve them by their index in it.
+static SmallVector<IREE::VM::ImportOp, 8> getSortedImports(
+    IREE::VM::ModuleOp moduleOp) {
+  SmallVector<IREE::VM::ImportOp, 8> importOps(
+      moduleOp.getOps<IREE::VM::ImportOp>());
+  llvm::sort(importOps, [](IREE::VM::ImportOp lhs, IREE::VM::ImportOp rhs) {
+    return lhs.getName() < rhs.getName();
+  });
+  return importOps;
+}
+
+static size_t getImportIndex(IREE::VM::ModuleOp moduleOp,
+                             StringRef importName) {
+  return llvm::count_if(
+      moduleOp.getOps<IREE::VM::ImportOp>(),
+      [&](IREE::VM::ImportOp importOp) {
+        return importOp.getName() < importName;
+      });
+}
+
 static LogicalResult translateCallOpToC(mlir::emitc::CppEmitter &emitter,
+                                        FunctionContext &context,
                                         IREE::VM::CallOp callOp,
                                         llvm::raw_ostream &output) {
+  Operation *calleeOp =
+      SymbolTable::lookupNearestSymbolFrom(callOp, callOp.getCallee());
+
+  if (auto funcOp = dyn_cast_or_null<IREE::VM::FuncOp>(calleeOp)) {
+    // Internal calls go directly to the implementation function.
+    std::vector<std::string> args = {"stack", "state"};
+    for (Value operand : callOp.getOperands()) {
+      args.push_back(isRefType(operand.getType())
+                         ? getRefPointer(emitter, operand)
+                         : emitter.getOrCreateName(operand).str());
+    }
+    for (Value result : callOp.getResults()) {
+      args.push_back("&" + emitter.getOrCreateName(result).str());
+    }
+    emitCheckedCall(
+        context,
+        buildCheckedExpr(buildFunctionName(context.moduleOp, funcOp,
+                                           /*implSuffix=*/true),
+                         args),
+        output);
+    return success();
+  }
+
+  auto importOp = dyn_cast_or_null<IREE::VM::ImportOp>(calleeOp);
+  if (!importOp) {
+    return callOp.emitError() << "unable to resolve callee";
+  }
+
+  // Imports are called through the VM calling convention with arguments and
+  // results marshaled into buffers.
+  auto operandTypes = callOp.getOperandTypes();
+  auto resultTypes = callOp.getResultTypes();
+  bool hasRefs = llvm::any_of(operandTypes, isRefType) ||
+                 llvm::any_of(resultTypes, isRefType);
+  std::string argsSize = buildABISizeExpr(operandTypes);
+  std::string resultsSize = buildABISizeExpr(resultTypes);
+  auto argOffsets = buildABIOffsetExprs(operandTypes);
+  auto resultOffsets = buildABIOffsetExprs(resultTypes);
+
+  output << "{\n";
+  if (callOp.getNumOperands() > 0) {
+    output << "uint8_t import_args[" << argsSize << "];\n";
+    if (hasRefs) output << "memset(import_args, 0, sizeof(import_args));\n";
+  }
+  if (callOp.getNumResults() > 0) {
+    output << "uint8_t import_results[" << resultsSize << "];\n";
+    if (hasRefs) {
+      output << "memset(import_results, 0, sizeof(import_results));\n";
+    }
+  }
+  for (auto operand : llvm::enumerate(callOp.getOperands())) {
+    Value value = operand.value();
+    std::string ptr = "import_args + " + argOffsets[operand.index()];
+    if (isRefType(value.getType())) {
+      // The callee takes ownership of ref arguments.
+      output << "iree_vm_ref_retain(" << getRefPointer(emitter, value)
+             << ", (iree_vm_ref_t*)(" << ptr << "));\n";
+    } else {
+      output << "vm_abi_store_i32(" << ptr << ", "
+             << emitter.getOrCreateName(value) << ");\n";
+    }
+  }
+  emitCheckedCall(
+      context,
+      buildCheckedExpr(
+          "vm_call_import",
+          {"stack", "&state->imports[" +
+                        std::to_string(getImportIndex(
+                            context.moduleOp, importOp.getName())) +
+                        "]",
+           callOp.getNumOperands() > 0 ? "import_args" : "NULL",
+           callOp.getNumOperands() > 0 ? "sizeof(import_args)" : "0",
+           callOp.getNumResults() > 0 ? "import_results" : "NULL",
+           callOp.getNumResults() > 0 ? "sizeof(import_results)" : "0"}),
+      output);
+  for (auto result : llvm::enumerate(callOp.getResults())) {
+    Value value = result.value();
+    std::string ptr = "import_results + " + resultOffsets[result.index()];
+    if (isRefType(value.getType())) {
+      output << "iree_vm_ref_move((iree_vm_ref_t*)(" << ptr << "), &"
+             << emitter.getOrCreateName(value) << ");\n";
+    } else {
+      output << emitter.getOrCreateName(value) << " = vm_abi_load_i32(" << ptr
+             << ");\n";
+    }
+  }
+  output << "}\n";
   return success();
 }
 
-static LogicalResult translateReturnOpToC(
-    mlir::emitc::CppEmitter &emitter, IREE::VM::ReturnOp returnOp,
-    llvm::raw_ostream &output, std::vector<std::string> resultNames) {
+static LogicalResult translateReturnOpToC(mlir::emitc::CppEmitter &emitter,
+                                          FunctionContext &context,
+                                          IREE::VM::ReturnOp returnOp,
+                                          llvm::raw_ostream &output) {
   for (std::tuple<Value, std::string> tuple :
-       llvm::zip(returnOp.getOperands(), resultNames)) {
+       llvm::zip(returnOp.getOperands(), context.resultNames)) {
     Value operand = std::get<0>(tuple);
     std::string resultName = std::get<1>(tuple);
-    output << "*" << resultName << " = " << emitter.getOrCreateName(operand)
-           << ";\n";
+    if (isRefType(operand.getType())) {
+      output << "iree_vm_ref_retain(" << getRefPointer(emitter, operand)
+             << ", " << resultName << ");\n";
+    } else {
+      output << "*" << resultName << " = " << emitter.getOrCreateName(operand)
+             << ";\n";
+    }
   }
 
-  output << "return iree_ok_status();\n";
+  emitReturnStatus(context, "iree_ok_status()", output);
 
   return success();
 }
 
+// Returns the ordinal assigned to the global or rodata |symbolName| referenced
+// by |op|.
+static Optional<int64_t> lookupSymbolOrdinal(Operation *op,
+                                             StringRef symbolName) {
+  auto *symbolOp = SymbolTable::lookupNearestSymbolFrom(op, symbolName);
+  if (!symbolOp) return llvm::None;
+  auto ordinalAttr = symbolOp->getAttrOfType<IntegerAttr>("ordinal");
+  if (!ordinalAttr) return llvm::None;
+  return ordinalAttr.getInt();
+}
+
+// Returns a C expression constructing the list element type of |listType|.
+// Lists of refs are created as variant lists as list types may be widened.
+static std::string buildListElementTypeExpr(IREE::VM::ListType listType) {
+  Type elementType = listType.getElementType();
+  if (elementType.isInteger(8)) {
+    return "iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I8)";
+  } else if (elementType.isInteger(16)) {
+    return "iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I16)";
+  } else if (elementType.isInteger(32)) {
+    return "iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I32)";
+  } else if (elementType.isInteger(64)) {
+    return "iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I64)";
+  } else if (elementType.isF32()) {
+    return "iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_F32)";
+  }
+  return "iree_vm_type_def_make_variant_type()";
+}
+
+// Emits a C switch assigning the value at |index| in |values| to |result| or
+// |defaultValue| if |index| is out of range.
+static void emitSwitchToC(mlir::emitc::CppEmitter &emitter, Value index,
+                          Value defaultValue, OperandRange values,
+                          Value result, llvm::raw_ostream &output) {
+  auto emitAssign = [&](Value value) {
+    if (isRefType(result.getType())) {
+      output << "iree_vm_ref_retain(" << getRefPointer(emitter, value) << ", "
+             << getRefPointer(emitter, result) << ");\n";
+    } else {
+      output << emitter.getOrCreateName(result) << " = "
+             << emitter.getOrCreateName(value) << ";\n";
+    }
+  };
+  output << "switch (" << emitter.getOrCreateName(index) << ") {\n";
+  for (auto value : llvm::enumerate(values)) {
+    output << "case " << value.index() << ":\n";
+    emitAssign(value.value());
+    output << "break;\n";
+  }
+  output << "default:\n";
+  emitAssign(defaultValue);
+  output << "break;\n"
+         << "}\n";
+}
+
 static LogicalResult translateOpToC(mlir::emitc::CppEmitter &emitter,
-                                    Operation &op, llvm::raw_ostream &output,
-                                    std::vector<std::string> resultNames) {
-  if (auto callOp = dyn_cast<IREE::VM::CallOp>(op))
-    return translateCallOpToC(emitter, callOp, output);
-  if (auto returnOp = dyn_cast<IREE::VM::ReturnOp>(op))
-    return translateReturnOpToC(emitter, returnOp, output, resultNames);
-  if (succeeded(emitter.emitOperation(op))) {
+                                    FunctionContext &context, Operation &op,
+                                    llvm::raw_ostream &output) {
+  auto name = [&](Value value) { return emitter.getOrCreateName(value); };
+  auto refPtr = [&](Value value) { return getRefPointer(emitter, value); };
+
+  if (auto callOp = dyn_cast<mlir::emitc::CallOp>(op)) {
+    return translateEmitCCallOpToC(emitter, callOp, output);
+  }
+
+  // Globals
+  if (auto loadOp = dyn_cast<IREE::VM::GlobalLoadI32Op>(op)) {
+    auto ordinal = lookupSymbolOrdinal(&op, loadOp.global());
+    if (!ordinal) return op.emitError() << "global has no ordinal assigned";
+    output << name(loadOp.value()) << " = vm_global_load_i32(state->rwdata, "
+           << ordinal.getValue() << ");\n";
+    return success();
+  }
+  if (auto storeOp = dyn_cast<IREE::VM::GlobalStoreI32Op>(op)) {
+    auto ordinal = lookupSymbolOrdinal(&op, storeOp.global());
+    if (!ordinal) return op.emitError() << "global has no ordinal assigned";
+    output << "vm_global_store_i32(state->rwdata, " << ordinal.getValue()
+           << ", " << name(storeOp.value()) << ");\n";
+    return success();
+  }
+  if (auto loadOp = dyn_cast<IREE::VM::GlobalLoadIndirectI32Op>(op)) {
+    output << name(loadOp.value())
+           << " = vm_global_load_i32(state->rwdata, (uint32_t)"
+           << name(loadOp.global()) << ");\n";
+    return success();
+  }
+  if (auto storeOp = dyn_cast<IREE::VM::GlobalStoreIndirectI32Op>(op)) {
+    output << "vm_global_store_i32(state->rwdata, (uint32_t)"
+           << name(storeOp.global()) << ", " << name(storeOp.value())
+           << ");\n";
+    return success();
+  }
+  if (auto loadOp = dyn_cast<IREE::VM::GlobalLoadRefOp>(op)) {
+    auto ordinal = lookupSymbolOrdinal(&op, loadOp.global());
+    if (!ordinal) return op.emitError() << "global has no ordinal assigned";
+    output << "iree_vm_ref_retain(&state->refs[" << ordinal.getValue()
+           << "], " << refPtr(loadOp.value()) << ");\n";
+    return success();
+  }
+  if (auto storeOp = dyn_cast<IREE::VM::GlobalStoreRefOp>(op)) {
+    auto ordinal = lookupSymbolOrdinal(&op, storeOp.global());
+    if (!ordinal) return op.emitError() << "global has no ordinal assigned";
+    output << "iree_vm_ref_retain(" << refPtr(storeOp.value())
+           << ", &state->refs[" << ordinal.getValue() << "]);\n";
+    return success();
+  }
+
+  // Constants
+  if (auto constOp = dyn_cast<IREE::VM::ConstRefZeroOp>(op)) {
+    output << "iree_vm_ref_release(" << refPtr(constOp.result()) << ");\n";
+    return success();
+  }
+  if (auto constOp = dyn_cast<IREE::VM::ConstRefRodataOp>(op)) {
+    auto ordinal = lookupSymbolOrdinal(&op, constOp.rodata());
+    if (!ordinal) return op.emitError() << "rodata has no ordinal assigned";
+    emitCheckedCall(context,
+                    buildCheckedExpr("vm_const_ref_rodata",
+                                     {"&state->rodata[" +
+                                          std::to_string(ordinal.getValue()) +
+                                          "]",
+                                      refPtr(constOp.value())}),
+                    output);
+    return success();
+  }
+
+  // Lists
+  if (auto allocOp = dyn_cast<IREE::VM::ListAllocOp>(op)) {
+    auto listType = allocOp.result()
+                        .getType()
+                        .cast<IREE::VM::RefType>()
+                        .getObjectType()
+                        .cast<IREE::VM::ListType>();
+    emitCheckedCall(
+        context,
+        buildCheckedExpr("vm_list_alloc",
+                         {buildListElementTypeExpr(listType),
+                          name(allocOp.initial_capacity()).str(),
+                          "state->allocator", refPtr(allocOp.result())}),
+        output);
+    return success();
+  }
+  if (auto reserveOp = dyn_cast<IREE::VM::ListReserveOp>(op)) {
+    emitCheckedCall(
+        context,
+        buildCheckedExpr("vm_list_reserve",
+                         {refPtr(reserveOp.list()),
+                          name(reserveOp.minimum_capacity()).str()}),
+        output);
     return success();
   }
+  if (auto sizeOp = dyn_cast<IREE::VM::ListSizeOp>(op)) {
+    emitCheckedCall(context,
+                    buildCheckedExpr("vm_list_size",
+                                     {refPtr(sizeOp.list()),
+                                      "&" + name(sizeOp.result()).str()}),
+                    output);
+    return success();
+  }
+  if (auto resizeOp = dyn_cast<IREE::VM::ListResizeOp>(op)) {
+    emitCheckedCall(context,
+                    buildCheckedExpr("vm_list_resize",
+                                     {refPtr(resizeOp.list()),
+                                      name(resizeOp.new_size()).str()}),
+                    output);
+    return success();
+  }
+  if (auto getOp = dyn_cast<IREE::VM::ListGetI32Op>(op)) {
+    emitCheckedCall(
+        context,
+        buildCheckedExpr("vm_list_get_i32",
+                         {refPtr(getOp.list()), name(getOp.index()).str(),
+                          "&" + name(getOp.result()).str()}),
+        output);
+    return success();
+  }
+  if (auto setOp = dyn_cast<IREE::VM::ListSetI32Op>(op)) {
+    emitCheckedCall(
+        context,
+        buildCheckedExpr("vm_list_set_i32",
+                         {refPtr(setOp.list()), name(setOp.index()).str(),
+                          name(setOp.value()).str()}),
+        output);
+    return success();
+  }
+  if (auto getOp = dyn_cast<IREE::VM::ListGetRefOp>(op)) {
+    emitCheckedCall(
+        context,
+        buildCheckedExpr("vm_list_get_ref",
+                         {refPtr(getOp.list()), name(getOp.index()).str(),
+                          refPtr(getOp.result())}),
+        output);
+    return success();
+  }
+  if (auto setOp = dyn_cast<IREE::VM::ListSetRefOp>(op)) {
+    emitCheckedCall(
+        context,
+        buildCheckedExpr("vm_list_set_ref",
+                         {refPtr(setOp.list()), name(setOp.index()).str(),
+                          refPtr(setOp.value())}),
+        output);
+    return success();
+  }
+
+  // Conditional assignment
+  if (auto selectOp = dyn_cast<IREE::VM::SelectRefOp>(op)) {
+    output << "iree_vm_ref_retain(" << name(selectOp.condition()) << " ? "
+           << refPtr(selectOp.true_value()) << " : "
+           << refPtr(selectOp.false_value()) << ", "
+           << refPtr(selectOp.result()) << ");\n";
+    return success();
+  }
+  if (auto switchOp = dyn_cast<IREE::VM::SwitchI32Op>(op)) {
+    emitSwitchToC(emitter, switchOp.index(), switchOp.default_value(),
+                  switchOp.values(), switchOp.result(), output);
+    return success();
+  }
+  if (auto switchOp = dyn_cast<IREE::VM::SwitchRefOp>(op)) {
+    emitSwitchToC(emitter, switchOp.index(), switchOp.default_value(),
+                  switchOp.values(), switchOp.result(), output);
+    return success();
+  }
+
+  // Comparison ops
+  if (auto cmpOp = dyn_cast<IREE::VM::CmpEQRefOp>(op)) {
+    output << name(cmpOp.result()) << " = vm_cmp_eq_ref("
+           << refPtr(cmpOp.lhs()) << ", " << refPtr(cmpOp.rhs()) << ");\n";
+    return success();
+  }
+  if (auto cmpOp = dyn_cast<IREE::VM::CmpNERefOp>(op)) {
+    output << name(cmpOp.result()) << " = vm_cmp_ne_ref("
+           << refPtr(cmpOp.lhs()) << ", " << refPtr(cmpOp.rhs()) << ");\n";
+    return success();
+  }
+  if (auto cmpOp = dyn_cast<IREE::VM::CmpNZRefOp>(op)) {
+    output << name(cmpOp.result()) << " = vm_cmp_nz_ref("
+           << refPtr(cmpOp.operand()) << ");\n";
+    return success();
+  }
+
+  // Control flow ops
+  if (auto branchOp = dyn_cast<IREE::VM::BranchOp>(op)) {
+    return emitBranchToC(emitter, context, branchOp.getDest(),
+                         branchOp.getOperands(), output);
+  }
+  if (auto condBranchOp = dyn_cast<IREE::VM::CondBranchOp>(op)) {
+    output << "if (" << name(condBranchOp.getCondition()) << ") {\n";
+    if (failed(emitBranchToC(emitter, context, condBranchOp.getTrueDest(),
+                             condBranchOp.getTrueOperands(), output))) {
+      return failure();
+    }
+    output << "} else {\n";
+    if (failed(emitBranchToC(emitter, context, condBranchOp.getFalseDest(),
+                             condBranchOp.getFalseOperands(), output))) {
+      return failure();
+    }
+    output << "}\n";
+    return success();
+  }
+  if (auto callOp = dyn_cast<IREE::VM::CallOp>(op)) {
+    return translateCallOpToC(emitter, context, callOp, output);
+  }
+  if (auto returnOp = dyn_cast<IREE::VM::ReturnOp>(op)) {
+    return translateReturnOpToC(emitter, context, returnOp, output);
+  }
+  if (auto failOp = dyn_cast<IREE::VM::FailOp>(op)) {
+    std::string message;
+    llvm::raw_string_ostream messageStream(message);
+    if (failOp.message().hasValue()) {
+      StringRef messageValue = failOp.message().getValue();
+      messageStream << "iree_make_string_view(";
+      printCStringLiteral(messageValue, messageStream);
+      messageStream << ", " << messageValue.size() << ")";
+    } else {
+      messageStream << "iree_string_view_empty()";
+    }
+    emitReturnStatus(context,
+                     buildCheckedExpr("vm_fail", {name(failOp.status()).str(),
+                                                  messageStream.str()}),
+                     output);
+    return success();
+  }
+
+  // Execution is synchronous so yields are dropped and debug ops have no
+  // effect in generated modules.
+  if (isa<IREE::VM::YieldOp>(op) ||
+      op.hasTrait<OpTrait::IREE::VM::DebugOnly>()) {
+    return success();
+  }
+
+  return op.emitError() << "op is not yet supported by the C target";
+}
+
+// Emits the declaration of the implementation function for |funcOp|.
+// Refs are passed by pointer and borrowed from the caller. Results are
+// returned through pointers and refs are retained into them.
+static LogicalResult emitFunctionDeclaration(mlir::emitc::CppEmitter &emitter,
+                                             IREE::VM::ModuleOp &moduleOp,
+                                             IREE::VM::FuncOp &funcOp,
+                                             llvm::raw_ostream &output) {
+  output << "static iree_status_t "
+         << buildFunctionName(moduleOp, funcOp, /*implSuffix=*/true)
+         << "(iree_vm_stack_t* stack, " << buildModuleName(moduleOp)
+         << "_state_t* state";
+
+  for (auto arg : funcOp.getArguments()) {
+    output << ", ";
+    if (failed(emitTypeToC(emitter, arg.getType(), output))) {
+      return failure();
+    }
+    output << (isRefType(arg.getType()) ? "* " : " ")
+           << emitter.getOrCreateName(arg);
+  }
 
-  return failure();
+  for (auto result : llvm::enumerate(funcOp.getType().getResults())) {
+    output << ", ";
+    if (failed(emitTypeToC(emitter, result.value(), output))) {
+      return failure();
+    }
+    output << " *out" << result.index();
+  }
+
+  output << ")";
+  return success();
 }
 
 static LogicalResult translateFunctionToC(mlir::emitc::CppEmitter &emitter,
@@ -94,147 +808,592 @@ static LogicalResult translateFunctionToC(mlir::emitc::CppEmitter &emitter,
                                           llvm::raw_ostream &output) {
   emitc::CppEmitter::Scope scope(emitter);
 
+  FunctionContext context;
+  context.moduleOp = moduleOp;
+  context.funcOp = funcOp;
+  for (size_t idx = 0; idx < funcOp.getNumResults(); idx++) {
+    context.resultNames.push_back("out" + std::to_string(idx));
+  }
+
   // this function later gets wrapped with argument marshalling code
-  std::string functionName =
-      buildFunctionName(moduleOp, funcOp, /*implSuffix=*/true);
+  if (failed(emitFunctionDeclaration(emitter, moduleOp, funcOp, output))) {
+    return failure();
+  }
+  output << " {\n";
 
-  output << "iree_status_t " << functionName << "(";
+  // Declare all values up front so that branches never jump past a
+  // declaration (which is invalid when compiled as C++).
+  SmallVector<Value, 16> locals;
+  for (auto &block : funcOp.getBlocks()) {
+    context.blockLabels[&block] =
+        "bb" + std::to_string(context.blockLabels.size());
+    if (!block.isEntryBlock()) {
+      locals.append(block.args_begin(), block.args_end());
+    }
+    for (auto &op : block) {
+      locals.append(op.result_begin(), op.result_end());
+    }
+  }
+  for (Value value : locals) {
+    if (!isSupportedType(value.getType())) {
+      return value.getDefiningOp()
+                 ? value.getDefiningOp()->emitError()
+                       << "type " << value.getType()
+                       << " is not yet supported by the C target"
+                 : funcOp.emitError() << "type " << value.getType()
+                                      << " is not yet supported by the C "
+                                         "target";
+    }
+    if (isRefType(value.getType())) {
+      context.refLocals.push_back(value);
+    }
+  }
+  if (!context.refLocals.empty()) {
+    output << "iree_status_t status = iree_ok_status();\n";
+  }
+  for (Value value : locals) {
+    if (isRefType(value.getType())) {
+      output << "iree_vm_ref_t " << emitter.getOrCreateName(value)
+             << " = {0};\n";
+    } else {
+      output << "int32_t " << emitter.getOrCreateName(value) << " = 0;\n";
+    }
+  }
 
-  mlir::emitc::interleaveCommaWithError(
-      funcOp.getArguments(), output, [&](auto arg) -> LogicalResult {
-        if (failed(emitter.emitType(arg.getType()))) {
-          return failure();
-        }
-        output << " " << emitter.getOrCreateName(arg);
-        return success();
-      });
+  for (auto &block : funcOp.getBlocks()) {
+    if (!block.isEntryBlock()) {
+      output << context.blockLabels[&block] << ":\n";
+    }
+    for (auto &op : block) {
+      if (failed(translateOpToC(emitter, context, op, output))) {
+        return failure();
+      }
+    }
+  }
 
-  if (funcOp.getNumResults() > 0) {
-    output << ", ";
+  if (!context.refLocals.empty()) {
+    output << "cleanup:\n";
+    for (Value value : context.refLocals) {
+      output << "iree_vm_ref_release(&" << emitter.getOrCreateName(value)
+             << ");\n";
+    }
+    output << "return status;\n";
   }
 
-  std::vector<std::string> resultNames;
-  for (size_t idx = 0; idx < funcOp.getNumResults(); idx++) {
-    std::string resultName("out");
-    resultName.append(std::to_string(idx));
-    resultNames.push_back(resultName);
-  }
-
-  mlir::emitc::interleaveCommaWithError(
-      llvm::zip(funcOp.getType().getResults(), resultNames), output,
-      [&](std::tuple<Type, std::string> tuple) -> LogicalResult {
-        Type type = std::get<0>(tuple);
-        std::string resultName = std::get<1>(tuple);
-
-        if (failed(emitter.emitType(type))) {
-          return failure();
-        }
-        output << " *" << resultName;
-        return success();
-      });
+  output << "}\n";
 
-  output << ") {\n";
+  return success();
+}
 
-  for (auto &op : funcOp.getOps()) {
-    if (failed(translateOpToC(emitter, op, output, resultNames))) {
-      return failure();
+//===----------------------------------------------------------------------===//
+// Module interface
+//===----------------------------------------------------------------------===//
+
+// Returns the rodata ops of |moduleOp| sorted by their assigned ordinal.
+static SmallVector<IREE::VM::RodataOp, 4> getSortedRodataOps(
+    IREE::VM::ModuleOp moduleOp) {
+  SmallVector<IREE::VM::RodataOp, 4> rodataOps(
+      moduleOp.getOps<IREE::VM::RodataOp>());
+  llvm::sort(rodataOps, [](IREE::VM::RodataOp lhs, IREE::VM::RodataOp rhs) {
+    return lhs.getAttrOfType<IntegerAttr>("ordinal").getInt() <
+           rhs.getAttrOfType<IntegerAttr>("ordinal").getInt();
+  });
+  return rodataOps;
+}
+
+static std::string buildRodataName(IREE::VM::ModuleOp &moduleOp,
+                                   IREE::VM::RodataOp rodataOp) {
+  return buildModuleName(moduleOp) + "_rodata_" +
+         std::to_string(rodataOp.getAttrOfType<IntegerAttr>("ordinal")
+                            .getInt()) +
+         "_";
+}
+
+// Serializes the value of |rodataOp| into |bytes| with the same layout the
+// bytecode target uses (see Bytecode/ConstantEncoder.cpp): densely packed
+// little-endian elements.
+static LogicalResult serializeRodata(IREE::VM::RodataOp rodataOp,
+                                     std::vector<uint8_t> &bytes) {
+  auto appendBits = [&](const APInt &bits) {
+    for (unsigned i = 0; i < bits.getBitWidth(); i += 8) {
+      bytes.push_back(bits.extractBitsAsZExtValue(8, i));
     }
+  };
+  ElementsAttr value = rodataOp.value();
+  unsigned bitWidth = value.getType().getElementTypeBitWidth();
+  if (bitWidth % 8 != 0) {
+    return rodataOp.emitError() << "unhandled element bitwidth " << bitWidth;
   }
+  if (auto attr = value.dyn_cast<DenseIntElementsAttr>()) {
+    for (const APInt &element : attr.getIntValues()) appendBits(element);
+    return success();
+  } else if (auto attr = value.dyn_cast<DenseFPElementsAttr>()) {
+    for (const APFloat &element : attr.getFloatValues()) {
+      appendBits(element.bitcastToAPInt());
+    }
+    return success();
+  }
+  return rodataOp.emitError()
+         << "unimplemented attribute encoding: " << value.getType();
+}
 
-  output << "}\n";
+// Emits the contents of all rodata ops as static arrays. These are wrapped in
+// byte buffers owned by the module state when the state is allocated.
+static LogicalResult buildRodataArrays(IREE::VM::ModuleOp &moduleOp,
+                                       llvm::raw_ostream &output) {
+  for (auto rodataOp : getSortedRodataOps(moduleOp)) {
+    std::vector<uint8_t> bytes;
+    if (failed(serializeRodata(rodataOp, bytes))) return failure();
+    // C does not allow empty arrays so a zero-length segment keeps one byte
+    // and is wrapped with a length of zero.
+    output << "static iree_alignas(16) const uint8_t "
+           << buildRodataName(moduleOp, rodataOp) << "["
+           << std::max<size_t>(bytes.size(), 1) << "] = {";
+    if (bytes.empty()) output << "0";
+    for (auto byte : llvm::enumerate(bytes)) {
+      if (byte.index() > 0) output << ",";
+      output << (byte.index() % 16 == 0 ? "\n" : " ")
+             << llvm::format_hex(byte.value(), 4);
+    }
+    output << "};\n";
+  }
+  output << "\n";
+  return success();
+}
+
+// Emits the module and module state structs. The state holds all globals,
+// rodata buffers and resolved imports laid out using the ordinals assigned by
+// OrdinalAllocationPass.
+static LogicalResult buildModuleStructs(IREE::VM::ModuleOp &moduleOp,
+                                        llvm::raw_ostream &output) {
+  std::string moduleName = buildModuleName(moduleOp);
+
+  int64_t rwdataSize = 0;
+  int64_t globalRefCount = 0;
+  int64_t rodataCount = 0;
+  int64_t importCount = 0;
+  for (auto &op : moduleOp.getBlock().getOperations()) {
+    if (auto globalOp = dyn_cast<IREE::VM::GlobalI32Op>(op)) {
+      auto ordinalAttr = globalOp.getAttrOfType<IntegerAttr>("ordinal");
+      if (!ordinalAttr) {
+        return globalOp.emitError() << "global has no ordinal assigned";
+      }
+      rwdataSize = std::max(rwdataSize, ordinalAttr.getInt() + 4);
+    } else if (isa<IREE::VM::GlobalRefOp>(op)) {
+      ++globalRefCount;
+    } else if (isa<IREE::VM::RodataOp>(op)) {
+      if (!op.getAttrOfType<IntegerAttr>("ordinal")) {
+        return op.emitError() << "rodata has no ordinal assigned";
+      }
+      ++rodataCount;
+    } else if (isa<IREE::VM::ImportOp>(op)) {
+      ++importCount;
+    } else if (isa<IREE::VM::GlobalI64Op, IREE::VM::GlobalF32Op>(op)) {
+      return op.emitError() << "op is not yet supported by the C target";
+    }
+  }
+
+  output << "struct " << moduleName << "_s;\n"
+         << "struct " << moduleName << "_state_s;\n"
+         << "typedef struct " << moduleName << "_s " << moduleName << "_t;\n"
+         << "typedef struct " << moduleName << "_state_s " << moduleName
+         << "_state_t;\n"
+         << "\n";
 
+  if (rodataCount > 0 && failed(buildRodataArrays(moduleOp, output))) {
+    return failure();
+  }
+
+  output << "struct " << moduleName << "_state_s {\n"
+         << "iree_allocator_t allocator;\n";
+  if (rwdataSize > 0) {
+    output << "uint8_t rwdata[" << rwdataSize << "];\n";
+  }
+  if (globalRefCount > 0) {
+    output << "iree_vm_ref_t refs[" << globalRefCount << "];\n";
+  }
+  if (rodataCount > 0) {
+    output << "iree_vm_ro_byte_buffer_t rodata[" << rodataCount << "];\n";
+  }
+  if (importCount > 0) {
+    output << "iree_vm_function_t imports[" << importCount << "];\n";
+  }
+  output << "};\n"
+         << "\n";
+  return success();
+}
+
+// Emits a shim marshaling arguments and results of the exported |funcOp|
+// between the VM calling convention and the implementation function.
+static LogicalResult buildExportShim(mlir::emitc::CppEmitter &emitter,
+                                     IREE::VM::ModuleOp &moduleOp,
+                                     IREE::VM::FuncOp &funcOp,
+                                     llvm::raw_ostream &output) {
+  std::string moduleName = buildModuleName(moduleOp);
+  FunctionType functionType = funcOp.getType();
+  auto argOffsets = buildABIOffsetExprs(functionType.getInputs());
+  auto resultOffsets = buildABIOffsetExprs(functionType.getResults());
+
+  output << "static iree_status_t "
+         << buildFunctionName(moduleOp, funcOp, /*implSuffix=*/false)
+         << "_shim(iree_vm_stack_t* stack, const iree_vm_function_call_t* "
+            "call, iree_vm_native_function_target_t target_fn, void* module, "
+            "void* module_state, iree_vm_execution_result_t* out_result) {\n";
+
+  std::vector<std::string> args = {
+      "stack", "(" + moduleName + "_state_t*)module_state"};
+  for (auto input : llvm::enumerate(functionType.getInputs())) {
+    std::string argName = "arg" + std::to_string(input.index());
+    std::string ptr =
+        "call->arguments.data + " + argOffsets[input.index()];
+    if (isRefType(input.value())) {
+      // Ref arguments are moved out of the argument buffer.
+      output << "iree_vm_ref_t " << argName << " = {0};\n"
+             << "iree_vm_ref_move((iree_vm_ref_t*)(" << ptr << "), &"
+             << argName << ");\n";
+      args.push_back("&" + argName);
+    } else {
+      output << "int32_t " << argName << " = vm_abi_load_i32(" << ptr
+             << ");\n";
+      args.push_back(argName);
+    }
+  }
+  for (auto result : llvm::enumerate(functionType.getResults())) {
+    std::string retName = "ret" + std::to_string(result.index());
+    if (isRefType(result.value())) {
+      output << "iree_vm_ref_t " << retName << " = {0};\n";
+    } else {
+      output << "int32_t " << retName << " = 0;\n";
+    }
+    args.push_back("&" + retName);
+  }
+
+  output << "iree_status_t status = "
+         << buildCheckedExpr(
+                buildFunctionName(moduleOp, funcOp, /*implSuffix=*/true),
+                args)
+         << ";\n";
+
+  for (auto input : llvm::enumerate(functionType.getInputs())) {
+    if (isRefType(input.value())) {
+      output << "iree_vm_ref_release(&arg" << input.index() << ");\n";
+    }
+  }
+  if (functionType.getNumResults() > 0) {
+    output << "if (iree_status_is_ok(status)) {\n";
+    for (auto result : llvm::enumerate(functionType.getResults())) {
+      std::string ptr =
+          "call->results.data + " + resultOffsets[result.index()];
+      if (isRefType(result.value())) {
+        output << "iree_vm_ref_move(&ret" << result.index()
+               << ", (iree_vm_ref_t*)(" << ptr << "));\n";
+      } else {
+        output << "vm_abi_store_i32(" << ptr << ", ret" << result.index()
+               << ");\n";
+      }
+    }
+    output << "}\n";
+    for (auto result : llvm::enumerate(functionType.getResults())) {
+      if (isRefType(result.value())) {
+        output << "iree_vm_ref_release(&ret" << result.index() << ");\n";
+      }
+    }
+  }
+  output << "return status;\n"
+         << "}\n"
+         << "\n";
   return success();
 }
 
-static LogicalResult buildModuleDescriptors(IREE::VM::ModuleOp &moduleOp,
+static LogicalResult buildModuleDescriptors(mlir::emitc::CppEmitter &emitter,
+                                            IREE::VM::ModuleOp &moduleOp,
                                             llvm::raw_ostream &output) {
-  std::string moduleName = moduleOp.getName().str();
+  std::string moduleName = buildModuleName(moduleOp);
+  SymbolTable symbolTable(moduleOp);
+
+  // Exports must be sorted by name for lookup.
+  SmallVector<IREE::VM::ExportOp, 8> exportOps(
+      moduleOp.getOps<IREE::VM::ExportOp>());
+  llvm::sort(exportOps, [](IREE::VM::ExportOp lhs, IREE::VM::ExportOp rhs) {
+    return lhs.export_name() < rhs.export_name();
+  });
+  SmallVector<IREE::VM::FuncOp, 8> exportFuncOps;
+  for (auto exportOp : exportOps) {
+    auto funcOp = symbolTable.lookup<IREE::VM::FuncOp>(exportOp.function_ref());
+    if (!funcOp) {
+      return exportOp.emitError() << "exported function not found";
+    }
+    exportFuncOps.push_back(funcOp);
+  }
+
+  // shims
+  llvm::SmallPtrSet<Operation *, 8> shimmedFuncOps;
+  for (auto funcOp : exportFuncOps) {
+    if (!shimmedFuncOps.insert(funcOp).second) continue;
+    if (failed(buildExportShim(emitter, moduleOp, funcOp, output))) {
+      return failure();
+    }
+  }
 
   // exports
   std::string exportName = moduleName + "_exports_";
-  // TODO(marbre/simon-camp): Fix generating the calling_convention.
-  /*
-  output << "static const iree_vm_native_export_descriptor_t " << exportName
-         << "[] = {\n";
-  for (auto exportOp : moduleOp.getOps<IREE::VM::ExportOp>()) {
-    // TODO(simon-camp) support function-level reflection attributes
-    output << "{iree_make_cstring_view(\"" << exportOp.export_name()
-           << "\"), 0, 0, 0, NULL},\n";
+  if (!exportOps.empty()) {
+    output << "static const iree_vm_native_export_descriptor_t " << exportName
+           << "[] = {\n";
+    for (auto it : llvm::zip(exportOps, exportFuncOps)) {
+      // TODO(simon-camp) support function-level reflection attributes
+      output << "{";
+      printStringViewInitializer(std::get<0>(it).export_name(), output);
+      output << ", ";
+      printStringViewInitializer(
+          makeCallingConventionString(std::get<1>(it).getType()), output);
+      output << ", 0, NULL},\n";
+    }
+    output << "};\n";
+    output << "\n";
   }
-  output << "};\n";
-  output << "\n";
-  */
 
   // imports
   std::string importName = moduleName + "_imports_";
-  output << "static const iree_vm_native_import_descriptor_t " << importName
-         << "[] = {\n";
-  for (auto importOp : moduleOp.getOps<IREE::VM::ImportOp>()) {
-    output << "{iree_make_cstring_view(\"" << importOp.getName() << "\")},\n";
+  auto importOps = getSortedImports(moduleOp);
+  bool hasImports = !importOps.empty();
+  if (hasImports) {
+    output << "static const iree_vm_native_import_descriptor_t " << importName
+           << "[] = {\n";
+    for (auto importOp : importOps) {
+      output << "{";
+      printStringViewInitializer(importOp.getName(), output);
+      output << "},\n";
+    }
+    output << "};\n";
+    output << "\n";
   }
-  output << "};\n";
-  output << "\n";
 
   // functions
+  // NOTE: native modules require a function table even when it is empty.
   std::string functionName = moduleName + "_funcs_";
+  output << "static const iree_vm_native_function_ptr_t " << functionName
+         << "[] = {\n";
+  for (auto funcOp : exportFuncOps) {
+    output << "{"
+           << buildFunctionName(moduleOp, funcOp, /*implSuffix=*/false)
+           << "_shim, NULL},\n";
+  }
+  if (exportFuncOps.empty()) {
+    output << "{NULL, NULL},\n";
+  }
+  output << "};\n";
+  output << "\n";
 
   // module descriptor
   // TODO(simon-camp): support module-level reflection attributes
-  // TODO(marbre/simon-camp): Renable after fix generating the export descriptor
-  /*
   std::string descriptorName = moduleName + "_descriptor_";
   output << "static const iree_vm_native_module_descriptor_t " << descriptorName
-         << " = {\n"
-         << "iree_make_cstring_view(\"" << moduleName << "\"),\n"
-         << "IREE_ARRAYSIZE(" << importName << "),\n"
-         << importName << ",\n"
-         << "IREE_ARRAYSIZE(" << exportName << "),\n"
-         << exportName << ",\n"
-         << "IREE_ARRAYSIZE(" << functionName << "),\n"
-         << functionName << ",\n"
+         << " = {\n";
+  printStringViewInitializer(moduleOp.getName(), output);
+  output << ",\n";
+  if (hasImports) {
+    output << "IREE_ARRAYSIZE(" << importName << "),\n" << importName << ",\n";
+  } else {
+    output << "0,\nNULL,\n";
+  }
+  if (!exportOps.empty()) {
+    output << "IREE_ARRAYSIZE(" << exportName << "),\n" << exportName << ",\n"
+           << "IREE_ARRAYSIZE(" << functionName << "),\n";
+  } else {
+    output << "0,\nNULL,\n0,\n";
+  }
+  output << functionName << ",\n"
          << "0,\n"
          << "NULL,\n"
-         << "};\n";
-  */
-
-  // TODO(simon-camp) generate boilerplate code
-  //   * module struct
-  //   * module state struct
-  //   * function wrappers
-  //   * function table
-  //   * interface functions
-  //      * create
-  //      * destroy
-  //      * alloc_state
-  //      * free_state
-  //      * resolve_import
+         << "};\n"
+         << "\n";
+
+  // interface functions
+  std::string stateType = moduleName + "_state_t";
+  int64_t globalRefCount = llvm::size(moduleOp.getOps<IREE::VM::GlobalRefOp>());
+  auto rodataOps = getSortedRodataOps(moduleOp);
+  output << "static iree_status_t " << moduleName
+         << "_alloc_state(void* self, iree_allocator_t allocator, "
+            "iree_vm_module_state_t** out_module_state) {\n"
+         << stateType << "* state = NULL;\n"
+         << "IREE_RETURN_IF_ERROR(iree_allocator_malloc(allocator, "
+            "sizeof(*state), (void**)&state));\n"
+         << "memset(state, 0, sizeof(*state));\n"
+         << "state->allocator = allocator;\n";
+  for (auto rodataOp : rodataOps) {
+    ElementsAttr value = rodataOp.value();
+    int64_t byteLength = value.getNumElements() *
+                         value.getType().getElementTypeBitWidth() / 8;
+    output << "vm_rodata_initialize(&state->rodata["
+           << rodataOp.getAttrOfType<IntegerAttr>("ordinal").getInt() << "], "
+           << buildRodataName(moduleOp, rodataOp) << ", " << byteLength
+           << ");\n";
+  }
+  output << "*out_module_state = (iree_vm_module_state_t*)state;\n"
+         << "return iree_ok_status();\n"
+         << "}\n"
+         << "\n";
+
+  output << "static void " << moduleName
+         << "_free_state(void* self, iree_vm_module_state_t* module_state) {\n"
+         << stateType << "* state = (" << stateType << "*)module_state;\n";
+  if (globalRefCount > 0) {
+    output << "for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(state->refs); "
+              "++i) {\n"
+           << "iree_vm_ref_release(&state->refs[i]);\n"
+           << "}\n";
+  }
+  output << "iree_allocator_free(state->allocator, state);\n"
+         << "}\n"
+         << "\n";
+
+  output << "static iree_status_t " << moduleName
+         << "_resolve_import(void* self, iree_vm_module_state_t* "
+            "module_state, iree_host_size_t ordinal, const "
+            "iree_vm_function_t* function, const "
+            "iree_vm_function_signature_t* signature) {\n";
+  if (hasImports) {
+    output << stateType << "* state = (" << stateType << "*)module_state;\n"
+           << "state->imports[ordinal] = *function;\n"
+           << "return iree_ok_status();\n";
+  } else {
+    output << "return iree_make_status(IREE_STATUS_OUT_OF_RANGE, "
+              "\"module has no imports\");\n";
+  }
+  output << "}\n"
+         << "\n";
+
+  output << "static iree_status_t " << moduleName
+         << "_create(iree_allocator_t allocator, iree_vm_module_t** "
+            "out_module) {\n";
+  if (!rodataOps.empty()) {
+    // Rodata is exposed as byte buffer refs which must be registered.
+    output << "IREE_RETURN_IF_ERROR(iree_vm_register_builtin_types());\n";
+  }
+  output << "iree_vm_module_t interface;\n"
+         << "IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, "
+            "NULL));\n"
+         << "interface.alloc_state = " << moduleName << "_alloc_state;\n"
+         << "interface.free_state = " << moduleName << "_free_state;\n"
+         << "interface.resolve_import = " << moduleName << "_resolve_import;\n"
+         << "return iree_vm_native_module_create(&interface, &"
+         << descriptorName << ", allocator, out_module);\n"
+         << "}\n";
 
   output << "\n";
   return success();
 }
 
-LogicalResult translateModuleToC(mlir::ModuleOp outerModuleOp,
-                                 llvm::raw_ostream &output) {
-  PassManager pm(outerModuleOp.getContext());
+// Lowers the module to the subset of the VM dialect supported by the C target
+// and assigns ordinals to all module-level symbols.
+static LogicalResult canonicalizeModule(IREE::VM::ModuleOp moduleOp) {
+  OwningRewritePatternList patterns;
+  ConversionTarget target(*moduleOp.getContext());
+  target.addLegalDialect<IREE::VM::VMDialect>();
+  target.addLegalOp<IREE::DoNotOptimizeOp>();
 
-  pm.addPass(createConvertVMToEmitCPass());
+  // Add all VM canonicalization patterns and mark pseudo-ops illegal.
+  auto *context = moduleOp.getContext();
+  for (auto *op : context->getRegisteredOperations()) {
+    // Non-serializable ops must be removed prior to serialization.
+    if (op->hasTrait<OpTrait::IREE::VM::PseudoOp>()) {
+      op->getCanonicalizationPatterns(patterns, context);
+      target.setOpAction(OperationName(op->name, context),
+                         ConversionTarget::LegalizationAction::Illegal);
+    }
+  }
 
-  if (failed(pm.run(outerModuleOp))) {
+  if (failed(applyFullConversion(moduleOp, target, patterns))) {
+    return moduleOp.emitError() << "unable to fully apply conversion to module";
+  }
+
+  PassManager passManager(context);
+  mlir::applyPassManagerCLOptions(passManager);
+  auto &modulePasses = passManager.nest<IREE::VM::ModuleOp>();
+  modulePasses.addPass(createDropCompilerHintsPass());
+  modulePasses.addPass(IREE::VM::createOrdinalAllocationPass());
+  modulePasses.addPass(createConvertVMToEmitCPass());
+
+  if (failed(passManager.run(moduleOp.getParentOfType<mlir::ModuleOp>()))) {
+    return moduleOp.emitError() << "failed during transform passes";
+  }
+
+  return success();
+}
+
+static LogicalResult translateModuleOpToC(IREE::VM::ModuleOp moduleOp,
+                                          llvm::raw_ostream &output) {
+  printModuleComment(moduleOp, output);
+
+  if (failed(buildModuleStructs(moduleOp, output))) {
     return failure();
   }
 
+  mlir::emitc::CppEmitter emitter(output);
+  mlir::emitc::CppEmitter::Scope scope(emitter);
+
+  // Declare all functions first so that calls may reference functions
+  // defined later in the module.
+  for (auto funcOp : moduleOp.getOps<IREE::VM::FuncOp>()) {
+    if (failed(verifySupportedFunctionType(funcOp, funcOp.getType()))) {
+      return failure();
+    }
+    mlir::emitc::CppEmitter::Scope funcScope(emitter);
+    if (failed(emitFunctionDeclaration(emitter, moduleOp, funcOp, output))) {
+      return failure();
+    }
+    output << ";\n";
+  }
+  output << "\n";
+  for (auto importOp : moduleOp.getOps<IREE::VM::ImportOp>()) {
+    if (importOp.isVariadic()) {
+      return importOp.emitError()
+             << "variadic imports are not yet supported by the C target";
+    }
+    if (failed(verifySupportedFunctionType(importOp, importOp.getType()))) {
+      return failure();
+    }
+  }
+
+  // translate functions
+  for (auto funcOp : moduleOp.getOps<IREE::VM::FuncOp>()) {
+    if (failed(translateFunctionToC(emitter, moduleOp, funcOp, output))) {
+      return failure();
+    }
+
+    output << "\n";
+  }
+
+  printSeparatingComment(output);
+
+  // generate module descriptors
+  return buildModuleDescriptors(emitter, moduleOp, output);
+}
+
+LogicalResult translateModuleToC(mlir::ModuleOp outerModuleOp,
+                                 llvm::raw_ostream &output) {
   auto moduleOps = outerModuleOp.getOps<ModuleOp>();
   if (moduleOps.empty()) {
     return outerModuleOp.emitError()
            << "outer module does not contain a vm.module op";
   }
 
+  for (auto moduleOp : moduleOps) {
+    if (failed(canonicalizeModule(moduleOp))) {
+      return moduleOp.emitError()
+             << "failed to canonicalize vm.module to a C-compatible form";
+    }
+  }
+
   auto printInlcude = [&output](std::string include) {
     output << "#include \"" << include << "\"\n";
   };
 
+  printInlcude("iree/vm/builtin_types.h");
   printInlcude("iree/vm/context.h");
   printInlcude("iree/vm/instance.h");
+  printInlcude("iree/vm/list.h");
   printInlcude("iree/vm/native_module.h");
   printInlcude("iree/vm/ref.h");
   printInlcude("iree/vm/stack.h");
@@ -244,28 +1403,7 @@ LogicalResult translateModuleToC(mlir::ModuleOp outerModuleOp,
   output << "\n";
 
   for (auto moduleOp : moduleOps) {
-    printModuleComment(moduleOp, output);
-
-    mlir::emitc::CppEmitter emitter(output);
-    mlir::emitc::CppEmitter::Scope scope(emitter);
-
-    // translate functions
-    for (auto funcOp : moduleOp.getOps<IREE::VM::FuncOp>()) {
-      if (failed(translateFunctionToC(emitter, moduleOp, funcOp, output))) {
-        return failure();
-      }
-
-      output << "\n";
-    }
-  }
-
-  printSeparatingComment(output);
-
-  for (auto moduleOp : moduleOps) {
-    printModuleComment(moduleOp, output);
-
-    // generate module descriptors
-    if (failed(buildModuleDescriptors(moduleOp, output))) {
+    if (failed(translateModuleOpToC(moduleOp, output))) {
       return failure();
     }
   }
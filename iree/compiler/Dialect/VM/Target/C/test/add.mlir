@@ -2,15 +2,31 @@
 
 // CHECK: #include "iree/vm/vm_c_funcs.h"
 vm.module @add_module {
-  // CHECK: iree_status_t add_module_add_1_impl(int32_t v1, int32_t v2, int32_t *out0, int32_t *out1) {
+  // CHECK: static iree_status_t add_module_add_1_impl(iree_vm_stack_t* stack, add_module_state_t* state, int32_t v1, int32_t v2, int32_t *out0, int32_t *out1) {
   vm.func @add_1(%arg0 : i32, %arg1 : i32) -> (i32, i32) {
-    // CHECK-NEXT: int32_t v3 = vm_add_i32(v1, v2);
+    // CHECK-NEXT: int32_t v3 = 0;
+    // CHECK-NEXT: int32_t v4 = 0;
+    // CHECK-NEXT: v3 = vm_add_i32(v1, v2);
     %0 = vm.add.i32 %arg0, %arg1 : i32
-    // CHECK-NEXT: int32_t v4 = vm_add_i32(v3, v3);
+    // CHECK-NEXT: v4 = vm_add_i32(v3, v3);
     %1 = vm.add.i32 %0, %0 : i32
     // CHECK-NEXT: *out0 = v3;
     // CHECK-NEXT: *out1 = v4;
     // CHECK-NEXT: return iree_ok_status();
     vm.return %0, %1 : i32, i32
   }
+  vm.export @add_1
+
+  // CHECK: static iree_status_t add_module_add_1_shim(
+  // CHECK: int32_t arg0 = vm_abi_load_i32(call->arguments.data + 0);
+  // CHECK: int32_t arg1 = vm_abi_load_i32(call->arguments.data + 4);
+  // CHECK: iree_status_t status = add_module_add_1_impl(stack, (add_module_state_t*)module_state, arg0, arg1, &ret0, &ret1);
+  // CHECK: vm_abi_store_i32(call->results.data + 0, ret0);
+  // CHECK: vm_abi_store_i32(call->results.data + 4, ret1);
+
+  // CHECK: static const iree_vm_native_export_descriptor_t add_module_exports_[] = {
+  // CHECK-NEXT: {{[{]}}"add_1", 5}, {"0ii.ii", 6}, 0, NULL},
+  // CHECK: static const iree_vm_native_function_ptr_t add_module_funcs_[] = {
+  // CHECK-NEXT: {add_module_add_1_shim, NULL},
+  // CHECK: static iree_status_t add_module_create(iree_allocator_t allocator, iree_vm_module_t** out_module) {
 }
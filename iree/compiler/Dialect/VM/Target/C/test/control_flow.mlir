@@ -0,0 +1,37 @@
+// RUN: iree-translate -iree-vm-ir-to-c-module %s | IreeFileCheck %s
+
+vm.module @control_flow_module {
+  // CHECK: struct control_flow_module_state_s {
+  // CHECK-NEXT: iree_allocator_t allocator;
+  // CHECK-NEXT: uint8_t rwdata[4];
+  // CHECK-NEXT: iree_vm_function_t imports[1];
+  // CHECK-NEXT: };
+  vm.global.i32 @counter mutable : i32
+  vm.import @other_module.step(%value : i32) -> i32
+
+  // CHECK: static iree_status_t control_flow_module_loop_impl(iree_vm_stack_t* stack, control_flow_module_state_t* state, int32_t v1, int32_t *out0) {
+  vm.func @loop(%arg0 : i32) -> i32 {
+    // CHECK: v{{[0-9]+}} = vm_const_i32_zero();
+    %zero = vm.const.i32.zero : i32
+    // CHECK: goto bb1;
+    vm.br ^bb1(%zero, %zero : i32, i32)
+  // CHECK: bb1:
+  ^bb1(%i : i32, %sum : i32):
+    // CHECK: IREE_RETURN_IF_ERROR(vm_call_import(stack, &state->imports[0], import_args, sizeof(import_args), import_results, sizeof(import_results)));
+    %next = vm.call @other_module.step(%i) : (i32) -> i32
+    %sum_next = vm.add.i32 %sum, %i : i32
+    %cmp = vm.cmp.lt.i32.s %next, %arg0 : i32
+    // CHECK: if (v{{[0-9]+}}) {
+    vm.cond_br %cmp, ^bb1(%next, %sum_next : i32, i32), ^bb2(%sum_next : i32)
+  // CHECK: bb2:
+  ^bb2(%result : i32):
+    // CHECK: vm_global_store_i32(state->rwdata, 0, v{{[0-9]+}});
+    vm.global.store.i32 %result, @counter : i32
+    vm.return %result : i32
+  }
+  vm.export @loop
+
+  // CHECK: static const iree_vm_native_import_descriptor_t control_flow_module_imports_[] = {
+  // CHECK-NEXT: {{[{]}}"other_module.step", 17}},
+  // CHECK: state->imports[ordinal] = *function;
+}
@@ -3,3 +3,9 @@
 // CHECK: #include "iree/vm/vm_c_funcs.h"
 vm.module @empty_module {
 }
+// CHECK: struct empty_module_state_s {
+// CHECK-NEXT: iree_allocator_t allocator;
+// CHECK-NEXT: };
+// CHECK: static const iree_vm_native_function_ptr_t empty_module_funcs_[] = {
+// CHECK-NEXT: {NULL, NULL},
+// CHECK: static iree_status_t empty_module_create(
@@ -0,0 +1,46 @@
+// RUN: iree-translate -iree-vm-ir-to-c-module %s | IreeFileCheck %s
+
+vm.module @rodata_switch_module {
+  // CHECK: static iree_alignas(16) const uint8_t rodata_switch_module_rodata_0_[8] = {
+  // CHECK-NEXT: 0x0a, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00};
+  vm.rodata @table dense<[10, 20]> : tensor<2xi32>
+
+  // CHECK: struct rodata_switch_module_state_s {
+  // CHECK-NEXT: iree_allocator_t allocator;
+  // CHECK-NEXT: iree_vm_ro_byte_buffer_t rodata[1];
+  // CHECK-NEXT: };
+
+  // CHECK: static iree_status_t rodata_switch_module_table_impl(iree_vm_stack_t* stack, rodata_switch_module_state_t* state, iree_vm_ref_t *out0) {
+  vm.func @table() -> !vm.ref<!iree.byte_buffer> {
+    // CHECK: status = vm_const_ref_rodata(&state->rodata[0], &v{{[0-9]+}});
+    %0 = vm.const.ref.rodata @table : !vm.ref<!iree.byte_buffer>
+    vm.return %0 : !vm.ref<!iree.byte_buffer>
+  }
+  vm.export @table
+
+  // CHECK: static iree_status_t rodata_switch_module_select_impl(iree_vm_stack_t* stack, rodata_switch_module_state_t* state, int32_t [[INDEX:v[0-9]+]], int32_t *out0) {
+  vm.func @select(%arg0 : i32) -> i32 {
+    %c5 = vm.const.i32 5 : i32
+    %c100 = vm.const.i32 100 : i32
+    %c200 = vm.const.i32 200 : i32
+    // CHECK: switch ([[INDEX]]) {
+    // CHECK-NEXT: case 0:
+    // CHECK-NEXT: [[RESULT:v[0-9]+]] = v{{[0-9]+}};
+    // CHECK-NEXT: break;
+    // CHECK-NEXT: case 1:
+    // CHECK-NEXT: [[RESULT]] = v{{[0-9]+}};
+    // CHECK-NEXT: break;
+    // CHECK-NEXT: default:
+    // CHECK-NEXT: [[RESULT]] = v{{[0-9]+}};
+    // CHECK-NEXT: break;
+    // CHECK-NEXT: }
+    %0 = vm.switch.i32 %arg0[%c100, %c200] else %c5 : i32
+    vm.return %0 : i32
+  }
+  vm.export @select
+
+  // CHECK: state->allocator = allocator;
+  // CHECK-NEXT: vm_rodata_initialize(&state->rodata[0], rodata_switch_module_rodata_0_, 8);
+
+  // CHECK: IREE_RETURN_IF_ERROR(iree_vm_register_builtin_types());
+}
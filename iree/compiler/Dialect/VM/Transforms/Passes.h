@@ -75,6 +75,17 @@ createGlobalInitializationPass();
 std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
 createOrdinalAllocationPass();
 
+//===----------------------------------------------------------------------===//
+// Optimization
+//===----------------------------------------------------------------------===//
+
+// Fuses common op sequences (such as a comparison feeding a conditional
+// branch) into superinstructions that execute with a single dispatch in the
+// bytecode interpreter. Only intended to be run immediately prior to bytecode
+// serialization as other targets do not handle the fused ops.
+std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
+createSuperinstructionFusionPass();
+
 //===----------------------------------------------------------------------===//
 // Test passes
 //===----------------------------------------------------------------------===//
@@ -92,6 +103,7 @@ inline void registerVMPasses() {
   createConversionPass(targetOptions);
   createGlobalInitializationPass();
   createOrdinalAllocationPass();
+  createSuperinstructionFusionPass();
 }
 
 inline void registerVMTestPasses() {
@@ -0,0 +1,150 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "iree/compiler/Dialect/VM/Transforms/Passes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace VM {
+
+namespace {
+
+/// Fuses a binary op with a constant operand into its immediate form.
+///
+/// Example:
+///   %c4 = vm.const.i32 4 : i32
+///   %0 = vm.add.i32 %arg0, %c4 : i32
+/// ->
+///   %0 = vm.add.i32.imm %arg0, 4 : i32
+template <typename OpT, typename ImmOpT>
+struct FuseBinaryOpConstOperand : public OpRewritePattern<OpT> {
+  using OpRewritePattern<OpT>::OpRewritePattern;
+  LogicalResult matchAndRewrite(OpT op,
+                                PatternRewriter &rewriter) const override {
+    APInt imm;
+    Value lhs;
+    if (matchPattern(op.rhs(), m_ConstantInt(&imm))) {
+      lhs = op.lhs();
+    } else if (matchPattern(op.lhs(), m_ConstantInt(&imm))) {
+      // All fused ops are commutative.
+      lhs = op.rhs();
+    } else {
+      return failure();
+    }
+    rewriter.replaceOpWithNewOp<ImmOpT>(
+        op, op.getType(), lhs,
+        rewriter.getI32IntegerAttr(static_cast<int32_t>(imm.getSExtValue())));
+    return success();
+  }
+};
+
+/// Fuses a subtraction of a constant into an add immediate of its negation.
+///
+/// Example:
+///   %c4 = vm.const.i32 4 : i32
+///   %0 = vm.sub.i32 %arg0, %c4 : i32
+/// ->
+///   %0 = vm.add.i32.imm %arg0, -4 : i32
+struct FuseSubI32ConstOperand : public OpRewritePattern<SubI32Op> {
+  using OpRewritePattern<SubI32Op>::OpRewritePattern;
+  LogicalResult matchAndRewrite(SubI32Op op,
+                                PatternRewriter &rewriter) const override {
+    APInt imm;
+    if (!matchPattern(op.rhs(), m_ConstantInt(&imm))) return failure();
+    // APInt negation wraps such that INT32_MIN remains INT32_MIN, matching the
+    // runtime behavior of the subtraction.
+    APInt negatedImm = -imm;
+    rewriter.replaceOpWithNewOp<AddI32ImmOp>(
+        op, op.getType(), op.lhs(),
+        rewriter.getI32IntegerAttr(
+            static_cast<int32_t>(negatedImm.getSExtValue())));
+    return success();
+  }
+};
+
+/// Fuses a comparison feeding a conditional branch into a single
+/// compare-and-branch op.
+///
+/// The comparison must be in the same block as the branch and have no other
+/// uses. This avoids extending the live ranges of the compared values and
+/// sinking comparisons that were hoisted out of loops back into them.
+///
+/// Example:
+///   %0 = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+///   vm.cond_br %0, ^bb1, ^bb2
+/// ->
+///   vm.cond_br.lt.i32.s %arg0, %arg1, ^bb1, ^bb2 : i32
+template <typename CmpOpT, typename BranchOpT>
+struct FuseCmpCondBranch : public OpRewritePattern<CondBranchOp> {
+  using OpRewritePattern<CondBranchOp>::OpRewritePattern;
+  LogicalResult matchAndRewrite(CondBranchOp op,
+                                PatternRewriter &rewriter) const override {
+    auto cmpOp = dyn_cast_or_null<CmpOpT>(op.getCondition().getDefiningOp());
+    if (!cmpOp || !cmpOp.getResult().hasOneUse() ||
+        cmpOp.getOperation()->getBlock() != op.getOperation()->getBlock()) {
+      return failure();
+    }
+    rewriter.replaceOpWithNewOp<BranchOpT>(
+        op, cmpOp.lhs(), cmpOp.rhs(), op.getTrueOperands(),
+        op.getFalseOperands(), op.getTrueDest(), op.getFalseDest());
+    rewriter.eraseOp(cmpOp);
+    return success();
+  }
+};
+
+}  // namespace
+
+// Fuses common op sequences into superinstructions that execute with a single
+// dispatch in the bytecode interpreter.
+class SuperinstructionFusionPass
+    : public PassWrapper<SuperinstructionFusionPass,
+                         OperationPass<IREE::VM::ModuleOp>> {
+ public:
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    OwningRewritePatternList patterns;
+    patterns.insert<FuseBinaryOpConstOperand<AddI32Op, AddI32ImmOp>,
+                    FuseBinaryOpConstOperand<MulI32Op, MulI32ImmOp>,
+                    FuseBinaryOpConstOperand<AndI32Op, AndI32ImmOp>,
+                    FuseBinaryOpConstOperand<OrI32Op, OrI32ImmOp>,
+                    FuseBinaryOpConstOperand<XorI32Op, XorI32ImmOp>,
+                    FuseSubI32ConstOperand>(context);
+    patterns.insert<FuseCmpCondBranch<CmpEQI32Op, CondBranchEQI32Op>,
+                    FuseCmpCondBranch<CmpNEI32Op, CondBranchNEI32Op>,
+                    FuseCmpCondBranch<CmpLTI32SOp, CondBranchLTI32SOp>,
+                    FuseCmpCondBranch<CmpLTI32UOp, CondBranchLTI32UOp>>(
+        context);
+    applyPatternsAndFoldGreedily(getOperation(), patterns);
+  }
+};
+
+std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
+createSuperinstructionFusionPass() {
+  return std::make_unique<SuperinstructionFusionPass>();
+}
+
+static PassRegistration<SuperinstructionFusionPass> pass(
+    "iree-vm-superinstruction-fusion",
+    "Fuses common op sequences into bytecode superinstructions");
+
+}  // namespace VM
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
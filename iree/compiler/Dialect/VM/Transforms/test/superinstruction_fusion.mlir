@@ -0,0 +1,130 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='vm.module(iree-vm-superinstruction-fusion)' %s | IreeFileCheck %s
+
+// CHECK-LABEL: @binary_imm_fusion
+vm.module @binary_imm_fusion {
+  // CHECK-LABEL: @add_imm
+  vm.func @add_imm(%arg0 : i32) -> i32 {
+    // CHECK-NEXT: %[[V:.+]] = vm.add.i32.imm %arg0, 4 : i32
+    // CHECK-NEXT: vm.return %[[V]] : i32
+    %c4 = vm.const.i32 4 : i32
+    %0 = vm.add.i32 %arg0, %c4 : i32
+    vm.return %0 : i32
+  }
+
+  // CHECK-LABEL: @add_imm_lhs
+  vm.func @add_imm_lhs(%arg0 : i32) -> i32 {
+    // CHECK-NEXT: %[[V:.+]] = vm.add.i32.imm %arg0, 4 : i32
+    // CHECK-NEXT: vm.return %[[V]] : i32
+    %c4 = vm.const.i32 4 : i32
+    %0 = vm.add.i32 %c4, %arg0 : i32
+    vm.return %0 : i32
+  }
+
+  // CHECK-LABEL: @sub_imm
+  vm.func @sub_imm(%arg0 : i32) -> i32 {
+    // CHECK-NEXT: %[[V:.+]] = vm.add.i32.imm %arg0, -4 : i32
+    // CHECK-NEXT: vm.return %[[V]] : i32
+    %c4 = vm.const.i32 4 : i32
+    %0 = vm.sub.i32 %arg0, %c4 : i32
+    vm.return %0 : i32
+  }
+
+  // CHECK-LABEL: @sub_imm_lhs
+  vm.func @sub_imm_lhs(%arg0 : i32) -> i32 {
+    // NOTE: subtraction is not commutative, so cannot fuse.
+    // CHECK-NEXT: %[[C4:.+]] = vm.const.i32 4 : i32
+    // CHECK-NEXT: %[[V:.+]] = vm.sub.i32 %[[C4]], %arg0 : i32
+    %c4 = vm.const.i32 4 : i32
+    %0 = vm.sub.i32 %c4, %arg0 : i32
+    vm.return %0 : i32
+  }
+
+  // CHECK-LABEL: @bitwise_imm
+  vm.func @bitwise_imm(%arg0 : i32) -> i32 {
+    // CHECK-NEXT: %[[V0:.+]] = vm.mul.i32.imm %arg0, 3 : i32
+    // CHECK-NEXT: %[[V1:.+]] = vm.and.i32.imm %[[V0]], 255 : i32
+    // CHECK-NEXT: %[[V2:.+]] = vm.or.i32.imm %[[V1]], 16 : i32
+    // CHECK-NEXT: %[[V3:.+]] = vm.xor.i32.imm %[[V2]], 1 : i32
+    // CHECK-NEXT: vm.return %[[V3]] : i32
+    %c3 = vm.const.i32 3 : i32
+    %c255 = vm.const.i32 255 : i32
+    %c16 = vm.const.i32 16 : i32
+    %c1 = vm.const.i32 1 : i32
+    %0 = vm.mul.i32 %arg0, %c3 : i32
+    %1 = vm.and.i32 %0, %c255 : i32
+    %2 = vm.or.i32 %1, %c16 : i32
+    %3 = vm.xor.i32 %2, %c1 : i32
+    vm.return %3 : i32
+  }
+
+  // CHECK-LABEL: @shared_const
+  vm.func @shared_const(%arg0 : i32) -> i32 {
+    // NOTE: the constant remains for its other (non-fusable) use.
+    // CHECK-NEXT: %[[C4:.+]] = vm.const.i32 4 : i32
+    // CHECK-NEXT: %[[V0:.+]] = vm.add.i32.imm %arg0, 4 : i32
+    // CHECK-NEXT: %[[V1:.+]] = vm.div.i32.s %[[V0]], %[[C4]] : i32
+    %c4 = vm.const.i32 4 : i32
+    %0 = vm.add.i32 %arg0, %c4 : i32
+    %1 = vm.div.i32.s %0, %c4 : i32
+    vm.return %1 : i32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @cmp_cond_br_fusion
+vm.module @cmp_cond_br_fusion {
+  // CHECK-LABEL: @cmp_lt_cond_br
+  vm.func @cmp_lt_cond_br(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK-NEXT: vm.cond_br.lt.i32.s %arg0, %arg1, ^bb1(%arg0 : i32), ^bb1(%arg1 : i32) : i32
+    %0 = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.cond_br %0, ^bb1(%arg0 : i32), ^bb1(%arg1 : i32)
+  ^bb1(%1 : i32):
+    vm.return %1 : i32
+  }
+
+  // CHECK-LABEL: @cmp_preds_cond_br
+  vm.func @cmp_preds_cond_br(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK-NEXT: vm.cond_br.eq.i32 %arg0, %arg1, ^bb1, ^bb2 : i32
+    %0 = vm.cmp.eq.i32 %arg0, %arg1 : i32
+    vm.cond_br %0, ^bb1, ^bb2
+  ^bb1:
+    // CHECK: vm.cond_br.ne.i32 %arg0, %arg1, ^bb2, ^bb3 : i32
+    %1 = vm.cmp.ne.i32 %arg0, %arg1 : i32
+    vm.cond_br %1, ^bb2, ^bb3
+  ^bb2:
+    // CHECK: vm.cond_br.lt.i32.u %arg0, %arg1, ^bb3, ^bb4 : i32
+    %2 = vm.cmp.lt.i32.u %arg0, %arg1 : i32
+    vm.cond_br %2, ^bb3, ^bb4
+  ^bb3:
+    vm.return %arg0 : i32
+  ^bb4:
+    vm.return %arg1 : i32
+  }
+
+  // CHECK-LABEL: @cmp_multiple_uses
+  vm.func @cmp_multiple_uses(%arg0 : i32, %arg1 : i32) -> i32 {
+    // NOTE: the comparison result is needed in a register, so cannot fuse.
+    // CHECK-NEXT: %[[CMP:.+]] = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    // CHECK-NEXT: vm.cond_br %[[CMP]], ^bb1(%[[CMP]] : i32), ^bb1(%arg1 : i32)
+    %0 = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.cond_br %0, ^bb1(%0 : i32), ^bb1(%arg1 : i32)
+  ^bb1(%1 : i32):
+    vm.return %1 : i32
+  }
+
+  // CHECK-LABEL: @cmp_other_block
+  vm.func @cmp_other_block(%arg0 : i32, %arg1 : i32) -> i32 {
+    // NOTE: the comparison is not sunk into the branching block.
+    // CHECK-NEXT: %[[CMP:.+]] = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    // CHECK-NEXT: vm.br ^bb1
+    // CHECK-NEXT: ^bb1:
+    // CHECK-NEXT: vm.cond_br %[[CMP]], ^bb1, ^bb2
+    %0 = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.br ^bb1
+  ^bb1:
+    vm.cond_br %0, ^bb1, ^bb2
+  ^bb2:
+    vm.return %arg0 : i32
+  }
+}
@@ -16,6 +16,7 @@
 #define IREE_HAL_ALLOCATOR_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 
 #include "absl/types/span.h"
@@ -26,6 +27,24 @@
 namespace iree {
 namespace hal {
 
+// Statistics of the memory allocated through an allocator.
+// Allocators may share their backing memory (such as a process-wide host pool)
+// in which case the statistics cover all allocators sharing it.
+struct AllocatorStatistics {
+  // Bytes currently allocated to live buffers.
+  int64_t bytes_allocated = 0;
+  // High-water mark of |bytes_allocated|.
+  int64_t bytes_allocated_peak = 0;
+  // Bytes currently held from the system, including memory retained for reuse.
+  int64_t bytes_reserved = 0;
+  // High-water mark of |bytes_reserved|.
+  int64_t bytes_reserved_peak = 0;
+  // Total number of buffer allocations made.
+  int64_t allocation_count = 0;
+  // Total number of allocations that had to be made from the system.
+  int64_t system_allocation_count = 0;
+};
+
 // Allocates buffers for a particular device memory space.
 //
 // Buffers allocated are only guaranteed to work with the driver that the
@@ -78,6 +97,14 @@ class Allocator : public RefObject<Allocator> {
                                              BufferUsageBitfield buffer_usage,
                                              size_t allocation_size) = 0;
 
+  // Releases memory retained by the allocator for reuse that is not backing any
+  // live buffer. Allocators that do not retain memory may ignore this.
+  virtual void Trim() {}
+
+  // Returns a snapshot of the allocation statistics. Allocators that do not
+  // track statistics return all zeros.
+  virtual AllocatorStatistics statistics() const { return {}; }
+
   // Allocates a buffer from the allocator for use as a constant value.
   // The provided |source_buffer| may be returned if the device can use it
   // directly and otherwise will be copied.
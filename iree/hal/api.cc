@@ -39,6 +39,7 @@
 #include "iree/hal/heap_buffer.h"
 #include "iree/hal/host/host_local_allocator.h"
 #include "iree/hal/semaphore.h"
+#include "iree/hal/transient_arena.h"
 
 namespace iree {
 namespace hal {
@@ -792,6 +793,31 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_allocator_wrap_buffer(
   return iree_ok_status();
 }
 
+IREE_API_EXPORT void IREE_API_CALL
+iree_hal_allocator_trim(iree_hal_allocator_t* allocator) {
+  IREE_TRACE_SCOPE0("iree_hal_allocator_trim");
+  if (!allocator) return;
+  auto* handle = reinterpret_cast<Allocator*>(allocator);
+  handle->Trim();
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_allocator_query_statistics(
+    const iree_hal_allocator_t* allocator,
+    iree_hal_allocator_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(allocator);
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  const auto* handle = reinterpret_cast<const Allocator*>(allocator);
+  auto statistics = handle->statistics();
+  out_statistics->bytes_allocated = statistics.bytes_allocated;
+  out_statistics->bytes_allocated_peak = statistics.bytes_allocated_peak;
+  out_statistics->bytes_reserved = statistics.bytes_reserved;
+  out_statistics->bytes_reserved_peak = statistics.bytes_reserved_peak;
+  out_statistics->allocation_count = statistics.allocation_count;
+  out_statistics->system_allocation_count = statistics.system_allocation_count;
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // iree::hal::Buffer
 //===----------------------------------------------------------------------===//
@@ -1510,6 +1536,29 @@ iree_hal_command_buffer_push_descriptor_set(
           binding_count));
 }
 
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_command_buffer_push_descriptor_set_indirect(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_executable_layout_t* executable_layout, int32_t set,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_indirect_binding_t* bindings) {
+  IREE_TRACE_SCOPE0("iree_hal_command_buffer_push_descriptor_set_indirect");
+  IREE_ASSERT_ARGUMENT(command_buffer);
+  IREE_ASSERT_ARGUMENT(executable_layout);
+  auto* handle = reinterpret_cast<CommandBuffer*>(command_buffer);
+  if (binding_count && !bindings) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "bindings/binding_count mismatch");
+  }
+  static_assert(sizeof(IndirectBinding) ==
+                    sizeof(iree_hal_descriptor_set_indirect_binding_t),
+                "Expecting identical layout");
+  return handle->PushDescriptorSetIndirect(
+      reinterpret_cast<ExecutableLayout*>(executable_layout), set,
+      absl::MakeConstSpan(reinterpret_cast<const IndirectBinding*>(bindings),
+                          binding_count));
+}
+
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_hal_command_buffer_bind_descriptor_set(
     iree_hal_command_buffer_t* command_buffer,
@@ -1718,6 +1767,13 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_device_queue_submit(
         absl::MakeConstSpan(&semaphore_values[base_semaphore_index],
                             src_batch.signal_semaphores.count);
     base_semaphore_index += src_batch.signal_semaphores.count;
+    if (src_batch.binding_table_count && !src_batch.binding_table) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "binding_table/binding_table_count mismatch");
+    }
+    dst_batch.binding_table =
+        iree::ReinterpretSpan<Buffer*>(absl::MakeConstSpan(
+            src_batch.binding_table, src_batch.binding_table_count));
   }
 
   // For now we always go to the first compute queue. TBD cleanup pending the
@@ -1775,6 +1831,79 @@ iree_hal_device_wait_semaphores_with_timeout(
       device, wait_mode, semaphore_list, deadline_ns);
 }
 
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_device_acquire_transient_arena(
+    iree_hal_device_t* device, iree_hal_memory_type_t memory_type,
+    iree_hal_buffer_usage_t buffer_usage, iree_device_size_t capacity_hint,
+    iree_hal_transient_arena_t** out_arena) {
+  IREE_TRACE_SCOPE0("iree_hal_device_acquire_transient_arena");
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(out_arena);
+  *out_arena = nullptr;
+
+  auto* handle = reinterpret_cast<Device*>(device);
+  auto* pool = handle->transient_arena_pool();
+  if (!pool) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "device does not pool transient memory");
+  }
+  IREE_ASSIGN_OR_RETURN(
+      auto arena,
+      pool->Acquire(handle->allocator(),
+                    static_cast<MemoryTypeBitfield>(memory_type),
+                    static_cast<BufferUsageBitfield>(buffer_usage),
+                    capacity_hint));
+
+  *out_arena = reinterpret_cast<iree_hal_transient_arena_t*>(arena.release());
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_device_release_transient_arena(iree_hal_device_t* device,
+                                        iree_hal_transient_arena_t* arena,
+                                        iree_hal_semaphore_t* semaphore,
+                                        uint64_t value) {
+  IREE_TRACE_SCOPE0("iree_hal_device_release_transient_arena");
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(arena);
+
+  auto* handle = reinterpret_cast<Device*>(device);
+  auto* pool = handle->transient_arena_pool();
+  if (!pool) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "device does not pool transient memory");
+  }
+  std::unique_ptr<TransientArena> arena_ptr(
+      reinterpret_cast<TransientArena*>(arena));
+  if (semaphore) {
+    pool->ReleaseOnSignal(std::move(arena_ptr),
+                          reinterpret_cast<Semaphore*>(semaphore), value);
+  } else {
+    pool->Release(std::move(arena_ptr));
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree::hal::TransientArena
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_transient_arena_allocate_buffer(iree_hal_transient_arena_t* arena,
+                                         iree_device_size_t allocation_size,
+                                         iree_hal_buffer_t** out_buffer) {
+  IREE_TRACE_SCOPE0("iree_hal_transient_arena_allocate_buffer");
+  IREE_ASSERT_ARGUMENT(arena);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = nullptr;
+
+  auto* handle = reinterpret_cast<TransientArena*>(arena);
+  IREE_ASSIGN_OR_RETURN(auto buffer, handle->Allocate(allocation_size));
+
+  *out_buffer = reinterpret_cast<iree_hal_buffer_t*>(buffer.release());
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // iree::hal::Driver
 //===----------------------------------------------------------------------===//
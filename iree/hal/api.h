@@ -42,6 +42,23 @@ typedef struct iree_hal_executable iree_hal_executable_t;
 typedef struct iree_hal_executable_cache iree_hal_executable_cache_t;
 typedef struct iree_hal_executable_layout iree_hal_executable_layout_t;
 typedef struct iree_hal_semaphore iree_hal_semaphore_t;
+typedef struct iree_hal_transient_arena iree_hal_transient_arena_t;
+
+// Statistics of the memory allocated through an allocator.
+typedef struct {
+  // Bytes currently allocated to live buffers.
+  int64_t bytes_allocated;
+  // High-water mark of |bytes_allocated|.
+  int64_t bytes_allocated_peak;
+  // Bytes currently held from the system, including memory retained for reuse.
+  int64_t bytes_reserved;
+  // High-water mark of |bytes_reserved|.
+  int64_t bytes_reserved_peak;
+  // Total number of buffer allocations made.
+  int64_t allocation_count;
+  // Total number of allocations that had to be made from the system.
+  int64_t system_allocation_count;
+} iree_hal_allocator_statistics_t;
 
 // Reference to a buffer's mapped memory.
 typedef struct {
@@ -192,6 +209,12 @@ typedef struct {
 } iree_hal_device_info_t;
 
 // A bitfield specifying the mode of operation for a command buffer.
+//
+// Command buffers created without IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT are
+// reusable and may be submitted any number of times once recorded. Buffers that
+// change between submissions can be recorded with
+// iree_hal_command_buffer_push_descriptor_set_indirect and provided in the
+// binding table of each submission batch.
 enum iree_hal_command_buffer_mode_e {
   // Command buffer will be submitted once and never used again.
   // This may enable in-place patching of command buffers that reduce overhead
@@ -253,6 +276,21 @@ typedef struct {
   iree_device_size_t length;
 } iree_hal_descriptor_set_binding_t;
 
+// Specifies a descriptor set binding whose buffer is provided by the binding
+// table of each submission batch instead of at the time the binding is
+// recorded into the command buffer.
+typedef struct {
+  // The binding number of this entry and corresponds to a resource of the
+  // same binding number in the executable interface.
+  int32_t binding;
+  // Index into the submission batch binding table of the buffer to bind.
+  int32_t slot;
+  // Offset, in bytes, into the buffer that the binding starts at.
+  iree_device_size_t offset;
+  // Length, in bytes, of the buffer that is available to the executable.
+  iree_device_size_t length;
+} iree_hal_descriptor_set_indirect_binding_t;
+
 // Specifies the usage type of the descriptor set.
 enum iree_hal_descriptor_set_layout_usage_type_e {
   // Descriptor set will be initialized once and never changed.
@@ -436,6 +474,12 @@ typedef struct {
 
   // Semaphores to signal once all command buffers have completed execution.
   iree_hal_semaphore_list_t signal_semaphores;
+
+  // Buffers referenced by slot from indirect bindings recorded in the command
+  // buffers with iree_hal_command_buffer_push_descriptor_set_indirect.
+  // The buffers must remain valid until the batch has completed execution.
+  iree_host_size_t binding_table_count;
+  iree_hal_buffer_t** binding_table;
 } iree_hal_submission_batch_t;
 
 // Defines how a multi-wait operation treats the results of multiple semaphores.
@@ -660,6 +704,19 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_hal_allocator_wrap_buffer(
     iree_hal_buffer_usage_t buffer_usage, iree_byte_span_t data,
     iree_hal_buffer_t** out_buffer);
 
+// Releases memory retained by the |allocator| for reuse that is not backing any
+// live buffer. Allocators that do not retain memory ignore this.
+IREE_API_EXPORT void IREE_API_CALL
+iree_hal_allocator_trim(iree_hal_allocator_t* allocator);
+
+// Queries a snapshot of the allocation statistics of the |allocator|.
+// Allocators sharing backing memory report the statistics of the shared memory.
+// Allocators that do not track statistics report all zeros.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_allocator_query_statistics(
+    const iree_hal_allocator_t* allocator,
+    iree_hal_allocator_statistics_t* out_statistics);
+
 //===----------------------------------------------------------------------===//
 // iree::hal::Buffer
 //===----------------------------------------------------------------------===//
@@ -984,6 +1041,17 @@ iree_hal_command_buffer_push_descriptor_set(
     iree_host_size_t binding_count,
     const iree_hal_descriptor_set_binding_t* bindings);
 
+// Pushes a descriptor set and associates it with |set| as with
+// iree_hal_command_buffer_push_descriptor_set but with the buffers resolved
+// from the binding table of each submission batch. This allows reusable
+// command buffers to be recorded once and submitted with different buffers.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_command_buffer_push_descriptor_set_indirect(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_executable_layout_t* executable_layout, int32_t set,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_indirect_binding_t* bindings);
+
 // Binds a descriptor set to the given |set| matching that used in the
 // executable layout interface.
 //
@@ -1145,6 +1213,48 @@ iree_hal_device_wait_semaphores_with_timeout(
     const iree_hal_semaphore_list_t* semaphore_list,
     iree_duration_t timeout_ns);
 
+// Acquires an arena for buffers used only by a single submission.
+// Buffers are bump-allocated from storage recycled from prior submissions and
+// the arena must be released with iree_hal_device_release_transient_arena
+// once the work using it has been submitted. If |capacity_hint| is non-zero
+// the arena will reserve at least that many bytes when first allocated from.
+//
+// Returns UNAVAILABLE if the device does not pool transient memory; callers
+// should fall back to allocating from iree_hal_device_allocator.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_device_acquire_transient_arena(
+    iree_hal_device_t* device, iree_hal_memory_type_t memory_type,
+    iree_hal_buffer_usage_t buffer_usage, iree_device_size_t capacity_hint,
+    iree_hal_transient_arena_t** out_arena);
+
+// Releases |arena| back to the device once |semaphore| reaches |value|.
+// All submissions using buffers allocated from the arena must signal
+// |semaphore| to |value| (or greater) on completion. If |semaphore| is NULL the
+// arena is released immediately and the caller must ensure no pending work
+// uses it. |arena| is invalid after this call.
+//
+// Buffers allocated from the arena must not be used after |semaphore| has
+// reached |value| as their storage may be reused by other submissions.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_device_release_transient_arena(iree_hal_device_t* device,
+                                        iree_hal_transient_arena_t* arena,
+                                        iree_hal_semaphore_t* semaphore,
+                                        uint64_t value);
+
+//===----------------------------------------------------------------------===//
+// iree::hal::TransientArena
+//===----------------------------------------------------------------------===//
+
+// Allocates a buffer of |allocation_size| bytes from the transient |arena|.
+// The buffer has the memory type and usage the arena was acquired with.
+// |out_buffer| must be released by the caller but the storage backing it is
+// only valid until the arena is recycled (see
+// iree_hal_device_release_transient_arena).
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_hal_transient_arena_allocate_buffer(iree_hal_transient_arena_t* arena,
+                                         iree_device_size_t allocation_size,
+                                         iree_hal_buffer_t** out_buffer);
+
 //===----------------------------------------------------------------------===//
 // iree::hal::Driver
 //===----------------------------------------------------------------------===//
@@ -557,6 +557,28 @@ TEST(BufferTest, Fill32Subspan) {
               ElementsAre(0x44, 0x33, 0x22, 0x11, 0xDD, 0xCC, 0xBB, 0xAA, 0));
 }
 
+// Tests fills spanning many blocks of the wide fill loop plus a partial tail.
+TEST(BufferTest, FillLarge) {
+  auto buffer = HeapBuffer::Allocate(BufferUsage::kMapping, 1024);
+  ASSERT_TRUE(buffer);
+
+  IREE_EXPECT_OK(buffer->Fill16(2, 1000, 0x1122u));
+  std::vector<uint16_t> actual_data(buffer->allocation_size() / 2);
+  IREE_EXPECT_OK(buffer->ReadData(0, actual_data.data(), 1024));
+  for (int i = 0; i < actual_data.size(); ++i) {
+    EXPECT_EQ(i >= 1 && i < 501 ? 0x1122u : 0u, actual_data[i]) << i;
+  }
+
+  IREE_EXPECT_OK(buffer->Fill32(4, 1012, 0xAABBCCDDu));
+  std::vector<uint32_t> actual_data32(buffer->allocation_size() / 4);
+  IREE_EXPECT_OK(buffer->ReadData(0, actual_data32.data(), 1024));
+  EXPECT_EQ(0x11220000u, actual_data32[0]);
+  for (int i = 1; i < 254; ++i) {
+    EXPECT_EQ(0xAABBCCDDu, actual_data32[i]) << i;
+  }
+  EXPECT_EQ(0u, actual_data32[255]);
+}
+
 TEST(BufferTest, ReadData) {
   std::vector<uint8_t> src_data = {0, 1, 2, 3};
   auto buffer =
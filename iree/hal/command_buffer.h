@@ -30,6 +30,11 @@ namespace iree {
 namespace hal {
 
 // A bitfield specifying the mode of operation for a command buffer.
+//
+// Command buffers created without kOneShot are reusable: once recorded they
+// may be submitted any number of times until the next Begin. Buffers that
+// change between submissions can be recorded with PushDescriptorSetIndirect
+// and provided in the SubmissionBatch::binding_table of each submission.
 enum class CommandBufferMode : uint32_t {
   // Command buffer will be submitted once and never used again.
   // This may enable in-place patching of command buffers that reduce overhead
@@ -51,6 +56,23 @@ IREE_BITFIELD(CommandCategory);
 using CommandCategoryBitfield = CommandCategory;
 std::string CommandCategoryString(CommandCategoryBitfield categories);
 
+// A descriptor set binding that references a buffer by its slot in the binding
+// table provided with each submission instead of a concrete buffer. This allows
+// a command buffer to be recorded once and executed against different buffers.
+//
+// Matches iree_hal_descriptor_set_indirect_binding_t.
+struct IndirectBinding {
+  // The binding number of this entry and corresponds to a resource of the
+  // same binding number in the executable interface.
+  int32_t binding = 0;
+  // Index into the SubmissionBatch::binding_table of the buffer to bind.
+  int32_t slot = 0;
+  // Offset, in bytes, into the buffer that the binding starts at.
+  device_size_t offset = 0;
+  // Length, in bytes, of the buffer that is available to the executable.
+  device_size_t length = kWholeBuffer;
+};
+
 // Bitfield specifying which execution stage a brarrier should start/end at.
 //
 // Maps to VkPipelineStageFlagBits.
@@ -298,6 +320,20 @@ class CommandBuffer : public Resource {
       ExecutableLayout* executable_layout, int32_t set,
       absl::Span<const DescriptorSet::Binding> bindings) = 0;
 
+  // Pushes a descriptor set and associates it with |set| as with
+  // PushDescriptorSet but with buffers resolved from the binding table of each
+  // submission. The same recorded command buffer may then be submitted many
+  // times with different buffers without re-recording.
+  //
+  // Implementations that cannot defer buffer resolution to submission time
+  // return UNIMPLEMENTED.
+  virtual Status PushDescriptorSetIndirect(
+      ExecutableLayout* executable_layout, int32_t set,
+      absl::Span<const IndirectBinding> bindings) {
+    return UnimplementedErrorBuilder(IREE_LOC)
+           << "Indirect descriptor set bindings are not supported";
+  }
+
   // Binds a descriptor set to the given |set| matching that used in the
   // executable layout interface.
   //
@@ -73,6 +73,9 @@ class ValidatingCommandBuffer : public CommandBuffer {
   Status PushDescriptorSet(
       ExecutableLayout* executable_layout, int32_t set,
       absl::Span<const DescriptorSet::Binding> bindings) override;
+  Status PushDescriptorSetIndirect(
+      ExecutableLayout* executable_layout, int32_t set,
+      absl::Span<const IndirectBinding> bindings) override;
   Status BindDescriptorSet(
       ExecutableLayout* executable_layout, int32_t set,
       DescriptorSet* descriptor_set,
@@ -425,6 +428,22 @@ Status ValidatingCommandBuffer::PushDescriptorSet(
   return impl_->PushDescriptorSet(executable_layout, set, bindings);
 }
 
+Status ValidatingCommandBuffer::PushDescriptorSetIndirect(
+    ExecutableLayout* executable_layout, int32_t set,
+    absl::Span<const IndirectBinding> bindings) {
+  IREE_DVLOG(3) << "CommandBuffer::PushDescriptorSetIndirect("
+                << executable_layout->DebugString() << ", " << set << ", "
+                << bindings.size() << " bindings)";
+
+  IREE_RETURN_IF_ERROR(ValidateCategories(CommandCategory::kDispatch));
+
+  // TODO(benvanik): validate set index.
+  // NOTE: buffers are only known at submission time when the implementation
+  // resolves them from the binding table.
+
+  return impl_->PushDescriptorSetIndirect(executable_layout, set, bindings);
+}
+
 Status ValidatingCommandBuffer::BindDescriptorSet(
     ExecutableLayout* executable_layout, int32_t set,
     DescriptorSet* descriptor_set,
@@ -43,6 +43,11 @@ struct SubmissionBatch {
   // Semaphore playloads will be set to the maximum of the specified payload or
   // their current payload.
   absl::Span<const SemaphoreValue> signal_semaphores;
+
+  // Buffers referenced by slot from indirect bindings recorded in the command
+  // buffers (see CommandBuffer::PushDescriptorSetIndirect).
+  // The buffers must remain valid until the batch has completed execution.
+  absl::Span<Buffer* const> binding_table;
 };
 
 // Asynchronous command execution queue.
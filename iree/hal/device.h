@@ -31,6 +31,7 @@
 #include "iree/hal/executable_cache.h"
 #include "iree/hal/executable_layout.h"
 #include "iree/hal/semaphore.h"
+#include "iree/hal/transient_arena.h"
 
 #if defined(IREE_PLATFORM_WINDOWS)
 // Win32 macro name conflicts:
@@ -61,6 +62,12 @@ class Device : public RefObject<Device> {
   // This allocator may be shared with other devices in the same family.
   virtual Allocator* allocator() const = 0;
 
+  // A pool of arenas for buffers that live only as long as a submission.
+  // Arenas allocate from allocator() and are recycled as the semaphores they
+  // are released with are signaled. Returns nullptr if the device does not
+  // pool transient memory.
+  virtual TransientArenaPool* transient_arena_pool() { return nullptr; }
+
   // Returns a list of all general-purpose dispatch queues provided by the
   // device. In general these map 1:1 with independent execution contexts,
   // though some devices may hide that and expose only a single queue that is
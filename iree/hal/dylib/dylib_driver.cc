@@ -18,7 +18,8 @@
 
 #include "iree/hal/device_info.h"
 #include "iree/hal/dylib/dylib_device.h"
-#include "iree/hal/host/serial/serial_scheduling_model.h"
+#include "iree/hal/host/dag/dag_scheduling_model.h"
+#include "iree/hal/host/parallel/parallel_scheduling_model.h"
 
 namespace iree {
 namespace hal {
@@ -39,7 +40,8 @@ DeviceInfo GetDefaultDeviceInfo() {
 
 }  // namespace
 
-DyLibDriver::DyLibDriver() : Driver("dylib") {}
+DyLibDriver::DyLibDriver(Options options)
+    : Driver("dylib"), options_(options) {}
 
 DyLibDriver::~DyLibDriver() = default;
 
@@ -56,7 +58,12 @@ StatusOr<ref_ptr<Device>> DyLibDriver::CreateDefaultDevice() {
 
 StatusOr<ref_ptr<Device>> DyLibDriver::CreateDevice(DriverDeviceID device_id) {
   // Only one device, ignore device_id.
-  auto scheduling_model = std::make_unique<host::SerialSchedulingModel>();
+  std::unique_ptr<host::SchedulingModel> scheduling_model;
+  if (options_.use_dag_scheduling) {
+    scheduling_model = std::make_unique<host::DagSchedulingModel>();
+  } else {
+    scheduling_model = std::make_unique<host::ParallelSchedulingModel>();
+  }
   return make_ref<DyLibDevice>(GetDefaultDeviceInfo(),
                                std::move(scheduling_model));
 }
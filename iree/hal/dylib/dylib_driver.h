@@ -23,7 +23,13 @@ namespace dylib {
 
 class DyLibDriver final : public Driver {
  public:
-  DyLibDriver();
+  struct Options {
+    // Schedules submissions out-of-order with host::DagSchedulingModel instead
+    // of in-order with host::ParallelSchedulingModel.
+    bool use_dag_scheduling = false;
+  };
+
+  explicit DyLibDriver(Options options);
   ~DyLibDriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -31,6 +37,9 @@ class DyLibDriver final : public Driver {
   StatusOr<ref_ptr<Device>> CreateDefaultDevice() override;
 
   StatusOr<ref_ptr<Device>> CreateDevice(DriverDeviceID device_id) override;
+
+ private:
+  Options options_;
 };
 
 }  // namespace dylib
@@ -14,17 +14,24 @@
 
 #include <memory>
 
+#include "absl/flags/flag.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/hal/driver_registry.h"
 #include "iree/hal/dylib/dylib_driver.h"
 
+ABSL_FLAG(bool, dylib_dag_scheduling, false,
+          "Runs independent submissions and the commands between barriers "
+          "concurrently instead of in-order.");
+
 namespace iree {
 namespace hal {
 namespace dylib {
 
 static StatusOr<ref_ptr<Driver>> CreateDyLibDriver() {
-  return make_ref<DyLibDriver>();
+  DyLibDriver::Options options;
+  options.use_dag_scheduling = absl::GetFlag(FLAGS_dylib_dag_scheduling);
+  return make_ref<DyLibDriver>(options);
 }
 
 }  // namespace dylib
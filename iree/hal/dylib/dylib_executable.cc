@@ -14,6 +14,8 @@
 
 #include "iree/hal/dylib/dylib_executable.h"
 
+#include <utility>
+
 #include "flatbuffers/flatbuffers.h"
 #include "iree/base/file_io.h"
 #include "iree/base/tracing.h"
@@ -55,9 +57,41 @@ Status DyLibExecutable::Initialize(ExecutableSpec spec) {
     return InvalidArgumentErrorBuilder(IREE_LOC) << "No embedded library";
   }
 
-  // Write the embedded library out to a temp file, since all of the dynamic
-  // library APIs work with files. We could instead use in-memory files on
-  // platforms where that is convenient.
+  absl::Span<const uint8_t> embedded_library_data(
+      dylib_executable_def->library_embedded()->data(),
+      dylib_executable_def->library_embedded()->size());
+
+  // Prefer loading the embedded library directly from memory to avoid
+  // filesystem I/O (and leaving files behind if we crash). Not all platforms
+  // support this so fall back to a temp file if needed.
+  auto executable_library_or =
+      DynamicLibrary::LoadFromMemory("dylib_executable", embedded_library_data);
+  if (executable_library_or.ok()) {
+    executable_library_ = std::move(executable_library_or.value());
+  } else {
+    IREE_RETURN_IF_ERROR(LoadFromTempFile(embedded_library_data));
+  }
+
+  const auto& entry_points = *dylib_executable_def->entry_points();
+  entry_functions_.resize(entry_points.size());
+  for (int i = 0; i < entry_functions_.size(); ++i) {
+    void* symbol = executable_library_->GetSymbol(entry_points[i]->c_str());
+    if (!symbol) {
+      return NotFoundErrorBuilder(IREE_LOC)
+             << "Could not find symbol: " << entry_points[i];
+    }
+    entry_functions_[i] = symbol;
+  }
+
+  return OkStatus();
+}
+
+Status DyLibExecutable::LoadFromTempFile(
+    absl::Span<const uint8_t> library_data) {
+  IREE_TRACE_SCOPE0("DyLibExecutable::LoadFromTempFile");
+
+  // Write the embedded library out to a temp file, since all of the file-based
+  // dynamic library APIs work with files.
   std::string base_name = "dylib_executable";
   IREE_ASSIGN_OR_RETURN(executable_library_temp_path_,
                         file_io::GetTempFile(base_name));
@@ -69,28 +103,14 @@ Status DyLibExecutable::Initialize(ExecutableSpec spec) {
   executable_library_temp_path_ += ".so";
 #endif
 
-  absl::string_view embedded_library_data(
-      reinterpret_cast<const char*>(
-          dylib_executable_def->library_embedded()->data()),
-      dylib_executable_def->library_embedded()->size());
+  absl::string_view library_contents(
+      reinterpret_cast<const char*>(library_data.data()), library_data.size());
   IREE_RETURN_IF_ERROR(file_io::SetFileContents(executable_library_temp_path_,
-                                                embedded_library_data));
+                                                library_contents));
 
   IREE_ASSIGN_OR_RETURN(
       executable_library_,
       DynamicLibrary::Load(executable_library_temp_path_.c_str()));
-
-  const auto& entry_points = *dylib_executable_def->entry_points();
-  entry_functions_.resize(entry_points.size());
-  for (int i = 0; i < entry_functions_.size(); ++i) {
-    void* symbol = executable_library_->GetSymbol(entry_points[i]->c_str());
-    if (!symbol) {
-      return NotFoundErrorBuilder(IREE_LOC)
-             << "Could not find symbol: " << entry_points[i];
-    }
-    entry_functions_[i] = symbol;
-  }
-
   return OkStatus();
 }
 
@@ -99,6 +119,7 @@ struct DyLibDispatchState : public HostExecutable::DispatchState {
   void* entry_function = nullptr;
   absl::InlinedVector<void*, 4> args;
   absl::InlinedVector<int32_t, 4> push_constant;
+  std::array<uint32_t, 3> workgroup_count;
 };
 
 StatusOr<ref_ptr<HostExecutable::DispatchState>>
@@ -112,6 +133,7 @@ DyLibExecutable::PrepareDispatch(const DispatchParams& params) {
 
   auto dispatch_state = make_ref<DyLibDispatchState>();
   dispatch_state->entry_function = entry_functions_[params.entry_point];
+  dispatch_state->workgroup_count = params.workgroup_count;
 
   for (size_t set = 0; set < params.set_bindings.size(); ++set) {
     for (size_t binding = 0; binding < params.set_bindings[set].size();
@@ -138,10 +160,11 @@ Status DyLibExecutable::DispatchTile(DispatchState* state,
   IREE_TRACE_SCOPE0("DyLibExecutable::DispatchTile");
   auto* dispatch_state = static_cast<DyLibDispatchState*>(state);
 
-  auto entry_function =
-      (void (*)(void**, int32_t*))dispatch_state->entry_function;
+  auto entry_function = (void (*)(void**, int32_t*, uint32_t*, uint32_t*))
+                            dispatch_state->entry_function;
   entry_function(dispatch_state->args.data(),
-                 dispatch_state->push_constant.data());
+                 dispatch_state->push_constant.data(), workgroup_xyz.data(),
+                 dispatch_state->workgroup_count.data());
 
   return OkStatus();
 }
@@ -19,6 +19,7 @@
 #include <string>
 
 #include "absl/container/inlined_vector.h"
+#include "absl/types/span.h"
 #include "iree/base/dynamic_library.h"
 #include "iree/base/status.h"
 #include "iree/hal/executable_spec.h"
@@ -46,6 +47,8 @@ class DyLibExecutable final : public HostExecutable {
 
  private:
   Status Initialize(ExecutableSpec spec);
+  // Writes |library_data| to a temp file and loads it from there.
+  Status LoadFromTempFile(absl::Span<const uint8_t> library_data);
 
   std::string executable_library_temp_path_;
   std::unique_ptr<DynamicLibrary> executable_library_;
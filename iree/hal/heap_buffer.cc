@@ -15,7 +15,6 @@
 #include "iree/hal/heap_buffer.h"
 
 #include <cstdint>
-#include <cstdlib>
 #include <string>
 #include <utility>
 
@@ -23,6 +22,7 @@
 #include "iree/base/tracing.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/host/host_buffer.h"
+#include "iree/hal/memory_pool.h"
 
 namespace iree {
 namespace hal {
@@ -40,7 +40,7 @@ class HeapAllocator : public Allocator {
   // additional copies.
   static Allocator* std_heap();
 
-  // TODO(benvanik): specify custom allocator (not malloc/free).
+  // Buffers are suballocated from the default MemoryPool.
   HeapAllocator();
   ~HeapAllocator() override;
 
@@ -57,6 +57,9 @@ class HeapAllocator : public Allocator {
                                      BufferUsageBitfield buffer_usage,
                                      size_t allocation_size) override;
 
+  void Trim() override;
+  AllocatorStatistics statistics() const override;
+
   StatusOr<ref_ptr<Buffer>> WrapMutable(MemoryTypeBitfield memory_type,
                                         MemoryAccessBitfield allowed_access,
                                         BufferUsageBitfield buffer_usage,
@@ -114,18 +117,27 @@ StatusOr<ref_ptr<Buffer>> HeapAllocator::Allocate(
            << ", allocation_size=" << allocation_size;
   }
 
-  void* malloced_data = std::calloc(1, allocation_size);
-  if (!malloced_data) {
+  // Heap buffers are always host-visible and zeroed unless transient.
+  bool zero_fill = !AnyBitSet(memory_type & MemoryType::kTransient);
+  auto* memory_pool = MemoryPool::GetDefault();
+  void* data = memory_pool->Allocate(allocation_size, zero_fill);
+  if (!data) {
     return ResourceExhaustedErrorBuilder(IREE_LOC)
-           << "Failed to malloc " << allocation_size << " bytes";
+           << "Failed to allocate " << allocation_size << " bytes";
   }
 
   auto buffer =
       make_ref<HostBuffer>(this, memory_type, MemoryAccess::kAll, buffer_usage,
-                           allocation_size, malloced_data, true);
+                           allocation_size, data, memory_pool);
   return buffer;
 }
 
+void HeapAllocator::Trim() { MemoryPool::GetDefault()->Trim(); }
+
+AllocatorStatistics HeapAllocator::statistics() const {
+  return MemoryPool::GetDefault()->statistics();
+}
+
 StatusOr<ref_ptr<Buffer>> HeapAllocator::WrapMutable(
     MemoryTypeBitfield memory_type, MemoryAccessBitfield allowed_access,
     BufferUsageBitfield buffer_usage, void* data, size_t data_length) {
@@ -14,22 +14,56 @@
 
 #include "iree/hal/host/condvar_semaphore.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
+#include <utility>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/synchronization/mutex.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 
+#if defined(IREE_HAL_HOST_SEMAPHORE_EVENTFD)
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif  // IREE_HAL_HOST_SEMAPHORE_EVENTFD
+
 namespace iree {
 namespace hal {
 namespace host {
 
+// State shared by all waiters registered by a single WaitForSemaphores call.
+// Lives on the stack of the waiting thread for the duration of the call.
+struct CondVarSemaphore::WaitGroup {
+  absl::Mutex mutex;
+  // Number of waiters that must be notified before the wait is satisfied.
+  int remaining ABSL_GUARDED_BY(mutex) = 0;
+
+  void Notify() {
+    absl::MutexLock lock(&mutex);
+    --remaining;
+  }
+};
+
 CondVarSemaphore::CondVarSemaphore(uint64_t initial_value)
     : value_(initial_value) {}
 
-CondVarSemaphore::~CondVarSemaphore() = default;
+CondVarSemaphore::~CondVarSemaphore() {
+  absl::MutexLock lock(&mutex_);
+  // Only exported eventfds may remain as WaitForSemaphores always unregisters
+  // its waiters before returning.
+  for (auto* waiter : waiters_) {
+#if defined(IREE_HAL_HOST_SEMAPHORE_EVENTFD)
+    ::close(waiter->event_fd);
+#endif  // IREE_HAL_HOST_SEMAPHORE_EVENTFD
+    delete waiter;
+  }
+  waiters_.clear();
+}
 
 StatusOr<uint64_t> CondVarSemaphore::Query() {
   absl::MutexLock lock(&mutex_);
@@ -44,10 +78,12 @@ Status CondVarSemaphore::Signal(uint64_t value) {
   if (!status_.ok()) {
     return status_;
   }
-  if (value_.exchange(value) >= value) {
+  if (value_.load(std::memory_order_acquire) >= value) {
     return InvalidArgumentErrorBuilder(IREE_LOC)
            << "Semaphore values must be monotonically increasing";
   }
+  value_.store(value, std::memory_order_release);
+  NotifyWaiters();
   return OkStatus();
 }
 
@@ -55,59 +91,183 @@ void CondVarSemaphore::Fail(Status status) {
   absl::MutexLock lock(&mutex_);
   status_ = std::move(status);
   value_.store(UINT64_MAX, std::memory_order_release);
+  NotifyWaiters();
+}
+
+bool CondVarSemaphore::EnqueueWaiter(Waiter* waiter) {
+  absl::MutexLock lock(&mutex_);
+  if (!status_.ok() ||
+      value_.load(std::memory_order_acquire) >= waiter->value) {
+    return false;
+  }
+  auto it = std::upper_bound(
+      waiters_.begin(), waiters_.end(), waiter->value,
+      [](uint64_t value, const Waiter* other) { return value < other->value; });
+  waiters_.insert(it, waiter);
+  return true;
 }
 
+void CondVarSemaphore::RemoveWaiter(Waiter* waiter) {
+  absl::MutexLock lock(&mutex_);
+  auto it = std::find(waiters_.begin(), waiters_.end(), waiter);
+  if (it != waiters_.end()) {
+    waiters_.erase(it);
+  }
+}
+
+void CondVarSemaphore::NotifyWaiters() {
+  IREE_TRACE_SCOPE0("CondVarSemaphore::NotifyWaiters");
+
+  // Waiters are sorted so all of those that have been reached are at the
+  // front of the list. Those beyond are left sleeping.
+  uint64_t value = value_.load(std::memory_order_acquire);
+  auto end = std::upper_bound(waiters_.begin(), waiters_.end(), value,
+                              [](uint64_t value, const Waiter* waiter) {
+                                return value < waiter->value;
+                              });
+  for (auto it = waiters_.begin(); it != end; ++it) {
+    auto* waiter = *it;
+    if (waiter->group) {
+      // NOTE: the wait group may be destroyed as soon as its waiter has been
+      // removed from all semaphores; as that requires |mutex_| it is safe to
+      // use here.
+      waiter->group->Notify();
+    } else {
+#if defined(IREE_HAL_HOST_SEMAPHORE_EVENTFD)
+      ::eventfd_write(waiter->event_fd, 1);
+      ::close(waiter->event_fd);
+#endif  // IREE_HAL_HOST_SEMAPHORE_EVENTFD
+      delete waiter;
+    }
+  }
+  waiters_.erase(waiters_.begin(), end);
+}
+
+#if defined(IREE_HAL_HOST_SEMAPHORE_EVENTFD)
+StatusOr<int> CondVarSemaphore::ExportEventFd(uint64_t value) {
+  int event_fd = ::eventfd(0, EFD_CLOEXEC);
+  if (event_fd == -1) {
+    return ResourceExhaustedErrorBuilder(IREE_LOC)
+           << "Unable to create eventfd: " << std::strerror(errno);
+  }
+
+  // The semaphore keeps its own duplicate of the fd to signal so that the
+  // caller may close theirs at any time.
+  auto* waiter = new Waiter();
+  waiter->value = value;
+  waiter->event_fd = ::dup(event_fd);
+  if (waiter->event_fd == -1) {
+    delete waiter;
+    ::close(event_fd);
+    return ResourceExhaustedErrorBuilder(IREE_LOC)
+           << "Unable to duplicate eventfd: " << std::strerror(errno);
+  }
+  if (!EnqueueWaiter(waiter)) {
+    // Already reached (or failed); signal immediately.
+    ::eventfd_write(waiter->event_fd, 1);
+    ::close(waiter->event_fd);
+    delete waiter;
+  }
+  return event_fd;
+}
+#endif  // IREE_HAL_HOST_SEMAPHORE_EVENTFD
+
 // static
-Status CondVarSemaphore::WaitForSemaphores(
+StatusOr<int> CondVarSemaphore::WaitForSemaphores(
     absl::Span<const SemaphoreValue> semaphores, bool wait_all,
     Time deadline_ns) {
   IREE_TRACE_SCOPE0("CondVarSemaphore::WaitForSemaphores");
+  if (semaphores.empty()) return 0;
 
-  // Some of the semaphores may already be signaled; we only need to wait for
-  // those that are not yet at the expected value.
-  using CondVarSemaphoreValue = std::pair<CondVarSemaphore*, uint64_t>;
-  absl::InlinedVector<CondVarSemaphoreValue, 4> waitable_semaphores;
-  waitable_semaphores.reserve(semaphores.size());
+  // Fast path for when the wait is already satisfied and there's no need to
+  // register with any semaphore. Failed semaphores have reached UINT64_MAX.
+  size_t reached_count = 0;
   for (auto& semaphore_value : semaphores) {
     auto* semaphore =
         reinterpret_cast<CondVarSemaphore*>(semaphore_value.semaphore);
-    IREE_ASSIGN_OR_RETURN(uint64_t current_value, semaphore->Query());
-    if (current_value < semaphore_value.value) {
-      // Semaphore has not yet hit the required value; wait for it.
-      waitable_semaphores.push_back({semaphore, semaphore_value.value});
+    if (semaphore->value_.load(std::memory_order_acquire) >=
+        semaphore_value.value) {
+      ++reached_count;
     }
   }
+  bool reached = wait_all ? reached_count == semaphores.size()
+                          : reached_count > 0;
+
+  if (!reached) {
+    IREE_RETURN_IF_ERROR(WaitForWaitGroup(semaphores, wait_all, deadline_ns));
+  }
 
-  // TODO(benvanik): maybe sort semaphores by value in case we are waiting on
-  // multiple values from the same semaphore.
-
-  // Loop over the semaphores and wait for them to complete.
-  // TODO(b/140026716): add WaitHandle support for !wait_all (wait any).
-  for (auto& semaphore_value : waitable_semaphores) {
-    auto* semaphore = semaphore_value.first;
-    absl::MutexLock lock(&semaphore->mutex_);
-    if (!semaphore->mutex_.AwaitWithDeadline(
-            absl::Condition(
-                +[](CondVarSemaphoreValue* semaphore_value) {
-                  return semaphore_value->first->value_.load(
-                             std::memory_order_acquire) >=
-                         semaphore_value->second;
-                },
-                &semaphore_value),
-            absl::FromUnixNanos(static_cast<int64_t>(deadline_ns)))) {
-      return DeadlineExceededErrorBuilder(IREE_LOC)
-             << "Deadline exceeded waiting for semaphores";
+  // Failed semaphores wake their waiters; propagate the failure.
+  int first_reached_index = -1;
+  for (int i = 0; i < semaphores.size(); ++i) {
+    auto* semaphore =
+        reinterpret_cast<CondVarSemaphore*>(semaphores[i].semaphore);
+    uint64_t value = semaphore->value_.load(std::memory_order_acquire);
+    if (value == UINT64_MAX) {
+      IREE_RETURN_IF_ERROR(semaphore->Query().status());
+    }
+    if (first_reached_index == -1 && value >= semaphores[i].value) {
+      first_reached_index = i;
     }
-    if (!semaphore->status_.ok()) {
-      return semaphore->status_;
+  }
+  return wait_all ? 0 : first_reached_index;
+}
+
+// static
+Status CondVarSemaphore::WaitForWaitGroup(
+    absl::Span<const SemaphoreValue> semaphores, bool wait_all,
+    Time deadline_ns) {
+  WaitGroup group;
+  {
+    absl::MutexLock lock(&group.mutex);
+    group.remaining = wait_all ? static_cast<int>(semaphores.size()) : 1;
+  }
+
+  // Register with each semaphore that has not yet reached its value. Some may
+  // already be signaled and count towards the wait immediately; when waiting
+  // for any we can stop as soon as one has been reached.
+  absl::InlinedVector<Waiter, 4> waiters(semaphores.size());
+  absl::InlinedVector<std::pair<CondVarSemaphore*, Waiter*>, 4>
+      enqueued_waiters;
+  for (size_t i = 0; i < semaphores.size(); ++i) {
+    auto* semaphore =
+        reinterpret_cast<CondVarSemaphore*>(semaphores[i].semaphore);
+    auto& waiter = waiters[i];
+    waiter.value = semaphores[i].value;
+    waiter.group = &group;
+    if (semaphore->EnqueueWaiter(&waiter)) {
+      enqueued_waiters.push_back({semaphore, &waiter});
+      continue;
     }
+    group.Notify();
+    if (!wait_all) break;
   }
 
+  bool reached = false;
+  {
+    absl::MutexLock lock(&group.mutex);
+    reached = group.mutex.AwaitWithDeadline(
+        absl::Condition(
+            +[](int* remaining) { return *remaining <= 0; }, &group.remaining),
+        absl::FromUnixNanos(static_cast<int64_t>(deadline_ns)));
+  }
+
+  // Unregister any waiters that were not notified. This also ensures that no
+  // signaling thread is still referencing the wait group.
+  for (auto& enqueued_waiter : enqueued_waiters) {
+    enqueued_waiter.first->RemoveWaiter(enqueued_waiter.second);
+  }
+
+  if (!reached) {
+    return DeadlineExceededErrorBuilder(IREE_LOC)
+           << "Deadline exceeded waiting for semaphores";
+  }
   return OkStatus();
 }
 
 Status CondVarSemaphore::Wait(uint64_t value, Time deadline_ns) {
-  return WaitForSemaphores({{this, value}}, /*wait_all=*/true, deadline_ns);
+  return WaitForSemaphores({{this, value}}, /*wait_all=*/true, deadline_ns)
+      .status();
 }
 
 }  // namespace host
@@ -19,25 +19,40 @@
 #include <cstdint>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
+#include "iree/base/target_platform.h"
 #include "iree/hal/semaphore.h"
 
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+#define IREE_HAL_HOST_SEMAPHORE_EVENTFD 1
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
 namespace iree {
 namespace hal {
 namespace host {
 
-// Simple host-only semaphore semaphore implemented with a mutex.
-// Uses a condition variable to track the current value.
+// Simple host-only timeline semaphore implemented with a mutex.
+//
+// Waiters register themselves in a list sorted by the value they are waiting
+// for and each signal only wakes the waiters whose value has been reached.
+// Waiters block on their own wait group instead of the semaphore so that
+// signaling does not cause all waiters to wake and recheck their conditions.
+// A single wait group may be registered with multiple semaphores to wait on
+// all or any of them.
 //
 // Thread-safe (as instances may be imported and used by others).
 class CondVarSemaphore final : public Semaphore {
  public:
   // Waits for one or more (or all) semaphores to reach or exceed the given
   // values.
-  static Status WaitForSemaphores(absl::Span<const SemaphoreValue> semaphores,
-                                  bool wait_all, Time deadline_ns);
+  // Returns the index of the first semaphore in |semaphores| that has reached
+  // its value. When |wait_all| is true all have and 0 is returned.
+  static StatusOr<int> WaitForSemaphores(
+      absl::Span<const SemaphoreValue> semaphores, bool wait_all,
+      Time deadline_ns);
 
   explicit CondVarSemaphore(uint64_t initial_value);
   ~CondVarSemaphore() override;
@@ -48,16 +63,53 @@ class CondVarSemaphore final : public Semaphore {
   void Fail(Status status) override;
   Status Wait(uint64_t value, Time deadline_ns) override;
 
+#if defined(IREE_HAL_HOST_SEMAPHORE_EVENTFD)
+  // Returns a new eventfd that becomes readable when the semaphore reaches or
+  // exceeds |value| or fails. This allows waiting on the semaphore alongside
+  // other file descriptors with poll/epoll.
+  //
+  // The caller takes ownership of the returned file descriptor and must close
+  // it when no longer required.
+  StatusOr<int> ExportEventFd(uint64_t value);
+#endif  // IREE_HAL_HOST_SEMAPHORE_EVENTFD
+
  private:
+  struct WaitGroup;
+
+  // A pending wait for the semaphore to reach |value|.
+  // Exactly one of |group| or |event_fd| is set.
+  struct Waiter {
+    uint64_t value = 0;
+    WaitGroup* group = nullptr;
+    int event_fd = -1;
+  };
+
+  // Registers a wait group with all |semaphores| and blocks until it has been
+  // notified by all (or any) of them or |deadline_ns| elapses.
+  static Status WaitForWaitGroup(absl::Span<const SemaphoreValue> semaphores,
+                                 bool wait_all, Time deadline_ns);
+
+  // Inserts |waiter| into the sorted waiter list.
+  // Returns false if the semaphore has already reached the waiter's value (or
+  // failed) and the waiter was not inserted.
+  bool EnqueueWaiter(Waiter* waiter);
+
+  // Removes |waiter| from the waiter list if it has not yet been notified.
+  void RemoveWaiter(Waiter* waiter);
+
+  // Notifies and removes all waiters whose value has been reached.
+  void NotifyWaiters() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // The mutex is not required to query the value; this lets us quickly check if
   // a required value has been exceeded. The mutex is only used to update and
   // notify waiters.
   std::atomic<uint64_t> value_{0};
 
-  // We have a full mutex here so that we can perform condvar waits on value
-  // changes.
   mutable absl::Mutex mutex_;
   Status status_ ABSL_GUARDED_BY(mutex_);
+
+  // Pending waiters sorted by ascending value.
+  absl::InlinedVector<Waiter*, 4> waiters_ ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace host
@@ -0,0 +1,115 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/logging.h"
+#include "iree/base/status.h"
+#include "iree/hal/host/condvar_semaphore.h"
+
+namespace {
+
+using iree::InfiniteFuture;
+using iree::hal::SemaphoreValue;
+using iree::hal::host::CondVarSemaphore;
+
+// Signals a semaphore that has no waiters.
+void BM_SignalNoWaiters(benchmark::State& state) {
+  CondVarSemaphore semaphore(0u);
+  uint64_t value = 0;
+  for (auto _ : state) {
+    IREE_CHECK_OK(semaphore.Signal(++value));
+  }
+}
+BENCHMARK(BM_SignalNoWaiters);
+
+// Waits on a semaphore that has already reached the value.
+void BM_WaitAlreadySignaled(benchmark::State& state) {
+  CondVarSemaphore semaphore(1u);
+  for (auto _ : state) {
+    IREE_CHECK_OK(semaphore.Wait(1u, InfiniteFuture()));
+  }
+}
+BENCHMARK(BM_WaitAlreadySignaled);
+
+// Round-trips between two threads with a pair of semaphores.
+void BM_PingPong(benchmark::State& state) {
+  CondVarSemaphore ping(0u);
+  CondVarSemaphore pong(0u);
+  const uint64_t iteration_count = state.max_iterations;
+  std::thread thread([&]() {
+    for (uint64_t value = 1; value <= iteration_count; ++value) {
+      IREE_CHECK_OK(ping.Wait(value, InfiniteFuture()));
+      IREE_CHECK_OK(pong.Signal(value));
+    }
+  });
+  uint64_t value = 0;
+  for (auto _ : state) {
+    IREE_CHECK_OK(ping.Signal(++value));
+    IREE_CHECK_OK(pong.Wait(value, InfiniteFuture()));
+  }
+  thread.join();
+}
+BENCHMARK(BM_PingPong)->UseRealTime();
+
+// Advances a semaphore one value at a time while many threads each wait for
+// a different value. Only the thread waiting for the signaled value should
+// wake; the others remain asleep.
+void BM_SignalManyWaiters(benchmark::State& state) {
+  const int waiter_count = state.range(0);
+  for (auto _ : state) {
+    CondVarSemaphore semaphore(0u);
+    std::vector<std::thread> threads;
+    threads.reserve(waiter_count);
+    for (int i = 1; i <= waiter_count; ++i) {
+      threads.emplace_back([&semaphore, i]() {
+        IREE_CHECK_OK(semaphore.Wait(i, InfiniteFuture()));
+      });
+    }
+    for (int i = 1; i <= waiter_count; ++i) {
+      IREE_CHECK_OK(semaphore.Signal(i));
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * waiter_count);
+}
+BENCHMARK(BM_SignalManyWaiters)->Arg(4)->Arg(16)->Arg(64)->UseRealTime();
+
+// Waits for any of many semaphores where only the last one is signaled.
+void BM_WaitAnyOfMany(benchmark::State& state) {
+  const int semaphore_count = state.range(0);
+  std::vector<std::unique_ptr<CondVarSemaphore>> semaphores;
+  std::vector<SemaphoreValue> semaphore_values;
+  for (int i = 0; i < semaphore_count; ++i) {
+    semaphores.push_back(std::make_unique<CondVarSemaphore>(0u));
+    semaphore_values.push_back({semaphores.back().get(), 1u});
+  }
+  uint64_t value = 0;
+  for (auto _ : state) {
+    semaphore_values.back().value = ++value;
+    IREE_CHECK_OK(semaphores.back()->Signal(value));
+    IREE_CHECK_OK(CondVarSemaphore::WaitForSemaphores(
+                      semaphore_values, /*wait_all=*/false, InfiniteFuture())
+                      .status());
+  }
+}
+BENCHMARK(BM_WaitAnyOfMany)->Arg(1)->Arg(8)->Arg(64);
+
+}  // namespace
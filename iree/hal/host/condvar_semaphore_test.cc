@@ -14,13 +14,20 @@
 
 #include "iree/hal/host/condvar_semaphore.h"
 
+#include <atomic>
 #include <cstdint>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "iree/base/status.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
+#if defined(IREE_HAL_HOST_SEMAPHORE_EVENTFD)
+#include <poll.h>
+#include <unistd.h>
+#endif  // IREE_HAL_HOST_SEMAPHORE_EVENTFD
+
 namespace iree {
 namespace hal {
 namespace host {
@@ -89,8 +96,10 @@ TEST(CondVarSemaphoreTest, WaitAlreadySignaled) {
 TEST(CondVarSemaphoreTest, WaitUnsignaled) {
   CondVarSemaphore semaphore(2u);
   // NOTE: we don't actually block here because otherwise we'd lock up.
-  EXPECT_TRUE(IsDeadlineExceeded(CondVarSemaphore::WaitForSemaphores(
-      {{&semaphore, 3u}}, /*wait_all=*/true, InfinitePast())));
+  EXPECT_TRUE(IsDeadlineExceeded(
+      CondVarSemaphore::WaitForSemaphores({{&semaphore, 3u}},
+                                          /*wait_all=*/true, InfinitePast())
+          .status()));
 }
 
 // Tests waiting on a failed semaphore (it should return the error on the
@@ -98,8 +107,10 @@ TEST(CondVarSemaphoreTest, WaitUnsignaled) {
 TEST(CondVarSemaphoreTest, WaitAlreadyFailed) {
   CondVarSemaphore semaphore(2u);
   semaphore.Fail(UnknownErrorBuilder(IREE_LOC));
-  EXPECT_TRUE(IsUnknown(CondVarSemaphore::WaitForSemaphores(
-      {{&semaphore, 2u}}, /*wait_all=*/true, InfinitePast())));
+  EXPECT_TRUE(IsUnknown(
+      CondVarSemaphore::WaitForSemaphores({{&semaphore, 2u}},
+                                          /*wait_all=*/true, InfinitePast())
+          .status()));
 }
 
 // Tests threading behavior by ping-ponging between the test main thread and
@@ -129,8 +140,10 @@ TEST(CondVarSemaphoreTest, FailNotifies) {
   bool got_failure = false;
   std::thread thread([&]() {
     IREE_ASSERT_OK(b2a.Signal(1u));
-    got_failure = IsUnknown(CondVarSemaphore::WaitForSemaphores(
-        {{&a2b, 1u}}, /*wait_all=*/true, InfiniteFuture()));
+    got_failure = IsUnknown(
+        CondVarSemaphore::WaitForSemaphores({{&a2b, 1u}}, /*wait_all=*/true,
+                                            InfiniteFuture())
+            .status());
   });
   IREE_ASSERT_OK(CondVarSemaphore::WaitForSemaphores(
       {{&b2a, 1u}}, /*wait_all=*/true, InfiniteFuture()));
@@ -139,6 +152,115 @@ TEST(CondVarSemaphoreTest, FailNotifies) {
   ASSERT_TRUE(got_failure);
 }
 
+
+// Tests waiting on any of multiple semaphores returns when only one of them
+// has been signaled.
+TEST(CondVarSemaphoreTest, WaitAny) {
+  CondVarSemaphore a(0u);
+  CondVarSemaphore b(0u);
+  std::thread thread([&]() { IREE_ASSERT_OK(b.Signal(1u)); });
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int index, CondVarSemaphore::WaitForSemaphores({{&a, 1u}, {&b, 1u}},
+                                                     /*wait_all=*/false,
+                                                     InfiniteFuture()));
+  thread.join();
+  EXPECT_EQ(1, index);
+  EXPECT_EQ(0u, a.Query().value());
+  // Waiting for all must not be satisfied by the single signaled semaphore.
+  EXPECT_TRUE(IsDeadlineExceeded(
+      CondVarSemaphore::WaitForSemaphores({{&a, 1u}, {&b, 1u}},
+                                          /*wait_all=*/true, InfinitePast())
+          .status()));
+}
+
+// Tests waiting on all of multiple semaphores signaled from another thread.
+TEST(CondVarSemaphoreTest, WaitAll) {
+  CondVarSemaphore a(0u);
+  CondVarSemaphore b(0u);
+  std::thread thread([&]() {
+    IREE_ASSERT_OK(a.Signal(1u));
+    IREE_ASSERT_OK(b.Signal(2u));
+  });
+  IREE_ASSERT_OK(CondVarSemaphore::WaitForSemaphores(
+      {{&a, 1u}, {&b, 2u}}, /*wait_all=*/true, InfiniteFuture()));
+  thread.join();
+}
+
+// Tests that waiters for different values are only woken once their own value
+// has been reached.
+TEST(CondVarSemaphoreTest, WaitersWokenInOrder) {
+  CondVarSemaphore semaphore(0u);
+  std::vector<std::thread> threads;
+  std::atomic<int> woken_count{0};
+  for (uint64_t value = 1; value <= 4; ++value) {
+    threads.emplace_back([&, value]() {
+      IREE_ASSERT_OK(semaphore.Wait(value, InfiniteFuture()));
+      EXPECT_GE(semaphore.Query().value(), value);
+      ++woken_count;
+    });
+  }
+  for (uint64_t value = 1; value <= 4; ++value) {
+    IREE_ASSERT_OK(semaphore.Signal(value));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(4, woken_count);
+}
+
+// Tests that a timed out wait unregisters itself and later signals succeed.
+TEST(CondVarSemaphoreTest, WaitTimeoutUnregisters) {
+  CondVarSemaphore semaphore(0u);
+  EXPECT_TRUE(IsDeadlineExceeded(
+      semaphore.Wait(1u, RelativeTimeoutToDeadlineNanos(Duration(1000000)))));
+  IREE_EXPECT_OK(semaphore.Signal(1u));
+  IREE_EXPECT_OK(semaphore.Wait(1u, InfinitePast()));
+}
+
+// Tests that failure wakes waiters of a wait-any.
+TEST(CondVarSemaphoreTest, WaitAnyFailNotifies) {
+  CondVarSemaphore a(0u);
+  CondVarSemaphore b(0u);
+  std::thread thread([&]() { a.Fail(UnknownErrorBuilder(IREE_LOC)); });
+  EXPECT_TRUE(IsUnknown(
+      CondVarSemaphore::WaitForSemaphores({{&a, 1u}, {&b, 1u}},
+                                          /*wait_all=*/false, InfiniteFuture())
+          .status()));
+  thread.join();
+}
+
+#if defined(IREE_HAL_HOST_SEMAPHORE_EVENTFD)
+
+// Returns true if |fd| is readable without blocking.
+bool IsEventFdSignaled(int fd) {
+  struct pollfd poll_fd = {fd, POLLIN, 0};
+  return ::poll(&poll_fd, 1, /*timeout=*/0) == 1;
+}
+
+// Tests that exported eventfds are signaled when their value is reached.
+TEST(CondVarSemaphoreTest, ExportEventFd) {
+  CondVarSemaphore semaphore(1u);
+  IREE_ASSERT_OK_AND_ASSIGN(int signaled_fd, semaphore.ExportEventFd(1u));
+  IREE_ASSERT_OK_AND_ASSIGN(int pending_fd_2, semaphore.ExportEventFd(2u));
+  IREE_ASSERT_OK_AND_ASSIGN(int pending_fd_3, semaphore.ExportEventFd(3u));
+  EXPECT_TRUE(IsEventFdSignaled(signaled_fd));
+  EXPECT_FALSE(IsEventFdSignaled(pending_fd_2));
+  EXPECT_FALSE(IsEventFdSignaled(pending_fd_3));
+
+  IREE_ASSERT_OK(semaphore.Signal(2u));
+  EXPECT_TRUE(IsEventFdSignaled(pending_fd_2));
+  EXPECT_FALSE(IsEventFdSignaled(pending_fd_3));
+
+  semaphore.Fail(UnknownErrorBuilder(IREE_LOC));
+  EXPECT_TRUE(IsEventFdSignaled(pending_fd_3));
+
+  ::close(signaled_fd);
+  ::close(pending_fd_2);
+  ::close(pending_fd_3);
+}
+
+#endif  // IREE_HAL_HOST_SEMAPHORE_EVENTFD
+
 }  // namespace
 }  // namespace host
 }  // namespace hal
@@ -0,0 +1,172 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/dag/dag_command_processor.h"
+
+#include <cstring>
+
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+DagCommandProcessor::DagCommandProcessor(
+    CommandCategoryBitfield command_categories, WorkStealingPool* pool)
+    : ParallelCommandProcessor(command_categories, pool), pool_(pool) {}
+
+DagCommandProcessor::~DagCommandProcessor() = default;
+
+Status DagCommandProcessor::End() {
+  IREE_TRACE_SCOPE0("DagCommandProcessor::End");
+  IREE_RETURN_IF_ERROR(FlushSegment());
+  return ParallelCommandProcessor::End();
+}
+
+Status DagCommandProcessor::ExecutionBarrier(
+    ExecutionStageBitfield source_stage_mask,
+    ExecutionStageBitfield target_stage_mask,
+    absl::Span<const MemoryBarrier> memory_barriers,
+    absl::Span<const BufferBarrier> buffer_barriers) {
+  IREE_TRACE_SCOPE0("DagCommandProcessor::ExecutionBarrier");
+  return FlushSegment();
+}
+
+Status DagCommandProcessor::WaitEvents(
+    absl::Span<Event*> events, ExecutionStageBitfield source_stage_mask,
+    ExecutionStageBitfield target_stage_mask,
+    absl::Span<const MemoryBarrier> memory_barriers,
+    absl::Span<const BufferBarrier> buffer_barriers) {
+  IREE_TRACE_SCOPE0("DagCommandProcessor::WaitEvents");
+  // Events are not tracked (see NopEvent) so conservatively treat waits as a
+  // full barrier.
+  return FlushSegment();
+}
+
+Status DagCommandProcessor::FillBuffer(Buffer* target_buffer,
+                                       device_size_t target_offset,
+                                       device_size_t length,
+                                       const void* pattern,
+                                       size_t pattern_length) {
+  IREE_TRACE_SCOPE0("DagCommandProcessor::FillBuffer");
+  DeferredCommand command;
+  if (pattern_length > command.pattern.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Fill patterns must be 1, 2, or 4 bytes (got "
+           << pattern_length << ")";
+  }
+  command.type = DeferredCommand::Type::kFillBuffer;
+  command.target_buffer = target_buffer;
+  command.target_offset = target_offset;
+  command.length = length;
+  std::memcpy(command.pattern.data(), pattern, pattern_length);
+  command.pattern_length = pattern_length;
+  segment_.push_back(std::move(command));
+  return OkStatus();
+}
+
+Status DagCommandProcessor::UpdateBuffer(const void* source_buffer,
+                                         device_size_t source_offset,
+                                         Buffer* target_buffer,
+                                         device_size_t target_offset,
+                                         device_size_t length) {
+  IREE_TRACE_SCOPE0("DagCommandProcessor::UpdateBuffer");
+  DeferredCommand command;
+  command.type = DeferredCommand::Type::kUpdateBuffer;
+  command.source_data =
+      static_cast<const uint8_t*>(source_buffer) + source_offset;
+  command.target_buffer = target_buffer;
+  command.target_offset = target_offset;
+  command.length = length;
+  segment_.push_back(std::move(command));
+  return OkStatus();
+}
+
+Status DagCommandProcessor::CopyBuffer(Buffer* source_buffer,
+                                       device_size_t source_offset,
+                                       Buffer* target_buffer,
+                                       device_size_t target_offset,
+                                       device_size_t length) {
+  IREE_TRACE_SCOPE0("DagCommandProcessor::CopyBuffer");
+  DeferredCommand command;
+  command.type = DeferredCommand::Type::kCopyBuffer;
+  command.source_buffer = source_buffer;
+  command.source_offset = source_offset;
+  command.target_buffer = target_buffer;
+  command.target_offset = target_offset;
+  command.length = length;
+  segment_.push_back(std::move(command));
+  return OkStatus();
+}
+
+Status DagCommandProcessor::DispatchTiles(
+    HostExecutable* executable, HostExecutable::DispatchState* dispatch_state,
+    std::array<uint32_t, 3> workgroup_count) {
+  IREE_TRACE_SCOPE0("DagCommandProcessor::DispatchTiles");
+  // The dispatch state captures the push constants and bindings at the time
+  // of the dispatch so later state changes in the segment don't affect it.
+  DeferredCommand command;
+  command.type = DeferredCommand::Type::kDispatch;
+  command.executable = executable;
+  command.dispatch_state = add_ref(dispatch_state);
+  command.workgroup_count = workgroup_count;
+  segment_.push_back(std::move(command));
+  return OkStatus();
+}
+
+Status DagCommandProcessor::RunCommand(const DeferredCommand& command) {
+  switch (command.type) {
+    case DeferredCommand::Type::kFillBuffer:
+      return ParallelCommandProcessor::FillBuffer(
+          command.target_buffer, command.target_offset, command.length,
+          command.pattern.data(), command.pattern_length);
+    case DeferredCommand::Type::kUpdateBuffer:
+      return command.target_buffer->WriteData(
+          command.target_offset, command.source_data, command.length);
+    case DeferredCommand::Type::kCopyBuffer:
+      return ParallelCommandProcessor::CopyBuffer(
+          command.source_buffer, command.source_offset, command.target_buffer,
+          command.target_offset, command.length);
+    case DeferredCommand::Type::kDispatch:
+      return ParallelCommandProcessor::DispatchTiles(
+          command.executable, command.dispatch_state.get(),
+          command.workgroup_count);
+  }
+  return UnimplementedErrorBuilder(IREE_LOC) << "Unhandled deferred command";
+}
+
+Status DagCommandProcessor::FlushSegment() {
+  IREE_TRACE_SCOPE0("DagCommandProcessor::FlushSegment");
+  Status status;
+  if (segment_.size() == 1) {
+    // Nothing to overlap with; the dispatch (if any) still runs its tiles
+    // across the pool.
+    status = RunCommand(segment_.front());
+  } else if (!segment_.empty()) {
+    status = pool_->ParallelFor(
+        static_cast<uint32_t>(segment_.size()), /*min_chunk_size=*/1,
+        [this](uint32_t begin, uint32_t end) -> Status {
+          for (uint32_t i = begin; i < end; ++i) {
+            IREE_RETURN_IF_ERROR(RunCommand(segment_[i]));
+          }
+          return OkStatus();
+        });
+  }
+  segment_.clear();
+  return status;
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
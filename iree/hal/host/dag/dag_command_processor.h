@@ -0,0 +1,123 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_DAG_DAG_COMMAND_PROCESSOR_H_
+#define IREE_HAL_HOST_DAG_DAG_COMMAND_PROCESSOR_H_
+
+#include "absl/container/inlined_vector.h"
+#include "iree/hal/host/parallel/parallel_command_processor.h"
+#include "iree/hal/host/parallel/work_stealing_pool.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Host-local command processor that runs the commands between execution
+// barriers concurrently.
+//
+// Transfer and dispatch commands are deferred into the current segment as they
+// are processed. When a barrier (ExecutionBarrier or WaitEvents) or the end of
+// the command buffer is reached all commands in the segment are issued to the
+// WorkStealingPool together, with dispatch tiles and large transfers further
+// split across the pool as with ParallelCommandProcessor. Commands that the
+// compiler recorded without an intervening barrier have no hazards between them
+// and so may run in any order.
+//
+// Thread-compatible (as with CommandBuffer itself).
+class DagCommandProcessor final : public ParallelCommandProcessor {
+ public:
+  DagCommandProcessor(CommandCategoryBitfield command_categories,
+                      WorkStealingPool* pool);
+  ~DagCommandProcessor() override;
+
+  Status End() override;
+
+  Status ExecutionBarrier(
+      ExecutionStageBitfield source_stage_mask,
+      ExecutionStageBitfield target_stage_mask,
+      absl::Span<const MemoryBarrier> memory_barriers,
+      absl::Span<const BufferBarrier> buffer_barriers) override;
+
+  Status WaitEvents(absl::Span<Event*> events,
+                    ExecutionStageBitfield source_stage_mask,
+                    ExecutionStageBitfield target_stage_mask,
+                    absl::Span<const MemoryBarrier> memory_barriers,
+                    absl::Span<const BufferBarrier> buffer_barriers) override;
+
+  Status FillBuffer(Buffer* target_buffer, device_size_t target_offset,
+                    device_size_t length, const void* pattern,
+                    size_t pattern_length) override;
+
+  Status UpdateBuffer(const void* source_buffer, device_size_t source_offset,
+                      Buffer* target_buffer, device_size_t target_offset,
+                      device_size_t length) override;
+
+  Status CopyBuffer(Buffer* source_buffer, device_size_t source_offset,
+                    Buffer* target_buffer, device_size_t target_offset,
+                    device_size_t length) override;
+
+ protected:
+  Status DispatchTiles(HostExecutable* executable,
+                       HostExecutable::DispatchState* dispatch_state,
+                       std::array<uint32_t, 3> workgroup_count) override;
+
+ private:
+  // A command deferred until the end of the current segment.
+  // Referenced buffers and update data are owned by the command buffer being
+  // processed and remain valid as segments are always flushed before End.
+  struct DeferredCommand {
+    enum class Type {
+      kFillBuffer,
+      kUpdateBuffer,
+      kCopyBuffer,
+      kDispatch,
+    };
+    Type type;
+
+    Buffer* target_buffer = nullptr;
+    device_size_t target_offset = 0;
+    device_size_t length = 0;
+
+    // kFillBuffer:
+    std::array<uint8_t, 4> pattern;
+    size_t pattern_length = 0;
+
+    // kUpdateBuffer:
+    const uint8_t* source_data = nullptr;
+
+    // kCopyBuffer:
+    Buffer* source_buffer = nullptr;
+    device_size_t source_offset = 0;
+
+    // kDispatch:
+    HostExecutable* executable = nullptr;
+    ref_ptr<HostExecutable::DispatchState> dispatch_state;
+    std::array<uint32_t, 3> workgroup_count;
+  };
+
+  // Runs a single deferred command.
+  Status RunCommand(const DeferredCommand& command);
+
+  // Runs all commands in the current segment and waits for them to complete.
+  Status FlushSegment();
+
+  WorkStealingPool* pool_;
+  absl::InlinedVector<DeferredCommand, 8> segment_;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_DAG_DAG_COMMAND_PROCESSOR_H_
@@ -0,0 +1,195 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iree/hal/host/dag/dag_command_processor.h"
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "iree/base/status.h"
+#include "iree/hal/heap_buffer.h"
+#include "iree/hal/host/host_executable.h"
+#include "iree/hal/host/parallel/work_stealing_pool.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// Executable that calls |tile_fn| with the entry point of each dispatched tile.
+class TestExecutable final : public HostExecutable {
+ public:
+  using TileFn = std::function<Status(int32_t entry_point,
+                                      std::array<uint32_t, 3> workgroup_xyz)>;
+
+  explicit TestExecutable(TileFn tile_fn) : tile_fn_(std::move(tile_fn)) {}
+
+  bool supports_debugging() const override { return false; }
+
+  StatusOr<ref_ptr<DispatchState>> PrepareDispatch(
+      const DispatchParams& params) override {
+    auto dispatch_state = make_ref<TestDispatchState>();
+    dispatch_state->entry_point = params.entry_point;
+    return dispatch_state;
+  }
+
+  Status DispatchTile(DispatchState* state,
+                      std::array<uint32_t, 3> workgroup_xyz) override {
+    return tile_fn_(static_cast<TestDispatchState*>(state)->entry_point,
+                    workgroup_xyz);
+  }
+
+ private:
+  struct TestDispatchState : public DispatchState {
+    int32_t entry_point = 0;
+  };
+
+  TileFn tile_fn_;
+};
+
+class DagCommandProcessorTest : public ::testing::Test {
+ protected:
+  DagCommandProcessorTest()
+      : pool_(/*worker_count=*/4),
+        command_processor_(
+            CommandCategory::kTransfer | CommandCategory::kDispatch, &pool_) {}
+
+  WorkStealingPool pool_;
+  DagCommandProcessor command_processor_;
+};
+
+// Tests that commands not separated by a barrier run concurrently. Each
+// dispatch blocks until all of them have started so this would time out if
+// they were run one after another.
+TEST_F(DagCommandProcessorTest, CommandsWithinSegmentRunConcurrently) {
+  constexpr int kDispatchCount = 3;
+  absl::Mutex mutex;
+  int started_count = 0;
+  auto executable = make_ref<TestExecutable>(
+      [&](int32_t entry_point,
+          std::array<uint32_t, 3> workgroup_xyz) -> Status {
+        absl::MutexLock lock(&mutex);
+        ++started_count;
+        auto all_started = [&]() { return started_count == kDispatchCount; };
+        if (!mutex.AwaitWithTimeout(absl::Condition(&all_started),
+                                    absl::Seconds(10))) {
+          return DeadlineExceededErrorBuilder(IREE_LOC)
+                 << "Dispatch " << entry_point << " ran alone";
+        }
+        return OkStatus();
+      });
+
+  IREE_ASSERT_OK(command_processor_.Begin());
+  for (int i = 0; i < kDispatchCount; ++i) {
+    IREE_ASSERT_OK(command_processor_.Dispatch(executable.get(), i, {1, 1, 1}));
+  }
+  IREE_ASSERT_OK(command_processor_.End());
+  EXPECT_EQ(kDispatchCount, started_count);
+}
+
+// Tests that commands after a barrier only start once all commands before it
+// have completed.
+TEST_F(DagCommandProcessorTest, BarrierOrdersSegments) {
+  constexpr int kTileCount = 16;
+  std::atomic<int> completed_count{0};
+  auto executable = make_ref<TestExecutable>(
+      [&](int32_t entry_point,
+          std::array<uint32_t, 3> workgroup_xyz) -> Status {
+        int segment = entry_point / 2;
+        if (completed_count.load() < segment * 2 * kTileCount) {
+          return FailedPreconditionErrorBuilder(IREE_LOC)
+                 << "Dispatch " << entry_point
+                 << " started before the barrier";
+        }
+        absl::SleepFor(absl::Milliseconds(1));
+        ++completed_count;
+        return OkStatus();
+      });
+
+  // Two segments of two dispatches each.
+  IREE_ASSERT_OK(command_processor_.Begin());
+  IREE_ASSERT_OK(
+      command_processor_.Dispatch(executable.get(), 0, {kTileCount, 1, 1}));
+  IREE_ASSERT_OK(
+      command_processor_.Dispatch(executable.get(), 1, {kTileCount, 1, 1}));
+  IREE_ASSERT_OK(command_processor_.ExecutionBarrier(
+      ExecutionStage::kCommandRetire, ExecutionStage::kCommandIssue, {}, {}));
+  IREE_ASSERT_OK(
+      command_processor_.Dispatch(executable.get(), 2, {kTileCount, 1, 1}));
+  IREE_ASSERT_OK(
+      command_processor_.Dispatch(executable.get(), 3, {kTileCount, 1, 1}));
+  IREE_ASSERT_OK(command_processor_.End());
+  EXPECT_EQ(4 * kTileCount, completed_count.load());
+}
+
+// Tests segments whose commands themselves split across the pool: multi-tile
+// dispatches alongside fills and copies large enough to be processed in
+// blocks. These issue ParallelFor calls from within pool workers.
+TEST_F(DagCommandProcessorTest, NestedParallelCommands) {
+  constexpr int kTileCount = 64;
+  constexpr device_size_t kTransferLength = 8 * 1024 * 1024;
+  std::atomic<int> tile_count{0};
+  auto executable = make_ref<TestExecutable>(
+      [&](int32_t entry_point,
+          std::array<uint32_t, 3> workgroup_xyz) -> Status {
+        ++tile_count;
+        return OkStatus();
+      });
+  auto source_buffer = HeapBuffer::Allocate(
+      BufferUsage::kTransfer | BufferUsage::kMapping, kTransferLength);
+  auto fill_buffer = HeapBuffer::Allocate(
+      BufferUsage::kTransfer | BufferUsage::kMapping, kTransferLength);
+  auto copy_buffer = HeapBuffer::Allocate(
+      BufferUsage::kTransfer | BufferUsage::kMapping, kTransferLength);
+  std::vector<uint8_t> source_data(kTransferLength);
+  for (size_t i = 0; i < source_data.size(); ++i) {
+    source_data[i] = static_cast<uint8_t>(i * 7);
+  }
+  IREE_ASSERT_OK(
+      source_buffer->WriteData(0, source_data.data(), source_data.size()));
+
+  uint32_t pattern = 0xCAFEF00Du;
+  IREE_ASSERT_OK(command_processor_.Begin());
+  IREE_ASSERT_OK(
+      command_processor_.Dispatch(executable.get(), 0, {kTileCount, 1, 1}));
+  IREE_ASSERT_OK(command_processor_.FillBuffer(
+      fill_buffer.get(), 0, kTransferLength, &pattern, sizeof(pattern)));
+  IREE_ASSERT_OK(command_processor_.CopyBuffer(
+      source_buffer.get(), 0, copy_buffer.get(), 0, kTransferLength));
+  IREE_ASSERT_OK(command_processor_.Dispatch(executable.get(), 1, {8, 8, 1}));
+  IREE_ASSERT_OK(command_processor_.End());
+  EXPECT_EQ(2 * kTileCount, tile_count.load());
+
+  std::vector<uint32_t> fill_data(kTransferLength / sizeof(uint32_t));
+  IREE_ASSERT_OK(fill_buffer->ReadData(0, fill_data.data(), kTransferLength));
+  for (size_t i = 0; i < fill_data.size(); ++i) {
+    ASSERT_EQ(pattern, fill_data[i]) << "at element " << i;
+  }
+  std::vector<uint8_t> copy_data(kTransferLength);
+  IREE_ASSERT_OK(copy_buffer->ReadData(0, copy_data.data(), kTransferLength));
+  EXPECT_EQ(source_data, copy_data);
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
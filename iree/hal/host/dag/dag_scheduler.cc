@@ -0,0 +1,277 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/dag/dag_scheduler.h"
+
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+DagScheduler::DagScheduler(int executor_count, ExecuteFn execute_fn)
+    : execute_fn_(std::move(execute_fn)) {
+  IREE_TRACE_SCOPE0("DagScheduler::ctor");
+  executor_count = std::max(1, executor_count);
+  scheduler_thread_ = std::thread([this]() { SchedulerMain(); });
+  executor_threads_.reserve(executor_count);
+  for (int i = 0; i < executor_count; ++i) {
+    executor_threads_.emplace_back([this]() { ExecutorMain(); });
+  }
+}
+
+DagScheduler::~DagScheduler() {
+  IREE_TRACE_SCOPE0("DagScheduler::dtor");
+  {
+    // Nodes that can still make progress are allowed to complete; the
+    // scheduler thread fails any left blocked once nothing else is running.
+    absl::MutexLock lock(&mutex_);
+    shutdown_ = true;
+    WakeScheduler();
+  }
+  scheduler_thread_.join();
+  for (auto& thread : executor_threads_) {
+    thread.join();
+  }
+
+  absl::MutexLock lock(&mutex_);
+  IREE_CHECK(blocked_nodes_.empty() && ready_nodes_.empty())
+      << "Dirty shutdown of DAG scheduler (unexpected thread exit?)";
+}
+
+Status DagScheduler::Enqueue(absl::Span<const SubmissionBatch> batches) {
+  IREE_TRACE_SCOPE0("DagScheduler::Enqueue");
+  absl::MutexLock lock(&mutex_);
+  if (shutdown_) {
+    return FailedPreconditionErrorBuilder(IREE_LOC)
+           << "Cannot enqueue new submissions; scheduler is exiting";
+  } else if (!permanent_error_.ok()) {
+    return permanent_error_;
+  }
+
+  bool any_blocked = false;
+  for (const auto& batch : batches) {
+    auto node = absl::make_unique<Node>();
+    node->wait_semaphores = {batch.wait_semaphores.begin(),
+                             batch.wait_semaphores.end()};
+    node->command_buffers = {batch.command_buffers.begin(),
+                             batch.command_buffers.end()};
+    node->signal_semaphores = {batch.signal_semaphores.begin(),
+                               batch.signal_semaphores.end()};
+    node->binding_table = {batch.binding_table.begin(),
+                           batch.binding_table.end()};
+
+    // Chain behind any earlier node that has yet to signal the same timeline.
+    for (const auto& signal_point : node->signal_semaphores) {
+      auto it = pending_signal_values_.find(signal_point.semaphore);
+      if (it == pending_signal_values_.end()) {
+        pending_signal_values_[signal_point.semaphore] = signal_point.value;
+      } else if (it->second < signal_point.value) {
+        node->wait_semaphores.push_back({signal_point.semaphore, it->second});
+        it->second = signal_point.value;
+      }
+    }
+
+    SemaphoreValue blocking_wait;
+    auto ready_or = CheckNodeReady(*node, &blocking_wait);
+    if (ready_or.ok() && ready_or.value()) {
+      ready_nodes_.push_back(std::move(node));
+    } else {
+      // Failed waits are handled by the scheduler thread as well.
+      blocked_nodes_.push_back(std::move(node));
+      any_blocked = true;
+    }
+  }
+  if (any_blocked) {
+    WakeScheduler();
+  }
+
+  return OkStatus();
+}
+
+Status DagScheduler::WaitIdle(Time deadline_ns) {
+  IREE_TRACE_SCOPE0("DagScheduler::WaitIdle");
+  absl::MutexLock lock(&mutex_);
+  if (!mutex_.AwaitWithDeadline(
+          absl::Condition(this, &DagScheduler::IsIdleOrFailed),
+          absl::FromUnixNanos(static_cast<int64_t>(deadline_ns)))) {
+    return DeadlineExceededErrorBuilder(IREE_LOC)
+           << "Deadline exceeded waiting for DAG scheduler to go idle";
+  }
+  return permanent_error_;
+}
+
+bool DagScheduler::IsIdleOrFailed() const {
+  return (blocked_nodes_.empty() && ready_nodes_.empty() &&
+          executing_count_ == 0) ||
+         !permanent_error_.ok();
+}
+
+bool DagScheduler::HasReadyNodesOrExited() const {
+  return !ready_nodes_.empty() || scheduler_exited_;
+}
+
+StatusOr<bool> DagScheduler::CheckNodeReady(
+    const Node& node, SemaphoreValue* out_blocking_wait) const {
+  for (const auto& wait_point : node.wait_semaphores) {
+    IREE_ASSIGN_OR_RETURN(uint64_t value, wait_point.semaphore->Query());
+    if (value < wait_point.value) {
+      *out_blocking_wait = wait_point;
+      return false;
+    }
+  }
+  return true;
+}
+
+void DagScheduler::PromoteReadyNodes(
+    absl::InlinedVector<SemaphoreValue, 8>* out_waits) {
+  IREE_TRACE_SCOPE0("DagScheduler::PromoteReadyNodes");
+  for (auto it = blocked_nodes_.begin(); it != blocked_nodes_.end();) {
+    SemaphoreValue blocking_wait;
+    auto ready_or = CheckNodeReady(**it, &blocking_wait);
+    if (!ready_or.ok()) {
+      // A dependency failed; this takes down all pending nodes (including
+      // this one) and so there is nothing left to wait on.
+      FailAllPending(std::move(ready_or).status());
+      out_waits->clear();
+      return;
+    } else if (ready_or.value()) {
+      ready_nodes_.push_back(std::move(*it));
+      it = blocked_nodes_.erase(it);
+    } else {
+      out_waits->push_back(blocking_wait);
+      ++it;
+    }
+  }
+}
+
+void DagScheduler::SchedulerMain() {
+  IREE_TRACE_SET_THREAD_NAME("dag_scheduler");
+
+  while (true) {
+    absl::InlinedVector<SemaphoreValue, 8> waits;
+    {
+      absl::MutexLock lock(&mutex_);
+      PromoteReadyNodes(&waits);
+      if (shutdown_ && ready_nodes_.empty() && executing_count_ == 0) {
+        // Nothing is left running that could unblock the remaining nodes.
+        if (!blocked_nodes_.empty()) {
+          FailAllPending(FailedPreconditionErrorBuilder(IREE_LOC)
+                         << "Scheduler shut down with blocked submissions");
+        }
+        scheduler_exited_ = true;
+        return;
+      }
+      waits.push_back({&wake_semaphore_, wake_value_ + 1});
+    }
+
+    // Sleep until one of the blocked nodes may have become ready or we are
+    // woken for new nodes or shutdown. Failures are picked up on the next
+    // pass when the nodes are checked.
+    CondVarSemaphore::WaitForSemaphores(waits, /*wait_all=*/false,
+                                        InfiniteFuture())
+        .status()
+        .IgnoreError();
+  }
+}
+
+void DagScheduler::ExecutorMain() {
+  IREE_TRACE_SET_THREAD_NAME("dag_executor");
+
+  while (true) {
+    std::unique_ptr<Node> node;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(
+          absl::Condition(this, &DagScheduler::HasReadyNodesOrExited));
+      if (ready_nodes_.empty()) {
+        // Scheduler has exited and there's nothing left to run.
+        return;
+      }
+      node = std::move(ready_nodes_.front());
+      ready_nodes_.pop_front();
+      ++executing_count_;
+    }
+
+    Status status = execute_fn_(node->command_buffers, node->binding_table);
+    status = SignalNode(*node, std::move(status));
+
+    absl::MutexLock lock(&mutex_);
+    ReleaseSignalChain(*node);
+    if (!status.ok()) {
+      FailAllPending(std::move(status));
+    }
+    --executing_count_;
+    if (shutdown_) {
+      // The scheduler exits once nothing is executing; let it re-check.
+      WakeScheduler();
+    }
+  }
+}
+
+Status DagScheduler::SignalNode(const Node& node, Status status) {
+  IREE_TRACE_SCOPE0("DagScheduler::SignalNode");
+  if (status.ok()) {
+    for (const auto& signal_point : node.signal_semaphores) {
+      status = signal_point.semaphore->Signal(signal_point.value);
+      if (!status.ok()) break;
+    }
+  }
+  if (!status.ok()) {
+    for (const auto& signal_point : node.signal_semaphores) {
+      signal_point.semaphore->Fail(status);
+    }
+  }
+  return status;
+}
+
+void DagScheduler::ReleaseSignalChain(const Node& node) {
+  for (const auto& signal_point : node.signal_semaphores) {
+    auto it = pending_signal_values_.find(signal_point.semaphore);
+    if (it != pending_signal_values_.end() &&
+        it->second == signal_point.value) {
+      // No later node signals this semaphore; the semaphore may be destroyed
+      // by the caller as soon as we return so we must forget it.
+      pending_signal_values_.erase(it);
+    }
+  }
+}
+
+void DagScheduler::FailAllPending(Status status) {
+  IREE_TRACE_SCOPE0("DagScheduler::FailAllPending");
+  if (permanent_error_.ok()) {
+    permanent_error_ = Status(status);
+  }
+  auto fail_node = [&](const Node& node) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    for (const auto& signal_point : node.signal_semaphores) {
+      signal_point.semaphore->Fail(status);
+    }
+    ReleaseSignalChain(node);
+  };
+  for (auto& node : blocked_nodes_) fail_node(*node);
+  blocked_nodes_.clear();
+  for (auto& node : ready_nodes_) fail_node(*node);
+  ready_nodes_.clear();
+}
+
+void DagScheduler::WakeScheduler() {
+  wake_semaphore_.Signal(++wake_value_).IgnoreError();
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
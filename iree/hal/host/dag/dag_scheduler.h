@@ -0,0 +1,155 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_DAG_DAG_SCHEDULER_H_
+#define IREE_HAL_HOST_DAG_DAG_SCHEDULER_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/status.h"
+#include "iree/base/time.h"
+#include "iree/hal/command_queue.h"
+#include "iree/hal/host/condvar_semaphore.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Schedules submission batches from any number of queues as a dependency DAG.
+//
+// Each batch is a node whose incoming edges are its wait semaphores. Nodes
+// become ready as soon as all of their waits are satisfied and are then run
+// by whichever executor thread is free, so batches that do not depend on each
+// other (whether on the same queue or not) execute concurrently instead of in
+// submission order.
+//
+// Nodes that signal the same semaphore are additionally chained in submission
+// order so that a timeline never observes its payload move past a value whose
+// work has not yet completed. In practice this means that work submitted to a
+// single timeline runs in-order while independent timelines overlap.
+//
+// Errors behave as with SerialSubmissionQueue: the first failure becomes a
+// sticky error, all pending nodes are failed, and future enqueues are
+// rejected. Nodes already executing are allowed to complete.
+//
+// Thread-safe.
+class DagScheduler final {
+ public:
+  using ExecuteFn =
+      std::function<Status(absl::Span<CommandBuffer* const> command_buffers,
+                           absl::Span<Buffer* const> binding_table)>;
+
+  // Creates a scheduler that runs up to |executor_count| batches concurrently
+  // by calling |execute_fn| from its executor threads.
+  DagScheduler(int executor_count, ExecuteFn execute_fn);
+  ~DagScheduler();
+
+  DagScheduler(const DagScheduler&) = delete;
+  DagScheduler& operator=(const DagScheduler&) = delete;
+
+  // Enqueues new batches. Batches run as soon as their wait semaphores have
+  // been signaled.
+  Status Enqueue(absl::Span<const SubmissionBatch> batches);
+
+  // Blocks until all enqueued batches have completed, the scheduler has
+  // failed, or |deadline_ns| elapses.
+  Status WaitIdle(Time deadline_ns);
+
+ private:
+  // A submitted batch and its synchronization information.
+  struct Node {
+    absl::InlinedVector<SemaphoreValue, 4> wait_semaphores;
+    absl::InlinedVector<CommandBuffer*, 4> command_buffers;
+    absl::InlinedVector<SemaphoreValue, 4> signal_semaphores;
+    absl::InlinedVector<Buffer*, 4> binding_table;
+  };
+
+  // Thread entry point for the thread resolving node dependencies.
+  void SchedulerMain();
+
+  // Thread entry point for the threads executing ready nodes.
+  void ExecutorMain();
+
+  // Returns true if all wait semaphores of |node| have been signaled. If not
+  // then |out_blocking_wait| is set to one of the waits not yet satisfied.
+  // Returns the failure status of a failed wait semaphore, if any.
+  StatusOr<bool> CheckNodeReady(const Node& node,
+                                SemaphoreValue* out_blocking_wait) const;
+
+  // Moves blocked nodes that have become ready to the ready list and appends
+  // the semaphores the remaining nodes are blocked on to |out_waits|.
+  void PromoteReadyNodes(absl::InlinedVector<SemaphoreValue, 8>* out_waits)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Signals (or on failure fails) the semaphores of a node that has finished
+  // executing.
+  Status SignalNode(const Node& node, Status status);
+
+  // Releases the timeline ordering entries held by |node|.
+  void ReleaseSignalChain(const Node& node)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Sets the sticky error (if not already set) and fails all nodes that have
+  // not yet started executing.
+  void FailAllPending(Status status) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Wakes the scheduler thread so that it re-evaluates the blocked nodes.
+  void WakeScheduler() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns true if no nodes are pending or executing or the scheduler has
+  // failed.
+  bool IsIdleOrFailed() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns true if executors have a node to run or should exit.
+  bool HasReadyNodesOrExited() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  ExecuteFn execute_fn_;
+
+  std::thread scheduler_thread_;
+  std::vector<std::thread> executor_threads_;
+
+  // Signaled to wake the scheduler thread when new nodes arrive or it should
+  // exit. Waited on along with the semaphores of all blocked nodes.
+  CondVarSemaphore wake_semaphore_{0ull};
+
+  mutable absl::Mutex mutex_;
+  uint64_t wake_value_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  bool scheduler_exited_ ABSL_GUARDED_BY(mutex_) = false;
+  Status permanent_error_ ABSL_GUARDED_BY(mutex_);
+
+  // Nodes waiting on semaphores, ready to execute, and executing.
+  std::vector<std::unique_ptr<Node>> blocked_nodes_ ABSL_GUARDED_BY(mutex_);
+  std::deque<std::unique_ptr<Node>> ready_nodes_ ABSL_GUARDED_BY(mutex_);
+  int executing_count_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  // Largest payload value each semaphore will be signaled to by a node that
+  // has not yet completed. New signalers of the semaphore wait on this value.
+  absl::flat_hash_map<Semaphore*, uint64_t> pending_signal_values_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_DAG_DAG_SCHEDULER_H_
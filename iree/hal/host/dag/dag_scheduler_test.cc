@@ -0,0 +1,213 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/dag/dag_scheduler.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "iree/base/status.h"
+#include "iree/base/time.h"
+#include "iree/hal/host/condvar_semaphore.h"
+#include "iree/hal/testing/mock_command_buffer.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+using testing::MockCommandBuffer;
+
+class DagSchedulerTest : public ::testing::Test {
+ protected:
+  // Returns a command buffer used only to identify batches in |execute_fn|.
+  CommandBuffer* MakeCommandBuffer() {
+    command_buffers_.push_back(make_ref<MockCommandBuffer>(
+        CommandBufferMode::kOneShot, CommandCategory::kDispatch));
+    return command_buffers_.back().get();
+  }
+
+ private:
+  std::vector<ref_ptr<MockCommandBuffer>> command_buffers_;
+};
+
+// Tests that batches without dependencies on each other run concurrently.
+// Each batch blocks until the other has started so this would deadlock if
+// the batches were run in submission order.
+TEST_F(DagSchedulerTest, IndependentBatchesRunConcurrently) {
+  auto* cmd_a = MakeCommandBuffer();
+  auto* cmd_b = MakeCommandBuffer();
+  absl::Notification a_started;
+  absl::Notification b_started;
+  DagScheduler scheduler(
+      /*executor_count=*/2,
+      [&](absl::Span<CommandBuffer* const> command_buffers,
+          absl::Span<Buffer* const> binding_table) {
+        if (command_buffers[0] == cmd_a) {
+          a_started.Notify();
+          b_started.WaitForNotification();
+        } else {
+          b_started.Notify();
+          a_started.WaitForNotification();
+        }
+        return OkStatus();
+      });
+
+  CondVarSemaphore semaphore_a(0ull);
+  CondVarSemaphore semaphore_b(0ull);
+  IREE_ASSERT_OK(scheduler.Enqueue({{{}, {cmd_a}, {{&semaphore_a, 1ull}}}}));
+  IREE_ASSERT_OK(scheduler.Enqueue({{{}, {cmd_b}, {{&semaphore_b, 1ull}}}}));
+  IREE_ASSERT_OK(scheduler.WaitIdle(InfiniteFuture()));
+  EXPECT_EQ(1ull, semaphore_a.Query().value());
+  EXPECT_EQ(1ull, semaphore_b.Query().value());
+}
+
+// Tests that a batch waiting on a semaphore runs only after the batch that
+// signals it, even when submitted first.
+TEST_F(DagSchedulerTest, WaitSemaphoreOrdersBatches) {
+  auto* cmd_a = MakeCommandBuffer();
+  auto* cmd_b = MakeCommandBuffer();
+  absl::Mutex mutex;
+  std::vector<CommandBuffer*> order;
+  DagScheduler scheduler(
+      /*executor_count=*/2,
+      [&](absl::Span<CommandBuffer* const> command_buffers,
+          absl::Span<Buffer* const> binding_table) {
+        absl::MutexLock lock(&mutex);
+        order.push_back(command_buffers[0]);
+        return OkStatus();
+      });
+
+  CondVarSemaphore semaphore_a(0ull);
+  CondVarSemaphore semaphore_b(0ull);
+  IREE_ASSERT_OK(scheduler.Enqueue(
+      {{{{&semaphore_a, 1ull}}, {cmd_b}, {{&semaphore_b, 1ull}}}}));
+  IREE_ASSERT_OK(scheduler.Enqueue({{{}, {cmd_a}, {{&semaphore_a, 1ull}}}}));
+  IREE_ASSERT_OK(semaphore_b.Wait(1ull, InfiniteFuture()));
+
+  absl::MutexLock lock(&mutex);
+  ASSERT_EQ(2, order.size());
+  EXPECT_EQ(cmd_a, order[0]);
+  EXPECT_EQ(cmd_b, order[1]);
+}
+
+// Tests that batches signaling the same timeline run in submission order so
+// that the timeline never passes a value whose work has not completed.
+TEST_F(DagSchedulerTest, SameTimelineRunsInOrder) {
+  CondVarSemaphore timeline(0ull);
+  std::atomic<int> out_of_order_count{0};
+  std::vector<CommandBuffer*> command_buffers;
+  for (int i = 0; i < 8; ++i) {
+    command_buffers.push_back(MakeCommandBuffer());
+  }
+  DagScheduler scheduler(
+      /*executor_count=*/4,
+      [&](absl::Span<CommandBuffer* const> batch_command_buffers,
+          absl::Span<Buffer* const> binding_table) {
+        // Batch i signals i + 1 and so must observe i when it runs.
+        uint64_t expected_value = 0;
+        while (command_buffers[expected_value] != batch_command_buffers[0]) {
+          ++expected_value;
+        }
+        if (timeline.Query().value() != expected_value) {
+          ++out_of_order_count;
+        }
+        return OkStatus();
+      });
+
+  for (int i = 0; i < command_buffers.size(); ++i) {
+    IREE_ASSERT_OK(scheduler.Enqueue(
+        {{{}, {command_buffers[i]}, {{&timeline, i + 1ull}}}}));
+  }
+  IREE_ASSERT_OK(timeline.Wait(command_buffers.size(), InfiniteFuture()));
+  EXPECT_EQ(0, out_of_order_count.load());
+}
+
+// Tests that batches blocked on semaphores signaled from the host are woken.
+TEST_F(DagSchedulerTest, HostSignalUnblocks) {
+  auto* cmd = MakeCommandBuffer();
+  std::atomic<int> run_count{0};
+  DagScheduler scheduler(
+      /*executor_count=*/1,
+      [&](absl::Span<CommandBuffer* const> command_buffers,
+          absl::Span<Buffer* const> binding_table) {
+        ++run_count;
+        return OkStatus();
+      });
+
+  CondVarSemaphore wait_semaphore(0ull);
+  CondVarSemaphore signal_semaphore(0ull);
+  IREE_ASSERT_OK(scheduler.Enqueue(
+      {{{{&wait_semaphore, 1ull}}, {cmd}, {{&signal_semaphore, 1ull}}}}));
+  EXPECT_TRUE(IsDeadlineExceeded(
+      scheduler.WaitIdle(RelativeTimeoutToDeadlineNanos(Duration(1000000)))));
+  EXPECT_EQ(0, run_count.load());
+
+  IREE_ASSERT_OK(wait_semaphore.Signal(1ull));
+  IREE_ASSERT_OK(scheduler.WaitIdle(InfiniteFuture()));
+  EXPECT_EQ(1, run_count.load());
+  EXPECT_EQ(1ull, signal_semaphore.Query().value());
+}
+
+// Tests that a failing batch fails its semaphores and those of its dependents
+// and that the scheduler rejects new work afterward.
+TEST_F(DagSchedulerTest, PropagateFailure) {
+  auto* cmd_a = MakeCommandBuffer();
+  auto* cmd_b = MakeCommandBuffer();
+  DagScheduler scheduler(
+      /*executor_count=*/2,
+      [&](absl::Span<CommandBuffer* const> command_buffers,
+          absl::Span<Buffer* const> binding_table) -> Status {
+        if (command_buffers[0] == cmd_a) {
+          return DataLossErrorBuilder(IREE_LOC);
+        }
+        return OkStatus();
+      });
+
+  CondVarSemaphore semaphore_a(0ull);
+  CondVarSemaphore semaphore_b(0ull);
+  IREE_ASSERT_OK(scheduler.Enqueue(
+      {{{{&semaphore_a, 1ull}}, {cmd_b}, {{&semaphore_b, 1ull}}}}));
+  IREE_ASSERT_OK(scheduler.Enqueue({{{}, {cmd_a}, {{&semaphore_a, 1ull}}}}));
+  EXPECT_TRUE(IsDataLoss(semaphore_a.Wait(1ull, InfiniteFuture())));
+  EXPECT_TRUE(IsDataLoss(semaphore_b.Wait(1ull, InfiniteFuture())));
+  EXPECT_TRUE(IsDataLoss(scheduler.WaitIdle(InfiniteFuture())));
+  EXPECT_TRUE(IsDataLoss(scheduler.Enqueue({{{}, {cmd_b}, {}}})));
+}
+
+// Tests that batches that can never run are failed on shutdown.
+TEST_F(DagSchedulerTest, ShutdownFailsBlockedBatches) {
+  auto* cmd = MakeCommandBuffer();
+  CondVarSemaphore wait_semaphore(0ull);
+  CondVarSemaphore signal_semaphore(0ull);
+  auto scheduler = absl::make_unique<DagScheduler>(
+      /*executor_count=*/1,
+      [&](absl::Span<CommandBuffer* const> command_buffers,
+          absl::Span<Buffer* const> binding_table) { return OkStatus(); });
+  IREE_ASSERT_OK(scheduler->Enqueue(
+      {{{{&wait_semaphore, 1ull}}, {cmd}, {{&signal_semaphore, 1ull}}}}));
+  scheduler.reset();
+  EXPECT_TRUE(IsFailedPrecondition(signal_semaphore.Query().status()));
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
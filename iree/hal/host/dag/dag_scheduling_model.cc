@@ -0,0 +1,136 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/dag/dag_scheduling_model.h"
+
+#include <algorithm>
+#include <string>
+
+#include "absl/memory/memory.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/host/condvar_semaphore.h"
+#include "iree/hal/host/dag/dag_command_processor.h"
+#include "iree/hal/host/inproc_command_buffer.h"
+#include "iree/hal/host/nop_event.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// A CommandQueue that relays all submissions to a DagScheduler shared with the
+// other queues of the device. Queues have no ordering of their own; all
+// ordering comes from the semaphores in the submitted batches.
+class DagCommandQueue final : public CommandQueue {
+ public:
+  DagCommandQueue(std::string name,
+                  CommandCategoryBitfield supported_categories,
+                  DagScheduler* scheduler)
+      : CommandQueue(std::move(name), supported_categories),
+        scheduler_(scheduler) {}
+  ~DagCommandQueue() override = default;
+
+  Status Submit(absl::Span<const SubmissionBatch> batches) override {
+    IREE_TRACE_SCOPE0("DagCommandQueue::Submit");
+    return scheduler_->Enqueue(batches);
+  }
+
+  Status WaitIdle(Time deadline_ns) override {
+    IREE_TRACE_SCOPE0("DagCommandQueue::WaitIdle");
+    // NOTE: this waits for the work of all queues sharing the scheduler.
+    return scheduler_->WaitIdle(deadline_ns);
+  }
+
+ private:
+  DagScheduler* scheduler_;
+};
+
+}  // namespace
+
+DagSchedulingModel::DagSchedulingModel(int queue_count, int worker_count) {
+  IREE_TRACE_SCOPE0("DagSchedulingModel::ctor");
+  auto supported_categories =
+      CommandCategory::kTransfer | CommandCategory::kDispatch;
+
+  pool_ = absl::make_unique<WorkStealingPool>(worker_count);
+
+  // Each batch processes its command buffers in order with a fresh processor
+  // so that no state carries across buffers.
+  scheduler_ = absl::make_unique<DagScheduler>(
+      queue_count,
+      [this, supported_categories](
+          absl::Span<CommandBuffer* const> command_buffers,
+          absl::Span<Buffer* const> binding_table) -> Status {
+        IREE_TRACE_SCOPE0("DagSchedulingModel::ExecuteBatch");
+        for (auto* command_buffer : command_buffers) {
+          auto* inproc_command_buffer =
+              static_cast<InProcCommandBuffer*>(command_buffer->impl());
+          DagCommandProcessor command_processor(supported_categories,
+                                                pool_.get());
+          IREE_RETURN_IF_ERROR(inproc_command_buffer->Process(
+              &command_processor, binding_table));
+        }
+        return OkStatus();
+      });
+
+  for (int i = 0; i < std::max(1, queue_count); ++i) {
+    command_queues_.push_back(absl::make_unique<DagCommandQueue>(
+        "cpu" + std::to_string(i), supported_categories, scheduler_.get()));
+  }
+}
+
+DagSchedulingModel::~DagSchedulingModel() {
+  // The scheduler drains outstanding work into the pool before it is torn
+  // down.
+  command_queues_.clear();
+  scheduler_.reset();
+  pool_.reset();
+}
+
+StatusOr<ref_ptr<CommandBuffer>> DagSchedulingModel::CreateCommandBuffer(
+    CommandBufferModeBitfield mode,
+    CommandCategoryBitfield command_categories) {
+  return make_ref<InProcCommandBuffer>(mode, command_categories);
+}
+
+StatusOr<ref_ptr<Event>> DagSchedulingModel::CreateEvent() {
+  return make_ref<NopEvent>();
+}
+
+StatusOr<ref_ptr<Semaphore>> DagSchedulingModel::CreateSemaphore(
+    uint64_t initial_value) {
+  return make_ref<CondVarSemaphore>(initial_value);
+}
+
+Status DagSchedulingModel::WaitAllSemaphores(
+    absl::Span<const SemaphoreValue> semaphores, Time deadline_ns) {
+  return CondVarSemaphore::WaitForSemaphores(semaphores, /*wait_all=*/true,
+                                             deadline_ns)
+      .status();
+}
+
+StatusOr<int> DagSchedulingModel::WaitAnySemaphore(
+    absl::Span<const SemaphoreValue> semaphores, Time deadline_ns) {
+  return CondVarSemaphore::WaitForSemaphores(semaphores, /*wait_all=*/false,
+                                             deadline_ns);
+}
+
+Status DagSchedulingModel::WaitIdle(Time deadline_ns) {
+  // All queues share the scheduler so any one of them will do.
+  return scheduler_->WaitIdle(deadline_ns);
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,60 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iree/hal/host/dag/dag_scheduling_model.h"
+
+#include <thread>  // NOLINT
+
+#include "iree/base/status.h"
+#include "iree/base/time.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// Tests that waiting for any semaphore returns the index of the one that was
+// signaled.
+TEST(DagSchedulingModelTest, WaitAnySemaphoreReturnsSignaledIndex) {
+  DagSchedulingModel scheduling_model(/*queue_count=*/1, /*worker_count=*/1);
+  IREE_ASSERT_OK_AND_ASSIGN(auto a, scheduling_model.CreateSemaphore(0u));
+  IREE_ASSERT_OK_AND_ASSIGN(auto b, scheduling_model.CreateSemaphore(0u));
+
+  std::thread thread([&]() { IREE_ASSERT_OK(b->Signal(1u)); });
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int index, scheduling_model.WaitAnySemaphore(
+                     {{a.get(), 1u}, {b.get(), 1u}}, InfiniteFuture()));
+  thread.join();
+  EXPECT_EQ(1, index);
+
+  IREE_ASSERT_OK(a->Signal(1u));
+  IREE_ASSERT_OK_AND_ASSIGN(
+      index, scheduling_model.WaitAnySemaphore({{a.get(), 1u}, {b.get(), 1u}},
+                                               InfinitePast()));
+  EXPECT_EQ(0, index);
+
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DEADLINE_EXCEEDED,
+      scheduling_model
+          .WaitAnySemaphore({{a.get(), 2u}, {b.get(), 2u}}, InfinitePast())
+          .status());
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -26,6 +26,54 @@ namespace hal {
 
 class Allocator;
 
+namespace {
+
+// Fills |length| bytes at |data| by repeating the |pattern_length| byte
+// |pattern|. |length| must be a multiple of |pattern_length|.
+//
+// The pattern is splatted into a cache line sized block that is then copied
+// with fixed-size memcpys. Compilers lower these to the widest vector stores
+// the target supports without us needing per-architecture intrinsics.
+void FillPattern(uint8_t* data, device_size_t length, const void* pattern,
+                 device_size_t pattern_length) {
+  uint64_t pattern_bits = 0;
+  switch (pattern_length) {
+    case 1:
+      pattern_bits = *static_cast<const uint8_t*>(pattern) *
+                     UINT64_C(0x0101010101010101);
+      break;
+    case 2:
+      pattern_bits = *static_cast<const uint16_t*>(pattern) *
+                     UINT64_C(0x0001000100010001);
+      break;
+    case 4:
+      pattern_bits = *static_cast<const uint32_t*>(pattern) *
+                     UINT64_C(0x0000000100000001);
+      break;
+  }
+
+  // Patterns made of a single repeated byte (such as all zeros or all ones)
+  // can use memset, which is usually the fastest fill the platform has.
+  uint8_t byte_value = static_cast<uint8_t>(pattern_bits);
+  if (pattern_bits == byte_value * UINT64_C(0x0101010101010101)) {
+    std::memset(data, byte_value, length);
+    return;
+  }
+
+  constexpr device_size_t kBlockLength = 64;
+  uint64_t block[kBlockLength / sizeof(uint64_t)];
+  for (auto& value : block) value = pattern_bits;
+  while (length >= kBlockLength) {
+    std::memcpy(data, block, kBlockLength);
+    data += kBlockLength;
+    length -= kBlockLength;
+  }
+  // The block starts with a whole pattern so the tail is still in phase.
+  std::memcpy(data, block, length);
+}
+
+}  // namespace
+
 HostBuffer::HostBuffer(Allocator* allocator, MemoryTypeBitfield memory_type,
                        MemoryAccessBitfield allowed_access,
                        BufferUsageBitfield usage, device_size_t allocation_size,
@@ -35,9 +83,23 @@ HostBuffer::HostBuffer(Allocator* allocator, MemoryTypeBitfield memory_type,
       data_(data),
       owns_data_(owns_data) {}
 
+HostBuffer::HostBuffer(Allocator* allocator, MemoryTypeBitfield memory_type,
+                       MemoryAccessBitfield allowed_access,
+                       BufferUsageBitfield usage, device_size_t allocation_size,
+                       void* data, MemoryPool* memory_pool)
+    : Buffer(allocator, memory_type, allowed_access, usage, allocation_size, 0,
+             allocation_size),
+      data_(data),
+      owns_data_(true),
+      memory_pool_(memory_pool) {}
+
 HostBuffer::~HostBuffer() {
   if (owns_data_ && data_) {
-    std::free(data_);
+    if (memory_pool_) {
+      memory_pool_->Free(data_, allocation_size());
+    } else {
+      std::free(data_);
+    }
     data_ = nullptr;
   }
 }
@@ -45,32 +107,12 @@ HostBuffer::~HostBuffer() {
 Status HostBuffer::FillImpl(device_size_t byte_offset,
                             device_size_t byte_length, const void* pattern,
                             device_size_t pattern_length) {
-  auto data_ptr = data_;
-  switch (pattern_length) {
-    case 1: {
-      uint8_t* data = static_cast<uint8_t*>(data_ptr);
-      uint8_t value_bits = *static_cast<const uint8_t*>(pattern);
-      std::fill_n(data + byte_offset, byte_length, value_bits);
-      break;
-    }
-    case 2: {
-      uint16_t* data = static_cast<uint16_t*>(data_ptr);
-      uint16_t value_bits = *static_cast<const uint16_t*>(pattern);
-      std::fill_n(data + byte_offset / sizeof(uint16_t),
-                  byte_length / sizeof(uint16_t), value_bits);
-      break;
-    }
-    case 4: {
-      uint32_t* data = static_cast<uint32_t*>(data_ptr);
-      uint32_t value_bits = *static_cast<const uint32_t*>(pattern);
-      std::fill_n(data + byte_offset / sizeof(uint32_t),
-                  byte_length / sizeof(uint32_t), value_bits);
-      break;
-    }
-    default:
-      return InvalidArgumentErrorBuilder(IREE_LOC)
-             << "Unsupported scalar data size: " << pattern_length;
+  if (pattern_length != 1 && pattern_length != 2 && pattern_length != 4) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Unsupported scalar data size: " << pattern_length;
   }
+  FillPattern(static_cast<uint8_t*>(data_) + byte_offset, byte_length, pattern,
+              pattern_length);
   return OkStatus();
 }
 
@@ -19,6 +19,7 @@
 
 #include "iree/base/status.h"
 #include "iree/hal/buffer.h"
+#include "iree/hal/memory_pool.h"
 
 namespace iree {
 namespace hal {
@@ -32,6 +33,13 @@ class HostBuffer : public Buffer {
              MemoryAccessBitfield allowed_access, BufferUsageBitfield usage,
              device_size_t allocation_size, void* data, bool owns_data);
 
+  // Takes ownership of |data| allocated from |memory_pool| and returns it to
+  // the pool when the buffer is destroyed.
+  HostBuffer(Allocator* allocator, MemoryTypeBitfield memory_type,
+             MemoryAccessBitfield allowed_access, BufferUsageBitfield usage,
+             device_size_t allocation_size, void* data,
+             MemoryPool* memory_pool);
+
   ~HostBuffer() override;
 
   const void* data() const { return data_; }
@@ -62,6 +70,7 @@ class HostBuffer : public Buffer {
  private:
   void* data_ = nullptr;
   bool owns_data_ = false;
+  MemoryPool* memory_pool_ = nullptr;
 };
 
 }  // namespace hal
@@ -14,13 +14,13 @@
 
 #include "iree/hal/host/host_local_allocator.h"
 
-#include <cstdlib>
 #include <string>
 #include <utility>
 
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/host/host_buffer.h"
+#include "iree/hal/host/host_memory_pool.h"
 
 namespace iree {
 namespace hal {
@@ -92,21 +92,34 @@ StatusOr<ref_ptr<Buffer>> HostLocalAllocator::Allocate(
            << ", allocation_size=" << allocation_size;
   }
 
+  // The host can only observe the initial contents of buffers it is able to
+  // map; all other buffers are written by the device before they are read and
+  // don't need to be zeroed. Transient buffers are undefined by definition.
+  bool zero_fill = AnyBitSet(buffer_usage & BufferUsage::kMapping) &&
+                   !AnyBitSet(memory_type & MemoryType::kTransient);
+
   // Make compatible with our requirements.
   IREE_RETURN_IF_ERROR(MakeCompatible(&memory_type, &buffer_usage));
 
-  void* malloced_data = std::calloc(1, allocation_size);
-  if (!malloced_data) {
+  auto* memory_pool = HostMemoryPool::Get();
+  void* data = memory_pool->Allocate(allocation_size, zero_fill);
+  if (!data) {
     return ResourceExhaustedErrorBuilder(IREE_LOC)
-           << "Failed to malloc " << allocation_size << " bytes";
+           << "Failed to allocate " << allocation_size << " bytes";
   }
 
   auto buffer =
       make_ref<HostBuffer>(this, memory_type, MemoryAccess::kAll, buffer_usage,
-                           allocation_size, malloced_data, true);
+                           allocation_size, data, memory_pool);
   return buffer;
 }
 
+void HostLocalAllocator::Trim() { HostMemoryPool::Get()->Trim(); }
+
+AllocatorStatistics HostLocalAllocator::statistics() const {
+  return HostMemoryPool::Get()->statistics();
+}
+
 }  // namespace host
 }  // namespace hal
 }  // namespace iree
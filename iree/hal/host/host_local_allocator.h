@@ -33,6 +33,11 @@ namespace host {
 // the 'device' in the case of a host-local queue *is* the host. To keep code
 // written initially for a host-local queue working when other queues are used
 // the allocator only works with buffers that are kDeviceVisible.
+//
+// Memory is suballocated from the process-wide HostMemoryPool so that repeated
+// invocations reuse the same host memory. Buffers that cannot be mapped by the
+// host (or are kTransient) are not zero-initialized as their contents are
+// undefined until written by the device.
 class HostLocalAllocator : public Allocator {
  public:
   HostLocalAllocator();
@@ -53,6 +58,11 @@ class HostLocalAllocator : public Allocator {
   StatusOr<ref_ptr<Buffer>> Allocate(MemoryTypeBitfield memory_type,
                                      BufferUsageBitfield buffer_usage,
                                      size_t allocation_size) override;
+
+  // Buffers are backed by the process-wide HostMemoryPool and the trimming and
+  // statistics apply to all allocators sharing it.
+  void Trim() override;
+  AllocatorStatistics statistics() const override;
 };
 
 }  // namespace host
@@ -90,7 +90,10 @@ StatusOr<int> HostLocalDevice::WaitAnySemaphore(
 
 Status HostLocalDevice::WaitIdle(Time deadline_ns) {
   IREE_TRACE_SCOPE0("HostLocalDevice::WaitIdle");
-  return scheduling_model_->WaitIdle(deadline_ns);
+  IREE_RETURN_IF_ERROR(scheduling_model_->WaitIdle(deadline_ns));
+  // Nothing is in flight so memory retained for reuse can be released.
+  allocator_.Trim();
+  return OkStatus();
 }
 
 }  // namespace host
@@ -34,6 +34,9 @@ class HostLocalDevice : public Device {
   ~HostLocalDevice() override;
 
   Allocator* allocator() const override { return &allocator_; }
+  TransientArenaPool* transient_arena_pool() override {
+    return &transient_arena_pool_;
+  }
 
   absl::Span<CommandQueue*> dispatch_queues() const override {
     return scheduling_model_->dispatch_queues();
@@ -76,6 +79,8 @@ class HostLocalDevice : public Device {
  private:
   std::unique_ptr<SchedulingModel> scheduling_model_;
   mutable HostLocalAllocator allocator_;
+  // Declared after |allocator_| so arena blocks are released first.
+  TransientArenaPool transient_arena_pool_;
 };
 
 }  // namespace host
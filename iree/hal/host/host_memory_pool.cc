@@ -0,0 +1,257 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/host_memory_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "iree/base/initializer.h"
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+namespace {
+
+// Adds |delta| to |value| and raises |peak| if the new value exceeds it.
+void AddAndUpdatePeak(std::atomic<int64_t>* value, std::atomic<int64_t>* peak,
+                      int64_t delta) {
+  int64_t new_value =
+      value->fetch_add(delta, std::memory_order_relaxed) + delta;
+  int64_t old_peak = peak->load(std::memory_order_relaxed);
+  while (new_value > old_peak &&
+         !peak->compare_exchange_weak(old_peak, new_value,
+                                      std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+// Blocks freed by a thread that have not yet been returned to the shared free
+// lists. Flushed when the thread exits or the pool is trimmed.
+struct HostMemoryPool::ThreadCache {
+  ThreadCache() { HostMemoryPool::Get()->RegisterThreadCache(this); }
+  ~ThreadCache() {
+    auto* pool = HostMemoryPool::Get();
+    pool->UnregisterThreadCache(this);
+    pool->FlushThreadCache(this);
+  }
+
+  // Only contended when another thread is trimming the pool.
+  absl::Mutex mutex;
+  std::array<FreeBlock*, kSizeClassCount> free_lists ABSL_GUARDED_BY(mutex) =
+      {};
+  std::array<size_t, kSizeClassCount> free_bytes ABSL_GUARDED_BY(mutex) = {};
+};
+
+// static
+HostMemoryPool* HostMemoryPool::Get() {
+  // Intentionally leaked so that thread caches can be flushed on exit of
+  // threads that outlive static destruction.
+  static HostMemoryPool* pool = new HostMemoryPool();
+  return pool;
+}
+
+// static
+HostMemoryPool::ThreadCache& HostMemoryPool::thread_cache() {
+  static thread_local ThreadCache cache;
+  return cache;
+}
+
+// static
+int HostMemoryPool::SizeClassIndex(size_t byte_length) {
+  if (byte_length > SizeClassByteLength(kSizeClassCount - 1)) return -1;
+  int size_class = 0;
+  while (SizeClassByteLength(size_class) < byte_length) ++size_class;
+  return size_class;
+}
+
+void* HostMemoryPool::Allocate(size_t byte_length, bool zero_fill) {
+  IREE_TRACE_SCOPE0("HostMemoryPool::Allocate");
+  allocation_count_.fetch_add(1, std::memory_order_relaxed);
+
+  void* data = nullptr;
+  int size_class = SizeClassIndex(byte_length);
+  if (size_class < 0) {
+    data = AllocateFromSystem(byte_length, zero_fill);
+  } else {
+    size_t block_length = SizeClassByteLength(size_class);
+    auto& cache = thread_cache();
+    FreeBlock* block = nullptr;
+    {
+      absl::MutexLock lock(&cache.mutex);
+      block = cache.free_lists[size_class];
+      if (block) {
+        cache.free_lists[size_class] = block->next;
+        cache.free_bytes[size_class] -= block_length;
+      }
+    }
+    if (!block) {
+      absl::MutexLock lock(&mutex_);
+      block = shared_free_lists_[size_class];
+      if (block) {
+        shared_free_lists_[size_class] = block->next;
+        shared_cache_bytes_ -= block_length;
+      }
+    }
+    if (block) {
+      data = block;
+      if (zero_fill) std::memset(data, 0, byte_length);
+    } else {
+      data = AllocateFromSystem(block_length, zero_fill);
+    }
+  }
+  if (!data) return nullptr;
+
+  AddAndUpdatePeak(&bytes_allocated_, &bytes_allocated_peak_, byte_length);
+  return data;
+}
+
+void HostMemoryPool::Free(void* data, size_t byte_length) {
+  if (!data) return;
+  IREE_TRACE_SCOPE0("HostMemoryPool::Free");
+  bytes_allocated_.fetch_sub(byte_length, std::memory_order_relaxed);
+
+  int size_class = SizeClassIndex(byte_length);
+  if (size_class < 0) {
+    FreeToSystem(data, byte_length);
+    return;
+  }
+
+  size_t block_length = SizeClassByteLength(size_class);
+  auto* block = static_cast<FreeBlock*>(data);
+  auto& cache = thread_cache();
+  {
+    absl::MutexLock lock(&cache.mutex);
+    if (cache.free_bytes[size_class] + block_length <=
+        kMaxThreadCacheBytesPerClass) {
+      block->next = cache.free_lists[size_class];
+      cache.free_lists[size_class] = block;
+      cache.free_bytes[size_class] += block_length;
+      return;
+    }
+  }
+  ReleaseToSharedCache(size_class, block);
+}
+
+void HostMemoryPool::Trim() {
+  IREE_TRACE_SCOPE0("HostMemoryPool::Trim");
+  {
+    absl::MutexLock lock(&thread_caches_mutex_);
+    for (auto* cache : thread_caches_) {
+      FlushThreadCache(cache);
+    }
+  }
+
+  std::array<FreeBlock*, kSizeClassCount> free_lists;
+  {
+    absl::MutexLock lock(&mutex_);
+    free_lists = shared_free_lists_;
+    shared_free_lists_.fill(nullptr);
+    shared_cache_bytes_ = 0;
+  }
+  for (int size_class = 0; size_class < kSizeClassCount; ++size_class) {
+    FreeBlock* block = free_lists[size_class];
+    while (block) {
+      FreeBlock* next = block->next;
+      FreeToSystem(block, SizeClassByteLength(size_class));
+      block = next;
+    }
+  }
+}
+
+AllocatorStatistics HostMemoryPool::statistics() const {
+  AllocatorStatistics statistics;
+  statistics.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+  statistics.bytes_allocated_peak =
+      bytes_allocated_peak_.load(std::memory_order_relaxed);
+  statistics.bytes_reserved = bytes_reserved_.load(std::memory_order_relaxed);
+  statistics.bytes_reserved_peak =
+      bytes_reserved_peak_.load(std::memory_order_relaxed);
+  statistics.allocation_count =
+      allocation_count_.load(std::memory_order_relaxed);
+  statistics.system_allocation_count =
+      system_allocation_count_.load(std::memory_order_relaxed);
+  return statistics;
+}
+
+void HostMemoryPool::FlushThreadCache(ThreadCache* cache) {
+  std::array<FreeBlock*, kSizeClassCount> free_lists;
+  {
+    absl::MutexLock lock(&cache->mutex);
+    free_lists = cache->free_lists;
+    cache->free_lists.fill(nullptr);
+    cache->free_bytes.fill(0);
+  }
+  for (int size_class = 0; size_class < kSizeClassCount; ++size_class) {
+    FreeBlock* block = free_lists[size_class];
+    while (block) {
+      FreeBlock* next = block->next;
+      ReleaseToSharedCache(size_class, block);
+      block = next;
+    }
+  }
+}
+
+void HostMemoryPool::RegisterThreadCache(ThreadCache* cache) {
+  absl::MutexLock lock(&thread_caches_mutex_);
+  thread_caches_.push_back(cache);
+}
+
+void HostMemoryPool::UnregisterThreadCache(ThreadCache* cache) {
+  absl::MutexLock lock(&thread_caches_mutex_);
+  thread_caches_.erase(
+      std::find(thread_caches_.begin(), thread_caches_.end(), cache));
+}
+
+void HostMemoryPool::ReleaseToSharedCache(int size_class, FreeBlock* block) {
+  size_t block_length = SizeClassByteLength(size_class);
+  {
+    absl::MutexLock lock(&mutex_);
+    if (shared_cache_bytes_ + block_length <= kMaxSharedCacheBytes) {
+      block->next = shared_free_lists_[size_class];
+      shared_free_lists_[size_class] = block;
+      shared_cache_bytes_ += block_length;
+      return;
+    }
+  }
+  FreeToSystem(block, block_length);
+}
+
+void* HostMemoryPool::AllocateFromSystem(size_t byte_length, bool zero_fill) {
+  IREE_TRACE_SCOPE0("HostMemoryPool::AllocateFromSystem");
+  void* data =
+      zero_fill ? std::calloc(1, byte_length) : std::malloc(byte_length);
+  if (!data) return nullptr;
+  system_allocation_count_.fetch_add(1, std::memory_order_relaxed);
+  AddAndUpdatePeak(&bytes_reserved_, &bytes_reserved_peak_, byte_length);
+  return data;
+}
+
+void HostMemoryPool::FreeToSystem(void* data, size_t byte_length) {
+  std::free(data);
+  bytes_reserved_.fetch_sub(byte_length, std::memory_order_relaxed);
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+IREE_REGISTER_MODULE_INITIALIZER(iree_hal_host_memory_pool, {
+  ::iree::hal::MemoryPool::SetDefault(
+      ::iree::hal::host::HostMemoryPool::Get());
+});
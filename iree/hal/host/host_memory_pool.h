@@ -0,0 +1,143 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_HOST_MEMORY_POOL_H_
+#define IREE_HAL_HOST_HOST_MEMORY_POOL_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/hal/allocator.h"
+#include "iree/hal/memory_pool.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// A process-wide pool of host memory blocks used to back host buffers.
+//
+// Requests are rounded up to power-of-two size classes and freed blocks are
+// retained for reuse by later requests of the same class instead of being
+// returned to the system. This avoids churning the system heap (and zeroing
+// memory that is about to be overwritten) when the same function is invoked
+// repeatedly with buffers of the same sizes.
+//
+// Freed blocks are first placed in a small cache local to the freeing thread so
+// that the common allocate/free ping-pong within a thread does not contend on a
+// shared lock. Caches overflow into shared per-class free lists that any thread
+// may allocate from. Requests larger than the largest size class are passed
+// through to the system allocator directly.
+//
+// The pool installs itself as the MemoryPool::GetDefault pool when the
+// iree_hal_host_memory_pool module initializer runs.
+//
+// Thread-safe.
+class HostMemoryPool final : public MemoryPool {
+ public:
+  // Smallest and largest pooled block sizes as log2(bytes).
+  static constexpr int kMinSizeClassLog2 = 6;   // 64B
+  static constexpr int kMaxSizeClassLog2 = 26;  // 64MiB
+  static constexpr int kSizeClassCount =
+      kMaxSizeClassLog2 - kMinSizeClassLog2 + 1;
+
+  // Maximum number of bytes retained in the shared free lists. Blocks freed
+  // beyond this are returned to the system immediately.
+  static constexpr size_t kMaxSharedCacheBytes = 256 * 1024 * 1024;
+
+  // Maximum number of bytes retained per size class in a thread-local cache.
+  // Blocks of classes larger than this always go to the shared free lists so
+  // that an idle thread pins at most this many bytes per class.
+  static constexpr size_t kMaxThreadCacheBytesPerClass = 1024 * 1024;
+
+  // Returns the process-wide pool.
+  static HostMemoryPool* Get();
+
+  HostMemoryPool(const HostMemoryPool&) = delete;
+  HostMemoryPool& operator=(const HostMemoryPool&) = delete;
+
+  // Allocates a block of at least |byte_length| bytes. When |zero_fill| is set
+  // the first |byte_length| bytes are zeroed; otherwise the contents are
+  // undefined. Returns nullptr if the system is out of memory.
+  void* Allocate(size_t byte_length, bool zero_fill) override;
+
+  // Returns a block previously allocated with the same |byte_length|.
+  void Free(void* data, size_t byte_length) override;
+
+  // Releases all unused blocks in the shared free lists and the caches of all
+  // threads back to the system.
+  void Trim() override;
+
+  // Returns a snapshot of the pool statistics.
+  AllocatorStatistics statistics() const override;
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  struct ThreadCache;
+
+  HostMemoryPool() = default;
+
+  // Returns the cache of the calling thread.
+  static ThreadCache& thread_cache();
+
+  // Returns the size class index for |byte_length| or -1 if it is too large
+  // to be pooled.
+  static int SizeClassIndex(size_t byte_length);
+  static size_t SizeClassByteLength(int size_class) {
+    return size_t{1} << (size_class + kMinSizeClassLog2);
+  }
+
+  // Moves all of |cache| back into the shared free lists.
+  void FlushThreadCache(ThreadCache* cache);
+
+  void RegisterThreadCache(ThreadCache* cache);
+  void UnregisterThreadCache(ThreadCache* cache);
+
+  // Pushes |block| into the shared free list of |size_class| or returns it to
+  // the system if the shared cache is full.
+  void ReleaseToSharedCache(int size_class, FreeBlock* block);
+
+  void* AllocateFromSystem(size_t byte_length, bool zero_fill);
+  void FreeToSystem(void* data, size_t byte_length);
+
+  // Caches of all live threads that have used the pool so that Trim can drain
+  // them. Acquired before any ThreadCache::mutex.
+  absl::Mutex thread_caches_mutex_;
+  std::vector<ThreadCache*> thread_caches_
+      ABSL_GUARDED_BY(thread_caches_mutex_);
+
+  absl::Mutex mutex_;
+  std::array<FreeBlock*, kSizeClassCount> shared_free_lists_ ABSL_GUARDED_BY(
+      mutex_) = {};
+  size_t shared_cache_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  std::atomic<int64_t> bytes_allocated_{0};
+  std::atomic<int64_t> bytes_allocated_peak_{0};
+  std::atomic<int64_t> bytes_reserved_{0};
+  std::atomic<int64_t> bytes_reserved_peak_{0};
+  std::atomic<int64_t> allocation_count_{0};
+  std::atomic<int64_t> system_allocation_count_{0};
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_HOST_MEMORY_POOL_H_
@@ -0,0 +1,175 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/host_memory_pool.h"
+
+#include <cstdint>
+#include <cstring>
+#include <thread>  // NOLINT
+
+#include "absl/synchronization/notification.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+class HostMemoryPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    pool_ = HostMemoryPool::Get();
+    pool_->Trim();
+  }
+
+  HostMemoryPool* pool_ = nullptr;
+};
+
+// Tests that freed blocks are reused for requests in the same size class.
+TEST_F(HostMemoryPoolTest, ReusesFreedBlocks) {
+  void* data = pool_->Allocate(1000, /*zero_fill=*/false);
+  ASSERT_NE(nullptr, data);
+  pool_->Free(data, 1000);
+
+  auto before = pool_->statistics();
+  void* reused_data = pool_->Allocate(1024, /*zero_fill=*/false);
+  EXPECT_EQ(data, reused_data);
+  auto after = pool_->statistics();
+  EXPECT_EQ(before.system_allocation_count, after.system_allocation_count);
+  EXPECT_EQ(before.allocation_count + 1, after.allocation_count);
+  pool_->Free(reused_data, 1024);
+}
+
+// Tests that reused blocks are zeroed only when requested.
+TEST_F(HostMemoryPoolTest, ZeroFillReusedBlocks) {
+  auto* data = static_cast<uint8_t*>(pool_->Allocate(256, false));
+  ASSERT_NE(nullptr, data);
+  std::memset(data, 0xCD, 256);
+  pool_->Free(data, 256);
+
+  auto* zeroed_data = static_cast<uint8_t*>(pool_->Allocate(256, true));
+  ASSERT_EQ(data, zeroed_data);
+  for (int i = 0; i < 256; ++i) {
+    EXPECT_EQ(0, zeroed_data[i]);
+  }
+  pool_->Free(zeroed_data, 256);
+}
+
+// Tests that live bytes and the high-water mark are tracked.
+TEST_F(HostMemoryPoolTest, TracksHighWaterMark) {
+  auto before = pool_->statistics();
+  void* data0 = pool_->Allocate(4096, false);
+  void* data1 = pool_->Allocate(4096, false);
+  auto during = pool_->statistics();
+  EXPECT_EQ(before.bytes_allocated + 8192, during.bytes_allocated);
+  EXPECT_GE(during.bytes_allocated_peak, during.bytes_allocated);
+  pool_->Free(data0, 4096);
+  pool_->Free(data1, 4096);
+  auto after = pool_->statistics();
+  EXPECT_EQ(before.bytes_allocated, after.bytes_allocated);
+  EXPECT_EQ(during.bytes_allocated_peak, after.bytes_allocated_peak);
+}
+
+// Tests that trimming releases retained blocks to the system.
+TEST_F(HostMemoryPoolTest, TrimReleasesRetainedBlocks) {
+  void* data = pool_->Allocate(64 * 1024, false);
+  pool_->Free(data, 64 * 1024);
+  auto before = pool_->statistics();
+  pool_->Trim();
+  auto after = pool_->statistics();
+  EXPECT_EQ(before.bytes_reserved - 64 * 1024, after.bytes_reserved);
+}
+
+// Tests that requests larger than the largest size class pass through to the
+// system and are not retained.
+TEST_F(HostMemoryPoolTest, LargeAllocationsPassThrough) {
+  size_t byte_length = (size_t{1} << HostMemoryPool::kMaxSizeClassLog2) + 1;
+  auto before = pool_->statistics();
+  void* data = pool_->Allocate(byte_length, false);
+  ASSERT_NE(nullptr, data);
+  pool_->Free(data, byte_length);
+  auto after = pool_->statistics();
+  EXPECT_EQ(before.system_allocation_count + 1, after.system_allocation_count);
+  EXPECT_EQ(before.bytes_reserved, after.bytes_reserved);
+}
+
+// Tests that blocks cached by a thread are made available to other threads
+// once it exits.
+TEST_F(HostMemoryPoolTest, ThreadCacheFlushedOnExit) {
+  void* data = nullptr;
+  std::thread thread([&]() {
+    data = pool_->Allocate(512, false);
+    pool_->Free(data, 512);
+  });
+  thread.join();
+
+  auto before = pool_->statistics();
+  void* reused_data = pool_->Allocate(512, false);
+  EXPECT_EQ(data, reused_data);
+  auto after = pool_->statistics();
+  EXPECT_EQ(before.system_allocation_count, after.system_allocation_count);
+  pool_->Free(reused_data, 512);
+}
+
+// Tests that blocks larger than the per-class thread cache limit are shared
+// immediately instead of being pinned by the freeing thread.
+TEST_F(HostMemoryPoolTest, LargeClassesBypassThreadCache) {
+  size_t byte_length = HostMemoryPool::kMaxThreadCacheBytesPerClass * 4;
+  absl::Notification freed;
+  absl::Notification reused;
+  void* data = nullptr;
+  std::thread thread([&]() {
+    data = pool_->Allocate(byte_length, false);
+    pool_->Free(data, byte_length);
+    freed.Notify();
+    reused.WaitForNotification();
+  });
+  freed.WaitForNotification();
+
+  auto before = pool_->statistics();
+  void* reused_data = pool_->Allocate(byte_length, false);
+  EXPECT_EQ(data, reused_data);
+  auto after = pool_->statistics();
+  EXPECT_EQ(before.system_allocation_count, after.system_allocation_count);
+  pool_->Free(reused_data, byte_length);
+
+  reused.Notify();
+  thread.join();
+}
+
+// Tests that Trim releases blocks cached by threads other than the caller.
+TEST_F(HostMemoryPoolTest, TrimDrainsOtherThreadCaches) {
+  absl::Notification cached;
+  absl::Notification trimmed;
+  std::thread thread([&]() {
+    void* data = pool_->Allocate(512, false);
+    pool_->Free(data, 512);
+    cached.Notify();
+    trimmed.WaitForNotification();
+  });
+  cached.WaitForNotification();
+
+  auto before = pool_->statistics();
+  pool_->Trim();
+  auto after = pool_->statistics();
+  EXPECT_EQ(before.bytes_reserved - 512, after.bytes_reserved);
+
+  trimmed.Notify();
+  thread.join();
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
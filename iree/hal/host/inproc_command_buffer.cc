@@ -14,6 +14,7 @@
 
 #include "iree/hal/host/inproc_command_buffer.h"
 
+#include "absl/container/inlined_vector.h"
 #include "iree/base/tracing.h"
 
 namespace iree {
@@ -159,6 +160,17 @@ Status InProcCommandBuffer::PushDescriptorSet(
   return OkStatus();
 }
 
+Status InProcCommandBuffer::PushDescriptorSetIndirect(
+    ExecutableLayout* executable_layout, int32_t set,
+    absl::Span<const IndirectBinding> bindings) {
+  IREE_TRACE_SCOPE0("InProcCommandBuffer::PushDescriptorSetIndirect");
+  IREE_ASSIGN_OR_RETURN(auto* cmd, AppendCmd<PushDescriptorSetIndirectCmd>());
+  cmd->executable_layout = executable_layout;
+  cmd->set = set;
+  cmd->bindings = AppendStructSpan(bindings);
+  return OkStatus();
+}
+
 Status InProcCommandBuffer::BindDescriptorSet(
     ExecutableLayout* executable_layout, int32_t set,
     DescriptorSet* descriptor_set,
@@ -230,7 +242,9 @@ void* InProcCommandBuffer::AppendCmdData(const void* source_buffer,
   return allocated_bytes;
 }
 
-Status InProcCommandBuffer::Process(CommandBuffer* command_processor) const {
+Status InProcCommandBuffer::Process(
+    CommandBuffer* command_processor,
+    absl::Span<Buffer* const> binding_table) const {
   IREE_TRACE_SCOPE0("InProcCommandBuffer::Process");
 
   IREE_RETURN_IF_ERROR(command_processor->Begin());
@@ -239,7 +253,8 @@ Status InProcCommandBuffer::Process(CommandBuffer* command_processor) const {
   auto* cmd_list = &current_cmd_list_;
   for (CmdHeader* cmd_header = cmd_list->head; cmd_header != nullptr;
        cmd_header = cmd_header->next) {
-    auto command_status = ProcessCmd(cmd_header, command_processor);
+    auto command_status =
+        ProcessCmd(cmd_header, command_processor, binding_table);
     if (!command_status.ok()) {
       IREE_LOG(ERROR)
           << "DeviceQueue failure while executing command; permanently "
@@ -254,8 +269,9 @@ Status InProcCommandBuffer::Process(CommandBuffer* command_processor) const {
   return OkStatus();
 }
 
-Status InProcCommandBuffer::ProcessCmd(CmdHeader* cmd_header,
-                                       CommandBuffer* command_processor) const {
+Status InProcCommandBuffer::ProcessCmd(
+    CmdHeader* cmd_header, CommandBuffer* command_processor,
+    absl::Span<Buffer* const> binding_table) const {
   switch (cmd_header->type) {
     case CmdType::kExecutionBarrier: {
       auto* cmd = reinterpret_cast<ExecutionBarrierCmd*>(cmd_header + 1);
@@ -309,6 +325,28 @@ Status InProcCommandBuffer::ProcessCmd(CmdHeader* cmd_header,
       return command_processor->PushDescriptorSet(cmd->executable_layout,
                                                   cmd->set, cmd->bindings);
     }
+    case CmdType::kPushDescriptorSetIndirect: {
+      auto* cmd =
+          reinterpret_cast<PushDescriptorSetIndirectCmd*>(cmd_header + 1);
+      absl::InlinedVector<DescriptorSet::Binding, 8> bindings(
+          cmd->bindings.size());
+      for (int i = 0; i < cmd->bindings.size(); ++i) {
+        const auto& indirect_binding = cmd->bindings[i];
+        if (indirect_binding.slot < 0 ||
+            indirect_binding.slot >= binding_table.size()) {
+          return InvalidArgumentErrorBuilder(IREE_LOC)
+                 << "Binding table slot " << indirect_binding.slot
+                 << " out of range (" << binding_table.size()
+                 << " buffers provided)";
+        }
+        bindings[i].binding = indirect_binding.binding;
+        bindings[i].buffer = binding_table[indirect_binding.slot];
+        bindings[i].offset = indirect_binding.offset;
+        bindings[i].length = indirect_binding.length;
+      }
+      return command_processor->PushDescriptorSet(cmd->executable_layout,
+                                                  cmd->set, bindings);
+    }
     case CmdType::kBindDescriptorSet: {
       auto* cmd = reinterpret_cast<BindDescriptorSetCmd*>(cmd_header + 1);
       return command_processor->BindDescriptorSet(cmd->executable_layout,
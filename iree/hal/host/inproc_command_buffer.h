@@ -30,6 +30,10 @@ namespace host {
 // implementation use Process to call each command method as it was originally
 // recorded.
 //
+// Recorded commands are retained until the next Begin such that reusable
+// command buffers can be processed once per submission. Indirect bindings are
+// resolved against the binding table provided to Process.
+//
 // Thread-compatible (as with CommandBuffer itself).
 class InProcCommandBuffer final : public CommandBuffer {
  public:
@@ -81,6 +85,10 @@ class InProcCommandBuffer final : public CommandBuffer {
       ExecutableLayout* executable_layout, int32_t set,
       absl::Span<const DescriptorSet::Binding> bindings) override;
 
+  Status PushDescriptorSetIndirect(
+      ExecutableLayout* executable_layout, int32_t set,
+      absl::Span<const IndirectBinding> bindings) override;
+
   Status BindDescriptorSet(
       ExecutableLayout* executable_layout, int32_t set,
       DescriptorSet* descriptor_set,
@@ -94,8 +102,10 @@ class InProcCommandBuffer final : public CommandBuffer {
                           device_size_t workgroups_offset) override;
 
   // Processes all commands in the buffer using the given |command_processor|.
-  // The commands are issued in the order they were recorded.
-  Status Process(CommandBuffer* command_processor) const;
+  // The commands are issued in the order they were recorded. Indirect bindings
+  // are resolved to the buffers in |binding_table| by slot.
+  Status Process(CommandBuffer* command_processor,
+                 absl::Span<Buffer* const> binding_table = {}) const;
 
  private:
   // Type of Cmd, used by CmdHeader to identify the command payload.
@@ -110,6 +120,7 @@ class InProcCommandBuffer final : public CommandBuffer {
     kCopyBuffer,
     kPushConstants,
     kPushDescriptorSet,
+    kPushDescriptorSetIndirect,
     kBindDescriptorSet,
     kDispatch,
     kDispatchIndirect,
@@ -227,6 +238,14 @@ class InProcCommandBuffer final : public CommandBuffer {
     absl::Span<const DescriptorSet::Binding> bindings;
   };
 
+  // Pushes an inline descriptor set update with buffers from the binding table.
+  struct PushDescriptorSetIndirectCmd {
+    static constexpr CmdType kType = CmdType::kPushDescriptorSetIndirect;
+    ExecutableLayout* executable_layout;
+    int32_t set;
+    absl::Span<const IndirectBinding> bindings;
+  };
+
   // Binds a descriptor set.
   struct BindDescriptorSetCmd {
     static constexpr CmdType kType = CmdType::kBindDescriptorSet;
@@ -284,8 +303,8 @@ class InProcCommandBuffer final : public CommandBuffer {
   }
 
   // Processes a single command.
-  Status ProcessCmd(CmdHeader* cmd_header,
-                    CommandBuffer* command_processor) const;
+  Status ProcessCmd(CmdHeader* cmd_header, CommandBuffer* command_processor,
+                    absl::Span<Buffer* const> binding_table) const;
 
   bool is_recording_ = false;
 
@@ -0,0 +1,112 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iree/hal/host/inproc_command_buffer.h"
+
+#include "iree/base/status.h"
+#include "iree/hal/heap_buffer.h"
+#include "iree/hal/testing/mock_command_buffer.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+using ::iree::hal::testing::MockCommandBuffer;
+using ::testing::_;
+using ::testing::Return;
+
+// Matches descriptor set bindings that bind only |buffer| to binding 0.
+MATCHER_P(BindsBuffer, buffer, "") {
+  return arg.size() == 1 && arg[0].binding == 0 && arg[0].buffer == buffer &&
+         arg[0].offset == 16 && arg[0].length == 32;
+}
+
+class InProcCommandBufferTest : public ::testing::Test {
+ protected:
+  ref_ptr<Buffer> AllocateBuffer() {
+    return HeapBuffer::Allocate(BufferUsage::kAll, 64);
+  }
+
+  // Records a reusable command buffer pushing binding table slot 1 to
+  // binding 0.
+  ref_ptr<InProcCommandBuffer> RecordIndirectCommandBuffer() {
+    auto command_buffer = make_ref<InProcCommandBuffer>(
+        static_cast<CommandBufferModeBitfield>(0), CommandCategory::kDispatch);
+    IREE_CHECK_OK(command_buffer->Begin());
+    IndirectBinding binding;
+    binding.binding = 0;
+    binding.slot = 1;
+    binding.offset = 16;
+    binding.length = 32;
+    IREE_CHECK_OK(command_buffer->PushDescriptorSetIndirect(
+        /*executable_layout=*/nullptr, /*set=*/0, {binding}));
+    IREE_CHECK_OK(command_buffer->End());
+    return command_buffer;
+  }
+};
+
+// Tests that a reusable command buffer resolves its indirect bindings against
+// the binding table provided each time it is processed.
+TEST_F(InProcCommandBufferTest, ProcessesWithDifferentBindingTables) {
+  auto command_buffer = RecordIndirectCommandBuffer();
+  auto buffer_a = AllocateBuffer();
+  auto buffer_b = AllocateBuffer();
+  auto unused_buffer = AllocateBuffer();
+
+  MockCommandBuffer command_processor(CommandBufferMode::kOneShot,
+                                      CommandCategory::kDispatch);
+  {
+    ::testing::InSequence sequence;
+    EXPECT_CALL(command_processor, Begin()).WillOnce(Return(OkStatus()));
+    EXPECT_CALL(command_processor,
+                PushDescriptorSet(nullptr, 0, BindsBuffer(buffer_a.get())))
+        .WillOnce(Return(OkStatus()));
+    EXPECT_CALL(command_processor, End()).WillOnce(Return(OkStatus()));
+    EXPECT_CALL(command_processor, Begin()).WillOnce(Return(OkStatus()));
+    EXPECT_CALL(command_processor,
+                PushDescriptorSet(nullptr, 0, BindsBuffer(buffer_b.get())))
+        .WillOnce(Return(OkStatus()));
+    EXPECT_CALL(command_processor, End()).WillOnce(Return(OkStatus()));
+  }
+
+  Buffer* binding_table_a[] = {unused_buffer.get(), buffer_a.get()};
+  IREE_EXPECT_OK(command_buffer->Process(&command_processor, binding_table_a));
+  Buffer* binding_table_b[] = {unused_buffer.get(), buffer_b.get()};
+  IREE_EXPECT_OK(command_buffer->Process(&command_processor, binding_table_b));
+}
+
+// Tests that referencing a slot beyond the end of the binding table fails the
+// command buffer instead of binding an arbitrary buffer.
+TEST_F(InProcCommandBufferTest, OutOfRangeSlotFails) {
+  auto command_buffer = RecordIndirectCommandBuffer();
+  auto buffer = AllocateBuffer();
+
+  MockCommandBuffer command_processor(CommandBufferMode::kOneShot,
+                                      CommandCategory::kDispatch);
+  EXPECT_CALL(command_processor, Begin()).WillOnce(Return(OkStatus()));
+  EXPECT_CALL(command_processor, PushDescriptorSet(_, _, _)).Times(0);
+
+  Buffer* binding_table[] = {buffer.get()};
+  EXPECT_TRUE(IsInvalidArgument(
+      command_buffer->Process(&command_processor, binding_table)));
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,126 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/parallel/parallel_command_processor.h"
+
+#include <algorithm>
+
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+namespace {
+
+// Transfers smaller than this run on the calling thread as waking workers
+// costs more than the parallelism saves.
+constexpr device_size_t kParallelTransferMinLength = 2 * 1024 * 1024;
+
+// Granularity at which large transfers are split. Must be a multiple of all
+// supported fill pattern lengths.
+constexpr device_size_t kParallelTransferBlockLength = 256 * 1024;
+
+// Splits [0, |length|) into blocks and calls |fn| with the byte offset and
+// length of each block from threads across |pool|.
+template <typename F>
+Status ParallelForBlocks(WorkStealingPool* pool, device_size_t length, F fn) {
+  uint32_t block_count = static_cast<uint32_t>(
+      (length + kParallelTransferBlockLength - 1) /
+      kParallelTransferBlockLength);
+  return pool->ParallelFor(
+      block_count, /*min_chunk_size=*/1,
+      [&](uint32_t begin, uint32_t end) -> Status {
+        device_size_t block_offset = begin * kParallelTransferBlockLength;
+        device_size_t block_end =
+            std::min(length, end * kParallelTransferBlockLength);
+        return fn(block_offset, block_end - block_offset);
+      });
+}
+
+}  // namespace
+
+ParallelCommandProcessor::ParallelCommandProcessor(
+    CommandCategoryBitfield command_categories, WorkStealingPool* pool)
+    : SerialCommandProcessor(command_categories), pool_(pool) {}
+
+ParallelCommandProcessor::~ParallelCommandProcessor() = default;
+
+Status ParallelCommandProcessor::FillBuffer(Buffer* target_buffer,
+                                            device_size_t target_offset,
+                                            device_size_t length,
+                                            const void* pattern,
+                                            size_t pattern_length) {
+  // kWholeBuffer lengths are rare in practice and left to the serial path
+  // to resolve.
+  if (length < kParallelTransferMinLength || length == kWholeBuffer) {
+    return SerialCommandProcessor::FillBuffer(target_buffer, target_offset,
+                                              length, pattern, pattern_length);
+  }
+  IREE_TRACE_SCOPE0("ParallelCommandProcessor::FillBuffer");
+  return ParallelForBlocks(
+      pool_, length,
+      [&](device_size_t block_offset, device_size_t block_length) {
+        return target_buffer->Fill(target_offset + block_offset, block_length,
+                                   pattern, pattern_length);
+      });
+}
+
+Status ParallelCommandProcessor::CopyBuffer(Buffer* source_buffer,
+                                            device_size_t source_offset,
+                                            Buffer* target_buffer,
+                                            device_size_t target_offset,
+                                            device_size_t length) {
+  if (length < kParallelTransferMinLength || length == kWholeBuffer) {
+    return SerialCommandProcessor::CopyBuffer(
+        source_buffer, source_offset, target_buffer, target_offset, length);
+  }
+  IREE_TRACE_SCOPE0("ParallelCommandProcessor::CopyBuffer");
+  return ParallelForBlocks(
+      pool_, length,
+      [&](device_size_t block_offset, device_size_t block_length) {
+        return target_buffer->CopyData(target_offset + block_offset,
+                                       source_buffer,
+                                       source_offset + block_offset,
+                                       block_length);
+      });
+}
+
+Status ParallelCommandProcessor::DispatchTiles(
+    HostExecutable* executable, HostExecutable::DispatchState* dispatch_state,
+    std::array<uint32_t, 3> workgroup_count) {
+  IREE_TRACE_SCOPE0("ParallelCommandProcessor::DispatchTiles");
+
+  // Flatten the grid so that chunks are contiguous runs of tiles in x-major
+  // order (matching the serial processor traversal order).
+  uint32_t count_x = workgroup_count[0];
+  uint32_t count_xy = workgroup_count[0] * workgroup_count[1];
+  uint32_t tile_count = count_xy * workgroup_count[2];
+  return pool_->ParallelFor(
+      tile_count, /*min_chunk_size=*/1,
+      [&](uint32_t begin, uint32_t end) -> Status {
+        for (uint32_t i = begin; i < end; ++i) {
+          uint32_t z = i / count_xy;
+          uint32_t y = (i % count_xy) / count_x;
+          uint32_t x = i % count_x;
+          IREE_RETURN_IF_ERROR(
+              executable->DispatchTile(dispatch_state, {x, y, z}));
+        }
+        return OkStatus();
+      });
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
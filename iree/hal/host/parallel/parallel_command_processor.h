@@ -0,0 +1,59 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_PARALLEL_PARALLEL_COMMAND_PROCESSOR_H_
+#define IREE_HAL_HOST_PARALLEL_PARALLEL_COMMAND_PROCESSOR_H_
+
+#include "iree/hal/host/parallel/work_stealing_pool.h"
+#include "iree/hal/host/serial/serial_command_processor.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Host-local command processor that distributes the tiles of each dispatch
+// across a WorkStealingPool. Commands are still processed in-order and each
+// dispatch completes before the next command is processed; only the tiles
+// within a single dispatch run concurrently. Large fills and copies are
+// likewise split into blocks that are processed across the pool.
+//
+// Thread-compatible (as with CommandBuffer itself).
+class ParallelCommandProcessor : public SerialCommandProcessor {
+ public:
+  ParallelCommandProcessor(CommandCategoryBitfield command_categories,
+                           WorkStealingPool* pool);
+  ~ParallelCommandProcessor() override;
+
+  Status FillBuffer(Buffer* target_buffer, device_size_t target_offset,
+                    device_size_t length, const void* pattern,
+                    size_t pattern_length) override;
+
+  Status CopyBuffer(Buffer* source_buffer, device_size_t source_offset,
+                    Buffer* target_buffer, device_size_t target_offset,
+                    device_size_t length) override;
+
+ protected:
+  Status DispatchTiles(HostExecutable* executable,
+                       HostExecutable::DispatchState* dispatch_state,
+                       std::array<uint32_t, 3> workgroup_count) override;
+
+ private:
+  WorkStealingPool* pool_;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_PARALLEL_PARALLEL_COMMAND_PROCESSOR_H_
@@ -0,0 +1,148 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/parallel/parallel_scheduling_model.h"
+
+#include "absl/flags/flag.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/host/condvar_semaphore.h"
+#include "iree/hal/host/inproc_command_buffer.h"
+#include "iree/hal/host/nop_event.h"
+#include "iree/hal/host/parallel/parallel_command_processor.h"
+#include "iree/hal/host/serial/async_command_queue.h"
+
+ABSL_FLAG(int, host_worker_count, 0,
+          "Number of worker threads used to process dispatch tiles on "
+          "host-local devices. 0 uses one worker per logical core.");
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// A CommandQueue that performs no synchronization (semaphores/fences) and
+// directly executes command buffers inline with tiles fanned out to |pool|.
+//
+// This is meant to be wrapped by AsyncCommandQueue which handles all
+// synchronization and threading of the submissions themselves.
+class UnsynchronizedParallelCommandQueue final : public CommandQueue {
+ public:
+  UnsynchronizedParallelCommandQueue(
+      std::string name, CommandCategoryBitfield supported_categories,
+      WorkStealingPool* pool)
+      : CommandQueue(std::move(name), supported_categories), pool_(pool) {}
+  ~UnsynchronizedParallelCommandQueue() override = default;
+
+  Status Submit(absl::Span<const SubmissionBatch> batches) override {
+    IREE_TRACE_SCOPE0("UnsynchronizedParallelCommandQueue::Submit");
+    for (auto& batch : batches) {
+      IREE_DCHECK(batch.wait_semaphores.empty() &&
+                  batch.signal_semaphores.empty())
+          << "Semaphores must be handled by the wrapping queue";
+      IREE_RETURN_IF_ERROR(
+          ProcessCommandBuffers(batch.command_buffers, batch.binding_table));
+    }
+    return OkStatus();
+  }
+
+  Status WaitIdle(Time deadline_ns) override {
+    // No-op.
+    return OkStatus();
+  }
+
+ private:
+  // Processes each command buffer in-turn with a fresh processor.
+  // This ensures we don't have any state that can carry across buffers.
+  Status ProcessCommandBuffers(absl::Span<CommandBuffer* const> command_buffers,
+                               absl::Span<Buffer* const> binding_table) {
+    IREE_TRACE_SCOPE0(
+        "UnsynchronizedParallelCommandQueue::ProcessCommandBuffers");
+    for (auto* command_buffer : command_buffers) {
+      auto* inproc_command_buffer =
+          static_cast<InProcCommandBuffer*>(command_buffer->impl());
+      ParallelCommandProcessor command_processor(supported_categories(), pool_);
+      IREE_RETURN_IF_ERROR(
+          inproc_command_buffer->Process(&command_processor, binding_table));
+    }
+    return OkStatus();
+  }
+
+  WorkStealingPool* pool_;
+};
+
+}  // namespace
+
+ParallelSchedulingModel::ParallelSchedulingModel(int worker_count) {
+  IREE_TRACE_SCOPE0("ParallelSchedulingModel::ctor");
+  if (worker_count <= 0) {
+    worker_count = absl::GetFlag(FLAGS_host_worker_count);
+  }
+  pool_ = absl::make_unique<WorkStealingPool>(worker_count);
+
+  // We currently only expose a single command queue; parallelism comes from
+  // the tiles within each dispatch.
+  auto command_queue = absl::make_unique<UnsynchronizedParallelCommandQueue>(
+      "cpu0", CommandCategory::kTransfer | CommandCategory::kDispatch,
+      pool_.get());
+
+  // Wrap in the simple async command queue.
+  auto async_command_queue =
+      absl::make_unique<AsyncCommandQueue>(std::move(command_queue));
+  command_queues_.push_back(std::move(async_command_queue));
+}
+
+ParallelSchedulingModel::~ParallelSchedulingModel() {
+  // Queues must be torn down before the pool their processors dispatch into.
+  command_queues_.clear();
+  pool_.reset();
+}
+
+StatusOr<ref_ptr<CommandBuffer>> ParallelSchedulingModel::CreateCommandBuffer(
+    CommandBufferModeBitfield mode,
+    CommandCategoryBitfield command_categories) {
+  return make_ref<InProcCommandBuffer>(mode, command_categories);
+}
+
+StatusOr<ref_ptr<Event>> ParallelSchedulingModel::CreateEvent() {
+  return make_ref<NopEvent>();
+}
+
+StatusOr<ref_ptr<Semaphore>> ParallelSchedulingModel::CreateSemaphore(
+    uint64_t initial_value) {
+  return make_ref<CondVarSemaphore>(initial_value);
+}
+
+Status ParallelSchedulingModel::WaitAllSemaphores(
+    absl::Span<const SemaphoreValue> semaphores, Time deadline_ns) {
+  return CondVarSemaphore::WaitForSemaphores(semaphores, /*wait_all=*/true,
+                                             deadline_ns)
+      .status();
+}
+
+StatusOr<int> ParallelSchedulingModel::WaitAnySemaphore(
+    absl::Span<const SemaphoreValue> semaphores, Time deadline_ns) {
+  return CondVarSemaphore::WaitForSemaphores(semaphores, /*wait_all=*/false,
+                                             deadline_ns);
+}
+
+Status ParallelSchedulingModel::WaitIdle(Time deadline_ns) {
+  for (auto& command_queue : command_queues_) {
+    IREE_RETURN_IF_ERROR(command_queue->WaitIdle(deadline_ns));
+  }
+  return OkStatus();
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,72 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_PARALLEL_PARALLEL_SCHEDULING_MODEL_H_
+#define IREE_HAL_HOST_PARALLEL_PARALLEL_SCHEDULING_MODEL_H_
+
+#include <memory>
+
+#include "absl/container/inlined_vector.h"
+#include "iree/base/memory.h"
+#include "iree/hal/host/parallel/work_stealing_pool.h"
+#include "iree/hal/host/scheduling_model.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Performs host-local scheduling with an in-order submission queue (as with
+// SerialSchedulingModel) but distributes the tiles of each dispatch across a
+// pool of pinned worker threads. Tiles are split into chunked ranges that
+// workers steal from each other to balance out uneven tile costs.
+class ParallelSchedulingModel final : public SchedulingModel {
+ public:
+  // Creates a scheduling model with a pool of |worker_count| threads. If 0 the
+  // --host_worker_count flag is used (which defaults to one per core).
+  explicit ParallelSchedulingModel(int worker_count = 0);
+  ~ParallelSchedulingModel() override;
+
+  absl::Span<CommandQueue*> dispatch_queues() const override {
+    return RawPtrSpan(absl::MakeSpan(command_queues_));
+  }
+
+  absl::Span<CommandQueue*> transfer_queues() const override {
+    return RawPtrSpan(absl::MakeSpan(command_queues_));
+  }
+
+  StatusOr<ref_ptr<CommandBuffer>> CreateCommandBuffer(
+      CommandBufferModeBitfield mode,
+      CommandCategoryBitfield command_categories) override;
+
+  StatusOr<ref_ptr<Event>> CreateEvent() override;
+
+  StatusOr<ref_ptr<Semaphore>> CreateSemaphore(uint64_t initial_value) override;
+
+  Status WaitAllSemaphores(absl::Span<const SemaphoreValue> semaphores,
+                           Time deadline_ns) override;
+  StatusOr<int> WaitAnySemaphore(absl::Span<const SemaphoreValue> semaphores,
+                                 Time deadline_ns) override;
+  Status WaitIdle(Time deadline_ns) override;
+
+ private:
+  // Shared by all queues. Declared before the queues so that it outlives them.
+  std::unique_ptr<WorkStealingPool> pool_;
+  mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 4> command_queues_;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_PARALLEL_PARALLEL_SCHEDULING_MODEL_H_
@@ -0,0 +1,226 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/parallel/work_stealing_pool.h"
+
+#include <algorithm>
+#include <string>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "iree/base/target_platform.h"
+#include "iree/base/tracing.h"
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+#include <pthread.h>
+#include <sched.h>
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
+namespace iree {
+namespace hal {
+namespace host {
+
+namespace {
+
+// Number of chunks we try to produce per participating thread. Having more than
+// one chunk per thread gives the stealing a chance to balance out tiles with
+// uneven cost without making chunks so small that the deque traffic dominates.
+constexpr uint32_t kChunksPerThread = 4;
+
+// Pins the calling thread to the logical core |cpu_index|.
+// No-op on platforms where we don't (yet) support affinity control.
+void PinCurrentThreadToCore(int cpu_index) {
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu_index, &cpu_set);
+  pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+}
+
+}  // namespace
+
+// State shared by all chunks issued from a single ParallelFor call.
+// Lives on the stack of the calling thread for the duration of the call.
+struct WorkStealingPool::Task {
+  Task(RangeFn fn, int chunk_count) : fn(fn), remaining(chunk_count) {}
+
+  RangeFn fn;
+
+  // Set once any chunk fails so that unstarted chunks can be skipped.
+  std::atomic<bool> failed{false};
+  absl::Mutex status_mutex;
+  Status status ABSL_GUARDED_BY(status_mutex);
+
+  // Outstanding chunk count; the caller waits for this to reach zero.
+  absl::BlockingCounter remaining;
+};
+
+WorkStealingPool::WorkStealingPool(int worker_count) {
+  IREE_TRACE_SCOPE0("WorkStealingPool::ctor");
+  int core_count = static_cast<int>(std::thread::hardware_concurrency());
+  if (worker_count <= 0) {
+    worker_count = std::max(1, core_count);
+  }
+  workers_.reserve(worker_count);
+  for (int i = 0; i < worker_count; ++i) {
+    workers_.push_back(absl::make_unique<Worker>());
+  }
+  // Start threads only after all workers exist as they steal from each other.
+  for (int i = 0; i < worker_count; ++i) {
+    workers_[i]->thread = std::thread([this, i]() { ThreadMain(i); });
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  IREE_TRACE_SCOPE0("WorkStealingPool::dtor");
+  {
+    absl::MutexLock lock(&idle_mutex_);
+    shutdown_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void WorkStealingPool::ThreadMain(int worker_index) {
+  std::string thread_name = "worker" + std::to_string(worker_index);
+  IREE_TRACE_SET_THREAD_NAME(thread_name.c_str());
+
+  int core_count = static_cast<int>(std::thread::hardware_concurrency());
+  if (core_count > 0) {
+    PinCurrentThreadToCore(worker_index % core_count);
+  }
+
+  while (true) {
+    Chunk chunk;
+    if (TryClaimChunk(worker_index, &chunk)) {
+      RunChunk(chunk);
+      continue;
+    }
+
+    // Nothing to steal; park until more chunks are queued or we are asked to
+    // exit. Pending chunks are always drained before exiting.
+    absl::MutexLock lock(&idle_mutex_);
+    idle_mutex_.Await(
+        absl::Condition(this, &WorkStealingPool::HasPendingWorkOrShutdown));
+    if (shutdown_ &&
+        pending_chunk_count_.load(std::memory_order_acquire) <= 0) {
+      break;
+    }
+  }
+}
+
+bool WorkStealingPool::HasPendingWorkOrShutdown() {
+  return shutdown_ || pending_chunk_count_.load(std::memory_order_acquire) > 0;
+}
+
+bool WorkStealingPool::TryClaimChunk(int worker_index, Chunk* out_chunk) {
+  int worker_count = static_cast<int>(workers_.size());
+
+  // Pop from the back of our own deque first (LIFO for locality).
+  if (worker_index >= 0) {
+    auto* worker = workers_[worker_index].get();
+    absl::MutexLock lock(&worker->mutex);
+    if (!worker->chunks.empty()) {
+      *out_chunk = worker->chunks.back();
+      worker->chunks.pop_back();
+      pending_chunk_count_.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+  }
+
+  // Steal from the front of the other deques, starting with our neighbor so
+  // that thieves spread out across victims.
+  int start_index = worker_index >= 0 ? worker_index + 1 : 0;
+  for (int i = 0; i < worker_count; ++i) {
+    int victim_index = (start_index + i) % worker_count;
+    if (victim_index == worker_index) continue;
+    auto* victim = workers_[victim_index].get();
+    absl::MutexLock lock(&victim->mutex);
+    if (!victim->chunks.empty()) {
+      *out_chunk = victim->chunks.front();
+      victim->chunks.pop_front();
+      pending_chunk_count_.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// static
+void WorkStealingPool::RunChunk(const Chunk& chunk) {
+  IREE_TRACE_SCOPE0("WorkStealingPool::RunChunk");
+  Task* task = chunk.task;
+  if (!task->failed.load(std::memory_order_acquire)) {
+    Status status = task->fn(chunk.begin, chunk.end);
+    if (!status.ok()) {
+      absl::MutexLock lock(&task->status_mutex);
+      if (task->status.ok()) task->status = std::move(status);
+      task->failed.store(true, std::memory_order_release);
+    }
+  }
+  // NOTE: |task| may be deleted as soon as the count is decremented.
+  task->remaining.DecrementCount();
+}
+
+Status WorkStealingPool::ParallelFor(uint32_t item_count,
+                                     uint32_t min_chunk_size, RangeFn fn) {
+  IREE_TRACE_SCOPE0("WorkStealingPool::ParallelFor");
+  if (item_count == 0) return OkStatus();
+
+  uint32_t thread_count = static_cast<uint32_t>(workers_.size()) + 1;
+  uint32_t target_chunk_count = thread_count * kChunksPerThread;
+  uint32_t chunk_size =
+      (item_count + target_chunk_count - 1) / target_chunk_count;
+  chunk_size = std::max(chunk_size, std::max(min_chunk_size, 1u));
+  uint32_t chunk_count = (item_count + chunk_size - 1) / chunk_size;
+  if (chunk_count == 1) {
+    // Not worth waking anyone up; run inline.
+    return fn(0, item_count);
+  }
+
+  Task task(fn, static_cast<int>(chunk_count));
+  uint32_t worker_cursor =
+      next_worker_.fetch_add(chunk_count, std::memory_order_relaxed);
+  for (uint32_t begin = 0; begin < item_count; begin += chunk_size) {
+    uint32_t end = std::min(item_count, begin + chunk_size);
+    auto* worker = workers_[worker_cursor++ % workers_.size()].get();
+    absl::MutexLock lock(&worker->mutex);
+    worker->chunks.push_back({&task, begin, end});
+  }
+  {
+    // Publish under the idle mutex so that parked workers re-evaluate their
+    // wait condition.
+    absl::MutexLock lock(&idle_mutex_);
+    pending_chunk_count_.fetch_add(static_cast<int>(chunk_count),
+                                   std::memory_order_acq_rel);
+  }
+
+  // Help out until there is nothing left to claim and then wait for the chunks
+  // still running on workers to finish.
+  Chunk chunk;
+  while (TryClaimChunk(/*worker_index=*/-1, &chunk)) {
+    RunChunk(chunk);
+  }
+  task.remaining.Wait();
+
+  absl::MutexLock lock(&task.status_mutex);
+  return std::move(task.status);
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,117 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_PARALLEL_WORK_STEALING_POOL_H_
+#define IREE_HAL_HOST_PARALLEL_WORK_STEALING_POOL_H_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/status.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// A fixed-size pool of worker threads that cooperatively process index ranges.
+//
+// Each ParallelFor call splits its [0, item_count) range into chunks that are
+// distributed round-robin across per-worker deques. Workers pop chunks from the
+// back of their own deque (keeping recently-touched data hot) and when empty
+// steal from the front of other workers' deques. The calling thread also
+// participates in processing until all chunks have been claimed so that a
+// ParallelFor issued from a pool-external thread never idles a core.
+//
+// Workers are pinned to individual logical cores when the platform supports it
+// to avoid the OS migrating them between cores mid-dispatch.
+//
+// Thread-safe; multiple threads may issue ParallelFor concurrently and their
+// chunks will be interleaved across the workers.
+class WorkStealingPool final {
+ public:
+  // Processes the half-open range [begin, end) of items.
+  using RangeFn = absl::FunctionRef<Status(uint32_t begin, uint32_t end)>;
+
+  // Creates a pool with |worker_count| threads. A |worker_count| of 0 will use
+  // one worker per logical core reported by the system.
+  explicit WorkStealingPool(int worker_count = 0);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  // Total number of worker threads in the pool (excluding callers).
+  int worker_count() const { return static_cast<int>(workers_.size()); }
+
+  // Processes all items in [0, |item_count|) by calling |fn| with ranges of at
+  // least |min_chunk_size| items (except possibly the last). Blocks the caller
+  // until all ranges have been processed.
+  //
+  // Returns the first error returned by |fn|. After an error no new ranges will
+  // be started though ranges already in-flight on other threads will complete.
+  Status ParallelFor(uint32_t item_count, uint32_t min_chunk_size, RangeFn fn);
+
+ private:
+  struct Task;
+
+  // A contiguous range of items from a single ParallelFor task.
+  struct Chunk {
+    Task* task;
+    uint32_t begin;
+    uint32_t end;
+  };
+
+  struct Worker {
+    std::thread thread;
+    absl::Mutex mutex;
+    std::deque<Chunk> chunks ABSL_GUARDED_BY(mutex);
+  };
+
+  // Thread entry point for the worker with the given |worker_index|.
+  void ThreadMain(int worker_index);
+
+  // Returns true if parked workers should wake up.
+  bool HasPendingWorkOrShutdown() ABSL_EXCLUSIVE_LOCKS_REQUIRED(idle_mutex_);
+
+  // Tries to claim a chunk from the worker's own deque and, failing that, from
+  // any other worker. Pass -1 as |worker_index| for non-pool threads.
+  bool TryClaimChunk(int worker_index, Chunk* out_chunk);
+
+  // Runs |chunk| and marks it complete on its task.
+  static void RunChunk(const Chunk& chunk);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Total number of unclaimed chunks across all worker deques. Used to park
+  // workers when there is nothing to steal.
+  std::atomic<int> pending_chunk_count_{0};
+
+  // Round-robin cursor used when distributing chunks to worker deques.
+  std::atomic<uint32_t> next_worker_{0};
+
+  absl::Mutex idle_mutex_;
+  bool shutdown_ ABSL_GUARDED_BY(idle_mutex_) = false;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_PARALLEL_WORK_STEALING_POOL_H_
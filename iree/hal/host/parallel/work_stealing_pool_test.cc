@@ -0,0 +1,113 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/parallel/work_stealing_pool.h"
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "iree/base/status.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// Tests that every item is visited exactly once.
+TEST(WorkStealingPoolTest, VisitsAllItemsOnce) {
+  WorkStealingPool pool(4);
+  std::vector<std::atomic<int>> visits(1000);
+  IREE_ASSERT_OK(pool.ParallelFor(
+      visits.size(), /*min_chunk_size=*/1,
+      [&](uint32_t begin, uint32_t end) -> Status {
+        for (uint32_t i = begin; i < end; ++i) {
+          visits[i].fetch_add(1);
+        }
+        return OkStatus();
+      }));
+  for (auto& visit_count : visits) {
+    EXPECT_EQ(1, visit_count.load());
+  }
+}
+
+// Tests that empty and single-item ranges are handled without deadlocking.
+TEST(WorkStealingPoolTest, TinyRanges) {
+  WorkStealingPool pool(2);
+  int call_count = 0;
+  IREE_ASSERT_OK(pool.ParallelFor(0, 1, [&](uint32_t begin, uint32_t end) {
+    ++call_count;
+    return OkStatus();
+  }));
+  EXPECT_EQ(0, call_count);
+  IREE_ASSERT_OK(pool.ParallelFor(1, 1, [&](uint32_t begin, uint32_t end) {
+    EXPECT_EQ(0, begin);
+    EXPECT_EQ(1, end);
+    ++call_count;
+    return OkStatus();
+  }));
+  EXPECT_EQ(1, call_count);
+}
+
+// Tests that ranges are never smaller than the requested minimum chunk size.
+TEST(WorkStealingPoolTest, MinChunkSize) {
+  WorkStealingPool pool(4);
+  std::atomic<int> small_chunk_count{0};
+  IREE_ASSERT_OK(pool.ParallelFor(
+      1024, /*min_chunk_size=*/64, [&](uint32_t begin, uint32_t end) {
+        if (end - begin < 64) small_chunk_count.fetch_add(1);
+        return OkStatus();
+      }));
+  EXPECT_EQ(0, small_chunk_count.load());
+}
+
+// Tests that errors from any range are propagated to the caller.
+TEST(WorkStealingPoolTest, PropagatesErrors) {
+  WorkStealingPool pool(4);
+  auto fail_on_100 = [](uint32_t begin, uint32_t end) -> Status {
+    if (begin <= 100 && 100 < end) {
+      return DataLossErrorBuilder(IREE_LOC) << "tile 100";
+    }
+    return OkStatus();
+  };
+  auto status = pool.ParallelFor(256, /*min_chunk_size=*/1, fail_on_100);
+  EXPECT_TRUE(IsDataLoss(status));
+}
+
+// Tests that multiple threads can issue work into the same pool concurrently.
+TEST(WorkStealingPoolTest, ConcurrentCallers) {
+  WorkStealingPool pool(4);
+  std::atomic<int> total{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 16; ++j) {
+        IREE_CHECK_OK(pool.ParallelFor(
+            128, /*min_chunk_size=*/1, [&](uint32_t begin, uint32_t end) {
+              total.fetch_add(end - begin);
+              return OkStatus();
+            }));
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(4 * 16 * 128, total.load());
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -66,7 +66,8 @@ void AsyncCommandQueue::ThreadMain() {
       submission_mutex_.AssertHeld();
       submission_queue_
           .ProcessBatches(
-              [this](absl::Span<CommandBuffer* const> command_buffers)
+              [this](absl::Span<CommandBuffer* const> command_buffers,
+                     absl::Span<Buffer* const> binding_table)
                   ABSL_EXCLUSIVE_LOCKS_REQUIRED(submission_mutex_) {
                     // Release the lock while we perform the processing so that
                     // other threads can submit more work.
@@ -76,8 +77,8 @@ void AsyncCommandQueue::ThreadMain() {
                     // Relay the command buffers to the target queue.
                     // Since we are taking care of all synchronization they
                     // don't need any waiters or semaphores.
-                    auto status =
-                        target_queue_->Submit({{}, command_buffers, {}});
+                    auto status = target_queue_->Submit(
+                        {{}, command_buffers, {}, binding_table});
 
                     // Take back the lock so we can manipulate the queue safely.
                     submission_mutex_.Lock();
@@ -226,11 +226,19 @@ Status SerialCommandProcessor::DispatchGrid(
   auto* host_executable = reinterpret_cast<HostExecutable*>(executable);
   IREE_ASSIGN_OR_RETURN(auto dispatch_state,
                         host_executable->PrepareDispatch(params));
-  for (uint32_t z = 0; z < params.workgroup_count[2]; ++z) {
-    for (uint32_t y = 0; y < params.workgroup_count[1]; ++y) {
-      for (uint32_t x = 0; x < params.workgroup_count[0]; ++x) {
+  return DispatchTiles(host_executable, dispatch_state.get(),
+                       params.workgroup_count);
+}
+
+Status SerialCommandProcessor::DispatchTiles(
+    HostExecutable* executable, HostExecutable::DispatchState* dispatch_state,
+    std::array<uint32_t, 3> workgroup_count) {
+  IREE_TRACE_SCOPE0("SerialCommandProcessor::DispatchTiles");
+  for (uint32_t z = 0; z < workgroup_count[2]; ++z) {
+    for (uint32_t y = 0; y < workgroup_count[1]; ++y) {
+      for (uint32_t x = 0; x < workgroup_count[0]; ++x) {
         IREE_RETURN_IF_ERROR(
-            host_executable->DispatchTile(dispatch_state.get(), {x, y, z}));
+            executable->DispatchTile(dispatch_state, {x, y, z}));
       }
     }
   }
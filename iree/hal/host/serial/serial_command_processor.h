@@ -28,10 +28,12 @@ namespace host {
 // This assumes that all buffers are host-visible (if not local) and that all
 // buffers can be mapped for access.
 //
-// Uses HostExecutable to perform tiled dispatch processing.
+// Uses HostExecutable to perform tiled dispatch processing. Tiles are processed
+// serially on the calling thread; subclasses may override DispatchTiles to
+// distribute them (see ParallelCommandProcessor).
 //
 // Thread-compatible (as with CommandBuffer itself).
-class SerialCommandProcessor final : public CommandBuffer {
+class SerialCommandProcessor : public CommandBuffer {
  public:
   explicit SerialCommandProcessor(CommandCategoryBitfield command_categories);
   ~SerialCommandProcessor() override;
@@ -92,6 +94,13 @@ class SerialCommandProcessor final : public CommandBuffer {
                           Buffer* workgroups_buffer,
                           device_size_t workgroups_offset) override;
 
+ protected:
+  // Processes all tiles in the |workgroup_count| grid of a prepared dispatch.
+  // Returns only after all tiles have completed (or one has failed).
+  virtual Status DispatchTiles(HostExecutable* executable,
+                               HostExecutable::DispatchState* dispatch_state,
+                               std::array<uint32_t, 3> workgroup_count);
+
  private:
   Status DispatchGrid(Executable* executable, int32_t entry_point,
                       std::array<uint32_t, 3> workgroup_count);
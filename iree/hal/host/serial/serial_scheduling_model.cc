@@ -53,7 +53,8 @@ class UnsynchronizedCommandQueue final : public CommandQueue {
       IREE_DCHECK(batch.wait_semaphores.empty() &&
                   batch.signal_semaphores.empty())
           << "Semaphores must be handled by the wrapping queue";
-      IREE_RETURN_IF_ERROR(ProcessCommandBuffers(batch.command_buffers));
+      IREE_RETURN_IF_ERROR(
+          ProcessCommandBuffers(batch.command_buffers, batch.binding_table));
     }
 
     return OkStatus();
@@ -67,14 +68,15 @@ class UnsynchronizedCommandQueue final : public CommandQueue {
  private:
   // Processes each command buffer in-turn with a fresh processor.
   // This ensures we don't have any state that can carry across buffers.
-  Status ProcessCommandBuffers(
-      absl::Span<CommandBuffer* const> command_buffers) {
+  Status ProcessCommandBuffers(absl::Span<CommandBuffer* const> command_buffers,
+                               absl::Span<Buffer* const> binding_table) {
     IREE_TRACE_SCOPE0("UnsynchronizedCommandQueue::ProcessCommandBuffers");
     for (auto* command_buffer : command_buffers) {
       auto* inproc_command_buffer =
           static_cast<InProcCommandBuffer*>(command_buffer->impl());
       SerialCommandProcessor command_processor(supported_categories());
-      IREE_RETURN_IF_ERROR(inproc_command_buffer->Process(&command_processor));
+      IREE_RETURN_IF_ERROR(
+          inproc_command_buffer->Process(&command_processor, binding_table));
     }
     return OkStatus();
   }
@@ -113,7 +115,8 @@ StatusOr<ref_ptr<Semaphore>> SerialSchedulingModel::CreateSemaphore(
 Status SerialSchedulingModel::WaitAllSemaphores(
     absl::Span<const SemaphoreValue> semaphores, Time deadline_ns) {
   return CondVarSemaphore::WaitForSemaphores(semaphores, /*wait_all=*/true,
-                                             deadline_ns);
+                                             deadline_ns)
+      .status();
 }
 
 StatusOr<int> SerialSchedulingModel::WaitAnySemaphore(
@@ -0,0 +1,211 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "iree/hal/host/serial/serial_scheduling_model.h"
+
+#include <memory>
+
+#include "iree/base/status.h"
+#include "iree/base/time.h"
+#include "iree/hal/api.h"
+#include "iree/hal/host/host_executable.h"
+#include "iree/hal/host/host_local_device.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// Host-local device using the serial scheduling model.
+class TestDevice final : public HostLocalDevice {
+ public:
+  TestDevice()
+      : HostLocalDevice(DeviceInfo("test", "Test", DeviceFeature::kNone),
+                        std::make_unique<SerialSchedulingModel>()) {}
+
+  ref_ptr<ExecutableCache> CreateExecutableCache() override { return {}; }
+};
+
+// Executable that fills the buffer bound to set 0 binding 0 with the entry
+// point ordinal.
+class FillExecutable final : public HostExecutable {
+ public:
+  bool supports_debugging() const override { return false; }
+
+  StatusOr<ref_ptr<DispatchState>> PrepareDispatch(
+      const DispatchParams& params) override {
+    auto dispatch_state = make_ref<FillDispatchState>();
+    dispatch_state->value = static_cast<uint32_t>(params.entry_point);
+    dispatch_state->binding = params.set_bindings[0][0];
+    return dispatch_state;
+  }
+
+  Status DispatchTile(DispatchState* state,
+                      std::array<uint32_t, 3> workgroup_xyz) override {
+    auto* dispatch_state = static_cast<FillDispatchState*>(state);
+    const auto& binding = dispatch_state->binding;
+    return binding.buffer->Fill32(binding.offset, binding.length,
+                                  dispatch_state->value);
+  }
+
+ private:
+  struct FillDispatchState : public DispatchState {
+    uint32_t value = 0;
+    DescriptorSet::Binding binding;
+  };
+};
+
+class SerialSchedulingModelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    device_ = make_ref<TestDevice>();
+    IREE_ASSERT_OK_AND_ASSIGN(
+        set_layout_, device_->CreateDescriptorSetLayout(
+                         DescriptorSetLayout::UsageType::kPushOnly,
+                         {{0, DescriptorType::kStorageBuffer,
+                           MemoryAccess::kWrite}}));
+    IREE_ASSERT_OK_AND_ASSIGN(
+        executable_layout_,
+        device_->CreateExecutableLayout({set_layout_.get()}, 0));
+    IREE_ASSERT_OK_AND_ASSIGN(semaphore_, device_->CreateSemaphore(0ull));
+  }
+
+  ref_ptr<Buffer> AllocateBuffer() {
+    return device_->allocator()
+        ->Allocate(MemoryType::kHostLocal | MemoryType::kDeviceVisible,
+                   BufferUsage::kAll, sizeof(uint32_t))
+        .value();
+  }
+
+  // Submits |command_buffer| with |binding_table| through the C API and
+  // returns the submission status.
+  iree_status_t Submit(CommandBuffer* command_buffer,
+                       iree_host_size_t binding_table_count,
+                       iree_hal_buffer_t** binding_table) {
+    iree_hal_command_buffer_t* command_buffers[] = {
+        reinterpret_cast<iree_hal_command_buffer_t*>(command_buffer)};
+    iree_hal_semaphore_t* semaphores[] = {
+        reinterpret_cast<iree_hal_semaphore_t*>(semaphore_.get())};
+    uint64_t signal_value = ++signal_value_;
+    iree_hal_submission_batch_t batch;
+    batch.wait_semaphores = {0, nullptr, nullptr};
+    batch.command_buffer_count = 1;
+    batch.command_buffers = command_buffers;
+    batch.signal_semaphores = {1, semaphores, &signal_value};
+    batch.binding_table_count = binding_table_count;
+    batch.binding_table = binding_table;
+    return iree_hal_device_queue_submit(
+        reinterpret_cast<iree_hal_device_t*>(device_.get()),
+        IREE_HAL_COMMAND_CATEGORY_DISPATCH, 0, 1, &batch);
+  }
+
+  Status WaitForSubmissions() {
+    return semaphore_->Wait(signal_value_, InfiniteFuture());
+  }
+
+  ref_ptr<Device> device_;
+  ref_ptr<DescriptorSetLayout> set_layout_;
+  ref_ptr<ExecutableLayout> executable_layout_;
+  ref_ptr<Semaphore> semaphore_;
+  uint64_t signal_value_ = 0;
+};
+
+// Tests that a reusable command buffer can be submitted multiple times with
+// its indirect bindings resolved to different buffers each time.
+TEST_F(SerialSchedulingModelTest, ReusableCommandBufferWithBindingTables) {
+  auto executable = make_ref<FillExecutable>();
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto command_buffer,
+      device_->CreateCommandBuffer(static_cast<CommandBufferModeBitfield>(0),
+                                   CommandCategory::kDispatch));
+  IREE_ASSERT_OK(command_buffer->Begin());
+  IndirectBinding binding;
+  binding.binding = 0;
+  binding.slot = 0;
+  IREE_ASSERT_OK(command_buffer->PushDescriptorSetIndirect(
+      executable_layout_.get(), 0, {binding}));
+  IREE_ASSERT_OK(command_buffer->Dispatch(executable.get(),
+                                          /*entry_point=*/42, {1, 1, 1}));
+  IREE_ASSERT_OK(command_buffer->End());
+
+  auto buffer_a = AllocateBuffer();
+  auto buffer_b = AllocateBuffer();
+  iree_hal_buffer_t* binding_table_a[] = {
+      reinterpret_cast<iree_hal_buffer_t*>(buffer_a.get())};
+  IREE_ASSERT_OK(Submit(command_buffer.get(), 1, binding_table_a));
+  IREE_ASSERT_OK(WaitForSubmissions());
+  uint32_t value = 0;
+  IREE_ASSERT_OK(buffer_a->ReadData(0, &value, sizeof(value)));
+  EXPECT_EQ(42, value);
+  IREE_ASSERT_OK(buffer_b->ReadData(0, &value, sizeof(value)));
+  EXPECT_EQ(0, value);
+
+  iree_hal_buffer_t* binding_table_b[] = {
+      reinterpret_cast<iree_hal_buffer_t*>(buffer_b.get())};
+  IREE_ASSERT_OK(Submit(command_buffer.get(), 1, binding_table_b));
+  IREE_ASSERT_OK(WaitForSubmissions());
+  IREE_ASSERT_OK(buffer_b->ReadData(0, &value, sizeof(value)));
+  EXPECT_EQ(42, value);
+}
+
+// Tests that submissions claiming a binding table without providing one are
+// rejected before reaching the queue.
+TEST_F(SerialSchedulingModelTest, SubmitRejectsNullBindingTable) {
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto command_buffer,
+      device_->CreateCommandBuffer(static_cast<CommandBufferModeBitfield>(0),
+                                   CommandCategory::kDispatch));
+  IREE_ASSERT_OK(command_buffer->Begin());
+  IREE_ASSERT_OK(command_buffer->End());
+
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_INVALID_ARGUMENT,
+      ::iree::Status(Submit(command_buffer.get(), 1, nullptr)));
+}
+
+// Tests that waiting for any semaphore returns the index of the one that was
+// signaled, both through the device and the C API.
+TEST_F(SerialSchedulingModelTest, WaitAnySemaphoreReturnsSignaledIndex) {
+  IREE_ASSERT_OK_AND_ASSIGN(auto a, device_->CreateSemaphore(0u));
+  IREE_ASSERT_OK_AND_ASSIGN(auto b, device_->CreateSemaphore(0u));
+  IREE_ASSERT_OK(b->Signal(1u));
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int index, device_->WaitAnySemaphore({{a.get(), 1u}, {b.get(), 1u}},
+                                           InfiniteFuture()));
+  EXPECT_EQ(1, index);
+
+  iree_hal_semaphore_t* semaphores[] = {
+      reinterpret_cast<iree_hal_semaphore_t*>(a.get()),
+      reinterpret_cast<iree_hal_semaphore_t*>(b.get()),
+  };
+  uint64_t payload_values[] = {1u, 1u};
+  iree_hal_semaphore_list_t semaphore_list = {2, semaphores, payload_values};
+  IREE_EXPECT_OK(::iree::Status(iree_hal_device_wait_semaphores_with_deadline(
+      reinterpret_cast<iree_hal_device_t*>(device_.get()),
+      IREE_HAL_WAIT_MODE_ANY, &semaphore_list, IREE_TIME_INFINITE_FUTURE)));
+
+  // Neither semaphore has reached 2 so the wait must time out.
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DEADLINE_EXCEEDED,
+      device_->WaitAnySemaphore({{a.get(), 2u}, {b.get(), 2u}}, InfinitePast())
+          .status());
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
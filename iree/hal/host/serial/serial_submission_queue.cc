@@ -61,6 +61,7 @@ Status SerialSubmissionQueue::Enqueue(
         {batches[i].command_buffers.begin(), batches[i].command_buffers.end()},
         {batches[i].signal_semaphores.begin(),
          batches[i].signal_semaphores.end()},
+        {batches[i].binding_table.begin(), batches[i].binding_table.end()},
     };
   }
   list_.push_back(std::move(submission));
@@ -139,7 +140,7 @@ Status SerialSubmissionQueue::ProcessBatch(const PendingBatch& batch,
   // need to check the wait semaphores here.
 
   // Let the caller handle execution of the command buffers.
-  IREE_RETURN_IF_ERROR(execute_fn(batch.command_buffers));
+  IREE_RETURN_IF_ERROR(execute_fn(batch.command_buffers, batch.binding_table));
 
   // Signal all semaphores to allow them to unblock waiters.
   for (auto& signal_point : batch.signal_semaphores) {
@@ -40,7 +40,8 @@ namespace host {
 class SerialSubmissionQueue final {
  public:
   using ExecuteFn =
-      std::function<Status(absl::Span<CommandBuffer* const> command_buffers)>;
+      std::function<Status(absl::Span<CommandBuffer* const> command_buffers,
+                           absl::Span<Buffer* const> binding_table)>;
 
   SerialSubmissionQueue();
   ~SerialSubmissionQueue();
@@ -75,6 +76,7 @@ class SerialSubmissionQueue final {
     absl::InlinedVector<SemaphoreValue, 4> wait_semaphores;
     absl::InlinedVector<CommandBuffer*, 4> command_buffers;
     absl::InlinedVector<SemaphoreValue, 4> signal_semaphores;
+    absl::InlinedVector<Buffer*, 4> binding_table;
   };
   struct Submission : public IntrusiveLinkBase<void> {
     absl::InlinedVector<PendingBatch, 4> pending_batches;
@@ -15,7 +15,10 @@
 #ifndef IREE_HAL_LLVMJIT_LLVMJIT_DEVICE_H_
 #define IREE_HAL_LLVMJIT_LLVMJIT_DEVICE_H_
 
+#include <memory>
+
 #include "iree/hal/host/host_local_device.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 
 namespace iree {
 namespace hal {
@@ -23,11 +26,16 @@ namespace llvmjit {
 
 class LLVMJITDevice final : public host::HostLocalDevice {
  public:
+  // |object_cache| may be null to disable persistent executable caching.
   LLVMJITDevice(DeviceInfo device_info,
-                std::unique_ptr<host::SchedulingModel> scheduling_model);
+                std::unique_ptr<host::SchedulingModel> scheduling_model,
+                std::shared_ptr<LLVMJITObjectCache> object_cache);
   ~LLVMJITDevice() override;
 
   ref_ptr<ExecutableCache> CreateExecutableCache() override;
+
+ private:
+  std::shared_ptr<LLVMJITObjectCache> object_cache_;
 };
 
 }  // namespace llvmjit
@@ -15,9 +15,10 @@
 #include "iree/hal/llvmjit/llvmjit_driver.h"
 
 #include <memory>
+#include <utility>
 
 #include "iree/hal/device_info.h"
-#include "iree/hal/host/serial/serial_scheduling_model.h"
+#include "iree/hal/host/parallel/parallel_scheduling_model.h"
 #include "iree/hal/llvmjit/llvmjit_device.h"
 
 namespace iree {
@@ -38,7 +39,12 @@ DeviceInfo GetDefaultDeviceInfo() {
 
 }  // namespace
 
-LLVMJITDriver::LLVMJITDriver() : Driver("llvmjit") {}
+LLVMJITDriver::LLVMJITDriver(Options options) : Driver("llvmjit") {
+  if (!options.executable_cache_path.empty()) {
+    object_cache_ = std::make_shared<LLVMJITObjectCache>(
+        std::move(options.executable_cache_path));
+  }
+}
 
 LLVMJITDriver::~LLVMJITDriver() = default;
 
@@ -54,9 +60,9 @@ StatusOr<ref_ptr<Device>> LLVMJITDriver::CreateDefaultDevice() {
 
 StatusOr<ref_ptr<Device>> LLVMJITDriver::CreateDevice(
     DriverDeviceID device_id) {
-  auto scheduling_model = std::make_unique<host::SerialSchedulingModel>();
+  auto scheduling_model = std::make_unique<host::ParallelSchedulingModel>();
   return make_ref<LLVMJITDevice>(GetDefaultDeviceInfo(),
-                                 std::move(scheduling_model));
+                                 std::move(scheduling_model), object_cache_);
 }
 
 }  // namespace llvmjit
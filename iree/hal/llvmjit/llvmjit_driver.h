@@ -15,7 +15,11 @@
 #ifndef IREE_HAL_LLVMJIT_LLVMJIT_DRIVER_H_
 #define IREE_HAL_LLVMJIT_LLVMJIT_DRIVER_H_
 
+#include <memory>
+#include <string>
+
 #include "iree/hal/driver.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 
 namespace iree {
 namespace hal {
@@ -23,7 +27,13 @@ namespace llvmjit {
 
 class LLVMJITDriver final : public Driver {
  public:
-  LLVMJITDriver();
+  struct Options {
+    // Directory in which compiled executables are persisted across process
+    // launches. Persistent caching is disabled if empty.
+    std::string executable_cache_path;
+  };
+
+  explicit LLVMJITDriver(Options options);
   ~LLVMJITDriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -31,6 +41,10 @@ class LLVMJITDriver final : public Driver {
   StatusOr<ref_ptr<Device>> CreateDefaultDevice() override;
 
   StatusOr<ref_ptr<Device>> CreateDevice(DriverDeviceID device_id) override;
+
+ private:
+  // Shared by all devices created from the driver.
+  std::shared_ptr<LLVMJITObjectCache> object_cache_;
 };
 
 }  // namespace llvmjit
@@ -13,13 +13,20 @@
 // limitations under the License.
 
 #include <memory>
+#include <string>
+#include <utility>
 
+#include "absl/flags/flag.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/hal/driver_registry.h"
 #include "iree/hal/llvmjit/llvmjit_driver.h"
 #include "llvm/Support/TargetSelect.h"
 
+ABSL_FLAG(std::string, llvmjit_executable_cache_path, "",
+          "Directory in which JIT compiled executables are persisted across "
+          "runs. Persistent caching is disabled if empty.");
+
 namespace iree {
 namespace hal {
 namespace llvmjit {
@@ -27,7 +34,10 @@ namespace llvmjit {
 static StatusOr<ref_ptr<Driver>> CreateLLVMJITDriver() {
   llvm::InitializeNativeTarget();
   llvm::InitializeNativeTargetAsmPrinter();
-  return make_ref<LLVMJITDriver>();
+  LLVMJITDriver::Options options;
+  options.executable_cache_path =
+      absl::GetFlag(FLAGS_llvmjit_executable_cache_path);
+  return make_ref<LLVMJITDriver>(std::move(options));
 }
 
 }  // namespace llvmjit
@@ -25,6 +25,8 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/AsmParser/Parser.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Support/Error.h"
@@ -37,7 +39,8 @@ namespace llvmjit {
 
 // static
 StatusOr<ref_ptr<LLVMJITExecutable>> LLVMJITExecutable::Load(
-    ExecutableSpec spec, bool allow_aliasing_data) {
+    ExecutableSpec spec, bool allow_aliasing_data,
+    std::shared_ptr<LLVMJITObjectCache> object_cache) {
   IREE_TRACE_SCOPE0("LLVMJITExecutable::Load");
 
   auto module_def =
@@ -56,9 +59,25 @@ StatusOr<ref_ptr<LLVMJITExecutable>> LLVMJITExecutable::Load(
   }
   auto dataLayout = module->getDataLayout();
   const auto entry_points = module_def->entry_points();
+
+  llvm::orc::LLJITBuilder ll_jit_builder;
+  if (object_cache) {
+    // The object cache looks up objects by module identifier.
+    module->setModuleIdentifier(LLVMJITObjectCache::ComputeModuleKey(
+        llvm::StringRef(data, size)));
+    auto* object_cache_ptr = object_cache.get();
+    ll_jit_builder.setCompileFunctionCreator(
+        [object_cache_ptr](llvm::orc::JITTargetMachineBuilder jtmb)
+            -> llvm::Expected<
+                std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+          return std::make_unique<llvm::orc::ConcurrentIRCompiler>(
+              std::move(jtmb), object_cache_ptr);
+        });
+  }
+
   llvm::orc::ThreadSafeModule thread_safe_module(std::move(module),
                                                  std::move(llvm_context));
-  auto ll_jit = llvm::cantFail(llvm::orc::LLJITBuilder().create());
+  auto ll_jit = llvm::cantFail(ll_jit_builder.create());
 
   llvm::Error err = ll_jit->addIRModule(std::move(thread_safe_module));
   if (err) {
@@ -79,8 +98,8 @@ StatusOr<ref_ptr<LLVMJITExecutable>> LLVMJITExecutable::Load(
   auto& main_jitdylib = ll_jit->getMainJITDylib();
   main_jitdylib.addGenerator(std::move(dylib_serarch_generator.get()));
 
-  auto executable =
-      make_ref<LLVMJITExecutable>(spec, std::move(ll_jit), allow_aliasing_data);
+  auto executable = make_ref<LLVMJITExecutable>(
+      spec, std::move(object_cache), std::move(ll_jit), allow_aliasing_data);
 
   for (const auto func_name : *entry_points) {
     auto func_symbol = executable->ll_jit_->lookup(func_name->str());
@@ -95,10 +114,12 @@ StatusOr<ref_ptr<LLVMJITExecutable>> LLVMJITExecutable::Load(
   return executable;
 }
 
-LLVMJITExecutable::LLVMJITExecutable(ExecutableSpec spec,
-                                     std::unique_ptr<llvm::orc::LLJIT> ll_jit,
-                                     bool allow_aliasing_data)
-    : spec_(spec), ll_jit_(std::move(ll_jit)) {
+LLVMJITExecutable::LLVMJITExecutable(
+    ExecutableSpec spec, std::shared_ptr<LLVMJITObjectCache> object_cache,
+    std::unique_ptr<llvm::orc::LLJIT> ll_jit, bool allow_aliasing_data)
+    : spec_(spec),
+      object_cache_(std::move(object_cache)),
+      ll_jit_(std::move(ll_jit)) {
   if (!allow_aliasing_data) {
     // Clone data.
     cloned_executable_data_ = {spec.executable_data.begin(),
@@ -115,6 +136,7 @@ struct LLVMJITDispatchState : public HostExecutable::DispatchState {
   llvm::JITEvaluatedSymbol symbol;
   llvm::SmallVector<void*, 4> args;
   llvm::SmallVector<int32_t, 4> push_constant;
+  std::array<uint32_t, 3> workgroup_count;
 };
 
 StatusOr<ref_ptr<HostExecutable::DispatchState>>
@@ -128,6 +150,7 @@ LLVMJITExecutable::PrepareDispatch(const DispatchParams& params) {
 
   auto dispatch_state = make_ref<LLVMJITDispatchState>();
   dispatch_state->symbol = symbols_[params.entry_point];
+  dispatch_state->workgroup_count = params.workgroup_count;
 
   for (size_t set = 0; set < params.set_bindings.size(); ++set) {
     for (size_t binding = 0; binding < params.set_bindings[set].size();
@@ -154,9 +177,10 @@ Status LLVMJITExecutable::DispatchTile(DispatchState* state,
   IREE_TRACE_SCOPE0("LLVMJITExecutable::DispatchTile");
   auto* dispatch_state = static_cast<LLVMJITDispatchState*>(state);
 
-  auto func_ptr =
-      (void (*)(void**, int32_t*))dispatch_state->symbol.getAddress();
-  func_ptr(dispatch_state->args.data(), dispatch_state->push_constant.data());
+  auto func_ptr = (void (*)(void**, int32_t*, uint32_t*, uint32_t*))
+                      dispatch_state->symbol.getAddress();
+  func_ptr(dispatch_state->args.data(), dispatch_state->push_constant.data(),
+           workgroup_xyz.data(), dispatch_state->workgroup_count.data());
 
   return OkStatus();
 }
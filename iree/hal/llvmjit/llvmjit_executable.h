@@ -15,11 +15,13 @@
 #ifndef IREE_HAL_LLVMJIT_LLVMJIT_EXECUTABLE_H_
 #define IREE_HAL_LLVMJIT_LLVMJIT_EXECUTABLE_H_
 
+#include <memory>
 #include <vector>
 
 #include "iree/base/status.h"
 #include "iree/hal/executable_spec.h"
 #include "iree/hal/host/host_executable.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 #include "iree/schemas/llvmir_executable_def_generated.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
@@ -32,10 +34,15 @@ struct MemrefType;
 
 class LLVMJITExecutable final : public HostExecutable {
  public:
-  static StatusOr<ref_ptr<LLVMJITExecutable>> Load(ExecutableSpec spec,
-                                                   bool allow_aliasing_data);
+  // Loads and JIT compiles the executable in |spec|. If |object_cache| is
+  // provided previously compiled object code is reused when available and
+  // newly compiled object code is persisted for future loads.
+  static StatusOr<ref_ptr<LLVMJITExecutable>> Load(
+      ExecutableSpec spec, bool allow_aliasing_data,
+      std::shared_ptr<LLVMJITObjectCache> object_cache);
 
   LLVMJITExecutable(ExecutableSpec spec,
+                    std::shared_ptr<LLVMJITObjectCache> object_cache,
                     std::unique_ptr<llvm::orc::LLJIT> ll_jit,
                     bool allow_aliasing_data);
   ~LLVMJITExecutable() override;
@@ -50,6 +57,8 @@ class LLVMJITExecutable final : public HostExecutable {
  private:
   ExecutableSpec spec_;
   std::vector<uint8_t> cloned_executable_data_;
+  // Referenced by the compiler owned by |ll_jit_| and must outlive it.
+  std::shared_ptr<LLVMJITObjectCache> object_cache_;
   std::unique_ptr<llvm::orc::LLJIT> ll_jit_;
   llvm::SmallVector<llvm::JITEvaluatedSymbol, 4> symbols_;
 };
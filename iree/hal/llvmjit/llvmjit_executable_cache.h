@@ -15,8 +15,11 @@
 #ifndef IREE_HAL_LLVMJIT_EXECUTABLE_CACHE_H_
 #define IREE_HAL_LLVMJIT_EXECUTABLE_CACHE_H_
 
+#include <memory>
+
 #include "iree/hal/executable.h"
 #include "iree/hal/executable_cache.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
 
 namespace iree {
 namespace hal {
@@ -24,7 +27,9 @@ namespace llvmjit {
 
 class LLVMJITExecutableCache final : public ExecutableCache {
  public:
-  LLVMJITExecutableCache();
+  // |object_cache| may be null to disable persistent caching.
+  explicit LLVMJITExecutableCache(
+      std::shared_ptr<LLVMJITObjectCache> object_cache);
   ~LLVMJITExecutableCache() override;
 
   bool CanPrepareFormat(ExecutableFormat format) const override;
@@ -32,6 +37,9 @@ class LLVMJITExecutableCache final : public ExecutableCache {
   StatusOr<ref_ptr<Executable>> PrepareExecutable(
       ExecutableLayout* executable_layout, ExecutableCachingModeBitfield mode,
       const ExecutableSpec& spec) override;
+
+ private:
+  std::shared_ptr<LLVMJITObjectCache> object_cache_;
 };
 
 }  // namespace llvmjit
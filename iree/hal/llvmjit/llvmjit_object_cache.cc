@@ -0,0 +1,168 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "iree/base/tracing.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+namespace {
+
+// Bump when the layout of cached objects or the key derivation changes.
+constexpr char kCacheKeyVersion[] = "iree-llvmjit-v2";
+
+// Appended to each cached object. Files without a valid footer, or whose
+// contents don't match it, are treated as cache misses.
+struct CachedObjectFooter {
+  char magic[8];
+  uint64_t object_length;
+  uint64_t object_hash;
+};
+
+constexpr char kCachedObjectMagic[8] = {'I', 'R', 'E', 'E', 'O', 'B', 'J', 0};
+
+}  // namespace
+
+LLVMJITObjectCache::LLVMJITObjectCache(std::string cache_path)
+    : cache_path_(std::move(cache_path)) {}
+
+LLVMJITObjectCache::~LLVMJITObjectCache() = default;
+
+// static
+std::string LLVMJITObjectCache::ComputeModuleKey(llvm::StringRef module_data) {
+  llvm::StringMap<bool> host_features;
+  std::vector<llvm::StringRef> enabled_features;
+  if (llvm::sys::getHostCPUFeatures(host_features)) {
+    for (const auto& feature : host_features) {
+      if (feature.getValue()) enabled_features.push_back(feature.getKey());
+    }
+  }
+  return ComputeModuleKey(module_data, llvm::sys::getHostCPUName(),
+                          std::move(enabled_features));
+}
+
+// static
+std::string LLVMJITObjectCache::ComputeModuleKey(
+    llvm::StringRef module_data, llvm::StringRef cpu_name,
+    std::vector<llvm::StringRef> cpu_features) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::ComputeModuleKey");
+
+  // Host features are reported in hash map order and must be sorted to produce
+  // a stable key.
+  std::sort(cpu_features.begin(), cpu_features.end());
+
+  llvm::SHA1 hasher;
+  auto update = [&](llvm::StringRef value) {
+    hasher.update(value);
+    hasher.update(llvm::StringRef("\0", 1));
+  };
+  update(kCacheKeyVersion);
+  update(LLVM_VERSION_STRING);
+  update(llvm::sys::getProcessTriple());
+  update(cpu_name);
+  for (const auto& feature : cpu_features) update(feature);
+  update(module_data);
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+std::string LLVMJITObjectCache::GetObjectPath(
+    const llvm::Module* module) const {
+  llvm::SmallString<256> object_path(cache_path_);
+  llvm::sys::path::append(object_path, module->getModuleIdentifier() + ".o");
+  return std::string(object_path.str());
+}
+
+void LLVMJITObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                              llvm::MemoryBufferRef object) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::notifyObjectCompiled");
+
+  // Failing to populate the cache only costs a recompile on the next launch so
+  // errors are ignored.
+  if (llvm::sys::fs::create_directories(cache_path_)) return;
+
+  // Write to a unique temporary file and then rename it into place so that
+  // concurrent processes never observe a partially written object.
+  std::string object_path = GetObjectPath(module);
+  int temp_fd = -1;
+  llvm::SmallString<256> temp_path;
+  if (llvm::sys::fs::createUniqueFile(object_path + ".%%%%%%.tmp", temp_fd,
+                                      temp_path)) {
+    return;
+  }
+  CachedObjectFooter footer;
+  std::memcpy(footer.magic, kCachedObjectMagic, sizeof(footer.magic));
+  footer.object_length = object.getBufferSize();
+  footer.object_hash = llvm::xxHash64(object.getBuffer());
+  bool write_failed = false;
+  {
+    llvm::raw_fd_ostream temp_stream(temp_fd, /*shouldClose=*/true);
+    temp_stream << object.getBuffer();
+    temp_stream.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+    temp_stream.close();
+    write_failed = temp_stream.has_error();
+    temp_stream.clear_error();
+  }
+  if (write_failed || llvm::sys::fs::rename(temp_path, object_path)) {
+    llvm::sys::fs::remove(temp_path);
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer> LLVMJITObjectCache::getObject(
+    const llvm::Module* module) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::getObject");
+
+  std::string object_path = GetObjectPath(module);
+  auto file_buffer = llvm::MemoryBuffer::getFile(
+      object_path, /*FileSize=*/-1, /*RequiresNullTerminator=*/false);
+  if (!file_buffer) return nullptr;
+
+  // Reject files that were truncated or not fully written; returning null
+  // makes the JIT recompile and overwrite them.
+  llvm::StringRef contents = file_buffer.get()->getBuffer();
+  if (contents.size() < sizeof(CachedObjectFooter)) return nullptr;
+  CachedObjectFooter footer;
+  std::memcpy(&footer, contents.end() - sizeof(footer), sizeof(footer));
+  if (std::memcmp(footer.magic, kCachedObjectMagic, sizeof(footer.magic))) {
+    return nullptr;
+  }
+  llvm::StringRef object = contents.drop_back(sizeof(footer));
+  if (footer.object_length != object.size() ||
+      footer.object_hash != llvm::xxHash64(object)) {
+    return nullptr;
+  }
+  return llvm::MemoryBuffer::getMemBufferCopy(object, object_path);
+}
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
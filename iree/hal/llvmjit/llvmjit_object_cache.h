@@ -0,0 +1,75 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
+#define IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+// An llvm::ObjectCache that persists JIT compiled object code in a directory on
+// disk so that later process launches can skip compilation.
+//
+// Objects are keyed by the identifier of the module they were compiled from.
+// Callers must set the identifier of any module compiled with the cache to the
+// result of ComputeModuleKey so that code is never reused across different
+// modules, host CPUs, or LLVM versions.
+//
+// Cached files carry a footer with the length and hash of the object so that
+// truncated or partially written files are ignored and recompiled.
+//
+// Thread-safe; multiple processes may share the same cache directory.
+class LLVMJITObjectCache final : public llvm::ObjectCache {
+ public:
+  explicit LLVMJITObjectCache(std::string cache_path);
+  ~LLVMJITObjectCache() override;
+
+  // Returns a key uniquely identifying the object code produced by compiling
+  // |module_data| for the host CPU.
+  static std::string ComputeModuleKey(llvm::StringRef module_data);
+
+  // Returns a key uniquely identifying the object code produced by compiling
+  // |module_data| for |cpu_name| with |cpu_features| enabled. The order of
+  // |cpu_features| does not affect the key.
+  static std::string ComputeModuleKey(
+      llvm::StringRef module_data, llvm::StringRef cpu_name,
+      std::vector<llvm::StringRef> cpu_features);
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override;
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module* module) override;
+
+ private:
+  std::string GetObjectPath(const llvm::Module* module) const;
+
+  std::string cache_path_;
+};
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
@@ -0,0 +1,163 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "iree/testing/gtest.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+namespace {
+
+constexpr char kModuleData[] = "define void @main() { ret void }";
+constexpr char kObjectData[] = "\x7f" "ELF fake object contents";
+
+class LLVMJITObjectCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory(
+        "llvmjit_object_cache_test", cache_path_));
+    module_ = std::make_unique<llvm::Module>(
+        LLVMJITObjectCache::ComputeModuleKey(kModuleData), context_);
+  }
+
+  void TearDown() override {
+    llvm::sys::fs::remove_directories(cache_path_);
+  }
+
+  std::string ObjectPath() {
+    llvm::SmallString<256> object_path(cache_path_);
+    llvm::sys::path::append(object_path,
+                            module_->getModuleIdentifier() + ".o");
+    return std::string(object_path.str());
+  }
+
+  // Overwrites the cached object file with |contents|.
+  void WriteObjectFile(llvm::StringRef contents) {
+    std::error_code error;
+    llvm::raw_fd_ostream stream(ObjectPath(), error);
+    ASSERT_FALSE(error);
+    stream << contents;
+  }
+
+  std::string ReadObjectFile() {
+    auto buffer = llvm::MemoryBuffer::getFile(ObjectPath());
+    if (!buffer) return {};
+    return buffer.get()->getBuffer().str();
+  }
+
+  llvm::SmallString<256> cache_path_;
+  llvm::LLVMContext context_;
+  std::unique_ptr<llvm::Module> module_;
+};
+
+TEST_F(LLVMJITObjectCacheTest, ModuleKeyIsStable) {
+  EXPECT_EQ(LLVMJITObjectCache::ComputeModuleKey(kModuleData),
+            LLVMJITObjectCache::ComputeModuleKey(kModuleData));
+  EXPECT_EQ(
+      LLVMJITObjectCache::ComputeModuleKey(kModuleData, "skylake",
+                                           {"avx", "avx2"}),
+      LLVMJITObjectCache::ComputeModuleKey(kModuleData, "skylake",
+                                           {"avx2", "avx"}));
+}
+
+TEST_F(LLVMJITObjectCacheTest, ModuleKeyChangesWithInputs) {
+  std::string key = LLVMJITObjectCache::ComputeModuleKey(
+      kModuleData, "skylake", {"avx", "avx2"});
+  EXPECT_NE(key, LLVMJITObjectCache::ComputeModuleKey(kModuleData, "haswell",
+                                                      {"avx", "avx2"}));
+  EXPECT_NE(key, LLVMJITObjectCache::ComputeModuleKey(kModuleData, "skylake",
+                                                      {"avx"}));
+  EXPECT_NE(key, LLVMJITObjectCache::ComputeModuleKey(
+                     "define void @other() { ret void }", "skylake",
+                     {"avx", "avx2"}));
+  // Values are delimited so that moving bytes between them changes the key.
+  EXPECT_NE(LLVMJITObjectCache::ComputeModuleKey(kModuleData, "a", {"bc"}),
+            LLVMJITObjectCache::ComputeModuleKey(kModuleData, "ab", {"c"}));
+}
+
+TEST_F(LLVMJITObjectCacheTest, MissingObject) {
+  LLVMJITObjectCache cache(std::string(cache_path_.str()));
+  EXPECT_EQ(cache.getObject(module_.get()), nullptr);
+}
+
+TEST_F(LLVMJITObjectCacheTest, RoundTrip) {
+  LLVMJITObjectCache cache(std::string(cache_path_.str()));
+  cache.notifyObjectCompiled(
+      module_.get(), llvm::MemoryBufferRef(kObjectData, "object"));
+
+  auto object = cache.getObject(module_.get());
+  ASSERT_NE(object, nullptr);
+  EXPECT_EQ(object->getBuffer(), kObjectData);
+
+  // A new cache instance (as in a later process) sees the same object.
+  LLVMJITObjectCache other_cache(std::string(cache_path_.str()));
+  auto other_object = other_cache.getObject(module_.get());
+  ASSERT_NE(other_object, nullptr);
+  EXPECT_EQ(other_object->getBuffer(), kObjectData);
+}
+
+TEST_F(LLVMJITObjectCacheTest, TruncatedObjectIsIgnored) {
+  LLVMJITObjectCache cache(std::string(cache_path_.str()));
+  cache.notifyObjectCompiled(
+      module_.get(), llvm::MemoryBufferRef(kObjectData, "object"));
+  std::string contents = ReadObjectFile();
+  ASSERT_FALSE(contents.empty());
+
+  for (size_t length : {size_t{0}, size_t{4}, contents.size() / 2,
+                        contents.size() - 1}) {
+    WriteObjectFile(llvm::StringRef(contents).take_front(length));
+    EXPECT_EQ(cache.getObject(module_.get()), nullptr) << length;
+  }
+}
+
+TEST_F(LLVMJITObjectCacheTest, PartialObjectIsIgnored) {
+  LLVMJITObjectCache cache(std::string(cache_path_.str()));
+
+  // Only the object bytes without the trailing footer.
+  WriteObjectFile(kObjectData);
+  EXPECT_EQ(cache.getObject(module_.get()), nullptr);
+
+  // A complete file with corrupted contents.
+  cache.notifyObjectCompiled(
+      module_.get(), llvm::MemoryBufferRef(kObjectData, "object"));
+  std::string contents = ReadObjectFile();
+  ASSERT_FALSE(contents.empty());
+  contents[1] ^= 0xFF;
+  WriteObjectFile(contents);
+  EXPECT_EQ(cache.getObject(module_.get()), nullptr);
+
+  // Recompiling replaces the bad file.
+  cache.notifyObjectCompiled(
+      module_.get(), llvm::MemoryBufferRef(kObjectData, "object"));
+  auto object = cache.getObject(module_.get());
+  ASSERT_NE(object, nullptr);
+  EXPECT_EQ(object->getBuffer(), kObjectData);
+}
+
+}  // namespace
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,97 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/memory_pool.h"
+
+#include <atomic>
+#include <cstdlib>
+
+namespace iree {
+namespace hal {
+
+namespace {
+
+// Passes all requests through to the system allocator.
+class SystemMemoryPool final : public MemoryPool {
+ public:
+  void* Allocate(size_t byte_length, bool zero_fill) override {
+    void* data =
+        zero_fill ? std::calloc(1, byte_length) : std::malloc(byte_length);
+    if (!data) return nullptr;
+    allocation_count_.fetch_add(1, std::memory_order_relaxed);
+    int64_t bytes_allocated =
+        bytes_allocated_.fetch_add(byte_length, std::memory_order_relaxed) +
+        byte_length;
+    int64_t peak = bytes_allocated_peak_.load(std::memory_order_relaxed);
+    while (bytes_allocated > peak &&
+           !bytes_allocated_peak_.compare_exchange_weak(
+               peak, bytes_allocated, std::memory_order_relaxed)) {
+    }
+    return data;
+  }
+
+  void Free(void* data, size_t byte_length) override {
+    if (!data) return;
+    std::free(data);
+    bytes_allocated_.fetch_sub(byte_length, std::memory_order_relaxed);
+  }
+
+  void Trim() override {}
+
+  AllocatorStatistics statistics() const override {
+    AllocatorStatistics statistics;
+    statistics.bytes_allocated =
+        bytes_allocated_.load(std::memory_order_relaxed);
+    statistics.bytes_allocated_peak =
+        bytes_allocated_peak_.load(std::memory_order_relaxed);
+    statistics.bytes_reserved = statistics.bytes_allocated;
+    statistics.bytes_reserved_peak = statistics.bytes_allocated_peak;
+    statistics.allocation_count =
+        allocation_count_.load(std::memory_order_relaxed);
+    statistics.system_allocation_count = statistics.allocation_count;
+    return statistics;
+  }
+
+ private:
+  std::atomic<int64_t> bytes_allocated_{0};
+  std::atomic<int64_t> bytes_allocated_peak_{0};
+  std::atomic<int64_t> allocation_count_{0};
+};
+
+MemoryPool* SystemMemoryPoolInstance() {
+  // Intentionally leaked as buffers may outlive static destruction.
+  static MemoryPool* pool = new SystemMemoryPool();
+  return pool;
+}
+
+std::atomic<MemoryPool*>& DefaultMemoryPool() {
+  static std::atomic<MemoryPool*> pool{nullptr};
+  return pool;
+}
+
+}  // namespace
+
+// static
+MemoryPool* MemoryPool::GetDefault() {
+  MemoryPool* pool = DefaultMemoryPool().load(std::memory_order_acquire);
+  return pool ? pool : SystemMemoryPoolInstance();
+}
+
+// static
+void MemoryPool::SetDefault(MemoryPool* pool) {
+  DefaultMemoryPool().store(pool, std::memory_order_release);
+}
+
+}  // namespace hal
+}  // namespace iree
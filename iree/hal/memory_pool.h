@@ -0,0 +1,63 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_MEMORY_POOL_H_
+#define IREE_HAL_MEMORY_POOL_H_
+
+#include <cstddef>
+
+#include "iree/hal/allocator.h"
+
+namespace iree {
+namespace hal {
+
+// Allocates the blocks of host memory that back host buffers.
+//
+// Allocators that are not given a pool explicitly (such as the one used by
+// HeapBuffer) use the default pool. The default passes requests through to the
+// system allocator until a pooling implementation such as
+// host::HostMemoryPool installs itself with SetDefault.
+//
+// Thread-safe.
+class MemoryPool {
+ public:
+  // Returns the pool used by allocators that are not given one explicitly.
+  static MemoryPool* GetDefault();
+
+  // Sets the pool returned by GetDefault. |pool| must remain valid for the
+  // lifetime of the process. Blocks are always returned to the pool they were
+  // allocated from so the default may be changed while blocks are live.
+  static void SetDefault(MemoryPool* pool);
+
+  virtual ~MemoryPool() = default;
+
+  // Allocates a block of at least |byte_length| bytes. When |zero_fill| is set
+  // the first |byte_length| bytes are zeroed; otherwise the contents are
+  // undefined. Returns nullptr if the system is out of memory.
+  virtual void* Allocate(size_t byte_length, bool zero_fill) = 0;
+
+  // Returns a block previously allocated with the same |byte_length|.
+  virtual void Free(void* data, size_t byte_length) = 0;
+
+  // Releases any unused memory retained by the pool back to the system.
+  virtual void Trim() = 0;
+
+  // Returns a snapshot of the pool statistics.
+  virtual AllocatorStatistics statistics() const = 0;
+};
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_MEMORY_POOL_H_
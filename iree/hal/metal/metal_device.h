@@ -45,6 +45,9 @@ class MetalDevice final : public Device {
   std::string DebugString() const override;
 
   Allocator* allocator() const override { return allocator_.get(); }
+  TransientArenaPool* transient_arena_pool() override {
+    return &transient_arena_pool_;
+  }
 
   absl::Span<CommandQueue*> dispatch_queues() const override {
     return absl::MakeSpan(&common_queue_, 1);
@@ -90,6 +93,8 @@ class MetalDevice final : public Device {
   id<MTLDevice> metal_handle_;
 
   std::unique_ptr<Allocator> allocator_;
+  // Holds buffers from |allocator_| and so must be declared after it.
+  TransientArenaPool transient_arena_pool_;
 
   // Metal does not have clear graphics/dispatch/transfer queue distinction like
   // Vulkan; one just use the same newCommandQueue() API call on MTLDevice to
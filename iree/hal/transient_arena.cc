@@ -0,0 +1,166 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/transient_arena.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "iree/base/alignment.h"
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+
+TransientArena::TransientArena(Allocator* allocator,
+                               MemoryTypeBitfield memory_type,
+                               BufferUsageBitfield buffer_usage)
+    : allocator_(allocator),
+      memory_type_(memory_type),
+      buffer_usage_(buffer_usage) {}
+
+TransientArena::~TransientArena() = default;
+
+StatusOr<ref_ptr<Buffer>> TransientArena::Allocate(
+    device_size_t allocation_size) {
+  device_size_t aligned_size =
+      iree_align(allocation_size, kTransientArenaAlignment);
+  if (blocks_.empty() ||
+      block_offset_ + aligned_size > blocks_.back()->allocation_size()) {
+    IREE_TRACE_SCOPE0("TransientArena::AllocateBlock");
+    // Grow geometrically so that an arena that overflows its reservation
+    // needs only a few blocks before being coalesced on reset.
+    device_size_t block_length =
+        std::max({aligned_size, reserve_length_, capacity_});
+    IREE_ASSIGN_OR_RETURN(
+        auto block,
+        allocator_->Allocate(memory_type_, buffer_usage_, block_length));
+    capacity_ += block->allocation_size();
+    blocks_.push_back(std::move(block));
+    block_offset_ = 0;
+  }
+  IREE_ASSIGN_OR_RETURN(
+      auto buffer,
+      Buffer::Subspan(blocks_.back(), block_offset_, allocation_size));
+  block_offset_ += aligned_size;
+  allocated_length_ += aligned_size;
+  return buffer;
+}
+
+void TransientArena::Reserve(device_size_t length) {
+  reserve_length_ =
+      std::max(reserve_length_, iree_align(length, kTransientArenaAlignment));
+}
+
+void TransientArena::Reset() {
+  Reserve(allocated_length_);
+  if (blocks_.size() > 1 ||
+      (!blocks_.empty() &&
+       blocks_.front()->allocation_size() < reserve_length_)) {
+    // Drop the blocks so that the next allocation gets a single block large
+    // enough for everything allocated this time around.
+    blocks_.clear();
+    capacity_ = 0;
+  }
+  block_offset_ = 0;
+  allocated_length_ = 0;
+}
+
+TransientArenaPool::TransientArenaPool() = default;
+
+TransientArenaPool::~TransientArenaPool() = default;
+
+StatusOr<std::unique_ptr<TransientArena>> TransientArenaPool::Acquire(
+    Allocator* allocator, MemoryTypeBitfield memory_type,
+    BufferUsageBitfield buffer_usage, device_size_t capacity_hint) {
+  IREE_TRACE_SCOPE0("TransientArenaPool::Acquire");
+  std::unique_ptr<TransientArena> arena;
+  {
+    absl::MutexLock lock(&mutex_);
+    RecycleSignaledArenas();
+    // Prefer the compatible arena with the most storage so that idle arenas
+    // that never allocated don't cause new blocks to be allocated.
+    auto it = idle_arenas_.end();
+    for (auto idle_it = idle_arenas_.begin(); idle_it != idle_arenas_.end();
+         ++idle_it) {
+      const auto& idle_arena = *idle_it;
+      if (idle_arena->allocator_ != allocator ||
+          idle_arena->memory_type_ != memory_type ||
+          idle_arena->buffer_usage_ != buffer_usage) {
+        continue;
+      }
+      if (it == idle_arenas_.end() ||
+          idle_arena->capacity_ > (*it)->capacity_) {
+        it = idle_it;
+      }
+    }
+    if (it != idle_arenas_.end()) {
+      arena = std::move(*it);
+      idle_arenas_.erase(it);
+    }
+  }
+  if (!arena) {
+    arena = absl::WrapUnique(
+        new TransientArena(allocator, memory_type, buffer_usage));
+  }
+  arena->Reserve(capacity_hint);
+  return arena;
+}
+
+void TransientArenaPool::ReleaseOnSignal(std::unique_ptr<TransientArena> arena,
+                                         Semaphore* semaphore,
+                                         uint64_t value) {
+  absl::MutexLock lock(&mutex_);
+  pending_arenas_.push_back({std::move(arena), add_ref(semaphore), value});
+}
+
+void TransientArenaPool::Release(std::unique_ptr<TransientArena> arena) {
+  arena->Reset();
+  absl::MutexLock lock(&mutex_);
+  idle_arenas_.push_back(std::move(arena));
+}
+
+void TransientArenaPool::Trim() {
+  IREE_TRACE_SCOPE0("TransientArenaPool::Trim");
+  std::vector<std::unique_ptr<TransientArena>> idle_arenas;
+  {
+    absl::MutexLock lock(&mutex_);
+    RecycleSignaledArenas();
+    idle_arenas.swap(idle_arenas_);
+  }
+  // Blocks are released outside of the lock.
+  idle_arenas.clear();
+}
+
+void TransientArenaPool::RecycleSignaledArenas() {
+  auto it = pending_arenas_.begin();
+  while (it != pending_arenas_.end()) {
+    auto value_or = it->semaphore->Query();
+    if (value_or.ok() && value_or.value() < it->value) {
+      ++it;
+      continue;
+    }
+    // Arenas used by failed work are dropped instead of recycled as the device
+    // may not be done with them.
+    if (value_or.ok()) {
+      it->arena->Reset();
+      idle_arenas_.push_back(std::move(it->arena));
+    }
+    it = pending_arenas_.erase(it);
+  }
+}
+
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,165 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_TRANSIENT_ARENA_H_
+#define IREE_HAL_TRANSIENT_ARENA_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/ref_ptr.h"
+#include "iree/base/status.h"
+#include "iree/hal/allocator.h"
+#include "iree/hal/buffer.h"
+#include "iree/hal/semaphore.h"
+
+namespace iree {
+namespace hal {
+
+class TransientArenaPool;
+
+// Byte alignment of buffers allocated from a TransientArena.
+// Matches the alignment the compiler uses when packing transient values so
+// that suballocated buffers can be bound with dynamic offsets on all devices.
+constexpr device_size_t kTransientArenaAlignment = 256;
+
+// A bump allocator for buffers that are only used by a single submission.
+//
+// Buffers returned from Allocate are subspans of one or more large blocks
+// allocated from the device allocator. Individual buffers are never freed;
+// instead the entire arena is returned to its TransientArenaPool once the
+// submission using it has completed and reused for later submissions. Arenas
+// that needed more than one block are coalesced into a single block sized to
+// their high water mark when recycled so that in steady state no device
+// allocator calls are made. Each Allocate still heap-allocates the small
+// subspan Buffer object referencing the block.
+//
+// Buffers allocated from the arena must not be used after the arena has been
+// released back to the pool, even if references to them are still held, as
+// their memory will be handed out again.
+//
+// Thread-compatible.
+class TransientArena final {
+ public:
+  ~TransientArena();
+
+  MemoryTypeBitfield memory_type() const { return memory_type_; }
+  BufferUsageBitfield buffer_usage() const { return buffer_usage_; }
+
+  // Total bytes allocated from the arena since it was acquired, including
+  // alignment padding.
+  device_size_t allocated_length() const { return allocated_length_; }
+
+  // Total bytes of block storage currently backing the arena.
+  device_size_t capacity() const { return capacity_; }
+
+  // Allocates a buffer of |allocation_size| bytes from the arena.
+  // A new block is allocated from the device allocator only if the current
+  // block cannot fit the request. The returned subspan Buffer is a new heap
+  // object owned by the caller.
+  StatusOr<ref_ptr<Buffer>> Allocate(device_size_t allocation_size);
+
+ private:
+  friend class TransientArenaPool;
+
+  TransientArena(Allocator* allocator, MemoryTypeBitfield memory_type,
+                 BufferUsageBitfield buffer_usage);
+
+  // Ensures the first block allocated will be at least |length| bytes.
+  void Reserve(device_size_t length);
+
+  // Resets the arena for reuse, dropping blocks if they should be coalesced.
+  void Reset();
+
+  Allocator* allocator_;
+  MemoryTypeBitfield memory_type_;
+  BufferUsageBitfield buffer_usage_;
+
+  // Blocks backing the arena; allocations are made from the last one.
+  absl::InlinedVector<ref_ptr<Buffer>, 1> blocks_;
+  device_size_t block_offset_ = 0;
+  device_size_t allocated_length_ = 0;
+  device_size_t capacity_ = 0;
+
+  // Minimum size of the first block, grown to the high water mark.
+  device_size_t reserve_length_ = 0;
+};
+
+// A pool of TransientArenas recycled as the submissions using them complete.
+//
+// Usage:
+//  IREE_ASSIGN_OR_RETURN(auto arena, pool->Acquire(allocator, ...));
+//  IREE_ASSIGN_OR_RETURN(auto buffer, arena->Allocate(1024));
+//  ... record command buffers using |buffer| ...
+//  IREE_RETURN_IF_ERROR(queue->Submit({..., {{semaphore, 1ull}}}));
+//  pool->ReleaseOnSignal(std::move(arena), semaphore, 1ull);
+//
+// Arenas released with ReleaseOnSignal are polled when new arenas are
+// acquired; an arena becomes available again once its semaphore has reached
+// the payload value. Arenas whose semaphores have failed are discarded as the
+// state of the work using them is unknown.
+//
+// Thread-safe.
+class TransientArenaPool final {
+ public:
+  TransientArenaPool();
+  ~TransientArenaPool();
+
+  // Acquires an arena that allocates buffers of |memory_type| and
+  // |buffer_usage| from |allocator|. If |capacity_hint| is non-zero the first
+  // block allocated will be at least that large.
+  // |allocator| must remain valid for the lifetime of the pool.
+  StatusOr<std::unique_ptr<TransientArena>> Acquire(
+      Allocator* allocator, MemoryTypeBitfield memory_type,
+      BufferUsageBitfield buffer_usage, device_size_t capacity_hint = 0);
+
+  // Returns |arena| to the pool once |semaphore| reaches |value|.
+  // All work using buffers from the arena must signal |semaphore| to |value|
+  // (or greater) when it has completed.
+  void ReleaseOnSignal(std::unique_ptr<TransientArena> arena,
+                       Semaphore* semaphore, uint64_t value);
+
+  // Returns |arena| to the pool immediately.
+  // The caller must ensure that no pending work uses buffers from the arena.
+  void Release(std::unique_ptr<TransientArena> arena);
+
+  // Releases the blocks of all idle arenas back to their allocators.
+  // Arenas still pending their semaphore signals are retained.
+  void Trim();
+
+ private:
+  struct PendingArena {
+    std::unique_ptr<TransientArena> arena;
+    ref_ptr<Semaphore> semaphore;
+    uint64_t value;
+  };
+
+  // Moves all pending arenas whose semaphores have been signaled to the idle
+  // list and discards those whose semaphores have failed.
+  void RecycleSignaledArenas() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  absl::Mutex mutex_;
+  std::vector<PendingArena> pending_arenas_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::unique_ptr<TransientArena>> idle_arenas_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_TRANSIENT_ARENA_H_
@@ -0,0 +1,131 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/transient_arena.h"
+
+#include "iree/hal/host/condvar_semaphore.h"
+#include "iree/hal/host/host_local_allocator.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using host::CondVarSemaphore;
+using host::HostLocalAllocator;
+
+class TransientArenaTest : public ::testing::Test {
+ protected:
+  StatusOr<std::unique_ptr<TransientArena>> Acquire(
+      device_size_t capacity_hint = 0) {
+    return pool_.Acquire(&allocator_,
+                         MemoryType::kHostLocal | MemoryType::kDeviceVisible,
+                         BufferUsage::kTransfer | BufferUsage::kMapping,
+                         capacity_hint);
+  }
+
+  // Returns the number of allocations made from the device allocator.
+  int64_t allocation_count() const {
+    return allocator_.statistics().allocation_count;
+  }
+
+  HostLocalAllocator allocator_;
+  TransientArenaPool pool_;
+};
+
+// Tests that buffers are aligned subspans of a single block.
+TEST_F(TransientArenaTest, AllocatesAlignedSubspans) {
+  IREE_ASSERT_OK_AND_ASSIGN(auto arena, Acquire(/*capacity_hint=*/4096));
+  IREE_ASSERT_OK_AND_ASSIGN(auto buffer0, arena->Allocate(100));
+  IREE_ASSERT_OK_AND_ASSIGN(auto buffer1, arena->Allocate(200));
+  EXPECT_EQ(100, buffer0->byte_length());
+  EXPECT_EQ(200, buffer1->byte_length());
+  EXPECT_EQ(buffer0->allocated_buffer(), buffer1->allocated_buffer());
+  EXPECT_EQ(0, buffer0->byte_offset());
+  EXPECT_EQ(kTransientArenaAlignment, buffer1->byte_offset());
+  EXPECT_EQ(2 * kTransientArenaAlignment, arena->allocated_length());
+  EXPECT_EQ(4096, arena->capacity());
+
+  // Buffers are usable as any other.
+  IREE_EXPECT_OK(buffer0->Fill8(0, kWholeBuffer, 0x11));
+  IREE_EXPECT_OK(buffer1->Fill8(0, kWholeBuffer, 0x22));
+  uint8_t data = 0;
+  IREE_EXPECT_OK(buffer0->ReadData(99, &data, 1));
+  EXPECT_EQ(0x11, data);
+  pool_.Release(std::move(arena));
+}
+
+// Tests that arenas are only reused once their semaphore has been signaled.
+TEST_F(TransientArenaTest, RecycledAfterSignal) {
+  auto semaphore = make_ref<CondVarSemaphore>(0ull);
+  IREE_ASSERT_OK_AND_ASSIGN(auto arena0, Acquire());
+  IREE_ASSERT_OK(arena0->Allocate(1024).status());
+  pool_.ReleaseOnSignal(std::move(arena0), semaphore.get(), 1ull);
+
+  // Still pending so a new arena with no storage is returned.
+  IREE_ASSERT_OK_AND_ASSIGN(auto arena1, Acquire());
+  EXPECT_EQ(0, arena1->capacity());
+  pool_.Release(std::move(arena1));
+
+  IREE_ASSERT_OK(semaphore->Signal(1ull));
+  int64_t base_allocation_count = allocation_count();
+  for (int i = 0; i < 4; ++i) {
+    IREE_ASSERT_OK_AND_ASSIGN(auto arena, Acquire());
+    EXPECT_LE(1024, arena->capacity());
+    IREE_ASSERT_OK(arena->Allocate(1024).status());
+    pool_.ReleaseOnSignal(std::move(arena), semaphore.get(), 1ull);
+  }
+  EXPECT_EQ(base_allocation_count, allocation_count());
+}
+
+// Tests that arenas that overflowed into multiple blocks are coalesced into
+// one block large enough for the next submission of the same size.
+TEST_F(TransientArenaTest, CoalescesBlocks) {
+  IREE_ASSERT_OK_AND_ASSIGN(auto arena, Acquire(/*capacity_hint=*/1024));
+  for (int i = 0; i < 8; ++i) {
+    IREE_ASSERT_OK(arena->Allocate(1024).status());
+  }
+  EXPECT_EQ(8 * 1024, arena->allocated_length());
+  pool_.Release(std::move(arena));
+
+  int64_t base_allocation_count = allocation_count();
+  for (int j = 0; j < 4; ++j) {
+    IREE_ASSERT_OK_AND_ASSIGN(arena, Acquire(/*capacity_hint=*/1024));
+    for (int i = 0; i < 8; ++i) {
+      IREE_ASSERT_OK(arena->Allocate(1024).status());
+    }
+    EXPECT_EQ(8 * 1024, arena->capacity());
+    pool_.Release(std::move(arena));
+  }
+  // Only the coalesced block was allocated.
+  EXPECT_EQ(base_allocation_count + 1, allocation_count());
+}
+
+// Tests that arenas used by failed work are not reused.
+TEST_F(TransientArenaTest, FailedSemaphoreDiscardsArena) {
+  auto semaphore = make_ref<CondVarSemaphore>(0ull);
+  IREE_ASSERT_OK_AND_ASSIGN(auto arena0, Acquire());
+  IREE_ASSERT_OK(arena0->Allocate(1024).status());
+  pool_.ReleaseOnSignal(std::move(arena0), semaphore.get(), 1ull);
+  semaphore->Fail(DataLossErrorBuilder(IREE_LOC));
+
+  IREE_ASSERT_OK_AND_ASSIGN(auto arena1, Acquire());
+  EXPECT_EQ(0, arena1->capacity());
+  pool_.Release(std::move(arena1));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
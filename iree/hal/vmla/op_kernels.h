@@ -92,16 +92,6 @@ struct CompareGE {
                         absl::Span<uint8_t> dst_buffer);
 };
 
-struct Conv2D {
-  template <typename T>
-  static Status Execute(absl::Span<const T> input_buffer, ShapeSpan input_shape,
-                        absl::Span<const T> filter_buffer,
-                        ShapeSpan filter_shape, absl::Span<T> dst_buffer,
-                        ShapeSpan dst_shape, ShapeSpan strides, ShapeSpan pad_h,
-                        ShapeSpan pad_w, ShapeSpan dilation,
-                        const int32_t groups);
-};
-
 struct Copy {
   template <int element_size>
   static Status Execute(absl::Span<const uint8_t> src_buffer,
@@ -422,6 +412,31 @@ struct RuntimeState {
       MatMul::CreateRuntimeState();
 };
 
+// 2-D (grouped) convolution of a single HWC example with an
+// [kh, kw, in_channel, out_channel / groups] filter.
+struct Conv2D {
+  // Lowers the convolution to a matrix multiplication of im2col-packed input
+  // patches with the filter of each group using the MatMul runtime state.
+  template <typename T>
+  static Status Execute(MatMul::RuntimeState* runtime_state,
+                        absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                        absl::Span<const T> filter_buffer,
+                        ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                        ShapeSpan dst_shape, ShapeSpan strides, ShapeSpan pad_h,
+                        ShapeSpan pad_w, ShapeSpan dilation,
+                        const int32_t groups);
+
+  // Direct loop implementation; the reference for Execute.
+  template <typename T>
+  static Status ExecuteDirect(absl::Span<const T> input_buffer,
+                              ShapeSpan input_shape,
+                              absl::Span<const T> filter_buffer,
+                              ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                              ShapeSpan dst_shape, ShapeSpan strides,
+                              ShapeSpan pad_h, ShapeSpan pad_w,
+                              ShapeSpan dilation, const int32_t groups);
+};
+
 struct ReduceSum {
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
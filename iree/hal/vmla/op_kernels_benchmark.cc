@@ -0,0 +1,115 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "iree/base/status.h"
+#include "iree/hal/vmla/op_kernels.h"
+
+namespace {
+
+using iree::hal::vmla::kernels::Conv2D;
+using iree::hal::vmla::kernels::GetElementCount;
+using iree::hal::vmla::kernels::MatMul;
+
+// A single-example 'same' padded convolution configured from the benchmark
+// args: [spatial size, input channels, output channels, kernel size, groups].
+struct Conv2DProblem {
+  explicit Conv2DProblem(const benchmark::State& state) {
+    const int32_t size = state.range(0);
+    const int32_t input_channels = state.range(1);
+    const int32_t output_channels = state.range(2);
+    const int32_t kernel_size = state.range(3);
+    groups = state.range(4);
+    input_shape = {size, size, input_channels};
+    filter_shape = {kernel_size, kernel_size, input_channels,
+                    output_channels / groups};
+    dst_shape = {size, size, output_channels};
+    pad_h = {(kernel_size - 1) / 2, kernel_size / 2};
+    pad_w = {(kernel_size - 1) / 2, kernel_size / 2};
+
+    input_buffer.resize(GetElementCount(input_shape));
+    for (size_t i = 0; i < input_buffer.size(); ++i) {
+      input_buffer[i] = (i % 7) * 0.25f;
+    }
+    filter_buffer.resize(GetElementCount(filter_shape));
+    for (size_t i = 0; i < filter_buffer.size(); ++i) {
+      filter_buffer[i] = (i % 5) * 0.5f;
+    }
+    dst_buffer.resize(GetElementCount(dst_shape));
+  }
+
+  int64_t flops() const {
+    return 2 * GetElementCount(dst_shape) * filter_shape[0] * filter_shape[1] *
+           (input_shape[2] / groups);
+  }
+
+  std::array<int32_t, 3> input_shape;
+  std::array<int32_t, 4> filter_shape;
+  std::array<int32_t, 3> dst_shape;
+  std::array<int32_t, 2> strides = {1, 1};
+  std::array<int32_t, 2> pad_h;
+  std::array<int32_t, 2> pad_w;
+  std::array<int32_t, 2> dilation = {1, 1};
+  int32_t groups;
+  std::vector<float> input_buffer;
+  std::vector<float> filter_buffer;
+  std::vector<float> dst_buffer;
+};
+
+void Conv2DArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"size", "cin", "cout", "k", "groups"});
+  b->Args({56, 64, 64, 1, 1});
+  b->Args({56, 64, 64, 3, 1});
+  b->Args({28, 128, 128, 3, 1});
+  b->Args({14, 256, 256, 3, 1});
+  b->Args({56, 64, 64, 3, 64});
+  b->Args({28, 128, 128, 3, 4});
+}
+
+static void BM_Conv2DDirect(benchmark::State& state) {
+  Conv2DProblem p(state);
+  while (state.KeepRunning()) {
+    std::fill(p.dst_buffer.begin(), p.dst_buffer.end(), 0.0f);
+    IREE_CHECK_OK(Conv2D::ExecuteDirect<float>(
+        p.input_buffer, p.input_shape, p.filter_buffer, p.filter_shape,
+        absl::MakeSpan(p.dst_buffer), p.dst_shape, p.strides, p.pad_h, p.pad_w,
+        p.dilation, p.groups));
+    benchmark::DoNotOptimize(p.dst_buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * p.flops());
+}
+BENCHMARK(BM_Conv2DDirect)->Apply(Conv2DArgs);
+
+static void BM_Conv2DIm2Col(benchmark::State& state) {
+  Conv2DProblem p(state);
+  auto runtime_state = MatMul::CreateRuntimeState();
+  while (state.KeepRunning()) {
+    IREE_CHECK_OK(Conv2D::Execute<float>(
+        runtime_state.get(), p.input_buffer, p.input_shape, p.filter_buffer,
+        p.filter_shape, absl::MakeSpan(p.dst_buffer), p.dst_shape, p.strides,
+        p.pad_h, p.pad_w, p.dilation, p.groups));
+    benchmark::DoNotOptimize(p.dst_buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * p.flops());
+}
+BENCHMARK(BM_Conv2DIm2Col)->Apply(Conv2DArgs);
+
+}  // namespace
@@ -15,10 +15,17 @@
 #ifndef IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 #define IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
 #include "iree/base/status.h"
 #include "ruy/context.h"
 #include "ruy/mul_params.h"
@@ -32,8 +39,72 @@ namespace kernels {
 // TODO(benvanik): something more clever for making this shareable.
 // Maybe a factory fn based on the impl selected?
 struct MatMul::RuntimeState {
-  // TODO(benvanik): share the thread pool but keep context per-fiber?
-  ruy::Context context;
+  // State used by a single matmul at a time.
+  // ruy::Context is not thread-safe and the runtime state is shared across all
+  // contexts (and tiles running concurrently on the parallel host scheduler) so
+  // each concurrent matmul gets its own workspace from the pool below.
+  // Grow-only byte storage reused across calls.
+  struct Scratch {
+    std::unique_ptr<uint8_t[]> data;
+    size_t byte_length = 0;
+  };
+
+  struct Workspace {
+    ruy::Context context;
+    // Scratch space used by Conv2D for packing input patches and the filters
+    // of grouped convolutions.
+    Scratch patches;
+    Scratch group_filter;
+  };
+
+  // Returns |scratch| as storage for at least |count| values of T, growing it
+  // if needed. Existing contents are not preserved.
+  template <typename T>
+  static T* GrowScratch(Scratch* scratch, size_t count) {
+    static_assert(std::is_trivial<T>::value, "");
+    // Array new returns storage aligned for any fundamental type.
+    static_assert(alignof(T) <= alignof(std::max_align_t), "");
+    size_t byte_length = count * sizeof(T);
+    if (scratch->byte_length < byte_length) {
+      scratch->data.reset(new uint8_t[byte_length]);
+      scratch->byte_length = byte_length;
+    }
+    return reinterpret_cast<T*>(scratch->data.get());
+  }
+
+  // Acquires a workspace for the lifetime of the scope, allocating a new one
+  // only if all existing workspaces are in use. The pool grows to the maximum
+  // number of concurrent matmuls and is then reused.
+  class ScopedWorkspace {
+   public:
+    explicit ScopedWorkspace(RuntimeState* runtime_state)
+        : runtime_state_(runtime_state) {
+      {
+        absl::MutexLock lock(&runtime_state_->mutex);
+        if (!runtime_state_->free_workspaces.empty()) {
+          workspace_ = std::move(runtime_state_->free_workspaces.back());
+          runtime_state_->free_workspaces.pop_back();
+        }
+      }
+      if (!workspace_) workspace_ = absl::make_unique<Workspace>();
+    }
+    ~ScopedWorkspace() {
+      absl::MutexLock lock(&runtime_state_->mutex);
+      runtime_state_->free_workspaces.push_back(std::move(workspace_));
+    }
+    ScopedWorkspace(const ScopedWorkspace&) = delete;
+    ScopedWorkspace& operator=(const ScopedWorkspace&) = delete;
+
+    Workspace* operator->() const { return workspace_.get(); }
+
+   private:
+    RuntimeState* runtime_state_;
+    std::unique_ptr<Workspace> workspace_;
+  };
+
+  absl::Mutex mutex;
+  std::vector<std::unique_ptr<Workspace>> free_workspaces
+      ABSL_GUARDED_BY(mutex);
 };
 
 inline std::unique_ptr<MatMul::RuntimeState> MatMul::CreateRuntimeState() {
@@ -111,7 +182,121 @@ Status MatMul::Execute(RuntimeState* runtime_state,
   ruy::MulParams<ACC, T> mul_params;
   MakeRuyMulParams(buffers, &mul_params);
 
-  ruy::Mul(lhs, rhs, mul_params, &runtime_state->context, &dst);
+  MatMul::RuntimeState::ScopedWorkspace workspace(runtime_state);
+  ruy::Mul(lhs, rhs, mul_params, &workspace->context, &dst);
+
+  return OkStatus();
+}
+
+// Each group is computed as a single [output_pixels, kh * kw * in_channels]
+// x [kh * kw * in_channels, out_channels] matrix multiplication. The lhs is
+// produced by packing the (possibly padded and dilated) input patch of every
+// output pixel into a row (im2col) and the rhs is the group's slice of the
+// filter. The result of a group is written directly into its channel range of
+// the interleaved destination by using a strided layout.
+template <typename T>
+Status Conv2D::Execute(MatMul::RuntimeState* runtime_state,
+                       absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                       absl::Span<const T> filter_buffer,
+                       ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                       ShapeSpan dst_shape, ShapeSpan window_strides,
+                       ShapeSpan pad_h, ShapeSpan pad_w, ShapeSpan dilation,
+                       const int32_t groups) {
+  const int input_height = input_shape[0];
+  const int input_width = input_shape[1];
+  const int input_channels = input_shape[2];
+  const int filter_height = filter_shape[0];
+  const int filter_width = filter_shape[1];
+  const int output_height = dst_shape[0];
+  const int output_width = dst_shape[1];
+  const int output_channels = dst_shape[2];
+  const int input_group_size = input_channels / groups;
+  const int output_group_size = output_channels / groups;
+  const int output_pixels = output_height * output_width;
+  const int patch_size = filter_height * filter_width * input_group_size;
+
+  // A 1x1 unstrided convolution of an ungrouped input is already a matrix
+  // multiplication of the input and need not be packed.
+  const bool is_pointwise =
+      filter_height == 1 && filter_width == 1 && groups == 1 &&
+      window_strides[0] == 1 && window_strides[1] == 1 && pad_h[0] == 0 &&
+      pad_w[0] == 0 && input_height == output_height &&
+      input_width == output_width;
+
+  MatMul::RuntimeState::ScopedWorkspace workspace(runtime_state);
+  T* patches = nullptr;
+  if (!is_pointwise) {
+    patches = MatMul::RuntimeState::GrowScratch<T>(&workspace->patches,
+                                                   output_pixels * patch_size);
+  }
+  T* group_filter = nullptr;
+  if (groups > 1) {
+    group_filter = MatMul::RuntimeState::GrowScratch<T>(
+        &workspace->group_filter, patch_size * output_group_size);
+  }
+
+  for (int g = 0; g < groups; ++g) {
+    const T* lhs_data = input_buffer.data();
+    if (!is_pointwise) {
+      T* patch = patches;
+      for (int ho = 0; ho < output_height; ++ho) {
+        for (int wo = 0; wo < output_width; ++wo) {
+          for (int kh = 0; kh < filter_height; ++kh) {
+            const int ih = ho * window_strides[0] + kh * dilation[0] - pad_h[0];
+            for (int kw = 0; kw < filter_width; ++kw) {
+              const int iw =
+                  wo * window_strides[1] + kw * dilation[1] - pad_w[0];
+              if (ih < 0 || ih >= input_height || iw < 0 ||
+                  iw >= input_width) {
+                std::fill_n(patch, input_group_size, T(0));
+              } else {
+                const T* src = input_buffer.data() +
+                               (ih * input_width + iw) * input_channels +
+                               g * input_group_size;
+                std::copy_n(src, input_group_size, patch);
+              }
+              patch += input_group_size;
+            }
+          }
+        }
+      }
+      lhs_data = patches;
+    }
+
+    const T* rhs_data = filter_buffer.data();
+    if (groups > 1) {
+      // The filter rows of a group are interleaved with those of the other
+      // groups for every filter tap; gather them into a contiguous matrix.
+      const int tap_group_size = input_group_size * output_group_size;
+      for (int tap = 0; tap < filter_height * filter_width; ++tap) {
+        const T* src = filter_buffer.data() +
+                       (tap * input_channels + g * input_group_size) *
+                           output_group_size;
+        std::copy_n(src, tap_group_size,
+                    group_filter + tap * tap_group_size);
+      }
+      rhs_data = group_filter;
+    }
+
+    ruy::Matrix<T> lhs;
+    lhs.set_data(lhs_data);
+    ruy::MakeSimpleLayout(output_pixels, patch_size, ruy::Order::kRowMajor,
+                          lhs.mutable_layout());
+
+    ruy::Matrix<T> rhs;
+    rhs.set_data(rhs_data);
+    ruy::MakeSimpleLayout(patch_size, output_group_size, ruy::Order::kRowMajor,
+                          rhs.mutable_layout());
+
+    ruy::Matrix<T> dst;
+    dst.set_data(dst_buffer.data() + g * output_group_size);
+    ruy::MakeSimpleLayout(output_pixels, output_group_size,
+                          ruy::Order::kRowMajor, dst.mutable_layout());
+    dst.mutable_layout()->set_stride(output_channels);
+
+    ruy::MulParams<T, T> mul_params;
+    ruy::Mul(lhs, rhs, mul_params, &workspace->context, &dst);
+  }
 
   return OkStatus();
 }
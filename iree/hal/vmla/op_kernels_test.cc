@@ -492,10 +492,11 @@ TEST(Conv2d, NoDilation) {
   }
   std::vector<float> dst_buffer(GetShapeElementCount(dst_shape), 0.0f);
 
-  IREE_EXPECT_OK(Conv2D::Execute<float>(input_buffer, input_shape,
-                                        filter_buffer, filter_shape,
-                                        absl::MakeSpan(dst_buffer), dst_shape,
-                                        strides, pad_h, pad_w, dilation, 1));
+  auto runtime_state = MatMul::CreateRuntimeState();
+  IREE_EXPECT_OK(Conv2D::Execute<float>(
+      runtime_state.get(), input_buffer, input_shape, filter_buffer,
+      filter_shape, absl::MakeSpan(dst_buffer), dst_shape, strides, pad_h,
+      pad_w, dilation, 1));
 
   for (int i = 0; i < dst_buffer.size(); ++i) {
     EXPECT_NEAR(expected_dst[i], dst_buffer[i], kEpsilon);
@@ -524,16 +525,67 @@ TEST(Conv2d, DepthwiseConv) {
   }
   std::vector<float> dst_buffer(GetShapeElementCount(dst_shape), 0.0f);
 
-  IREE_EXPECT_OK(Conv2D::Execute<float>(input_buffer, input_shape,
-                                        filter_buffer, filter_shape,
-                                        absl::MakeSpan(dst_buffer), dst_shape,
-                                        strides, pad_h, pad_w, dilation, 2));
+  auto runtime_state = MatMul::CreateRuntimeState();
+  IREE_EXPECT_OK(Conv2D::Execute<float>(
+      runtime_state.get(), input_buffer, input_shape, filter_buffer,
+      filter_shape, absl::MakeSpan(dst_buffer), dst_shape, strides, pad_h,
+      pad_w, dilation, 2));
 
   for (int i = 0; i < dst_buffer.size(); ++i) {
     EXPECT_NEAR(expected_dst[i], dst_buffer[i], kEpsilon);
   }
 }
 
+// Checks the im2col/GEMM lowering against the direct loop reference.
+void ExpectConv2DMatchesDirect(Shape input_shape, Shape filter_shape,
+                               Shape dst_shape, Shape strides, Shape pad_h,
+                               Shape pad_w, Shape dilation, int32_t groups) {
+  std::vector<float> input_buffer(GetShapeElementCount(input_shape));
+  std::vector<float> filter_buffer(GetShapeElementCount(filter_shape));
+  for (int i = 0; i < input_buffer.size(); ++i) {
+    input_buffer[i] = (i % 7) - 3;
+  }
+  for (int i = 0; i < filter_buffer.size(); ++i) {
+    filter_buffer[i] = (i % 5) - 2;
+  }
+  std::vector<float> expected_dst(GetShapeElementCount(dst_shape), 0.0f);
+  IREE_ASSERT_OK(Conv2D::ExecuteDirect<float>(
+      input_buffer, input_shape, filter_buffer, filter_shape,
+      absl::MakeSpan(expected_dst), dst_shape, strides, pad_h, pad_w, dilation,
+      groups));
+
+  std::vector<float> dst_buffer(GetShapeElementCount(dst_shape), 0.0f);
+  auto runtime_state = MatMul::CreateRuntimeState();
+  IREE_ASSERT_OK(Conv2D::Execute<float>(
+      runtime_state.get(), input_buffer, input_shape, filter_buffer,
+      filter_shape, absl::MakeSpan(dst_buffer), dst_shape, strides, pad_h,
+      pad_w, dilation, groups));
+
+  for (int i = 0; i < dst_buffer.size(); ++i) {
+    EXPECT_NEAR(expected_dst[i], dst_buffer[i], kEpsilon);
+  }
+}
+
+TEST(Conv2d, PointwiseMatchesDirect) {
+  ExpectConv2DMatchesDirect({4, 5, 3}, {1, 1, 3, 6}, {4, 5, 6}, {1, 1}, {0, 0},
+                            {0, 0}, {1, 1}, 1);
+}
+
+TEST(Conv2d, StridedPaddedMatchesDirect) {
+  ExpectConv2DMatchesDirect({7, 6, 3}, {3, 3, 3, 4}, {4, 3, 4}, {2, 2}, {1, 1},
+                            {1, 1}, {1, 1}, 1);
+}
+
+TEST(Conv2d, DilatedMatchesDirect) {
+  ExpectConv2DMatchesDirect({8, 8, 2}, {3, 3, 2, 3}, {4, 4, 3}, {1, 1}, {0, 0},
+                            {0, 0}, {2, 2}, 1);
+}
+
+TEST(Conv2d, GroupedMatchesDirect) {
+  ExpectConv2DMatchesDirect({6, 6, 4}, {3, 3, 4, 3}, {6, 6, 6}, {1, 1}, {1, 1},
+                            {1, 1}, {1, 1}, 2);
+}
+
 }  // namespace
 }  // namespace kernels
 }  // namespace vmla
@@ -18,7 +18,7 @@
 
 #include "iree/base/tracing.h"
 #include "iree/hal/device_info.h"
-#include "iree/hal/host/serial/serial_scheduling_model.h"
+#include "iree/hal/host/parallel/parallel_scheduling_model.h"
 #include "iree/hal/vmla/vmla_device.h"
 #include "iree/hal/vmla/vmla_module.h"
 #include "iree/vm/module.h"
@@ -84,7 +84,7 @@ StatusOr<ref_ptr<Device>> VMLADriver::CreateDefaultDevice() {
 }
 
 StatusOr<ref_ptr<Device>> VMLADriver::CreateDevice(DriverDeviceID device_id) {
-  auto scheduling_model = std::make_unique<host::SerialSchedulingModel>();
+  auto scheduling_model = std::make_unique<host::ParallelSchedulingModel>();
   auto device =
       make_ref<VMLADevice>(GetDefaultDeviceInfo(), std::move(scheduling_model),
                            instance_, vmla_module_);
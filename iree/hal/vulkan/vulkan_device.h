@@ -75,6 +75,9 @@ class VulkanDevice final : public Device {
   }
 
   Allocator* allocator() const override { return allocator_.get(); }
+  TransientArenaPool* transient_arena_pool() override {
+    return &transient_arena_pool_;
+  }
 
   absl::Span<CommandQueue*> dispatch_queues() const override {
     return absl::MakeSpan(dispatch_queues_);
@@ -136,6 +139,8 @@ class VulkanDevice final : public Device {
   ref_ptr<VkDeviceHandle> logical_device_;
 
   std::unique_ptr<Allocator> allocator_;
+  // Must be destroyed before |allocator_|.
+  TransientArenaPool transient_arena_pool_;
 
   mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 4> command_queues_;
   mutable absl::InlinedVector<CommandQueue*, 4> dispatch_queues_;
@@ -112,6 +112,12 @@ class HALModuleState final {
       iree_vm_ref_release(&ref);
     }
     deferred_releases_.clear();
+    if (transient_arena_) {
+      // Nothing was submitted using the arena so it can be recycled now.
+      iree_status_ignore(iree_hal_device_release_transient_arena(
+          shared_device_ptr(), transient_arena_, /*semaphore=*/nullptr, 0ull));
+      transient_arena_ = nullptr;
+    }
   }
 
   //===--------------------------------------------------------------------===//
@@ -135,7 +141,23 @@ class HALModuleState final {
       const vm::ref<iree_hal_device_t>& device,
       const vm::ref<iree_hal_command_buffer_t>& command_buffer) {
     IREE_TRACE_SCOPE0("HALModuleState::ExSubmitAndWait");
+    return SubmitAndWait(device, command_buffer, {});
+  }
+
+  Status ExSubmitAndWaitIndirect(
+      const vm::ref<iree_hal_device_t>& device,
+      const vm::ref<iree_hal_command_buffer_t>& command_buffer,
+      absl::Span<const vm::ref<iree_hal_buffer_t>> binding_table) {
+    IREE_TRACE_SCOPE0("HALModuleState::ExSubmitAndWaitIndirect");
+    return SubmitAndWait(device, command_buffer, binding_table);
+  }
 
+  // Submits |command_buffer| with the buffers in |binding_table| available to
+  // its indirect bindings and waits for it to complete.
+  Status SubmitAndWait(
+      const vm::ref<iree_hal_device_t>& device,
+      const vm::ref<iree_hal_command_buffer_t>& command_buffer,
+      absl::Span<const vm::ref<iree_hal_buffer_t>> binding_table) {
     vm::ref<iree_hal_semaphore_t> semaphore;
     IREE_RETURN_IF_ERROR(iree_hal_semaphore_create(
         device.get(), 0ull, iree_allocator_system(), &semaphore));
@@ -150,8 +172,31 @@ class HALModuleState final {
     batch.signal_semaphores.semaphores = semaphore_ptrs;
     uint64_t signal_value = 1ull;
     batch.signal_semaphores.payload_values = &signal_value;
-    IREE_RETURN_IF_ERROR(iree_hal_device_queue_submit(
-        device.get(), IREE_HAL_COMMAND_CATEGORY_ANY, 0, 1, &batch));
+    absl::InlinedVector<iree_hal_buffer_t*, 16> binding_table_ptrs(
+        binding_table.size());
+    for (int i = 0; i < binding_table.size(); ++i) {
+      binding_table_ptrs[i] = binding_table[i].get();
+    }
+    batch.binding_table_count = binding_table_ptrs.size();
+    batch.binding_table = binding_table_ptrs.data();
+    iree_status_t submit_status = iree_hal_device_queue_submit(
+        device.get(), IREE_HAL_COMMAND_CATEGORY_ANY, 0, 1, &batch);
+
+    // Transient buffers allocated for this submission are recycled once it
+    // signals. If the submission failed nothing is using them.
+    if (transient_arena_) {
+      iree_status_t release_status = iree_hal_device_release_transient_arena(
+          shared_device_ptr(), transient_arena_,
+          iree_status_is_ok(submit_status) ? semaphore.get() : nullptr,
+          signal_value);
+      transient_arena_ = nullptr;
+      if (iree_status_is_ok(submit_status)) {
+        submit_status = release_status;
+      } else {
+        iree_status_ignore(release_status);
+      }
+    }
+    IREE_RETURN_IF_ERROR(submit_status);
 
     IREE_RETURN_IF_ERROR(iree_hal_semaphore_wait_with_deadline(
         semaphore.get(), 1ull, IREE_TIME_INFINITE_FUTURE));
@@ -210,11 +255,55 @@ class HALModuleState final {
       int32_t allocation_size) {
     IREE_TRACE_SCOPE0("HALModuleState::AllocatorAllocate");
     vm::ref<iree_hal_buffer_t> buffer;
+    if (memory_types & IREE_HAL_MEMORY_TYPE_TRANSIENT) {
+      // The compiler marks buffers used only within the next submission as
+      // transient. The bit is only a hint to this module and is not passed on
+      // to the device allocator.
+      memory_types &= ~IREE_HAL_MEMORY_TYPE_TRANSIENT;
+      IREE_RETURN_IF_ERROR(AllocateTransient(allocator, memory_types,
+                                             buffer_usage, allocation_size,
+                                             &buffer));
+      if (buffer.get()) return std::move(buffer);
+    }
     IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
         allocator.get(), memory_types, buffer_usage, allocation_size, &buffer));
     return std::move(buffer);
   }
 
+  // Allocates |out_buffer| from the transient arena of the shared device that
+  // is released by the next ExSubmitAndWait. |out_buffer| is left empty if the
+  // arena cannot be used and the caller should allocate from |allocator|.
+  Status AllocateTransient(const vm::ref<iree_hal_allocator_t>& allocator,
+                           iree_hal_memory_type_t memory_types,
+                           iree_hal_buffer_usage_t buffer_usage,
+                           int32_t allocation_size,
+                           iree_hal_buffer_t** out_buffer) {
+    if (allocator.get() != iree_hal_device_allocator(shared_device_ptr())) {
+      return OkStatus();
+    }
+    if (transient_arena_) {
+      // All transient buffers of a submission share one arena; buffers of
+      // other types are allocated directly.
+      if (transient_memory_types_ != memory_types ||
+          transient_buffer_usage_ != buffer_usage) {
+        return OkStatus();
+      }
+    } else {
+      iree_status_t status = iree_hal_device_acquire_transient_arena(
+          shared_device_ptr(), memory_types, buffer_usage,
+          /*capacity_hint=*/0, &transient_arena_);
+      if (iree_status_is_unavailable(status)) {
+        iree_status_ignore(status);
+        return OkStatus();
+      }
+      IREE_RETURN_IF_ERROR(status);
+      transient_memory_types_ = memory_types;
+      transient_buffer_usage_ = buffer_usage;
+    }
+    return iree_hal_transient_arena_allocate_buffer(
+        transient_arena_, allocation_size, out_buffer);
+  }
+
   StatusOr<vm::ref<iree_hal_buffer_t>> AllocatorAllocateConst(
       const vm::ref<iree_hal_allocator_t>& allocator,
       iree_hal_memory_type_t memory_types, iree_hal_buffer_usage_t buffer_usage,
@@ -537,6 +626,35 @@ class HALModuleState final {
         binding_structs.size(), binding_structs.data());
   }
 
+  Status CommandBufferPushDescriptorSetIndirect(
+      const vm::ref<iree_hal_command_buffer_t>& command_buffer,
+      const vm::ref<iree_hal_executable_layout_t>& executable_layout,
+      int32_t set, absl::Span<const int32_t> binding_ordinals,
+      absl::Span<const int32_t> binding_slots,
+      absl::Span<const int32_t> binding_offsets,
+      absl::Span<const int32_t> binding_lengths) {
+    if (binding_slots.size() != binding_ordinals.size() ||
+        binding_offsets.size() != binding_ordinals.size() ||
+        binding_lengths.size() != binding_ordinals.size()) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Binding field count mismatch (" << binding_ordinals.size()
+             << " ordinals, " << binding_slots.size() << " slots, "
+             << binding_offsets.size() << " offsets, "
+             << binding_lengths.size() << " lengths)";
+    }
+    absl::InlinedVector<iree_hal_descriptor_set_indirect_binding_t, 16>
+        binding_structs(binding_ordinals.size());
+    for (int i = 0; i < binding_ordinals.size(); ++i) {
+      binding_structs[i] = {
+          binding_ordinals[i], binding_slots[i],
+          static_cast<iree_device_size_t>(binding_offsets[i]),
+          static_cast<iree_device_size_t>(binding_lengths[i])};
+    }
+    return iree_hal_command_buffer_push_descriptor_set_indirect(
+        command_buffer.get(), executable_layout.get(), set,
+        binding_structs.size(), binding_structs.data());
+  }
+
   Status CommandBufferBindDescriptorSet(
       const vm::ref<iree_hal_command_buffer_t>& command_buffer,
       const vm::ref<iree_hal_executable_layout_t>& executable_layout,
@@ -732,17 +850,22 @@ class HALModuleState final {
   }
 
   StatusOr<int32_t> SemaphoreAwait(
-      const vm::ref<iree_hal_semaphore_t>& semaphore, uint32_t new_value) {
-    // TODO(benvanik): coroutine magic.
-    iree_status_t status = iree_hal_semaphore_wait_with_deadline(
-        semaphore.get(), new_value, IREE_TIME_INFINITE_FUTURE);
-    if (iree_status_is_ok(status)) {
+      iree_vm_stack_t* stack, const vm::ref<iree_hal_semaphore_t>& semaphore,
+      uint32_t new_value) {
+    if (!iree_vm_stack_async_waits(stack)) {
+      IREE_RETURN_IF_ERROR(iree_hal_semaphore_wait_with_deadline(
+          semaphore.get(), new_value, IREE_TIME_INFINITE_FUTURE));
       return 0;
-    } else if (iree_status_is_deadline_exceeded(status)) {
-      // Propagate deadline exceeded back to the VM.
-      return static_cast<int32_t>(iree_status_consume_code(status));
     }
-    return Status(std::move(status));
+    // When the caller can suspend we defer back to the VM rather than blocking
+    // so that other work can run on the thread. The await is reissued when
+    // the invocation is resumed.
+    uint64_t value = 0;
+    IREE_RETURN_IF_ERROR(iree_hal_semaphore_query(semaphore.get(), &value));
+    if (value < new_value) {
+      return Status(iree_status_from_code(IREE_STATUS_DEFERRED));
+    }
+    return 0;
   }
 
  private:
@@ -750,6 +873,16 @@ class HALModuleState final {
   ref_ptr<Device> shared_device_;
 
   std::vector<iree_vm_ref_t> deferred_releases_;
+
+  // Arena for transient buffers used by the next submission, acquired on the
+  // first transient allocation and handed back to the device on submit.
+  iree_hal_transient_arena_t* transient_arena_ = nullptr;
+  iree_hal_memory_type_t transient_memory_types_ = 0;
+  iree_hal_buffer_usage_t transient_buffer_usage_ = 0;
+
+  iree_hal_device_t* shared_device_ptr() const {
+    return reinterpret_cast<iree_hal_device_t*>(shared_device_.get());
+  }
 };
 
 //===----------------------------------------------------------------------===//
@@ -761,6 +894,8 @@ static const vm::NativeFunction<HALModuleState> kHALModuleFunctions[] = {
     vm::MakeNativeFunction("ex.defer_release", &HALModuleState::ExDeferRelease),
     vm::MakeNativeFunction("ex.submit_and_wait",
                            &HALModuleState::ExSubmitAndWait),
+    vm::MakeNativeFunction("ex.submit_and_wait.indirect",
+                           &HALModuleState::ExSubmitAndWaitIndirect),
 
     vm::MakeNativeFunction("allocator.compute_size",
                            &HALModuleState::AllocatorComputeSize),
@@ -825,6 +960,9 @@ static const vm::NativeFunction<HALModuleState> kHALModuleFunctions[] = {
                            &HALModuleState::CommandBufferPushConstants),
     vm::MakeNativeFunction("command_buffer.push_descriptor_set",
                            &HALModuleState::CommandBufferPushDescriptorSet),
+    vm::MakeNativeFunction(
+        "command_buffer.push_descriptor_set.indirect",
+        &HALModuleState::CommandBufferPushDescriptorSetIndirect),
     vm::MakeNativeFunction("command_buffer.bind_descriptor_set",
                            &HALModuleState::CommandBufferBindDescriptorSet),
     vm::MakeNativeFunction("command_buffer.dispatch",
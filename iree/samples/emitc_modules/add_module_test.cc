@@ -131,7 +131,7 @@ TEST_F(VMAddModuleTest, AddCallTest) {
   IREE_ASSERT_OK_AND_ASSIGN(
       int32_t v,
       RunFunction(iree_make_cstring_view("add_module.add_call"), 17));
-  ASSERT_EQ(v, 34);
+  ASSERT_EQ(v, 68);
 }
 
 }  // namespace
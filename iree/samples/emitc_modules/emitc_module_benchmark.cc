@@ -0,0 +1,178 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs the iree/vm/bytecode_module_benchmark.cc cases against the same module
+// compiled to C with the VM C target. Compare against the *Bytecode variants
+// there to measure the interpreter dispatch overhead.
+
+#include <array>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/module.h"
+#include "iree/vm/native_module.h"
+#include "iree/vm/stack.h"
+
+// Generated from iree/vm/bytecode_module_benchmark.mlir and defines
+// bytecode_module_benchmark_create.
+#include "iree/samples/emitc_modules/emitc_module_benchmark_module.module"
+
+namespace {
+
+// vm.import @native_import_module.add_1(%arg0 : i32) -> i32
+static iree_status_t native_import_module_add_1(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  // Add 1 to arg0 and return.
+  int32_t arg0 = *reinterpret_cast<int32_t*>(call->arguments.data);
+  int32_t ret0 = arg0 + 1;
+  *reinterpret_cast<int32_t*>(call->results.data) = ret0;
+  return iree_ok_status();
+}
+
+static const iree_vm_native_export_descriptor_t
+    native_import_module_exports_[] = {
+        {iree_make_cstring_view("add_1"), iree_make_cstring_view("0i.i"), 0,
+         NULL},
+};
+static const iree_vm_native_function_ptr_t native_import_module_funcs_[] = {
+    {(iree_vm_native_function_shim_t)native_import_module_add_1, NULL},
+};
+static_assert(IREE_ARRAYSIZE(native_import_module_funcs_) ==
+                  IREE_ARRAYSIZE(native_import_module_exports_),
+              "function pointer table must be 1:1 with exports");
+static const iree_vm_native_module_descriptor_t
+    native_import_module_descriptor_ = {
+        iree_make_cstring_view("native_import_module"),
+        0,
+        NULL,
+        IREE_ARRAYSIZE(native_import_module_exports_),
+        native_import_module_exports_,
+        IREE_ARRAYSIZE(native_import_module_funcs_),
+        native_import_module_funcs_,
+        0,
+        NULL,
+};
+
+static iree_status_t native_import_module_create(
+    iree_allocator_t allocator, iree_vm_module_t** out_module) {
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, NULL));
+  return iree_vm_native_module_create(
+      &interface, &native_import_module_descriptor_, allocator, out_module);
+}
+
+// Benchmarks the given exported function, optionally passing in arguments.
+static iree_status_t RunFunction(benchmark::State& state,
+                                 absl::string_view function_name,
+                                 absl::Span<const int32_t> i32_args,
+                                 int result_count, int batch_size = 1) {
+  iree_vm_instance_t* instance = NULL;
+  IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
+
+  iree_vm_module_t* import_module = NULL;
+  IREE_CHECK_OK(
+      native_import_module_create(iree_allocator_system(), &import_module));
+
+  iree_vm_module_t* c_module = NULL;
+  IREE_CHECK_OK(
+      bytecode_module_benchmark_create(iree_allocator_system(), &c_module));
+
+  std::array<iree_vm_module_t*, 2> modules = {import_module, c_module};
+  iree_vm_context_t* context = NULL;
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      instance, modules.data(), modules.size(), iree_allocator_system(),
+      &context));
+
+  iree_vm_function_t function;
+  IREE_CHECK_OK(iree_vm_context_resolve_function(
+      context,
+      iree_make_string_view(function_name.data(), function_name.size()),
+      &function));
+
+  iree_vm_function_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.function = function;
+  call.arguments =
+      iree_make_byte_span(iree_alloca(i32_args.size() * sizeof(int32_t)),
+                          i32_args.size() * sizeof(int32_t));
+  call.results =
+      iree_make_byte_span(iree_alloca(result_count * sizeof(int32_t)),
+                          result_count * sizeof(int32_t));
+
+  IREE_VM_INLINE_STACK_INITIALIZE(
+      stack, iree_vm_context_state_resolver(context), iree_allocator_system());
+  while (state.KeepRunningBatch(batch_size)) {
+    for (iree_host_size_t i = 0; i < i32_args.size(); ++i) {
+      reinterpret_cast<int32_t*>(call.arguments.data)[i] = i32_args[i];
+    }
+
+    iree_vm_execution_result_t result;
+    IREE_CHECK_OK(c_module->begin_call(c_module->self, stack, &call, &result));
+  }
+  iree_vm_stack_deinitialize(stack);
+
+  iree_vm_module_release(import_module);
+  iree_vm_module_release(c_module);
+  iree_vm_context_release(context);
+  iree_vm_instance_release(instance);
+
+  return iree_ok_status();
+}
+
+static void BM_EmptyFuncC(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, "bytecode_module_benchmark.empty_func", {},
+                            /*result_count=*/0));
+}
+BENCHMARK(BM_EmptyFuncC);
+
+static void BM_CallInternalFuncC(benchmark::State& state) {
+  IREE_CHECK_OK(
+      RunFunction(state, "bytecode_module_benchmark.call_internal_func", {100},
+                  /*result_count=*/1,
+                  /*batch_size=*/20));
+}
+BENCHMARK(BM_CallInternalFuncC);
+
+static void BM_CallImportedFuncC(benchmark::State& state) {
+  IREE_CHECK_OK(
+      RunFunction(state, "bytecode_module_benchmark.call_imported_func", {100},
+                  /*result_count=*/1,
+                  /*batch_size=*/20));
+}
+BENCHMARK(BM_CallImportedFuncC);
+
+static void BM_LoopSumC(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, "bytecode_module_benchmark.loop_sum",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*result_count=*/1,
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumC)->Arg(100000);
+
+static void BM_LoopBranchyC(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, "bytecode_module_benchmark.loop_branchy",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*result_count=*/1,
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopBranchyC)->Arg(100000);
+
+}  // namespace
@@ -0,0 +1,19 @@
+vm.module @rodata_switch_module {
+  vm.rodata @table dense<[10, 20, 30]> : tensor<3xi32>
+
+  vm.func @table() -> !vm.ref<!iree.byte_buffer> {
+    %0 = vm.const.ref.rodata @table : !vm.ref<!iree.byte_buffer>
+    vm.return %0 : !vm.ref<!iree.byte_buffer>
+  }
+  vm.export @table
+
+  vm.func @select(%arg0 : i32) -> i32 {
+    %c5 = vm.const.i32 5 : i32
+    %c100 = vm.const.i32 100 : i32
+    %c200 = vm.const.i32 200 : i32
+    %c300 = vm.const.i32 300 : i32
+    %0 = vm.switch.i32 %arg0[%c100, %c200, %c300] else %c5 : i32
+    vm.return %0 : i32
+  }
+  vm.export @select
+}
@@ -0,0 +1,135 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/samples/emitc_modules/rodata_switch_module_test.h"
+
+#include <cstring>
+
+#include "iree/base/status.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/builtin_types.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/invocation.h"
+#include "iree/vm/list.h"
+#include "iree/vm/ref_cc.h"
+
+namespace iree {
+namespace {
+
+class VMRodataSwitchModuleTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+
+    iree_vm_module_t* module = nullptr;
+    IREE_CHECK_OK(
+        rodata_switch_module_create(iree_allocator_system(), &module));
+
+    std::vector<iree_vm_module_t*> modules = {module};
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, modules.data(), modules.size(), iree_allocator_system(),
+        &context_));
+
+    iree_vm_module_release(module);
+  }
+
+  virtual void TearDown() {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  // Invokes |function_name| with the optional i32 |arg| and returns the output
+  // list holding its single result.
+  StatusOr<vm::ref<iree_vm_list_t>> Invoke(iree_string_view_t function_name,
+                                           const int32_t* arg) {
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_context_resolve_function(context_, function_name, &function),
+        "unable to resolve entry point");
+
+    vm::ref<iree_vm_list_t> input_list;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(
+        /*element_type=*/nullptr, 1, iree_allocator_system(), &input_list));
+    if (arg) {
+      auto arg_value = iree_vm_value_make_i32(*arg);
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_push_value(input_list.get(), &arg_value));
+    }
+    vm::ref<iree_vm_list_t> output_list;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(
+        /*element_type=*/nullptr, 1, iree_allocator_system(), &output_list));
+
+    IREE_RETURN_IF_ERROR(iree_vm_invoke(context_, function,
+                                        /*policy=*/nullptr, input_list.get(),
+                                        output_list.get(),
+                                        iree_allocator_system()));
+    return std::move(output_list);
+  }
+
+  StatusOr<int32_t> RunSelect(int32_t index) {
+    IREE_ASSIGN_OR_RETURN(
+        auto output_list,
+        Invoke(iree_make_cstring_view("rodata_switch_module.select"), &index));
+    iree_vm_value_t ret_value;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_get_value(output_list.get(), 0, &ret_value));
+    return ret_value.i32;
+  }
+
+ private:
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+};
+
+TEST_F(VMRodataSwitchModuleTest, SwitchInRange) {
+  IREE_ASSERT_OK_AND_ASSIGN(int32_t v0, RunSelect(0));
+  EXPECT_EQ(v0, 100);
+  IREE_ASSERT_OK_AND_ASSIGN(int32_t v1, RunSelect(1));
+  EXPECT_EQ(v1, 200);
+  IREE_ASSERT_OK_AND_ASSIGN(int32_t v2, RunSelect(2));
+  EXPECT_EQ(v2, 300);
+}
+
+TEST_F(VMRodataSwitchModuleTest, SwitchOutOfRangeSelectsDefault) {
+  IREE_ASSERT_OK_AND_ASSIGN(int32_t v_over, RunSelect(3));
+  EXPECT_EQ(v_over, 5);
+  IREE_ASSERT_OK_AND_ASSIGN(int32_t v_under, RunSelect(-1));
+  EXPECT_EQ(v_under, 5);
+}
+
+TEST_F(VMRodataSwitchModuleTest, RodataBuffer) {
+  // Rodata refs are shared across calls so the buffer must remain valid after
+  // the first returned ref has been released.
+  for (int i = 0; i < 2; ++i) {
+    IREE_ASSERT_OK_AND_ASSIGN(
+        auto output_list,
+        Invoke(iree_make_cstring_view("rodata_switch_module.table"),
+               /*arg=*/nullptr));
+    auto* buffer = reinterpret_cast<iree_vm_ro_byte_buffer_t*>(
+        iree_vm_list_get_ref_deref(output_list.get(), 0,
+                                   iree_vm_ro_byte_buffer_get_descriptor()));
+    ASSERT_NE(buffer, nullptr);
+    ASSERT_EQ(buffer->data.data_length, 3 * sizeof(int32_t));
+    int32_t values[3];
+    std::memcpy(values, buffer->data.data, sizeof(values));
+    EXPECT_EQ(values[0], 10);
+    EXPECT_EQ(values[1], 20);
+    EXPECT_EQ(values[2], 30);
+  }
+}
+
+}  // namespace
+}  // namespace iree
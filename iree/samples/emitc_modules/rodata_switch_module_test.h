@@ -0,0 +1,22 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_SAMPLES_EMITC_MODULES_RODATA_SWITCH_MODULE_TEST_H_
+#define IREE_SAMPLES_EMITC_MODULES_RODATA_SWITCH_MODULE_TEST_H_
+
+// The generated module contains the module implementation along with its
+// descriptors and a rodata_switch_module_create function.
+#include "iree/samples/emitc_modules/rodata_switch_module.module"
+
+#endif  // IREE_SAMPLES_EMITC_MODULES_RODATA_SWITCH_MODULE_TEST_H_
@@ -56,6 +56,11 @@ ABSL_FLAG(std::string, function_inputs_file, "",
           "Provides a file for input shapes and optional values (see "
           "ParseToVariantListFromFile in vm_util.h for details)");
 
+ABSL_FLAG(bool, print_vm_profile, false,
+          "Prints per-function and per-opcode VM execution counters "
+          "accumulated over all benchmark iterations. Requires "
+          "IREE_VM_PROFILING_ENABLE=1.");
+
 namespace iree {
 namespace {
 
@@ -125,6 +130,7 @@ class IREEBenchmark {
         device_(nullptr),
         hal_module_(nullptr),
         context_(nullptr),
+        profile_(nullptr),
         input_module_(nullptr){};
   ~IREEBenchmark() {
     // Order matters.
@@ -133,6 +139,7 @@ class IREEBenchmark {
     iree_vm_module_release(input_module_);
     iree_hal_device_release(device_);
     iree_vm_context_release(context_);
+    iree_vm_profile_release(profile_);
     iree_vm_instance_release(instance_);
   };
 
@@ -150,6 +157,11 @@ class IREEBenchmark {
     return iree::OkStatus();
   }
 
+  // Prints the VM profile recorded while benchmarking, if enabled.
+  void PrintProfile() {
+    if (profile_) PrintVmProfile(profile_);
+  }
+
  private:
   Status Init() {
     IREE_RETURN_IF_ERROR(GetModuleContentsFromFlags(module_data_));
@@ -170,6 +182,12 @@ class IREEBenchmark {
     IREE_RETURN_IF_ERROR(iree_vm_context_create_with_modules(
         instance_, modules.data(), modules.size(), iree_allocator_system(),
         &context_));
+
+    if (absl::GetFlag(FLAGS_print_vm_profile)) {
+      IREE_RETURN_IF_ERROR(
+          iree_vm_profile_create(iree_allocator_system(), &profile_));
+      iree_vm_context_set_profile(context_, profile_);
+    }
     return iree::OkStatus();
   }
 
@@ -232,6 +250,7 @@ class IREEBenchmark {
   iree_hal_device_t* device_;
   iree_vm_module_t* hal_module_;
   iree_vm_context_t* context_;
+  iree_vm_profile_t* profile_;
   iree_vm_module_t* input_module_;
   iree::vm::ref<iree_vm_list_t> inputs_;
 };
@@ -257,6 +276,7 @@ int main(int argc, char** argv) {
       "    [--function_inputs=2xi32=1 2,1x2xf32=2 1 | \n"
       "     --function_inputs_file=file_with_function_inputs]\n"
       "    [--driver=vmla]\n"
+      "    [--print_vm_profile={true|false}]\n"
       "\n\n"
       "  Optional flags from third_party/benchmark/src/benchmark.cc:\n"
       "    [--benchmark_list_tests={true|false}]\n"
@@ -285,5 +305,6 @@ int main(int argc, char** argv) {
     return static_cast<int>(status.code());
   }
   ::benchmark::RunSpecifiedBenchmarks();
+  iree_benchmark.PrintProfile();
   return 0;
 }
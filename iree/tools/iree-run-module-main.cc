@@ -51,6 +51,10 @@ ABSL_FLAG(std::string, function_inputs_file, "",
           "Provides a file for input shapes and optional values (see "
           "ParseToVariantListFromFile in vm_util.h for details)");
 
+ABSL_FLAG(bool, print_vm_profile, false,
+          "Prints per-function and per-opcode VM execution counters after "
+          "the function completes. Requires IREE_VM_PROFILING_ENABLE=1.");
+
 namespace iree {
 namespace {
 
@@ -94,6 +98,14 @@ Status Run() {
       &context))
       << "creating context";
 
+  iree_vm_profile_t* profile = nullptr;
+  if (absl::GetFlag(FLAGS_print_vm_profile)) {
+    IREE_RETURN_IF_ERROR(
+        iree_vm_profile_create(iree_allocator_system(), &profile))
+        << "creating profile";
+    iree_vm_context_set_profile(context, profile);
+  }
+
   std::string function_name = absl::GetFlag(FLAGS_entry_function);
   iree_vm_function_t function;
   IREE_RETURN_IF_ERROR(input_module->lookup_function(
@@ -138,12 +150,17 @@ Status Run() {
   IREE_RETURN_IF_ERROR(PrintVariantList(output_descs, outputs.get()))
       << "printing results";
 
+  if (profile) {
+    PrintVmProfile(profile);
+  }
+
   inputs.reset();
   outputs.reset();
   iree_vm_module_release(hal_module);
   iree_vm_module_release(input_module);
   iree_hal_device_release(device);
   iree_vm_context_release(context);
+  iree_vm_profile_release(profile);
   iree_vm_instance_release(instance);
   return OkStatus();
 }
@@ -14,9 +14,12 @@
 
 #include "iree/tools/utils/vm_util.h"
 
+#include <algorithm>
 #include <ostream>
 
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
@@ -222,6 +225,70 @@ Status PrintVariantList(absl::Span<const RawSignatureParser::Description> descs,
   return OkStatus();
 }
 
+void PrintVmProfile(iree_vm_profile_t* profile, std::ostream* os) {
+#if !IREE_VM_PROFILING_ENABLE
+  *os << "VM profiling is disabled in this build; rebuild with "
+         "IREE_VM_PROFILING_ENABLE=1 to record counters.\n";
+#endif  // !IREE_VM_PROFILING_ENABLE
+  std::vector<const iree_vm_profile_function_stats_t*> functions;
+  iree_duration_t total_time = 0;
+  for (iree_host_size_t i = 0; i < iree_vm_profile_function_count(profile);
+       ++i) {
+    functions.push_back(iree_vm_profile_function_stats(profile, i));
+    total_time += functions.back()->exclusive_time;
+  }
+  std::stable_sort(functions.begin(), functions.end(),
+                   [](const iree_vm_profile_function_stats_t* lhs,
+                      const iree_vm_profile_function_stats_t* rhs) {
+                     return lhs->exclusive_time > rhs->exclusive_time;
+                   });
+  *os << absl::StrFormat("%-40s %10s %12s %12s %12s %6s\n", "function",
+                         "calls", "ops", "incl (us)", "excl (us)", "excl%");
+  for (const auto* stats : functions) {
+    iree_string_view_t module_name =
+        iree_vm_module_name(stats->function.module);
+    iree_string_view_t function_name = iree_vm_function_name(&stats->function);
+    std::string name = absl::StrCat(
+        absl::string_view(module_name.data, module_name.size), ".",
+        absl::string_view(function_name.data, function_name.size));
+    *os << absl::StrFormat(
+        "%-40s %10d %12d %12.3f %12.3f %5.1f%%\n", name, stats->call_count,
+        stats->op_count, stats->inclusive_time / 1000.0,
+        stats->exclusive_time / 1000.0,
+        total_time ? 100.0 * stats->exclusive_time / total_time : 0.0);
+  }
+
+  std::vector<std::pair<std::string, uint64_t>> opcodes;
+  uint64_t total_ops = 0;
+  static const char* kOpcodeSetPrefixes[IREE_VM_PROFILE_OPCODE_SET_COUNT] = {
+      "", "ExtI64.", "ExtF32."};
+  for (iree_vm_profile_opcode_set_t opcode_set = 0;
+       opcode_set < IREE_VM_PROFILE_OPCODE_SET_COUNT; ++opcode_set) {
+    for (int opcode = 0; opcode < 256; ++opcode) {
+      uint64_t count =
+          iree_vm_profile_opcode_count(profile, opcode_set, opcode);
+      if (!count) continue;
+      iree_string_view_t opcode_name =
+          iree_vm_bytecode_opcode_name(opcode_set, opcode);
+      opcodes.emplace_back(
+          absl::StrCat(kOpcodeSetPrefixes[opcode_set],
+                       absl::string_view(opcode_name.data, opcode_name.size)),
+          count);
+      total_ops += count;
+    }
+  }
+  std::stable_sort(opcodes.begin(), opcodes.end(),
+                   [](const std::pair<std::string, uint64_t>& lhs,
+                      const std::pair<std::string, uint64_t>& rhs) {
+                     return lhs.second > rhs.second;
+                   });
+  *os << absl::StrFormat("\n%-40s %12s %6s\n", "opcode", "count", "%");
+  for (const auto& opcode : opcodes) {
+    *os << absl::StrFormat("%-40s %12d %5.1f%%\n", opcode.first, opcode.second,
+                           100.0 * opcode.second / total_ops);
+  }
+}
+
 Status CreateDevice(absl::string_view driver_name,
                     iree_hal_device_t** out_device) {
   IREE_LOG(INFO) << "Creating driver and device for '" << driver_name << "'...";
@@ -79,6 +79,10 @@ Status PrintVariantList(absl::Span<const RawSignatureParser::Description> descs,
                         iree_vm_list_t* variant_list,
                         std::ostream* os = &std::cout);
 
+// Prints the per-function and per-opcode counters recorded in |profile| to
+// |os|. Functions are listed by descending exclusive time.
+void PrintVmProfile(iree_vm_profile_t* profile, std::ostream* os = &std::cout);
+
 // Creates the default device for |driver| in |out_device|.
 // The returned |out_device| must be released by the caller.
 Status CreateDevice(absl::string_view driver_name,
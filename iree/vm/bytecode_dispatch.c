@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <math.h>
 #include <string.h>
 
 #include "iree/vm/bytecode_dispatch_util.h"
@@ -131,6 +132,8 @@ static iree_status_t iree_vm_bytecode_function_enter(
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "import ordinal out of range");
   }
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_ensure_function_verified(
+      module, function.ordinal));
   const iree_vm_FunctionDescriptor_t* target_descriptor =
       &module->function_descriptor_table[function.ordinal];
 
@@ -213,7 +216,8 @@ static iree_status_t iree_vm_bytecode_external_enter(
   const uint8_t* p = arguments.data;
   for (iree_host_size_t i = 0; i < cconv_arguments.size; ++i) {
     switch (cconv_arguments.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
         uint16_t dst_reg = i32_reg++;
         memcpy(&callee_registers.i32[dst_reg & callee_registers.i32_mask], p,
                sizeof(int32_t));
@@ -254,7 +258,8 @@ static iree_status_t iree_vm_bytecode_external_leave(
   for (iree_host_size_t i = 0; i < cconv_results.size; ++i) {
     uint16_t src_reg = src_reg_list->registers[i];
     switch (cconv_results.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
         memcpy(p, &callee_registers->i32[src_reg & callee_registers->i32_mask],
                sizeof(int32_t));
         p += sizeof(int32_t);
@@ -382,7 +387,10 @@ static iree_status_t iree_vm_bytecode_internal_leave(
   return iree_vm_stack_function_leave(stack);
 }
 
-// Populates an import call arguments
+// Populates an import call arguments.
+// Refs are always retained (even if the source register is marked as a move)
+// so that the caller registers remain intact should the import be deferred and
+// need to be reissued. Moved registers are released once the import succeeds.
 static void iree_vm_bytecode_populate_import_cconv_arguments(
     iree_string_view_t cconv_arguments,
     const iree_vm_registers_t caller_registers,
@@ -393,7 +401,8 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
   for (iree_host_size_t i = 0, seg_i = 0, reg_i = 0; i < cconv_arguments.size;
        ++i, ++seg_i) {
     switch (cconv_arguments.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
         memcpy(p,
                &caller_registers.i32[src_reg_list->registers[reg_i++] &
                                      caller_registers.i32_mask],
@@ -409,8 +418,7 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
       } break;
       case IREE_VM_CCONV_TYPE_REF: {
         uint16_t src_reg = src_reg_list->registers[reg_i++];
-        iree_vm_ref_retain_or_move(
-            src_reg & IREE_REF_REGISTER_MOVE_BIT,
+        iree_vm_ref_retain(
             &caller_registers.ref[src_reg & caller_registers.ref_mask],
             (iree_vm_ref_t*)p);
         p += sizeof(iree_vm_ref_t);
@@ -436,7 +444,8 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
                ++i) {
             // TODO(benvanik): share with switch above.
             switch (cconv_arguments.data[i]) {
-              case IREE_VM_CCONV_TYPE_INT32: {
+              case IREE_VM_CCONV_TYPE_INT32:
+              case IREE_VM_CCONV_TYPE_FLOAT32: {
                 memcpy(p,
                        &caller_registers.i32[src_reg_list->registers[reg_i++] &
                                              caller_registers.i32_mask],
@@ -452,8 +461,7 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
               } break;
               case IREE_VM_CCONV_TYPE_REF: {
                 uint16_t src_reg = src_reg_list->registers[reg_i++];
-                iree_vm_ref_retain_or_move(
-                    src_reg & IREE_REF_REGISTER_MOVE_BIT,
+                iree_vm_ref_retain(
                     &caller_registers.ref[src_reg & caller_registers.ref_mask],
                     (iree_vm_ref_t*)p);
                 p += sizeof(iree_vm_ref_t);
@@ -466,63 +474,226 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
   }
 }
 
+// Releases a single ABI value of the given cconv |type| at |p| if it is a ref
+// and returns the pointer to the next value.
+static inline uint8_t* iree_vm_bytecode_release_cconv_value(char type,
+                                                            uint8_t* p) {
+  switch (type) {
+    case IREE_VM_CCONV_TYPE_INT32:
+    case IREE_VM_CCONV_TYPE_FLOAT32:
+      return p + sizeof(int32_t);
+    case IREE_VM_CCONV_TYPE_INT64:
+      return p + sizeof(int64_t);
+    case IREE_VM_CCONV_TYPE_REF:
+      iree_vm_ref_release((iree_vm_ref_t*)p);
+      return p + sizeof(iree_vm_ref_t);
+    default:
+      return p;
+  }
+}
+
+// Releases any refs the callee left in an import arguments buffer populated by
+// iree_vm_bytecode_populate_import_cconv_arguments.
+static void iree_vm_bytecode_release_import_cconv_arguments(
+    iree_string_view_t cconv_arguments,
+    const iree_vm_register_list_t* IREE_RESTRICT segment_size_list,
+    iree_byte_span_t storage) {
+  uint8_t* p = storage.data;
+  for (iree_host_size_t i = 0, seg_i = 0; i < cconv_arguments.size;
+       ++i, ++seg_i) {
+    if (cconv_arguments.data[i] != IREE_VM_CCONV_TYPE_SPAN_START) {
+      p = iree_vm_bytecode_release_cconv_value(cconv_arguments.data[i], p);
+      continue;
+    }
+    int32_t span_count = segment_size_list->registers[seg_i];
+    p += sizeof(int32_t);
+    iree_host_size_t span_start_i = i + 1;
+    iree_host_size_t span_end_i = span_start_i;
+    while (span_end_i < cconv_arguments.size &&
+           cconv_arguments.data[span_end_i] != IREE_VM_CCONV_TYPE_SPAN_END) {
+      ++span_end_i;
+    }
+    for (int32_t j = 0; j < span_count; ++j) {
+      for (iree_host_size_t k = span_start_i; k < span_end_i; ++k) {
+        p = iree_vm_bytecode_release_cconv_value(cconv_arguments.data[k], p);
+      }
+    }
+    i = span_end_i;
+  }
+}
+
+// Marshals the |src_reg_list| registers into the arguments buffer |p| using a
+// precomputed |plan|. Refs are retained as with
+// iree_vm_bytecode_populate_import_cconv_arguments. |p| may be uninitialized;
+// ref slots are cleared before being retained into.
+static void iree_vm_bytecode_populate_import_planned_arguments(
+    const iree_vm_bytecode_marshal_plan_t* IREE_RESTRICT plan,
+    const iree_vm_registers_t caller_registers,
+    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
+    uint8_t* IREE_RESTRICT p) {
+  const iree_vm_bytecode_marshal_step_t* IREE_RESTRICT step = plan->steps;
+  for (uint16_t i = 0; i < plan->i32_count; ++i, ++step) {
+    uint16_t src_reg = src_reg_list->registers[step->reg_index];
+    memcpy(p + step->offset,
+           &caller_registers.i32[src_reg & caller_registers.i32_mask],
+           sizeof(int32_t));
+  }
+  for (uint16_t i = 0; i < plan->i64_count; ++i, ++step) {
+    uint16_t src_reg = src_reg_list->registers[step->reg_index];
+    memcpy(p + step->offset,
+           &caller_registers.i32[src_reg & (caller_registers.i32_mask & ~1)],
+           sizeof(int64_t));
+  }
+  for (uint16_t i = 0; i < plan->ref_count; ++i, ++step) {
+    uint16_t src_reg = src_reg_list->registers[step->reg_index];
+    iree_vm_ref_t* dst_ref = (iree_vm_ref_t*)(p + step->offset);
+    memset(dst_ref, 0, sizeof(*dst_ref));
+    iree_vm_ref_retain(
+        &caller_registers.ref[src_reg & caller_registers.ref_mask], dst_ref);
+  }
+}
+
+// Releases any refs the callee left in an import arguments buffer populated by
+// iree_vm_bytecode_populate_import_planned_arguments.
+static void iree_vm_bytecode_release_import_planned_arguments(
+    const iree_vm_bytecode_marshal_plan_t* IREE_RESTRICT plan, uint8_t* p) {
+  const iree_vm_bytecode_marshal_step_t* IREE_RESTRICT step =
+      plan->steps + plan->i32_count + plan->i64_count;
+  for (uint16_t i = 0; i < plan->ref_count; ++i, ++step) {
+    iree_vm_ref_release((iree_vm_ref_t*)(p + step->offset));
+  }
+}
+
 // Issues a populated import call and marshals the results into |dst_reg_list|.
+// |segment_size_list| is NULL if the arguments were marshaled with the
+// precomputed argument plan of |import|.
+//
+// Returns IREE_STATUS_DEFERRED without modifying the caller registers if the
+// import could not make progress without blocking. The caller is expected to
+// suspend and reissue the call when resumed.
 static iree_status_t iree_vm_bytecode_issue_import_call(
     iree_vm_stack_t* stack, const iree_vm_function_call_t call,
-    iree_string_view_t cconv_results,
+    const iree_vm_bytecode_import_t* IREE_RESTRICT import,
+    const iree_vm_register_list_t* IREE_RESTRICT segment_size_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
     const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
     iree_vm_stack_frame_t** out_caller_frame,
     iree_vm_registers_t* out_caller_registers,
     iree_vm_execution_result_t* out_result) {
+#if IREE_VM_PROFILING_ENABLE
+  // Imports are charged as a single function covering any nested execution
+  // they perform that is not itself recorded.
+  iree_vm_profile_recorder_t* profile_recorder =
+      iree_vm_stack_profile_recorder(stack);
+  int32_t profile_function_index = IREE_VM_PROFILE_FUNCTION_INDEX_NONE;
+  int32_t profile_parent_index = IREE_VM_PROFILE_FUNCTION_INDEX_NONE;
+  iree_duration_t profile_enter_time = 0;
+  if (IREE_UNLIKELY(profile_recorder)) {
+    iree_vm_profile_recorder_enter(profile_recorder, &call.function,
+                                   &profile_function_index,
+                                   &profile_parent_index, &profile_enter_time);
+  }
+#endif  // IREE_VM_PROFILING_ENABLE
+
   // Call external function.
+  memset(out_result, 0, sizeof(*out_result));
   iree_status_t call_status = call.function.module->begin_call(
       call.function.module->self, stack, &call, out_result);
+
+  // Yields within imports are run to completion here as the dispatcher is not
+  // able to suspend across module boundaries. Imports that need to wait must
+  // return IREE_STATUS_DEFERRED instead.
+  while (iree_status_is_ok(call_status) &&
+         out_result->state == IREE_VM_EXECUTION_STATE_YIELDED) {
+    call_status = call.function.module->resume_call(call.function.module->self,
+                                                    stack, out_result);
+  }
+  if (iree_status_is_ok(call_status) &&
+      out_result->state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+    call_status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                   "imports may not suspend while waiting");
+  }
+
+#if IREE_VM_PROFILING_ENABLE
+  if (IREE_UNLIKELY(profile_recorder)) {
+    iree_vm_profile_recorder_leave(profile_recorder, profile_function_index,
+                                   profile_parent_index, profile_enter_time);
+  }
+#endif  // IREE_VM_PROFILING_ENABLE
+
+  // Arguments not consumed by the callee are owned by us.
+  if (segment_size_list) {
+    iree_vm_bytecode_release_import_cconv_arguments(
+        import->arguments, segment_size_list, call.arguments);
+  } else {
+    iree_vm_bytecode_release_import_planned_arguments(&import->argument_plan,
+                                                      call.arguments.data);
+  }
   if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
+    if (iree_status_is_deferred(call_status)) return call_status;
     // TODO(benvanik): set execution result to failure/capture stack.
     return iree_status_annotate(call_status,
                                 iree_make_cstring_view("while calling import"));
   }
 
-  // NOTE: we don't support yielding within imported functions right now so it's
-  // safe to assume the stack is still valid here. If the called function can
-  // yield then we'll need to requery all pointers here.
+  // Requery the caller frame as the callee may have used the stack.
   *out_caller_frame = iree_vm_stack_current_frame(stack);
   *out_caller_registers =
       iree_vm_bytecode_get_register_storage(*out_caller_frame);
 
-  // Marshal outputs from the ABI results buffer to registers.
+  // Now that the call has completed the caller is done with any source
+  // registers it moved into the call.
   iree_vm_registers_t caller_registers = *out_caller_registers;
-  uint8_t* IREE_RESTRICT p = call.results.data;
-  for (iree_host_size_t i = 0; i < cconv_results.size && i < dst_reg_list->size;
-       ++i) {
-    uint16_t dst_reg = dst_reg_list->registers[i];
-    switch (cconv_results.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32:
-        memcpy(&caller_registers.i32[dst_reg & caller_registers.i32_mask], p,
-               sizeof(int32_t));
-        p += sizeof(int32_t);
-        break;
-      case IREE_VM_CCONV_TYPE_INT64:
-        memcpy(
-            &caller_registers.i32[dst_reg & (caller_registers.i32_mask & ~1)],
-            p, sizeof(int64_t));
-        p += sizeof(int64_t);
-        break;
-      case IREE_VM_CCONV_TYPE_REF:
-        iree_vm_ref_move(
-            (iree_vm_ref_t*)p,
-            &caller_registers.ref[dst_reg & caller_registers.ref_mask]);
-        p += sizeof(iree_vm_ref_t);
-        break;
+  if (segment_size_list) {
+    for (uint16_t i = 0; i < src_reg_list->size; ++i) {
+      uint16_t src_reg = src_reg_list->registers[i];
+      if ((src_reg & IREE_REF_REGISTER_TYPE_BIT) &&
+          (src_reg & IREE_REF_REGISTER_MOVE_BIT)) {
+        iree_vm_ref_release(
+            &caller_registers.ref[src_reg & caller_registers.ref_mask]);
+      }
+    }
+  } else {
+    const iree_vm_bytecode_marshal_plan_t* plan = &import->argument_plan;
+    const iree_vm_bytecode_marshal_step_t* step =
+        plan->steps + plan->i32_count + plan->i64_count;
+    for (uint16_t i = 0; i < plan->ref_count; ++i, ++step) {
+      uint16_t src_reg = src_reg_list->registers[step->reg_index];
+      if (src_reg & IREE_REF_REGISTER_MOVE_BIT) {
+        iree_vm_ref_release(
+            &caller_registers.ref[src_reg & caller_registers.ref_mask]);
+      }
     }
   }
 
+  // Marshal outputs from the ABI results buffer to registers.
+  const iree_vm_bytecode_marshal_plan_t* plan = &import->result_plan;
+  const iree_vm_bytecode_marshal_step_t* IREE_RESTRICT step = plan->steps;
+  uint8_t* IREE_RESTRICT p = call.results.data;
+  for (uint16_t i = 0; i < plan->i32_count; ++i, ++step) {
+    uint16_t dst_reg = dst_reg_list->registers[step->reg_index];
+    memcpy(&caller_registers.i32[dst_reg & caller_registers.i32_mask],
+           p + step->offset, sizeof(int32_t));
+  }
+  for (uint16_t i = 0; i < plan->i64_count; ++i, ++step) {
+    uint16_t dst_reg = dst_reg_list->registers[step->reg_index];
+    memcpy(&caller_registers.i32[dst_reg & (caller_registers.i32_mask & ~1)],
+           p + step->offset, sizeof(int64_t));
+  }
+  for (uint16_t i = 0; i < plan->ref_count; ++i, ++step) {
+    uint16_t dst_reg = dst_reg_list->registers[step->reg_index];
+    iree_vm_ref_move(
+        (iree_vm_ref_t*)(p + step->offset),
+        &caller_registers.ref[dst_reg & caller_registers.ref_mask]);
+  }
+
   return iree_ok_status();
 }
 
 // Calls an imported function from another module.
 // Marshals the |src_reg_list| registers into ABI storage and results into
-// |dst_reg_list|.
+// |dst_reg_list| using the marshaling plans precomputed when the import was
+// resolved.
 static iree_status_t iree_vm_bytecode_call_import(
     iree_vm_stack_t* stack, const iree_vm_bytecode_module_state_t* module_state,
     uint32_t import_ordinal, const iree_vm_registers_t caller_registers,
@@ -539,26 +710,34 @@ static iree_status_t iree_vm_bytecode_call_import(
   }
   const iree_vm_bytecode_import_t* import =
       &module_state->import_table[import_ordinal];
+  if (IREE_UNLIKELY(src_reg_list->size < import->argument_plan.value_count ||
+                    dst_reg_list->size < import->result_plan.value_count)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "import register list does not match signature");
+  }
   iree_vm_function_call_t call;
   memset(&call, 0, sizeof(call));
   call.function = import->function;
   IREE_DISPATCH_LOG_CALL(&call.function);
 
-  // Marshal inputs from registers to the ABI arguments buffer.
+  // Marshal inputs from registers to the ABI arguments buffer. Every byte of
+  // the buffer is written by the plan so it need not be cleared up front.
   call.arguments.data_length = import->argument_buffer_size;
   call.arguments.data = iree_alloca(call.arguments.data_length);
-  memset(call.arguments.data, 0, call.arguments.data_length);
-  iree_vm_bytecode_populate_import_cconv_arguments(
-      import->arguments, caller_registers,
-      /*segment_size_list=*/NULL, src_reg_list, call.arguments);
+  iree_vm_bytecode_populate_import_planned_arguments(
+      &import->argument_plan, caller_registers, src_reg_list,
+      call.arguments.data);
 
-  // Issue the call and handle results.
+  // Issue the call and handle results. Only refs need clearing as the callee
+  // moves into them.
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
-  memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
-                                            out_caller_registers, out_result);
+  if (import->result_plan.ref_count) {
+    memset(call.results.data, 0, call.results.data_length);
+  }
+  return iree_vm_bytecode_issue_import_call(
+      stack, call, import, /*segment_size_list=*/NULL, src_reg_list,
+      dst_reg_list, out_caller_frame, out_caller_registers, out_result);
 }
 
 // Calls a variadic imported function from another module.
@@ -581,6 +760,10 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
   }
   const iree_vm_bytecode_import_t* import =
       &module_state->import_table[import_ordinal];
+  if (IREE_UNLIKELY(dst_reg_list->size < import->result_plan.value_count)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "import register list does not match signature");
+  }
   iree_vm_function_call_t call;
   memset(&call, 0, sizeof(call));
   call.function = import->function;
@@ -602,9 +785,51 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
-                                            out_caller_registers, out_result);
+  return iree_vm_bytecode_issue_import_call(
+      stack, call, import, segment_size_list, src_reg_list, dst_reg_list,
+      out_caller_frame, out_caller_registers, out_result);
+}
+
+//===----------------------------------------------------------------------===//
+// Suspension
+//===----------------------------------------------------------------------===//
+
+// Suspends execution of |frame| such that a later resume continues at |pc|.
+// The native dispatch state needed to return to the external caller is lost
+// when the dispatcher returns and is stashed in the frame instead.
+static void iree_vm_bytecode_suspend(iree_vm_stack_frame_t* frame,
+                                     iree_vm_source_offset_t pc,
+                                     int32_t entry_frame_depth,
+                                     iree_string_view_t cconv_results,
+                                     iree_byte_span_t results) {
+  frame->pc = pc;
+  iree_vm_bytecode_frame_storage_t* stack_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(frame);
+  stack_storage->suspended_entry_frame_depth = entry_frame_depth;
+  stack_storage->suspended_cconv_results = cconv_results;
+  stack_storage->suspended_results = results;
+}
+
+// Reenters a frame previously suspended with iree_vm_bytecode_suspend.
+static iree_status_t iree_vm_bytecode_resume(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    iree_vm_stack_frame_t** out_frame, iree_vm_registers_t* out_registers,
+    int32_t* out_entry_frame_depth, iree_string_view_t* out_cconv_results,
+    iree_byte_span_t* out_results) {
+  iree_vm_stack_frame_t* frame = iree_vm_stack_current_frame(stack);
+  if (IREE_UNLIKELY(!frame) ||
+      IREE_UNLIKELY(frame->function.module != &module->interface)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "no suspended bytecode frame to resume");
+  }
+  const iree_vm_bytecode_frame_storage_t* stack_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(frame);
+  *out_frame = frame;
+  *out_registers = iree_vm_bytecode_get_register_storage(frame);
+  *out_entry_frame_depth = stack_storage->suspended_entry_frame_depth;
+  *out_cconv_results = stack_storage->suspended_cconv_results;
+  *out_results = stack_storage->suspended_results;
+  return iree_ok_status();
 }
 
 //===----------------------------------------------------------------------===//
@@ -621,14 +846,32 @@ iree_status_t iree_vm_bytecode_dispatch(
   // defining below.
   DEFINE_DISPATCH_TABLES();
 
-  // Enter function (as this is the initial call).
+#if IREE_VM_PROFILING_ENABLE
+  // Receives op counts and function transitions when a profile is attached.
+  iree_vm_profile_recorder_t* profile_recorder =
+      iree_vm_stack_profile_recorder(stack);
+#endif  // IREE_VM_PROFILING_ENABLE
+
+  // Enter function (as this is the initial call) or pick up where a previously
+  // suspended call left off.
   // The callee's return will take care of storing the output registers when it
   // actually does return, either immediately or in the future via a resume.
   iree_vm_stack_frame_t* current_frame = NULL;
   iree_vm_registers_t regs;
-  IREE_RETURN_IF_ERROR(
-      iree_vm_bytecode_external_enter(stack, call->function, cconv_arguments,
-                                      call->arguments, &current_frame, &regs));
+  int32_t entry_frame_depth = 0;
+  iree_byte_span_t results;
+  if (call) {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_external_enter(
+        stack, call->function, cconv_arguments, call->arguments,
+        &current_frame, &regs));
+    IREE_DISPATCH_PROFILE_ENTER(current_frame);
+    entry_frame_depth = current_frame->depth;
+    results = call->results;
+  } else {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_resume(
+        stack, module, &current_frame, &regs, &entry_frame_depth,
+        &cconv_results, &results));
+  }
 
   // Primary dispatch state. This is our 'native stack frame' and really
   // just enough to make dereferencing common addresses (like the current
@@ -644,7 +887,6 @@ iree_status_t iree_vm_bytecode_dispatch(
       module->function_descriptor_table[current_frame->function.ordinal]
           .bytecode_offset;
   iree_vm_source_offset_t pc = current_frame->pc;
-  const int32_t entry_frame_depth = current_frame->depth;
 
   BEGIN_DISPATCH_CORE() {
     //===------------------------------------------------------------------===//
@@ -798,16 +1040,16 @@ iree_status_t iree_vm_bytecode_dispatch(
 
     DISPATCH_OP(CORE, ConstRefRodata, {
       uint32_t rodata_ordinal = VM_DecRodataAttr("rodata");
-      if (IREE_UNLIKELY(rodata_ordinal >= module_state->rodata_ref_count)) {
+      if (IREE_UNLIKELY(rodata_ordinal >= module->rodata_ref_count)) {
         return iree_make_status(
             IREE_STATUS_OUT_OF_RANGE,
             "rodata ref ordinal out of range: %d (table=%zu)", rodata_ordinal,
-            module_state->rodata_ref_count);
+            module->rodata_ref_count);
       }
       bool result_is_move;
       iree_vm_ref_t* result = VM_DecResultRegRef("value", &result_is_move);
       IREE_RETURN_IF_ERROR(iree_vm_ref_wrap_retain(
-          &module_state->rodata_ref_table[rodata_ordinal],
+          &module->rodata_ref_table[rodata_ordinal],
           iree_vm_ro_byte_buffer_type_id(), result));
     });
 
@@ -1131,6 +1373,7 @@ iree_status_t iree_vm_bytecode_dispatch(
     });
 
     DISPATCH_OP(CORE, Call, {
+      iree_vm_source_offset_t call_pc = pc - 1;
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* src_reg_list =
           VM_DecVariadicOperands("operands");
@@ -1143,15 +1386,25 @@ iree_status_t iree_vm_bytecode_dispatch(
       int is_import = (function_ordinal & 0x80000000u) != 0;
       if (is_import) {
         // Call import (and possible yield).
-        IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import(
+        iree_status_t import_status = iree_vm_bytecode_call_import(
             stack, module_state, function_ordinal, regs, src_reg_list,
-            dst_reg_list, &current_frame, &regs, out_result));
+            dst_reg_list, &current_frame, &regs, out_result);
+        if (IREE_UNLIKELY(iree_status_is_deferred(import_status))) {
+          // Suspend such that the call is reissued when resumed.
+          iree_status_ignore(import_status);
+          iree_vm_bytecode_suspend(current_frame, call_pc, entry_frame_depth,
+                                   cconv_results, results);
+          out_result->state = IREE_VM_EXECUTION_STATE_WAITING;
+          return iree_ok_status();
+        }
+        IREE_RETURN_IF_ERROR(import_status);
       } else {
         // Switch execution to the target function and continue running in the
         // bytecode dispatcher.
         IREE_RETURN_IF_ERROR(iree_vm_bytecode_internal_enter(
             stack, current_frame->function.module, function_ordinal,
             src_reg_list, dst_reg_list, &current_frame, &regs));
+        IREE_DISPATCH_PROFILE_ENTER(current_frame);
         bytecode_data =
             module->bytecode_data.data +
             module->function_descriptor_table[function_ordinal].bytecode_offset;
@@ -1162,6 +1415,7 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP(CORE, CallVariadic, {
       // TODO(benvanik): dedupe with above or merge and always have the seg size
       // list be present (but empty) for non-variadic calls.
+      iree_vm_source_offset_t call_pc = pc - 1;
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* segment_size_list =
           VM_DecVariadicOperands("segment_sizes");
@@ -1182,21 +1436,31 @@ iree_status_t iree_vm_bytecode_dispatch(
       }
 
       // Call import (and possible yield).
-      IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import_variadic(
+      iree_status_t import_status = iree_vm_bytecode_call_import_variadic(
           stack, module_state, function_ordinal, regs, segment_size_list,
-          src_reg_list, dst_reg_list, &current_frame, &regs, out_result));
+          src_reg_list, dst_reg_list, &current_frame, &regs, out_result);
+      if (IREE_UNLIKELY(iree_status_is_deferred(import_status))) {
+        // Suspend such that the call is reissued when resumed.
+        iree_status_ignore(import_status);
+        iree_vm_bytecode_suspend(current_frame, call_pc, entry_frame_depth,
+                                 cconv_results, results);
+        out_result->state = IREE_VM_EXECUTION_STATE_WAITING;
+        return iree_ok_status();
+      }
+      IREE_RETURN_IF_ERROR(import_status);
     });
 
     DISPATCH_OP(CORE, Return, {
       const iree_vm_register_list_t* src_reg_list =
           VM_DecVariadicOperands("operands");
       current_frame->pc = pc;
+      IREE_DISPATCH_PROFILE_LEAVE(current_frame);
 
       if (current_frame->depth <= entry_frame_depth) {
         // Return from the top-level entry frame - return back to call().
         return iree_vm_bytecode_external_leave(stack, current_frame, &regs,
                                                src_reg_list, cconv_results,
-                                               call->results);
+                                               results);
       }
 
       // Store results into the caller frame and pop back to the parent.
@@ -1226,7 +1490,11 @@ iree_status_t iree_vm_bytecode_dispatch(
     //===------------------------------------------------------------------===//
 
     DISPATCH_OP(CORE, Yield, {
-      // TODO(benvanik): yield with execution results.
+      // Suspend and return to the caller; resuming continues with the next
+      // instruction.
+      iree_vm_bytecode_suspend(current_frame, pc, entry_frame_depth,
+                               cconv_results, results);
+      out_result->state = IREE_VM_EXECUTION_STATE_YIELDED;
       return iree_ok_status();
     });
 
@@ -1273,6 +1541,49 @@ iree_status_t iree_vm_bytecode_dispatch(
       pc = block_pc;
     });
 
+    //===------------------------------------------------------------------===//
+    // Superinstructions
+    //===------------------------------------------------------------------===//
+
+#define DISPATCH_OP_CORE_BINARY_ALU_I32_IMM(op_name, type, op) \
+  DISPATCH_OP(CORE, op_name, {                                 \
+    int32_t lhs = VM_DecOperandRegI32("lhs");                  \
+    int32_t imm = VM_DecIntAttr32("imm");                      \
+    int32_t* result = VM_DecResultRegI32("result");            \
+    *result = (int32_t)(((type)lhs)op((type)imm));             \
+  });
+
+    DISPATCH_OP_CORE_BINARY_ALU_I32_IMM(AddI32Imm, int32_t, +);
+    DISPATCH_OP_CORE_BINARY_ALU_I32_IMM(MulI32Imm, int32_t, *);
+    DISPATCH_OP_CORE_BINARY_ALU_I32_IMM(AndI32Imm, uint32_t, &);
+    DISPATCH_OP_CORE_BINARY_ALU_I32_IMM(OrI32Imm, uint32_t, |);
+    DISPATCH_OP_CORE_BINARY_ALU_I32_IMM(XorI32Imm, uint32_t, ^);
+
+#define DISPATCH_OP_CORE_CMP_BRANCH_I32(op_name, type, op)                    \
+  DISPATCH_OP(CORE, op_name, {                                                \
+    int32_t lhs = VM_DecOperandRegI32("lhs");                                 \
+    int32_t rhs = VM_DecOperandRegI32("rhs");                                 \
+    int32_t true_block_pc = VM_DecBranchTarget("true_dest");                  \
+    const iree_vm_register_remap_list_t* true_remap_list =                    \
+        VM_DecBranchOperands("true_operands");                                \
+    int32_t false_block_pc = VM_DecBranchTarget("false_dest");                \
+    const iree_vm_register_remap_list_t* false_remap_list =                   \
+        VM_DecBranchOperands("false_operands");                               \
+    if (((type)lhs)op((type)rhs)) {                                           \
+      pc = true_block_pc;                                                     \
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs, true_remap_list); \
+    } else {                                                                  \
+      pc = false_block_pc;                                                    \
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs,                  \
+                                                       false_remap_list);     \
+    }                                                                         \
+  });
+
+    DISPATCH_OP_CORE_CMP_BRANCH_I32(CondBranchEQI32, int32_t, ==);
+    DISPATCH_OP_CORE_CMP_BRANCH_I32(CondBranchNEI32, int32_t, !=);
+    DISPATCH_OP_CORE_CMP_BRANCH_I32(CondBranchLTI32S, int32_t, <);
+    DISPATCH_OP_CORE_CMP_BRANCH_I32(CondBranchLTI32U, uint32_t, <);
+
     //===------------------------------------------------------------------===//
     // Extension trampolines
     //===------------------------------------------------------------------===//
@@ -1505,8 +1816,214 @@ iree_status_t iree_vm_bytecode_dispatch(
     }
     END_DISPATCH_PREFIX();
 
-    DISPATCH_OP(CORE, PrefixExtF32,
-                { return iree_make_status(IREE_STATUS_UNIMPLEMENTED); });
+    BEGIN_DISPATCH_PREFIX(PrefixExtF32, EXT_F32) {
+#if IREE_VM_EXT_F32_ENABLE
+      //===----------------------------------------------------------------===//
+      // ExtF32: Globals
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, GlobalLoadF32, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float* value = VM_DecResultRegF32("value");
+        const float* global_ptr =
+            (const float*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalStoreF32, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float value = VM_DecOperandRegF32("value");
+        float* global_ptr =
+            (float*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalLoadIndirectF32, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float* value = VM_DecResultRegF32("value");
+        const float* global_ptr =
+            (const float*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalStoreIndirectF32, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float value = VM_DecOperandRegF32("value");
+        float* global_ptr =
+            (float*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Constants
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, ConstF32, {
+        float value = VM_DecFloatAttr32("value");
+        float* result = VM_DecResultRegF32("result");
+        *result = value;
+      });
+
+      DISPATCH_OP(EXT_F32, ConstF32Zero, {
+        float* result = VM_DecResultRegF32("result");
+        *result = 0.0f;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Lists
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, ListGetF32, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        float* result = VM_DecResultRegF32("result");
+        iree_vm_value_t value;
+        IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+            list, index, IREE_VM_VALUE_TYPE_F32, &value));
+        *result = value.f32;
+      });
+
+      DISPATCH_OP(EXT_F32, ListSetF32, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        float raw_value = VM_DecOperandRegF32("value");
+        iree_vm_value_t value = iree_vm_value_make_f32(raw_value);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(list, index, &value));
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Conditional assignment
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, SelectF32, {
+        int32_t condition = VM_DecOperandRegI32("condition");
+        float true_value = VM_DecOperandRegF32("true_value");
+        float false_value = VM_DecOperandRegF32("false_value");
+        float* result = VM_DecResultRegF32("result");
+        *result = condition ? true_value : false_value;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Native floating-point arithmetic
+      //===----------------------------------------------------------------===//
+
+#define DISPATCH_OP_EXT_F32_UNARY_ALU_F32(op_name, expr) \
+  DISPATCH_OP(EXT_F32, op_name, {                        \
+    float operand = VM_DecOperandRegF32("operand");      \
+    float* result = VM_DecResultRegF32("result");        \
+    *result = (expr);                                    \
+  });
+
+#define DISPATCH_OP_EXT_F32_BINARY_ALU_F32(op_name, op) \
+  DISPATCH_OP(EXT_F32, op_name, {                       \
+    float lhs = VM_DecOperandRegF32("lhs");             \
+    float rhs = VM_DecOperandRegF32("rhs");             \
+    float* result = VM_DecResultRegF32("result");       \
+    *result = lhs op rhs;                               \
+  });
+
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(AddF32, +);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(SubF32, -);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(MulF32, *);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(DivF32, /);
+      DISPATCH_OP(EXT_F32, RemF32, {
+        float lhs = VM_DecOperandRegF32("lhs");
+        float rhs = VM_DecOperandRegF32("rhs");
+        float* result = VM_DecResultRegF32("result");
+        *result = fmodf(lhs, rhs);
+      });
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(AbsF32, fabsf(operand));
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(NegF32, -operand);
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Casting and type conversion/emulation
+      //===----------------------------------------------------------------===//
+
+#define DISPATCH_OP_EXT_F32_CAST_TO_F32(op_name, src_type) \
+  DISPATCH_OP(EXT_F32, op_name, {                          \
+    int32_t operand = VM_DecOperandRegI32("operand");      \
+    float* result = VM_DecResultRegF32("result");          \
+    *result = (float)((src_type)operand);                  \
+  });
+
+#define DISPATCH_OP_EXT_F32_CAST_FROM_F32(op_name, cast_fn) \
+  DISPATCH_OP(EXT_F32, op_name, {                           \
+    float operand = VM_DecOperandRegF32("operand");         \
+    int32_t* result = VM_DecResultRegI32("result");         \
+    *result = (int32_t)cast_fn(operand);                    \
+  });
+
+      DISPATCH_OP_EXT_F32_CAST_TO_F32(CastSI32F32, int32_t);
+      DISPATCH_OP_EXT_F32_CAST_TO_F32(CastUI32F32, uint32_t);
+      DISPATCH_OP_EXT_F32_CAST_FROM_F32(CastF32SI32, iree_vm_cast_f32_si32);
+      DISPATCH_OP_EXT_F32_CAST_FROM_F32(CastF32UI32, iree_vm_cast_f32_ui32);
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Comparison ops
+      //===----------------------------------------------------------------===//
+      // C comparisons are ordered (false if either operand is NaN) with the
+      // exception of != which is unordered; this matches the VM op semantics.
+
+#define DISPATCH_OP_EXT_F32_CMP_F32(op_name, op)    \
+  DISPATCH_OP(EXT_F32, op_name, {                   \
+    float lhs = VM_DecOperandRegF32("lhs");         \
+    float rhs = VM_DecOperandRegF32("rhs");         \
+    int32_t* result = VM_DecResultRegI32("result"); \
+    *result = (lhs op rhs) ? 1 : 0;                 \
+  });
+
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpEQF32, ==);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpNEF32, !=);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTF32, <);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTEF32, <=);
+      DISPATCH_OP(EXT_F32, CmpNZF32, {
+        float operand = VM_DecOperandRegF32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = (operand != 0.0f) ? 1 : 0;
+      });
+#else
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
+#endif  // IREE_VM_EXT_F32_ENABLE
+    }
+    END_DISPATCH_PREFIX();
 
     DISPATCH_OP(CORE, PrefixExtF64,
                 { return iree_make_status(IREE_STATUS_UNIMPLEMENTED); });
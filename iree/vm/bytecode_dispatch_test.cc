@@ -38,12 +38,14 @@ namespace {
 struct TestParams {
   const iree::FileToc& module_file;
   std::string function_name;
+  iree_vm_bytecode_module_flags_t flags;
 };
 
 std::ostream& operator<<(std::ostream& os, const TestParams& params) {
-  return os << absl::StrReplaceAll(params.module_file.name,
-                                   {{":", "_"}, {".", "_"}})
-            << "_" << params.function_name;
+  os << absl::StrReplaceAll(params.module_file.name, {{":", "_"}, {".", "_"}})
+     << "_" << params.function_name;
+  if (params.flags & IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED) os << "_trusted";
+  return os;
 }
 
 std::vector<TestParams> GetModuleTestParams() {
@@ -62,13 +64,22 @@ std::vector<TestParams> GetModuleTestParams() {
         iree_allocator_null(), iree_allocator_system(), &module))
         << "Bytecode module failed to load";
     iree_vm_module_signature_t signature = module->signature(module->self);
-    test_params.reserve(test_params.size() + signature.export_function_count);
+    test_params.reserve(test_params.size() +
+                        2 * signature.export_function_count);
     for (int i = 0; i < signature.export_function_count; ++i) {
       iree_string_view_t name;
       IREE_CHECK_OK(module->get_function(module->self,
                                          IREE_VM_FUNCTION_LINKAGE_EXPORT, i,
                                          nullptr, &name, nullptr));
-      test_params.push_back({module_file, std::string(name.data, name.size)});
+      std::string function_name(name.data, name.size);
+      test_params.push_back(
+          {module_file, function_name, IREE_VM_BYTECODE_MODULE_FLAG_NONE});
+      // Trusted modules must behave the same when loaded without full
+      // verification and with functions verified on first call.
+      test_params.push_back(
+          {module_file, function_name,
+           IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED |
+               IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION});
     }
     iree_vm_module_release(module);
   }
@@ -85,11 +96,12 @@ class VMBytecodeDispatchTest
 
     IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
 
-    IREE_CHECK_OK(iree_vm_bytecode_module_create(
+    IREE_CHECK_OK(iree_vm_bytecode_module_create_with_flags(
         iree_const_byte_span_t{
             reinterpret_cast<const uint8_t*>(test_params.module_file.data),
             test_params.module_file.size},
-        iree_allocator_null(), iree_allocator_system(), &bytecode_module_))
+        test_params.flags, iree_allocator_null(), iree_allocator_system(),
+        &bytecode_module_))
         << "Bytecode module failed to load";
 
     std::vector<iree_vm_module_t*> modules = {bytecode_module_};
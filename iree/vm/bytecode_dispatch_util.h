@@ -22,10 +22,11 @@
 #include "iree/base/target_platform.h"
 #include "iree/vm/bytecode_module_impl.h"
 #include "iree/vm/bytecode_op_table.h"
+#include "iree/vm/profile.h"
 
 // TODO(benvanik): make a compiler setting.
 #define IREE_VM_EXT_I64_ENABLE 1
-#define IREE_VM_EXT_F32_ENABLE 0
+#define IREE_VM_EXT_F32_ENABLE 1
 #define IREE_VM_EXT_F64_ENABLE 0
 
 //===----------------------------------------------------------------------===//
@@ -102,6 +103,19 @@ typedef struct {
   // Relative byte offsets from the head of this struct.
   iree_host_size_t i32_register_offset;
   iree_host_size_t ref_register_offset;
+
+  // State of the external call that entered the dispatcher, stashed in the top
+  // frame when execution is suspended so that it can be resumed. Only valid
+  // while the frame is suspended.
+  int32_t suspended_entry_frame_depth;
+  iree_string_view_t suspended_cconv_results;
+  iree_byte_span_t suspended_results;
+
+  // Profiling state of the frame when the stack has a profile attached.
+  // Populated by iree_vm_profile_recorder_enter when the frame is entered.
+  int32_t profile_function_index;
+  int32_t profile_parent_index;
+  iree_duration_t profile_enter_time;
 } iree_vm_bytecode_frame_storage_t;
 
 // Interleaved src-dst register sets for branch register remapping.
@@ -126,6 +140,16 @@ static inline const iree_vm_type_def_t* iree_vm_map_type(
   return &module->type_table[type_id];
 }
 
+// Reinterprets the bits of |value| as an IEEE-754 single-precision float.
+static inline float iree_vm_bitcast_f32(uint32_t value) {
+  union {
+    uint32_t i;
+    float f;
+  } u;
+  u.i = value;
+  return u.f;
+}
+
 //===----------------------------------------------------------------------===//
 // Debugging utilities
 //===----------------------------------------------------------------------===//
@@ -145,6 +169,51 @@ static inline const iree_vm_type_def_t* iree_vm_map_type(
 #define IREE_DISPATCH_LOG_CALL(...)
 #endif  // IREE_DISPATCH_LOGGING
 
+#if IREE_VM_PROFILING_ENABLE
+// Records entry into the bytecode function of |frame|.
+static inline void iree_vm_bytecode_profile_enter(
+    iree_vm_profile_recorder_t* recorder, iree_vm_stack_frame_t* frame) {
+  iree_vm_bytecode_frame_storage_t* stack_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(frame);
+  iree_vm_profile_recorder_enter(recorder, &frame->function,
+                                 &stack_storage->profile_function_index,
+                                 &stack_storage->profile_parent_index,
+                                 &stack_storage->profile_enter_time);
+}
+
+// Records exit from the bytecode function of |frame|.
+static inline void iree_vm_bytecode_profile_leave(
+    iree_vm_profile_recorder_t* recorder, iree_vm_stack_frame_t* frame) {
+  const iree_vm_bytecode_frame_storage_t* stack_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(frame);
+  iree_vm_profile_recorder_leave(recorder,
+                                 stack_storage->profile_function_index,
+                                 stack_storage->profile_parent_index,
+                                 stack_storage->profile_enter_time);
+}
+
+// Profiling hooks used within the dispatch loop. These expect a local
+// |profile_recorder| that is NULL when profiling is not active.
+#define IREE_DISPATCH_PROFILE_OP(ext, op_name)                          \
+  if (IREE_UNLIKELY(profile_recorder)) {                                \
+    iree_vm_profile_recorder_count_op(profile_recorder,                 \
+                                      IREE_VM_PROFILE_OPCODE_SET_##ext, \
+                                      IREE_VM_OP_##ext##_##op_name);    \
+  }
+#define IREE_DISPATCH_PROFILE_ENTER(frame)                   \
+  if (IREE_UNLIKELY(profile_recorder)) {                     \
+    iree_vm_bytecode_profile_enter(profile_recorder, frame); \
+  }
+#define IREE_DISPATCH_PROFILE_LEAVE(frame)                   \
+  if (IREE_UNLIKELY(profile_recorder)) {                     \
+    iree_vm_bytecode_profile_leave(profile_recorder, frame); \
+  }
+#else
+#define IREE_DISPATCH_PROFILE_OP(...)
+#define IREE_DISPATCH_PROFILE_ENTER(...)
+#define IREE_DISPATCH_PROFILE_LEAVE(...)
+#endif  // IREE_VM_PROFILING_ENABLE
+
 #if defined(IREE_COMPILER_MSVC) && !defined(IREE_COMPILER_CLANG)
 #define IREE_DISPATCH_MODE_SWITCH 1
 #else
@@ -219,6 +288,9 @@ static const int kRegSize = sizeof(uint16_t);
 #define VM_DecTypeOf(name) VM_DecType(name)
 #define VM_DecIntAttr32(name) VM_DecConstI32(name)
 #define VM_DecIntAttr64(name) VM_DecConstI64(name)
+#define VM_DecFloatAttr32(name)   \
+  iree_vm_bitcast_f32(OP_I32(0)); \
+  pc += 4;
 #define VM_DecStrAttr(name, out_str)                     \
   (out_str)->size = (iree_host_size_t)OP_I16(0);         \
   (out_str)->data = (const char*)&bytecode_data[pc + 2]; \
@@ -235,6 +307,9 @@ static const int kRegSize = sizeof(uint16_t);
 #define VM_DecOperandRegI64(name)                           \
   *((int64_t*)&regs.i32[OP_I16(0) & (regs.i32_mask & ~1)]); \
   pc += kRegSize;
+#define VM_DecOperandRegF32(name)                 \
+  *((float*)&regs.i32[OP_I16(0) & regs.i32_mask]); \
+  pc += kRegSize;
 #define VM_DecOperandRegRef(name, out_is_move)             \
   &regs.ref[OP_I16(0) & regs.ref_mask];                    \
   *(out_is_move) = OP_I16(0) & IREE_REF_REGISTER_MOVE_BIT; \
@@ -249,6 +324,9 @@ static const int kRegSize = sizeof(uint16_t);
 #define VM_DecResultRegI64(name)                           \
   ((int64_t*)&regs.i32[OP_I16(0) & (regs.i32_mask & ~1)]); \
   pc += kRegSize;
+#define VM_DecResultRegF32(name)                 \
+  ((float*)&regs.i32[OP_I16(0) & regs.i32_mask]); \
+  pc += kRegSize;
 #define VM_DecResultRegRef(name, out_is_move)              \
   &regs.ref[OP_I16(0) & regs.ref_mask];                    \
   *(out_is_move) = OP_I16(0) & IREE_REF_REGISTER_MOVE_BIT; \
@@ -299,9 +377,19 @@ static const int kRegSize = sizeof(uint16_t);
 #define DEFINE_DISPATCH_TABLE_EXT_I64()
 #endif  // IREE_VM_EXT_I64_ENABLE
 
-#define DEFINE_DISPATCH_TABLES() \
-  DEFINE_DISPATCH_TABLE_CORE();  \
-  DEFINE_DISPATCH_TABLE_EXT_I64();
+#if IREE_VM_EXT_F32_ENABLE
+#define DECLARE_DISPATCH_EXT_F32_OPC(ordinal, name) &&_dispatch_EXT_F32_##name,
+#define DEFINE_DISPATCH_TABLE_EXT_F32()                                       \
+  static const void* kDispatchTable_EXT_F32[256] = {IREE_VM_OP_EXT_F32_TABLE( \
+      DECLARE_DISPATCH_EXT_F32_OPC, DECLARE_DISPATCH_EXT_RSV)};
+#else
+#define DEFINE_DISPATCH_TABLE_EXT_F32()
+#endif  // IREE_VM_EXT_F32_ENABLE
+
+#define DEFINE_DISPATCH_TABLES()   \
+  DEFINE_DISPATCH_TABLE_CORE();    \
+  DEFINE_DISPATCH_TABLE_EXT_I64(); \
+  DEFINE_DISPATCH_TABLE_EXT_F32();
 
 #define DISPATCH_UNHANDLED_CORE()                                           \
   _dispatch_unhandled : {                                                   \
@@ -312,6 +400,7 @@ static const int kRegSize = sizeof(uint16_t);
 
 #define DISPATCH_OP(ext, op_name, body)                             \
   _dispatch_##ext##_##op_name : IREE_DISPATCH_LOG_OPCODE(#op_name); \
+  IREE_DISPATCH_PROFILE_OP(ext, op_name);                           \
   body;                                                             \
   goto* kDispatchTable_CORE[bytecode_data[pc++]];
 
@@ -345,10 +434,11 @@ static const int kRegSize = sizeof(uint16_t);
                             "unhandled extension opcode"); \
   }
 
-#define DISPATCH_OP(ext, op_name, body) \
-  case IREE_VM_OP_##ext##_##op_name: {  \
-    IREE_DISPATCH_LOG_OPCODE(#op_name); \
-    body;                               \
+#define DISPATCH_OP(ext, op_name, body)     \
+  case IREE_VM_OP_##ext##_##op_name: {      \
+    IREE_DISPATCH_LOG_OPCODE(#op_name);     \
+    IREE_DISPATCH_PROFILE_OP(ext, op_name); \
+    body;                                   \
   } break;
 
 #define BEGIN_DISPATCH_PREFIX(op_name, ext) \
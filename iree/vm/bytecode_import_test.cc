@@ -0,0 +1,138 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests marshaling of bytecode calls into imported native functions.
+// bytecode_import_test.mlir contains the functions used here for testing.
+
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/builtin_types.h"
+#include "iree/vm/bytecode_import_test_module.h"
+#include "iree/vm/bytecode_module.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/invocation.h"
+#include "iree/vm/list.h"
+#include "iree/vm/native_module.h"
+
+namespace {
+
+// vm.import @ref_import_module.scribble(i32, i32, i32, i32, i32, i32, i32, i32)
+static iree_status_t ref_import_module_scribble(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  return iree_ok_status();
+}
+
+// vm.import @ref_import_module.list_sizes(!vm.list<i32>, !vm.list<i32>) -> i32
+static iree_status_t ref_import_module_list_sizes(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  auto* args = reinterpret_cast<iree_vm_ref_t*>(call->arguments.data);
+  iree_vm_list_t* list_a = nullptr;
+  IREE_RETURN_IF_ERROR(iree_vm_list_check_deref(&args[0], &list_a));
+  iree_vm_list_t* list_b = nullptr;
+  IREE_RETURN_IF_ERROR(iree_vm_list_check_deref(&args[1], &list_b));
+  int32_t ret0 = static_cast<int32_t>(iree_vm_list_size(list_a) +
+                                      iree_vm_list_size(list_b));
+  std::memcpy(call->results.data, &ret0, sizeof(ret0));
+  return iree_ok_status();
+}
+
+static const iree_vm_native_export_descriptor_t ref_import_module_exports_[] =
+    {
+        {iree_make_cstring_view("list_sizes"), iree_make_cstring_view("0rr.i"),
+         0, NULL},
+        {iree_make_cstring_view("scribble"),
+         iree_make_cstring_view("0iiiiiiii"), 0, NULL},
+};
+static const iree_vm_native_function_ptr_t ref_import_module_funcs_[] = {
+    {(iree_vm_native_function_shim_t)ref_import_module_list_sizes, NULL},
+    {(iree_vm_native_function_shim_t)ref_import_module_scribble, NULL},
+};
+static_assert(IREE_ARRAYSIZE(ref_import_module_funcs_) ==
+                  IREE_ARRAYSIZE(ref_import_module_exports_),
+              "function pointer table must be 1:1 with exports");
+static const iree_vm_native_module_descriptor_t ref_import_module_descriptor_ =
+    {
+        iree_make_cstring_view("ref_import_module"),
+        0,
+        NULL,
+        IREE_ARRAYSIZE(ref_import_module_exports_),
+        ref_import_module_exports_,
+        IREE_ARRAYSIZE(ref_import_module_funcs_),
+        ref_import_module_funcs_,
+        0,
+        NULL,
+};
+
+class BytecodeImportTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_CHECK_OK(iree_vm_register_builtin_types());
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+
+    iree_vm_module_t interface;
+    IREE_CHECK_OK(iree_vm_module_initialize(&interface, NULL));
+    IREE_CHECK_OK(iree_vm_native_module_create(
+        &interface, &ref_import_module_descriptor_, iree_allocator_system(),
+        &import_module_));
+
+    const auto* module_file = iree::vm::bytecode_import_test_module_create();
+    IREE_CHECK_OK(iree_vm_bytecode_module_create(
+        iree_make_const_byte_span(module_file->data, module_file->size),
+        iree_allocator_null(), iree_allocator_system(), &bytecode_module_));
+
+    iree_vm_module_t* modules[] = {import_module_, bytecode_module_};
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, modules, IREE_ARRAYSIZE(modules), iree_allocator_system(),
+        &context_));
+  }
+
+  void TearDown() override {
+    iree_vm_context_release(context_);
+    iree_vm_module_release(bytecode_module_);
+    iree_vm_module_release(import_module_);
+    iree_vm_instance_release(instance_);
+  }
+
+  iree_status_t RunFunction(const char* function_name) {
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(bytecode_module_->lookup_function(
+        bytecode_module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_make_cstring_view(function_name), &function));
+    return iree_vm_invoke(context_, function, /*policy=*/nullptr,
+                          /*inputs=*/nullptr, /*outputs=*/nullptr,
+                          iree_allocator_system());
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_module_t* import_module_ = nullptr;
+  iree_vm_module_t* bytecode_module_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+};
+
+// Tests that refs passed to imports are marshaled without touching whatever
+// the argument storage previously contained.
+TEST_F(BytecodeImportTest, RefArguments) {
+  IREE_EXPECT_OK(RunFunction("call_ref_import"));
+}
+
+}  // namespace
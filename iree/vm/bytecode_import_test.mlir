@@ -0,0 +1,41 @@
+vm.module @bytecode_import_test {
+  vm.import @ref_import_module.scribble(
+    %a : i32, %b : i32, %c : i32, %d : i32,
+    %e : i32, %f : i32, %g : i32, %h : i32
+  )
+  vm.import @ref_import_module.list_sizes(
+    %a : !vm.list<i32>, %b : !vm.list<i32>
+  ) -> i32
+
+  // Imports taking refs must not release whatever was left in the argument
+  // buffer by a prior import call. |scribble| fills the same stack storage with
+  // non-zero values that would crash if treated as refs.
+  vm.export @call_ref_import
+  vm.func @call_ref_import() {
+    %c1 = vm.const.i32 1 : i32
+    %c2 = vm.const.i32 2 : i32
+    %c3 = vm.const.i32 3 : i32
+    %c7 = vm.const.i32 7 : i32
+    %list_a = vm.list.alloc %c1 : (i32) -> !vm.list<i32>
+    vm.list.resize %list_a, %c1 : (!vm.list<i32>, i32)
+    %list_b = vm.list.alloc %c2 : (i32) -> !vm.list<i32>
+    vm.list.resize %list_b, %c2 : (!vm.list<i32>, i32)
+    %garbage = vm.const.i32 -559038737 : i32
+    vm.call @ref_import_module.scribble(
+        %garbage, %garbage, %garbage, %garbage,
+        %garbage, %garbage, %garbage, %garbage) :
+        (i32, i32, i32, i32, i32, i32, i32, i32) -> ()
+    %0 = vm.call @ref_import_module.list_sizes(%list_a, %list_b) :
+        (!vm.list<i32>, !vm.list<i32>) -> i32
+    vm.check.eq %0, %c3, "1+2=3" : i32
+    vm.call @ref_import_module.scribble(
+        %garbage, %garbage, %garbage, %garbage,
+        %garbage, %garbage, %garbage, %garbage) :
+        (i32, i32, i32, i32, i32, i32, i32, i32) -> ()
+    %1 = vm.call @ref_import_module.list_sizes(%list_b, %list_b) :
+        (!vm.list<i32>, !vm.list<i32>) -> i32
+    %2 = vm.add.i32 %0, %1 : i32
+    vm.check.eq %2, %c7, "3+4=7" : i32
+    vm.return
+  }
+}
@@ -17,6 +17,7 @@
 #include "iree/base/alignment.h"
 #include "iree/base/api.h"
 #include "iree/vm/bytecode_module_impl.h"
+#include "iree/vm/bytecode_op_table.h"
 #include "iree/vm/ref.h"
 #include "iree/vm/stack.h"
 
@@ -55,6 +56,9 @@ static iree_vm_type_def_t iree_vm_bytecode_module_resolve_type(
   } else if (iree_vm_flatbuffer_strcmp(full_name,
                                        iree_make_cstring_view("i64")) == 0) {
     result.value_type = IREE_VM_VALUE_TYPE_I64;
+  } else if (iree_vm_flatbuffer_strcmp(full_name,
+                                       iree_make_cstring_view("f32")) == 0) {
+    result.value_type = IREE_VM_VALUE_TYPE_F32;
   } else if (full_name[0] == '!') {
     // Note that we drop the ! prefix:
     iree_string_view_t type_name = {full_name + 1,
@@ -91,12 +95,85 @@ static iree_status_t iree_vm_bytecode_module_resolve_types(
   return iree_ok_status();
 }
 
+// Verifies the internal function with |function_ordinal| in |module_def|.
+// The function table entry must have already been checked to be present.
+static iree_status_t iree_vm_bytecode_module_flatbuffer_verify_function(
+    iree_vm_BytecodeModuleDef_table_t module_def, size_t function_ordinal) {
+  iree_vm_InternalFunctionDef_table_t function_def =
+      iree_vm_InternalFunctionDef_vec_at(
+          iree_vm_BytecodeModuleDef_internal_functions(module_def),
+          function_ordinal);
+  if (!iree_vm_InternalFunctionDef_signature(function_def)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "functions[%zu] missing signature",
+                            function_ordinal);
+  }
+
+  flatbuffers_uint8_vec_t bytecode_data =
+      iree_vm_BytecodeModuleDef_bytecode_data(module_def);
+  iree_vm_FunctionDescriptor_struct_t function_descriptor =
+      iree_vm_FunctionDescriptor_vec_at(
+          iree_vm_BytecodeModuleDef_function_descriptors(module_def),
+          function_ordinal);
+  if (function_descriptor->bytecode_offset < 0 ||
+      function_descriptor->bytecode_offset +
+              function_descriptor->bytecode_length >
+          flatbuffers_uint8_vec_len(bytecode_data)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "functions[%zu] descriptor bytecode span out of range (0 < %d < %zu)",
+        function_ordinal, function_descriptor->bytecode_offset,
+        flatbuffers_uint8_vec_len(bytecode_data));
+  }
+  if (function_descriptor->i32_register_count > IREE_I32_REGISTER_COUNT ||
+      function_descriptor->ref_register_count > IREE_REF_REGISTER_COUNT) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "functions[%zu] descriptor register count out of range",
+        function_ordinal);
+  }
+
+  // TODO(benvanik): run bytecode verifier on contents.
+
+  return iree_ok_status();
+}
+
+// Performs a cheap check that |flatbuffer_data| looks like a bytecode module
+// without walking its contents. Used in place of the full verification for
+// trusted modules.
+static iree_status_t iree_vm_bytecode_module_flatbuffer_verify_header(
+    iree_const_byte_span_t flatbuffer_data) {
+  if (!flatbuffers_has_identifier(flatbuffer_data.data,
+                                  iree_vm_BytecodeModuleDef_file_identifier)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "flatbuffer file identifier mismatch; expected '%s'",
+        iree_vm_BytecodeModuleDef_file_identifier);
+  }
+  // FlatBuffers are little-endian as are all hosts we support.
+  uint32_t root_offset = 0;
+  memcpy(&root_offset, flatbuffer_data.data, sizeof(root_offset));
+  if (root_offset < 8 || root_offset > flatbuffer_data.data_length - 4) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "flatbuffer root table offset out of range "
+                            "(%u of %zu bytes)",
+                            root_offset, flatbuffer_data.data_length);
+  }
+  return iree_ok_status();
+}
+
 // Verifies the structure of the flatbuffer so that we can avoid doing so during
 // runtime. There are still some conditions we must be aware of (such as omitted
 // names on functions with internal linkage), however we shouldn't need to
 // bounds check anything within the flatbuffer after this succeeds.
+//
+// With IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED the FlatBuffer itself is not
+// verified and only the module-level tables are checked. With
+// IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION function descriptors
+// are not verified here and must be verified prior to their first use.
 static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
-    iree_const_byte_span_t flatbuffer_data) {
+    iree_const_byte_span_t flatbuffer_data,
+    iree_vm_bytecode_module_flags_t flags) {
   if (!flatbuffer_data.data || flatbuffer_data.data_length < 16) {
     return iree_make_status(
         IREE_STATUS_INVALID_ARGUMENT,
@@ -104,15 +181,20 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
         flatbuffer_data.data_length);
   }
 
-  // Run flatcc generated verification. This ensures all pointers are in-bounds
-  // and that we can safely walk the file, but not that the actual contents of
-  // the flatbuffer meet our expectations.
-  int verify_ret = iree_vm_BytecodeModuleDef_verify_as_root(
-      flatbuffer_data.data, flatbuffer_data.data_length);
-  if (verify_ret != flatcc_verify_ok) {
-    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "flatbuffer verification failed: %s",
-                            flatcc_verify_error_string(verify_ret));
+  if (flags & IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED) {
+    IREE_RETURN_IF_ERROR(
+        iree_vm_bytecode_module_flatbuffer_verify_header(flatbuffer_data));
+  } else {
+    // Run flatcc generated verification. This ensures all pointers are
+    // in-bounds and that we can safely walk the file, but not that the actual
+    // contents of the flatbuffer meet our expectations.
+    int verify_ret = iree_vm_BytecodeModuleDef_verify_as_root(
+        flatbuffer_data.data, flatbuffer_data.data_length);
+    if (verify_ret != flatcc_verify_ok) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "flatbuffer verification failed: %s",
+                              flatcc_verify_error_string(verify_ret));
+    }
   }
 
   iree_vm_BytecodeModuleDef_table_t module_def =
@@ -207,8 +289,6 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
     }
   }
 
-  flatbuffers_uint8_vec_t bytecode_data =
-      iree_vm_BytecodeModuleDef_bytecode_data(module_def);
   for (size_t i = 0;
        i < iree_vm_InternalFunctionDef_vec_len(internal_functions); ++i) {
     iree_vm_InternalFunctionDef_table_t function_def =
@@ -217,39 +297,31 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
       return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                               "functions[%zu] missing body", i);
     }
-    if (!iree_vm_InternalFunctionDef_signature(function_def)) {
-      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                              "functions[%zu] missing signature", i);
-    }
-
-    iree_vm_FunctionDescriptor_struct_t function_descriptor =
-        iree_vm_FunctionDescriptor_vec_at(function_descriptors, i);
-    if (function_descriptor->bytecode_offset < 0 ||
-        function_descriptor->bytecode_offset +
-                function_descriptor->bytecode_length >
-            flatbuffers_uint8_vec_len(bytecode_data)) {
-      return iree_make_status(
-          IREE_STATUS_INVALID_ARGUMENT,
-          "functions[%zu] descriptor bytecode span out of range (0 < %d < %zu)",
-          i, function_descriptor->bytecode_offset,
-          flatbuffers_uint8_vec_len(bytecode_data));
-    }
-    if (function_descriptor->i32_register_count > IREE_I32_REGISTER_COUNT ||
-        function_descriptor->ref_register_count > IREE_REF_REGISTER_COUNT) {
-      return iree_make_status(
-          IREE_STATUS_INVALID_ARGUMENT,
-          "functions[%zu] descriptor register count out of range", i);
+    if (!(flags & IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION)) {
+      IREE_RETURN_IF_ERROR(
+          iree_vm_bytecode_module_flatbuffer_verify_function(module_def, i));
     }
-
-    // TODO(benvanik): run bytecode verifier on contents.
   }
 
   return iree_ok_status();
 }
 
+iree_status_t iree_vm_bytecode_module_verify_function(
+    iree_vm_bytecode_module_t* module, iree_host_size_t function_ordinal) {
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_flatbuffer_verify_function(
+      module->def, function_ordinal));
+  iree_atomic_store(&module->function_verified_table[function_ordinal], 1);
+  return iree_ok_status();
+}
+
 static void iree_vm_bytecode_module_destroy(void* self) {
   iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
 
+  for (iree_host_size_t i = 0; i < module->import_count; ++i) {
+    iree_allocator_free(module->allocator,
+                        module->import_table[i].marshal_steps);
+  }
+
   iree_allocator_free(module->flatbuffer_allocator,
                       (void*)module->flatbuffer_data.data);
   module->flatbuffer_data = iree_make_const_byte_span(NULL, 0);
@@ -393,6 +465,10 @@ static iree_status_t iree_vm_bytecode_module_get_function_reflection_attr(
       iree_vm_InternalFunctionDef_vec_at(internal_functions, ordinal);
   iree_vm_FunctionSignatureDef_table_t signature =
       iree_vm_InternalFunctionDef_signature(function_def);
+  if (!signature) {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "function %zu has no signature", ordinal);
+  }
   iree_vm_ReflectionAttrDef_vec_t reflection_attrs =
       iree_vm_FunctionSignatureDef_reflection_attrs(signature);
   if (index >= iree_vm_ReflectionAttrDef_vec_len(reflection_attrs)) {
@@ -421,6 +497,97 @@ static iree_status_t iree_vm_bytecode_module_get_function_reflection_attr(
   return iree_ok_status();
 }
 
+// Returns the name of the function with the given |linkage| and |ordinal| as
+// used for lookups by name.
+static flatbuffers_string_t iree_vm_bytecode_module_function_name(
+    iree_vm_BytecodeModuleDef_table_t module_def,
+    iree_vm_function_linkage_t linkage, iree_host_size_t ordinal) {
+  switch (linkage) {
+    case IREE_VM_FUNCTION_LINKAGE_IMPORT:
+      return iree_vm_ImportFunctionDef_full_name(
+          iree_vm_ImportFunctionDef_vec_at(
+              iree_vm_BytecodeModuleDef_imported_functions(module_def),
+              ordinal));
+    case IREE_VM_FUNCTION_LINKAGE_EXPORT:
+      return iree_vm_ExportFunctionDef_local_name(
+          iree_vm_ExportFunctionDef_vec_at(
+              iree_vm_BytecodeModuleDef_exported_functions(module_def),
+              ordinal));
+    default:
+      return iree_vm_InternalFunctionDef_local_name(
+          iree_vm_InternalFunctionDef_vec_at(
+              iree_vm_BytecodeModuleDef_internal_functions(module_def),
+              ordinal));
+  }
+}
+
+// Returns the FNV-1a hash of the function name in |data|.
+static uint32_t iree_vm_bytecode_function_name_hash(const char* data,
+                                                    iree_host_size_t size) {
+  uint32_t hash = 2166136261u;
+  for (iree_host_size_t i = 0; i < size; ++i) {
+    hash ^= (uint8_t)data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Returns the number of slots required to index |count| functions.
+static iree_host_size_t iree_vm_bytecode_function_index_capacity(
+    iree_host_size_t count) {
+  if (!count) return 0;
+  iree_host_size_t capacity = 4;
+  while (capacity < count * 2) capacity <<= 1;
+  return capacity;
+}
+
+// Builds |out_index| over the |count| functions with |linkage| in |slots|
+// storage sized by iree_vm_bytecode_function_index_capacity. Functions with
+// duplicate names resolve to the lowest ordinal.
+static void iree_vm_bytecode_function_index_build(
+    iree_vm_BytecodeModuleDef_table_t module_def,
+    iree_vm_function_linkage_t linkage, iree_host_size_t count,
+    iree_vm_bytecode_function_index_slot_t* slots,
+    iree_vm_bytecode_function_index_t* out_index) {
+  out_index->capacity = iree_vm_bytecode_function_index_capacity(count);
+  out_index->slots = slots;
+  iree_host_size_t mask = out_index->capacity - 1;
+  for (iree_host_size_t ordinal = 0; ordinal < count; ++ordinal) {
+    flatbuffers_string_t name =
+        iree_vm_bytecode_module_function_name(module_def, linkage, ordinal);
+    uint32_t hash =
+        iree_vm_bytecode_function_name_hash(name, flatbuffers_string_len(name));
+    iree_host_size_t i = hash & mask;
+    while (slots[i].ordinal_plus_one) i = (i + 1) & mask;
+    slots[i].hash = hash;
+    slots[i].ordinal_plus_one = (uint32_t)ordinal + 1;
+  }
+}
+
+// Looks up the ordinal of the function with |linkage| named |name| in |index|.
+// Returns false if no function with the name exists.
+static bool iree_vm_bytecode_function_index_lookup(
+    iree_vm_BytecodeModuleDef_table_t module_def,
+    iree_vm_function_linkage_t linkage,
+    const iree_vm_bytecode_function_index_t* index, iree_string_view_t name,
+    iree_host_size_t* out_ordinal) {
+  if (!index->capacity) return false;
+  uint32_t hash = iree_vm_bytecode_function_name_hash(name.data, name.size);
+  iree_host_size_t mask = index->capacity - 1;
+  for (iree_host_size_t i = hash & mask; index->slots[i].ordinal_plus_one;
+       i = (i + 1) & mask) {
+    if (index->slots[i].hash != hash) continue;
+    iree_host_size_t ordinal = index->slots[i].ordinal_plus_one - 1;
+    if (iree_vm_flatbuffer_strcmp(iree_vm_bytecode_module_function_name(
+                                      module_def, linkage, ordinal),
+                                  name) == 0) {
+      *out_ordinal = ordinal;
+      return true;
+    }
+  }
+  return false;
+}
+
 static iree_status_t iree_vm_bytecode_module_lookup_function(
     void* self, iree_vm_function_linkage_t linkage, iree_string_view_t name,
     iree_vm_function_t* out_function) {
@@ -432,60 +599,40 @@ static iree_status_t iree_vm_bytecode_module_lookup_function(
                             "function name required for query");
   }
 
-  // NOTE: we could organize imports/exports alphabetically so we could bsearch.
   iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
+  iree_host_size_t ordinal = 0;
   if (linkage == IREE_VM_FUNCTION_LINKAGE_IMPORT) {
-    iree_vm_ImportFunctionDef_vec_t imported_functions =
-        iree_vm_BytecodeModuleDef_imported_functions(module->def);
-    for (size_t ordinal = 0;
-         ordinal < iree_vm_ImportFunctionDef_vec_len(imported_functions);
-         ++ordinal) {
-      iree_vm_ImportFunctionDef_table_t import_def =
-          iree_vm_ImportFunctionDef_vec_at(imported_functions, ordinal);
-      if (iree_vm_flatbuffer_strcmp(
-              iree_vm_ImportFunctionDef_full_name(import_def), name) == 0) {
-        return iree_vm_bytecode_module_get_function(self, linkage, ordinal,
-                                                    out_function, NULL, NULL);
-      }
+    if (!iree_vm_bytecode_function_index_lookup(
+            module->def, linkage, &module->import_index, name, &ordinal)) {
+      return iree_make_status(IREE_STATUS_NOT_FOUND,
+                              "import with the given name not found");
     }
-    return iree_make_status(IREE_STATUS_NOT_FOUND,
-                            "import with the given name not found");
+    return iree_vm_bytecode_module_get_function(self, linkage, ordinal,
+                                                out_function, NULL, NULL);
   } else if (linkage == IREE_VM_FUNCTION_LINKAGE_EXPORT) {
-    iree_vm_ExportFunctionDef_vec_t exported_functions =
-        iree_vm_BytecodeModuleDef_exported_functions(module->def);
-    for (size_t ordinal = 0;
-         ordinal < iree_vm_InternalFunctionDef_vec_len(exported_functions);
-         ++ordinal) {
-      iree_vm_ExportFunctionDef_table_t export_def =
-          iree_vm_ExportFunctionDef_vec_at(exported_functions, ordinal);
-      if (iree_vm_flatbuffer_strcmp(
-              iree_vm_ExportFunctionDef_local_name(export_def), name) == 0) {
-        return iree_vm_bytecode_module_get_function(
-            self, IREE_VM_FUNCTION_LINKAGE_INTERNAL,
-            iree_vm_ExportFunctionDef_internal_ordinal(export_def),
-            out_function, NULL, NULL);
-      }
+    if (!iree_vm_bytecode_function_index_lookup(
+            module->def, linkage, &module->export_index, name, &ordinal)) {
+      return iree_make_status(IREE_STATUS_NOT_FOUND,
+                              "export with the given name not found");
     }
-    return iree_make_status(IREE_STATUS_NOT_FOUND,
-                            "export with the given name not found");
+    iree_vm_ExportFunctionDef_table_t export_def =
+        iree_vm_ExportFunctionDef_vec_at(
+            iree_vm_BytecodeModuleDef_exported_functions(module->def),
+            ordinal);
+    return iree_vm_bytecode_module_get_function(
+        self, IREE_VM_FUNCTION_LINKAGE_INTERNAL,
+        iree_vm_ExportFunctionDef_internal_ordinal(export_def), out_function,
+        NULL, NULL);
   } else {
-    iree_vm_InternalFunctionDef_vec_t internal_functions =
-        iree_vm_BytecodeModuleDef_internal_functions(module->def);
-    for (size_t ordinal = 0;
-         ordinal < iree_vm_InternalFunctionDef_vec_len(internal_functions);
-         ++ordinal) {
-      iree_vm_InternalFunctionDef_table_t function_def =
-          iree_vm_InternalFunctionDef_vec_at(internal_functions, ordinal);
-      if (iree_vm_flatbuffer_strcmp(
-              iree_vm_InternalFunctionDef_local_name(function_def), name) ==
-          0) {
-        return iree_vm_bytecode_module_get_function(
-            self, IREE_VM_FUNCTION_LINKAGE_INTERNAL, ordinal, out_function,
-            NULL, NULL);
-      }
+    if (!iree_vm_bytecode_function_index_lookup(
+            module->def, IREE_VM_FUNCTION_LINKAGE_INTERNAL,
+            &module->internal_index, name, &ordinal)) {
+      return iree_make_status(IREE_STATUS_NOT_FOUND,
+                              "function with the given name not found");
     }
-    return iree_make_status(IREE_STATUS_NOT_FOUND,
-                            "function with the given name not found");
+    return iree_vm_bytecode_module_get_function(
+        self, IREE_VM_FUNCTION_LINKAGE_INTERNAL, ordinal, out_function, NULL,
+        NULL);
   }
 }
 
@@ -504,8 +651,6 @@ static iree_host_size_t iree_vm_bytecode_module_layout_state(
         iree_vm_ModuleStateDef_global_bytes_capacity(module_state);
     global_ref_count = iree_vm_ModuleStateDef_global_ref_count(module_state);
   }
-  iree_host_size_t rodata_ref_count = iree_vm_RodataSegmentDef_vec_len(
-      iree_vm_BytecodeModuleDef_rodata_segments(module_def));
   iree_host_size_t import_function_count = iree_vm_ImportFunctionDef_vec_len(
       iree_vm_BytecodeModuleDef_imported_functions(module_def));
 
@@ -525,12 +670,6 @@ static iree_host_size_t iree_vm_bytecode_module_layout_state(
   }
   offset += iree_align(global_ref_count * sizeof(iree_vm_ref_t), 16);
 
-  if (state) {
-    state->rodata_ref_count = rodata_ref_count;
-    state->rodata_ref_table = (iree_vm_ro_byte_buffer_t*)(base_ptr + offset);
-  }
-  offset += iree_align(rodata_ref_count * sizeof(iree_vm_ro_byte_buffer_t), 16);
-
   if (state) {
     state->import_count = import_function_count;
     state->import_table = (iree_vm_bytecode_import_t*)(base_ptr + offset);
@@ -563,19 +702,6 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
   // Perform layout to get the pointers into the storage for each nested table.
   iree_vm_bytecode_module_layout_state(module_def, state);
 
-  // Setup rodata segments to point directly at the flatbuffer memory.
-  iree_vm_RodataSegmentDef_vec_t rodata_segments =
-      iree_vm_BytecodeModuleDef_rodata_segments(module_def);
-  for (int i = 0; i < state->rodata_ref_count; ++i) {
-    iree_vm_RodataSegmentDef_table_t segment =
-        iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
-    iree_vm_ro_byte_buffer_t* ref = &state->rodata_ref_table[i];
-    iree_atomic_store(&ref->ref_object.counter, 1);
-    ref->data.data = iree_vm_RodataSegmentDef_data(segment);
-    ref->data.data_length =
-        flatbuffers_uint8_vec_len(iree_vm_RodataSegmentDef_data(segment));
-  }
-
   *out_module_state = (iree_vm_module_state_t*)state;
   return iree_ok_status();
 }
@@ -592,25 +718,85 @@ static void iree_vm_bytecode_module_free_state(
     iree_vm_ref_release(&state->global_ref_table[i]);
   }
 
+  // Release import marshaling plans.
+  for (int i = 0; i < state->import_count; ++i) {
+    iree_allocator_free(state->allocator, state->import_table[i].marshal_steps);
+  }
+
   iree_allocator_free(state->allocator, module_state);
 }
 
-static iree_status_t iree_vm_bytecode_module_resolve_import(
-    void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
-    const iree_vm_function_t* function,
-    const iree_vm_function_signature_t* signature) {
-  IREE_ASSERT_ARGUMENT(module_state);
-  iree_vm_bytecode_module_state_t* state =
-      (iree_vm_bytecode_module_state_t*)module_state;
-  if (ordinal >= state->import_count) {
-    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "import ordinal out of range (0 < %zu < %zu)",
-                            ordinal, state->import_count);
+// Counts the values of each type in the non-variadic |cconv_fragment| and
+// stores them in |out_plan|. Steps are assigned with
+// iree_vm_bytecode_module_build_marshal_plan.
+static iree_status_t iree_vm_bytecode_module_count_marshal_plan(
+    iree_string_view_t cconv_fragment,
+    iree_vm_bytecode_marshal_plan_t* out_plan) {
+  memset(out_plan, 0, sizeof(*out_plan));
+  for (iree_host_size_t i = 0; i < cconv_fragment.size; ++i) {
+    switch (cconv_fragment.data[i]) {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32:
+        ++out_plan->i32_count;
+        break;
+      case IREE_VM_CCONV_TYPE_INT64:
+        ++out_plan->i64_count;
+        break;
+      case IREE_VM_CCONV_TYPE_REF:
+        ++out_plan->ref_count;
+        break;
+      default:
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "unsupported cconv type '%c'",
+                                cconv_fragment.data[i]);
+    }
   }
+  out_plan->value_count =
+      out_plan->i32_count + out_plan->i64_count + out_plan->ref_count;
+  return iree_ok_status();
+}
 
-  iree_vm_bytecode_import_t* import = &state->import_table[ordinal];
-  import->function = *function;
+// Assigns the steps of a |plan| counted by
+// iree_vm_bytecode_module_count_marshal_plan into |steps| storage.
+static void iree_vm_bytecode_module_build_marshal_plan(
+    iree_string_view_t cconv_fragment, iree_vm_bytecode_marshal_step_t* steps,
+    iree_vm_bytecode_marshal_plan_t* plan) {
+  iree_vm_bytecode_marshal_step_t* i32_step = steps;
+  iree_vm_bytecode_marshal_step_t* i64_step = i32_step + plan->i32_count;
+  iree_vm_bytecode_marshal_step_t* ref_step = i64_step + plan->i64_count;
+  uint16_t offset = 0;
+  for (uint16_t i = 0; i < plan->value_count; ++i) {
+    switch (cconv_fragment.data[i]) {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_FLOAT32:
+        i32_step->reg_index = i;
+        i32_step->offset = offset;
+        ++i32_step;
+        offset += sizeof(int32_t);
+        break;
+      case IREE_VM_CCONV_TYPE_INT64:
+        i64_step->reg_index = i;
+        i64_step->offset = offset;
+        ++i64_step;
+        offset += sizeof(int64_t);
+        break;
+      case IREE_VM_CCONV_TYPE_REF:
+        ref_step->reg_index = i;
+        ref_step->offset = offset;
+        ++ref_step;
+        offset += sizeof(iree_vm_ref_t);
+        break;
+    }
+  }
+  plan->steps = steps;
+}
 
+// Initializes |import| with the calling convention fragments, buffer sizes, and
+// marshaling plans of |signature|. Plan storage is allocated from |allocator|
+// and owned by |import|.
+static iree_status_t iree_vm_bytecode_module_initialize_import(
+    const iree_vm_function_signature_t* signature, iree_allocator_t allocator,
+    iree_vm_bytecode_import_t* import) {
   // Split up arguments/results into fragments so that we can avoid scanning
   // during calling.
   IREE_RETURN_IF_ERROR(iree_vm_function_call_get_cconv_fragments(
@@ -630,15 +816,129 @@ static iree_status_t iree_vm_bytecode_module_resolve_import(
       import->results, /*segment_size_list=*/NULL, &result_buffer_size));
   if (argument_buffer_size > 16 * 1024 || result_buffer_size > 16 * 1024) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "ABI marshaling buffer overflow on import %zu",
-                            ordinal);
+                            "ABI marshaling buffer overflow");
   }
   import->argument_buffer_size = (uint16_t)argument_buffer_size;
   import->result_buffer_size = (uint16_t)result_buffer_size;
 
+  // Resolve the marshaling plans used by each call of the import. Variadic
+  // arguments depend on the segment sizes of each call site and are marshaled
+  // by walking the cconv string instead.
+  memset(&import->argument_plan, 0, sizeof(import->argument_plan));
+  if (!iree_vm_function_call_is_variadic_cconv(import->arguments)) {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_count_marshal_plan(
+        import->arguments, &import->argument_plan));
+  }
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_count_marshal_plan(
+      import->results, &import->result_plan));
+  iree_host_size_t step_count =
+      import->argument_plan.value_count + import->result_plan.value_count;
+  if (step_count > 0) {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        allocator, step_count * sizeof(iree_vm_bytecode_marshal_step_t),
+        (void**)&import->marshal_steps));
+    iree_vm_bytecode_module_build_marshal_plan(
+        import->arguments, import->marshal_steps, &import->argument_plan);
+    iree_vm_bytecode_module_build_marshal_plan(
+        import->results,
+        import->marshal_steps + import->argument_plan.value_count,
+        &import->result_plan);
+  }
+
   return iree_ok_status();
 }
 
+// Prepares the shared module import table from the signatures declared by the
+// module. Imports whose declared signatures cannot be marshaled are left empty
+// and will be initialized per-state when resolved.
+static void iree_vm_bytecode_module_initialize_shared_imports(
+    iree_vm_bytecode_module_t* module) {
+  iree_vm_ImportFunctionDef_vec_t imported_functions =
+      iree_vm_BytecodeModuleDef_imported_functions(module->def);
+  for (iree_host_size_t i = 0; i < module->import_count; ++i) {
+    iree_vm_FunctionSignatureDef_table_t signature_def =
+        iree_vm_ImportFunctionDef_signature(
+            iree_vm_ImportFunctionDef_vec_at(imported_functions, i));
+    flatbuffers_string_t calling_convention =
+        iree_vm_FunctionSignatureDef_calling_convention(signature_def);
+    iree_vm_function_signature_t signature;
+    memset(&signature, 0, sizeof(signature));
+    signature.calling_convention.data = calling_convention;
+    signature.calling_convention.size =
+        flatbuffers_string_len(calling_convention);
+    iree_vm_bytecode_import_t* import = &module->import_table[i];
+    iree_status_t status = iree_vm_bytecode_module_initialize_import(
+        &signature, module->allocator, import);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      iree_allocator_free(module->allocator, import->marshal_steps);
+      memset(import, 0, sizeof(*import));
+    }
+  }
+}
+
+static iree_status_t iree_vm_bytecode_module_resolve_import(
+    void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
+    const iree_vm_function_t* function,
+    const iree_vm_function_signature_t* signature) {
+  IREE_ASSERT_ARGUMENT(module_state);
+  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
+  iree_vm_bytecode_module_state_t* state =
+      (iree_vm_bytecode_module_state_t*)module_state;
+  if (ordinal >= state->import_count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "import ordinal out of range (0 < %zu < %zu)",
+                            ordinal, state->import_count);
+  }
+
+  iree_vm_bytecode_import_t* import = &state->import_table[ordinal];
+  iree_allocator_free(state->allocator, import->marshal_steps);
+  memset(import, 0, sizeof(*import));
+
+  // Share the module import when the resolved function has the signature the
+  // module declared (as is nearly always the case) so that no per-state
+  // allocation is required.
+  const iree_vm_bytecode_import_t* shared_import =
+      &module->import_table[ordinal];
+  iree_string_view_t arguments = iree_string_view_empty();
+  iree_string_view_t results = iree_string_view_empty();
+  IREE_RETURN_IF_ERROR(iree_vm_function_call_get_cconv_fragments(
+      signature, &arguments, &results));
+  if (iree_string_view_equal(arguments, shared_import->arguments) &&
+      iree_string_view_equal(results, shared_import->results)) {
+    *import = *shared_import;
+    import->marshal_steps = NULL;
+  } else {
+    IREE_RETURN_IF_ERROR(
+        iree_vm_bytecode_module_initialize_import(signature, state->allocator,
+                                                  import),
+        "resolving import %zu", ordinal);
+  }
+  import->function = *function;
+
+  return iree_ok_status();
+}
+
+// Runs the dispatcher with the profile clock of |stack| running, if any.
+static iree_status_t iree_vm_bytecode_module_run_dispatch(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    const iree_vm_function_call_t* call, iree_string_view_t cconv_arguments,
+    iree_string_view_t cconv_results, iree_vm_execution_result_t* out_result) {
+#if IREE_VM_PROFILING_ENABLE
+  iree_vm_profile_recorder_t* profile_recorder =
+      iree_vm_stack_profile_recorder(stack);
+  if (IREE_UNLIKELY(profile_recorder)) {
+    iree_vm_profile_recorder_start(profile_recorder);
+    iree_status_t status = iree_vm_bytecode_dispatch(
+        stack, module, call, cconv_arguments, cconv_results, out_result);
+    iree_vm_profile_recorder_stop(profile_recorder);
+    return status;
+  }
+#endif  // IREE_VM_PROFILING_ENABLE
+  return iree_vm_bytecode_dispatch(stack, module, call, cconv_arguments,
+                                   cconv_results, out_result);
+}
+
 static iree_status_t iree_vm_bytecode_module_begin_call(
     void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
     iree_vm_execution_result_t* out_result) {
@@ -664,6 +964,8 @@ static iree_status_t iree_vm_bytecode_module_begin_call(
                             function.ordinal,
                             module->function_descriptor_count);
   }
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_ensure_function_verified(
+      module, function.ordinal));
 
   // Grab calling convention string. This is not great as we are guaranteed to
   // have a bunch of cache misses, but without putting it on the descriptor
@@ -693,19 +995,51 @@ static iree_status_t iree_vm_bytecode_module_begin_call(
 
   // Jump into the dispatch routine to execute bytecode until the function
   // either returns (synchronous) or yields (asynchronous).
-  return iree_vm_bytecode_dispatch(stack, module, call, cconv_arguments,
-                                   cconv_results, out_result);
+  return iree_vm_bytecode_module_run_dispatch(
+      stack, module, call, cconv_arguments, cconv_results, out_result);
+}
+
+static iree_status_t iree_vm_bytecode_module_resume_call(
+    void* self, iree_vm_stack_t* stack,
+    iree_vm_execution_result_t* out_result) {
+  IREE_ASSERT_ARGUMENT(out_result);
+  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
+
+  // The state required to complete the original call was stashed in the top
+  // frame when execution was suspended.
+  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
+  return iree_vm_bytecode_module_run_dispatch(
+      stack, module, /*call=*/NULL, iree_string_view_empty(),
+      iree_string_view_empty(), out_result);
 }
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
     iree_const_byte_span_t flatbuffer_data,
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module) {
+  return iree_vm_bytecode_module_create_with_flags(
+      flatbuffer_data, IREE_VM_BYTECODE_MODULE_FLAG_NONE, flatbuffer_allocator,
+      allocator, out_module);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_module_create_with_flags(
+    iree_const_byte_span_t flatbuffer_data,
+    iree_vm_bytecode_module_flags_t flags,
+    iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
+    iree_vm_module_t** out_module) {
   IREE_ASSERT_ARGUMENT(out_module);
   *out_module = NULL;
 
+  if ((flags & IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION) &&
+      !(flags & IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "lazy function verification requires a trusted module");
+  }
+
   IREE_RETURN_IF_ERROR(
-      iree_vm_bytecode_module_flatbuffer_verify(flatbuffer_data));
+      iree_vm_bytecode_module_flatbuffer_verify(flatbuffer_data, flags));
 
   iree_vm_BytecodeModuleDef_table_t module_def =
       iree_vm_BytecodeModuleDef_as_root(flatbuffer_data.data);
@@ -717,13 +1051,53 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   }
 
   iree_vm_TypeDef_vec_t type_defs = iree_vm_BytecodeModuleDef_types(module_def);
-  size_t type_table_size =
-      iree_vm_TypeDef_vec_len(type_defs) * sizeof(iree_vm_type_def_t);
+  iree_vm_RodataSegmentDef_vec_t rodata_segments =
+      iree_vm_BytecodeModuleDef_rodata_segments(module_def);
+  iree_host_size_t import_count = iree_vm_ImportFunctionDef_vec_len(
+      iree_vm_BytecodeModuleDef_imported_functions(module_def));
+
+  // Tables are stored in the same allocation as the module itself.
+  iree_host_size_t type_table_offset =
+      iree_align(sizeof(iree_vm_bytecode_module_t), 16);
+  iree_host_size_t rodata_ref_table_offset =
+      type_table_offset +
+      iree_align(
+          iree_vm_TypeDef_vec_len(type_defs) * sizeof(iree_vm_type_def_t), 16);
+  iree_host_size_t import_table_offset =
+      rodata_ref_table_offset +
+      iree_align(iree_vm_RodataSegmentDef_vec_len(rodata_segments) *
+                     sizeof(iree_vm_ro_byte_buffer_t),
+                 16);
+  iree_host_size_t export_count = iree_vm_ExportFunctionDef_vec_len(
+      iree_vm_BytecodeModuleDef_exported_functions(module_def));
+  iree_host_size_t internal_count = iree_vm_InternalFunctionDef_vec_len(
+      iree_vm_BytecodeModuleDef_internal_functions(module_def));
+  iree_host_size_t import_index_offset =
+      import_table_offset +
+      iree_align(import_count * sizeof(iree_vm_bytecode_import_t), 16);
+  iree_host_size_t export_index_offset =
+      import_index_offset +
+      iree_align(iree_vm_bytecode_function_index_capacity(import_count) *
+                     sizeof(iree_vm_bytecode_function_index_slot_t),
+                 16);
+  iree_host_size_t internal_index_offset =
+      export_index_offset +
+      iree_align(iree_vm_bytecode_function_index_capacity(export_count) *
+                     sizeof(iree_vm_bytecode_function_index_slot_t),
+                 16);
+  iree_host_size_t function_verified_table_offset =
+      internal_index_offset +
+      iree_align(iree_vm_bytecode_function_index_capacity(internal_count) *
+                     sizeof(iree_vm_bytecode_function_index_slot_t),
+                 16);
+  iree_host_size_t total_size = function_verified_table_offset;
+  if (flags & IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION) {
+    total_size += internal_count * sizeof(iree_atomic_intptr_t);
+  }
 
   iree_vm_bytecode_module_t* module = NULL;
-  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-      allocator, sizeof(iree_vm_bytecode_module_t) + type_table_size,
-      (void**)&module));
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, total_size, (void**)&module));
   module->allocator = allocator;
 
   iree_vm_FunctionDescriptor_vec_t function_descriptors =
@@ -731,6 +1105,15 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   module->function_descriptor_count =
       iree_vm_FunctionDescriptor_vec_len(function_descriptors);
   module->function_descriptor_table = function_descriptors;
+  module->function_verified_table = NULL;
+  if (flags & IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION) {
+    module->function_verified_table =
+        (iree_atomic_intptr_t*)((uint8_t*)module +
+                                function_verified_table_offset);
+    for (iree_host_size_t i = 0; i < internal_count; ++i) {
+      iree_atomic_store(&module->function_verified_table[i], 0);
+    }
+  }
 
   flatbuffers_uint8_vec_t bytecode_data =
       iree_vm_BytecodeModuleDef_bytecode_data(module_def);
@@ -742,8 +1125,8 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   module->def = module_def;
 
   module->type_count = iree_vm_TypeDef_vec_len(type_defs);
-  module->type_table = (iree_vm_type_def_t*)((uint8_t*)module +
-                                             sizeof(iree_vm_bytecode_module_t));
+  module->type_table =
+      (iree_vm_type_def_t*)((uint8_t*)module + type_table_offset);
   iree_status_t resolve_status =
       iree_vm_bytecode_module_resolve_types(type_defs, module->type_table);
   if (!iree_status_is_ok(resolve_status)) {
@@ -751,6 +1134,44 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
     return resolve_status;
   }
 
+  // Setup rodata segments to point directly at the flatbuffer memory. These
+  // are immutable and shared by all states.
+  module->rodata_ref_count = iree_vm_RodataSegmentDef_vec_len(rodata_segments);
+  module->rodata_ref_table =
+      (iree_vm_ro_byte_buffer_t*)((uint8_t*)module + rodata_ref_table_offset);
+  for (iree_host_size_t i = 0; i < module->rodata_ref_count; ++i) {
+    iree_vm_RodataSegmentDef_table_t segment =
+        iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
+    iree_vm_ro_byte_buffer_t* ref = &module->rodata_ref_table[i];
+    iree_atomic_store(&ref->ref_object.counter, 1);
+    ref->data.data = iree_vm_RodataSegmentDef_data(segment);
+    ref->data.data_length =
+        flatbuffers_uint8_vec_len(iree_vm_RodataSegmentDef_data(segment));
+  }
+
+  module->import_count = import_count;
+  module->import_table =
+      (iree_vm_bytecode_import_t*)((uint8_t*)module + import_table_offset);
+  iree_vm_bytecode_module_initialize_shared_imports(module);
+
+  // Index function names so that lookups (such as when resolving imports) need
+  // not scan the function tables.
+  iree_vm_bytecode_function_index_build(
+      module_def, IREE_VM_FUNCTION_LINKAGE_IMPORT, import_count,
+      (iree_vm_bytecode_function_index_slot_t*)((uint8_t*)module +
+                                                import_index_offset),
+      &module->import_index);
+  iree_vm_bytecode_function_index_build(
+      module_def, IREE_VM_FUNCTION_LINKAGE_EXPORT, export_count,
+      (iree_vm_bytecode_function_index_slot_t*)((uint8_t*)module +
+                                                export_index_offset),
+      &module->export_index);
+  iree_vm_bytecode_function_index_build(
+      module_def, IREE_VM_FUNCTION_LINKAGE_INTERNAL, internal_count,
+      (iree_vm_bytecode_function_index_slot_t*)((uint8_t*)module +
+                                                internal_index_offset),
+      &module->internal_index);
+
   iree_vm_module_initialize(&module->interface, module);
   module->interface.destroy = iree_vm_bytecode_module_destroy;
   module->interface.name = iree_vm_bytecode_module_name;
@@ -761,9 +1182,38 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   module->interface.free_state = iree_vm_bytecode_module_free_state;
   module->interface.resolve_import = iree_vm_bytecode_module_resolve_import;
   module->interface.begin_call = iree_vm_bytecode_module_begin_call;
+  module->interface.resume_call = iree_vm_bytecode_module_resume_call;
   module->interface.get_function_reflection_attr =
       iree_vm_bytecode_module_get_function_reflection_attr;
 
   *out_module = &module->interface;
   return iree_ok_status();
 }
+
+#define IREE_VM_OPCODE_NAME_OPC(ordinal, name) #name,
+#define IREE_VM_OPCODE_NAME_RSV(ordinal) NULL,
+
+IREE_API_EXPORT iree_string_view_t IREE_API_CALL iree_vm_bytecode_opcode_name(
+    iree_vm_profile_opcode_set_t opcode_set, uint8_t opcode) {
+  static const char* kCoreOpcodeNames[256] = {IREE_VM_OP_CORE_TABLE(
+      IREE_VM_OPCODE_NAME_OPC, IREE_VM_OPCODE_NAME_RSV)};
+  static const char* kExtI64OpcodeNames[256] = {IREE_VM_OP_EXT_I64_TABLE(
+      IREE_VM_OPCODE_NAME_OPC, IREE_VM_OPCODE_NAME_RSV)};
+  static const char* kExtF32OpcodeNames[256] = {IREE_VM_OP_EXT_F32_TABLE(
+      IREE_VM_OPCODE_NAME_OPC, IREE_VM_OPCODE_NAME_RSV)};
+  const char* name = NULL;
+  switch (opcode_set) {
+    case IREE_VM_PROFILE_OPCODE_SET_CORE:
+      name = kCoreOpcodeNames[opcode];
+      break;
+    case IREE_VM_PROFILE_OPCODE_SET_EXT_I64:
+      name = kExtI64OpcodeNames[opcode];
+      break;
+    case IREE_VM_PROFILE_OPCODE_SET_EXT_F32:
+      name = kExtF32OpcodeNames[opcode];
+      break;
+    default:
+      break;
+  }
+  return name ? iree_make_cstring_view(name) : iree_string_view_empty();
+}
@@ -19,11 +19,38 @@
 
 #include "iree/base/api.h"
 #include "iree/vm/module.h"
+#include "iree/vm/profile.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
+// A bitfield controlling how bytecode modules are verified when loaded.
+enum iree_vm_bytecode_module_flag_e {
+  IREE_VM_BYTECODE_MODULE_FLAG_NONE = 0,
+  // Skips the full FlatBuffer verification of the module and only performs a
+  // cheap check of the buffer header (size, file identifier, and root table
+  // offset). Only use for modules from a trusted source that have been
+  // verified before (such as when produced by the compiler in the same build):
+  // malformed modules loaded this way may crash the runtime.
+  //
+  // NOTE: this performs no integrity check of any kind (there is no hash or
+  // checksum of the module contents). Corrupted or tampered modules that keep
+  // a valid header will be accepted.
+  IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED = 1u << 0,
+  // Defers the per-function descriptor checks (signature, bytecode span, and
+  // register counts) until each function is first called. Load time then
+  // scales with the number of module-level declarations instead of the number
+  // of functions. Errors in descriptors are reported when called. The bytecode
+  // contents of functions are not verified by either path.
+  //
+  // Requires IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED: the full FlatBuffer
+  // verification walks every function anyway and deferring the remaining
+  // checks would save nothing.
+  IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION = 1u << 1,
+};
+typedef uint32_t iree_vm_bytecode_module_flags_t;
+
 // Creates a VM module from an in-memory ModuleDef FlatBuffer.
 // If a |flatbuffer_allocator| is provided then it will be used to free the
 // |flatbuffer_data| when the module is destroyed and otherwise the ownership of
@@ -33,6 +60,23 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module);
 
+// Creates a VM module from an in-memory ModuleDef FlatBuffer as with
+// iree_vm_bytecode_module_create using |flags| to control verification.
+// iree_vm_bytecode_module_create is equivalent to passing
+// IREE_VM_BYTECODE_MODULE_FLAG_NONE and fully verifies the module on load.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_bytecode_module_create_with_flags(
+    iree_const_byte_span_t flatbuffer_data,
+    iree_vm_bytecode_module_flags_t flags,
+    iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
+    iree_vm_module_t** out_module);
+
+// Returns the name of the bytecode op with |opcode| in |opcode_set| (such as
+// `AddI32`) or an empty string if the opcode is reserved. Used to display the
+// opcode counters of an iree_vm_profile_t.
+IREE_API_EXPORT iree_string_view_t IREE_API_CALL iree_vm_bytecode_opcode_name(
+    iree_vm_profile_opcode_set_t opcode_set, uint8_t opcode);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
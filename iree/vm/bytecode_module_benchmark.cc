@@ -19,12 +19,16 @@
 #include "benchmark/benchmark.h"
 #include "iree/base/api.h"
 #include "iree/base/logging.h"
+#include "iree/vm/builtin_types.h"
 #include "iree/vm/bytecode_module.h"
 #include "iree/vm/bytecode_module_benchmark_module.h"
+#include "iree/vm/bytecode_module_benchmark_unfused_module.h"
 #include "iree/vm/context.h"
 #include "iree/vm/instance.h"
+#include "iree/vm/list.h"
 #include "iree/vm/module.h"
 #include "iree/vm/native_module.h"
+#include "iree/vm/profile.h"
 #include "iree/vm/stack.h"
 
 namespace {
@@ -46,13 +50,33 @@ static iree_status_t native_import_module_add_1(
   return iree_ok_status();
 }
 
+// vm.import @native_import_module.add_list_size(
+//     %list : !vm.list<i32>, %arg0 : i32) -> i32
+static iree_status_t native_import_module_add_list_size(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  // Add the size of the list to arg0 and return.
+  auto* list_ref = reinterpret_cast<iree_vm_ref_t*>(call->arguments.data);
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_list_check_deref(list_ref, &list));
+  int32_t arg0 = 0;
+  memcpy(&arg0, call->arguments.data + sizeof(iree_vm_ref_t), sizeof(arg0));
+  int32_t ret0 = arg0 + static_cast<int32_t>(iree_vm_list_size(list));
+  memcpy(call->results.data, &ret0, sizeof(ret0));
+  return iree_ok_status();
+}
+
 static const iree_vm_native_export_descriptor_t
     native_import_module_exports_[] = {
         {iree_make_cstring_view("add_1"), iree_make_cstring_view("0i.i"), 0,
          NULL},
+        {iree_make_cstring_view("add_list_size"),
+         iree_make_cstring_view("0ri.i"), 0, NULL},
 };
 static const iree_vm_native_function_ptr_t native_import_module_funcs_[] = {
     {(iree_vm_native_function_shim_t)native_import_module_add_1, NULL},
+    {(iree_vm_native_function_shim_t)native_import_module_add_list_size, NULL},
 };
 static_assert(IREE_ARRAYSIZE(native_import_module_funcs_) ==
                   IREE_ARRAYSIZE(native_import_module_exports_),
@@ -78,11 +102,14 @@ static iree_status_t native_import_module_create(
       &interface, &native_import_module_descriptor_, allocator, out_module);
 }
 
-// Benchmarks the given exported function, optionally passing in arguments.
-static iree_status_t RunFunction(benchmark::State& state,
-                                 absl::string_view function_name,
-                                 absl::Span<const int32_t> i32_args,
-                                 int result_count, int batch_size = 1) {
+// Benchmarks the given exported function of the module in |module_file_toc|,
+// optionally passing in arguments.
+static iree_status_t RunFunctionInModule(benchmark::State& state,
+                                         const iree::FileToc* module_file_toc,
+                                         absl::string_view function_name,
+                                         absl::Span<const int32_t> i32_args,
+                                         int result_count, int batch_size) {
+  IREE_CHECK_OK(iree_vm_register_builtin_types());
   iree_vm_instance_t* instance = NULL;
   IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
 
@@ -90,8 +117,6 @@ static iree_status_t RunFunction(benchmark::State& state,
   IREE_CHECK_OK(
       native_import_module_create(iree_allocator_system(), &import_module));
 
-  const auto* module_file_toc =
-      iree::vm::bytecode_module_benchmark_module_create();
   iree_vm_module_t* bytecode_module = nullptr;
   IREE_CHECK_OK(iree_vm_bytecode_module_create(
       iree_const_byte_span_t{
@@ -132,6 +157,29 @@ static iree_status_t RunFunction(benchmark::State& state,
     IREE_CHECK_OK(bytecode_module->begin_call(bytecode_module->self, stack,
                                               &call, &result));
   }
+
+#if IREE_VM_PROFILING_ENABLE
+  // Reports the number of ops dispatched per item from one untimed call.
+  iree_vm_profile_t* profile = NULL;
+  IREE_CHECK_OK(iree_vm_profile_create(iree_allocator_system(), &profile));
+  iree_vm_stack_set_profile(stack, profile);
+  for (iree_host_size_t i = 0; i < i32_args.size(); ++i) {
+    reinterpret_cast<int32_t*>(call.arguments.data)[i] = i32_args[i];
+  }
+  iree_vm_execution_result_t result;
+  IREE_CHECK_OK(bytecode_module->begin_call(bytecode_module->self, stack,
+                                            &call, &result));
+  iree_vm_stack_set_profile(stack, NULL);
+  uint64_t op_count = 0;
+  for (iree_host_size_t i = 0; i < iree_vm_profile_function_count(profile);
+       ++i) {
+    op_count += iree_vm_profile_function_stats(profile, i)->op_count;
+  }
+  state.counters["ops_per_item"] =
+      static_cast<double>(op_count) / static_cast<double>(batch_size);
+  iree_vm_profile_release(profile);
+#endif  // IREE_VM_PROFILING_ENABLE
+
   iree_vm_stack_deinitialize(stack);
 
   iree_vm_module_release(import_module);
@@ -142,6 +190,16 @@ static iree_status_t RunFunction(benchmark::State& state,
   return iree_ok_status();
 }
 
+// Benchmarks the given exported function of the default benchmark module.
+static iree_status_t RunFunction(benchmark::State& state,
+                                 absl::string_view function_name,
+                                 absl::Span<const int32_t> i32_args,
+                                 int result_count, int batch_size = 1) {
+  return RunFunctionInModule(
+      state, iree::vm::bytecode_module_benchmark_module_create(),
+      function_name, i32_args, result_count, batch_size);
+}
+
 static void BM_ModuleCreate(benchmark::State& state) {
   while (state.KeepRunning()) {
     const auto* module_file_toc =
@@ -281,6 +339,17 @@ static void BM_CallImportedFuncBytecode(benchmark::State& state) {
 }
 BENCHMARK(BM_CallImportedFuncBytecode);
 
+// Measures imports taking both ref and i32 arguments, which exercises the
+// ref retain/release paths of import argument marshaling.
+static void BM_CallImportedRefFuncBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state,
+                            "bytecode_module_benchmark.call_imported_ref_func",
+                            {100},
+                            /*result_count=*/1,
+                            /*batch_size=*/20));
+}
+BENCHMARK(BM_CallImportedRefFuncBytecode);
+
 static void BM_LoopSumReference(benchmark::State& state) {
   static auto work = +[](int x) {
     benchmark::DoNotOptimize(x);
@@ -309,4 +378,50 @@ static void BM_LoopSumBytecode(benchmark::State& state) {
 }
 BENCHMARK(BM_LoopSumBytecode)->Arg(100000);
 
+static void BM_LoopBranchyReference(benchmark::State& state) {
+  static auto work = +[](int x) {
+    benchmark::DoNotOptimize(x);
+    return x;
+  };
+  static auto loop = +[](int count) {
+    int acc = 0;
+    for (int i = 0; i < count; ++i) {
+      if ((i & 3) == 0) {
+        acc = work(acc ^ 5);
+      } else if (acc < 1000) {
+        acc = work(acc + 3);
+      } else {
+        acc = work(acc - 7);
+      }
+    }
+    return acc;
+  };
+  while (state.KeepRunningBatch(state.range(0))) {
+    int ret = loop(state.range(0));
+    benchmark::DoNotOptimize(ret);
+  }
+}
+BENCHMARK(BM_LoopBranchyReference)->Arg(100000);
+
+static void BM_LoopBranchyBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, "bytecode_module_benchmark.loop_branchy",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*result_count=*/1,
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopBranchyBytecode)->Arg(100000);
+
+// Runs the same loop from a module compiled without superinstruction fusion.
+// Comparing against BM_LoopBranchyBytecode measures the dispatch savings of
+// fusion without requiring IREE_VM_PROFILING_ENABLE.
+static void BM_LoopBranchyBytecodeUnfused(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunctionInModule(
+      state, iree::vm::bytecode_module_benchmark_unfused_module_create(),
+      "bytecode_module_benchmark.loop_branchy",
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopBranchyBytecodeUnfused)->Arg(100000);
+
 }  // namespace
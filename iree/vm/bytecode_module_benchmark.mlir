@@ -63,6 +63,60 @@ vm.module @bytecode_module_benchmark {
     vm.return %20 : i32
   }
 
+  // Measures the cost of a call to an imported function taking a ref.
+  vm.import @native_import_module.add_list_size(
+    %list : !vm.list<i32>, %arg : i32
+  ) -> i32
+  vm.export @call_imported_ref_func
+  vm.func @call_imported_ref_func(%arg0 : i32) -> i32 {
+    %c1 = vm.const.i32 1 : i32
+    %list = vm.list.alloc %c1 : (i32) -> !vm.list<i32>
+    vm.list.resize %list, %c1 : (!vm.list<i32>, i32)
+    %0 = vm.call @native_import_module.add_list_size(%list, %arg0) :
+        (!vm.list<i32>, i32) -> i32
+    %1 = vm.call @native_import_module.add_list_size(%list, %0) :
+        (!vm.list<i32>, i32) -> i32
+    %2 = vm.call @native_import_module.add_list_size(%list, %1) :
+        (!vm.list<i32>, i32) -> i32
+    %3 = vm.call @native_import_module.add_list_size(%list, %2) :
+        (!vm.list<i32>, i32) -> i32
+    %4 = vm.call @native_import_module.add_list_size(%list, %3) :
+        (!vm.list<i32>, i32) -> i32
+    %5 = vm.call @native_import_module.add_list_size(%list, %4) :
+        (!vm.list<i32>, i32) -> i32
+    %6 = vm.call @native_import_module.add_list_size(%list, %5) :
+        (!vm.list<i32>, i32) -> i32
+    %7 = vm.call @native_import_module.add_list_size(%list, %6) :
+        (!vm.list<i32>, i32) -> i32
+    %8 = vm.call @native_import_module.add_list_size(%list, %7) :
+        (!vm.list<i32>, i32) -> i32
+    %9 = vm.call @native_import_module.add_list_size(%list, %8) :
+        (!vm.list<i32>, i32) -> i32
+    %10 = vm.call @native_import_module.add_list_size(%list, %9) :
+        (!vm.list<i32>, i32) -> i32
+    %11 = vm.call @native_import_module.add_list_size(%list, %10) :
+        (!vm.list<i32>, i32) -> i32
+    %12 = vm.call @native_import_module.add_list_size(%list, %11) :
+        (!vm.list<i32>, i32) -> i32
+    %13 = vm.call @native_import_module.add_list_size(%list, %12) :
+        (!vm.list<i32>, i32) -> i32
+    %14 = vm.call @native_import_module.add_list_size(%list, %13) :
+        (!vm.list<i32>, i32) -> i32
+    %15 = vm.call @native_import_module.add_list_size(%list, %14) :
+        (!vm.list<i32>, i32) -> i32
+    %16 = vm.call @native_import_module.add_list_size(%list, %15) :
+        (!vm.list<i32>, i32) -> i32
+    %17 = vm.call @native_import_module.add_list_size(%list, %16) :
+        (!vm.list<i32>, i32) -> i32
+    %18 = vm.call @native_import_module.add_list_size(%list, %17) :
+        (!vm.list<i32>, i32) -> i32
+    %19 = vm.call @native_import_module.add_list_size(%list, %18) :
+        (!vm.list<i32>, i32) -> i32
+    %20 = vm.call @native_import_module.add_list_size(%list, %19) :
+        (!vm.list<i32>, i32) -> i32
+    vm.return %20 : i32
+  }
+
   // Measures the cost of a simple for-loop.
   vm.export @loop_sum
   vm.func @loop_sum(%count : i32) -> i32 {
@@ -76,4 +130,39 @@ vm.module @bytecode_module_benchmark {
   ^loop_exit(%ie : i32):
     vm.return %ie : i32
   }
+
+  // Measures the cost of a for-loop with data-dependent branches.
+  vm.export @loop_branchy
+  vm.func @loop_branchy(%count : i32) -> i32 {
+    %c1 = vm.const.i32 1 : i32
+    %c3 = vm.const.i32 3 : i32
+    %c5 = vm.const.i32 5 : i32
+    %c7 = vm.const.i32 7 : i32
+    %c1000 = vm.const.i32 1000 : i32
+    %zero = vm.const.i32.zero : i32
+    vm.br ^loop(%zero, %zero : i32, i32)
+  ^loop(%i : i32, %acc : i32):
+    %lane = vm.and.i32 %i, %c3 : i32
+    %is_first = vm.cmp.eq.i32 %lane, %zero : i32
+    vm.cond_br %is_first, ^flip, ^check
+  ^flip:
+    %acc_flip = vm.xor.i32 %acc, %c5 : i32
+    vm.br ^latch(%acc_flip : i32)
+  ^check:
+    %is_small = vm.cmp.lt.i32.s %acc, %c1000 : i32
+    vm.cond_br %is_small, ^grow, ^shrink
+  ^grow:
+    %acc_grow = vm.add.i32 %acc, %c3 : i32
+    vm.br ^latch(%acc_grow : i32)
+  ^shrink:
+    %acc_shrink = vm.sub.i32 %acc, %c7 : i32
+    vm.br ^latch(%acc_shrink : i32)
+  ^latch(%acc_next : i32):
+    %in = vm.add.i32 %i, %c1 : i32
+    %cmp = vm.cmp.lt.i32.s %in, %count : i32
+    vm.cond_br %cmp, ^loop(%in, %acc_next : i32, i32),
+                     ^loop_exit(%acc_next : i32)
+  ^loop_exit(%acc_exit : i32):
+    vm.return %acc_exit : i32
+  }
 }
@@ -24,6 +24,7 @@
 #endif  // _MSC_VER
 
 #include "iree/base/api.h"
+#include "iree/base/atomics.h"
 #include "iree/vm/builtin_types.h"
 #include "iree/vm/module.h"
 #include "iree/vm/ref.h"
@@ -54,6 +55,77 @@ extern "C" {
 #define IREE_REF_REGISTER_MOVE_BIT 0x4000
 #define IREE_REF_REGISTER_MASK 0x3FFF
 
+// A precomputed step marshaling a single value between a caller register and
+// an ABI buffer.
+typedef struct {
+  // Index of the register within the call register list.
+  uint16_t reg_index;
+  // Byte offset of the value within the ABI buffer.
+  uint16_t offset;
+} iree_vm_bytecode_marshal_step_t;
+
+// A marshaling plan for a non-variadic cconv fragment, resolved once when the
+// import is resolved so that calls need not walk the cconv string.
+// Steps are grouped by value type (all i32/f32, then all i64, then all refs) so
+// that marshaling is a few tight loops without a switch per value.
+typedef struct {
+  uint16_t i32_count;
+  uint16_t i64_count;
+  uint16_t ref_count;
+  // Total number of values (and registers) marshaled by the plan.
+  uint16_t value_count;
+  const iree_vm_bytecode_marshal_step_t* steps;
+} iree_vm_bytecode_marshal_plan_t;
+
+// A resolved and split import in the module state table.
+//
+// NOTE: a table of these are stored per module per context so ideally we'd
+// only store the absolute minimum information to reduce our fixed overhead.
+// There's a big tradeoff though as a few extra bytes here can avoid non-trivial
+// work per import function invocation.
+typedef struct {
+  // Import function in the source module.
+  iree_vm_function_t function;
+
+  // Pre-parsed argument/result calling convention string fragments.
+  // For example, 0ii.r will be split to arguments=ii and results=r.
+  iree_string_view_t arguments;
+  iree_string_view_t results;
+
+  // Precomputed argument/result size requirements for marshaling values.
+  // Only usable for non-variadic signatures. Results are always usable as they
+  // don't support variadic values (yet).
+  uint16_t argument_buffer_size;
+  uint16_t result_buffer_size;
+
+  // Precomputed marshaling plans. The argument plan is only valid for
+  // non-variadic signatures; variadic calls walk the cconv string per call.
+  iree_vm_bytecode_marshal_plan_t argument_plan;
+  iree_vm_bytecode_marshal_plan_t result_plan;
+
+  // Storage for the plan steps owned by this import or NULL if the plans are
+  // shared with the module import table.
+  iree_vm_bytecode_marshal_step_t* marshal_steps;
+} iree_vm_bytecode_import_t;
+
+// A slot in a function name hash index.
+typedef struct {
+  // Hash of the function name.
+  uint32_t hash;
+  // Ordinal of the function within its linkage table + 1 or 0 if empty.
+  uint32_t ordinal_plus_one;
+} iree_vm_bytecode_function_index_slot_t;
+
+// An open-addressed hash index mapping function names to ordinals.
+// Built once when the module is created so that lookups by name (such as
+// import resolution during context creation) do not scan the function tables.
+typedef struct {
+  // Number of slots; always zero or a power of two larger than the number of
+  // indexed functions so that probing terminates.
+  iree_host_size_t capacity;
+  iree_vm_bytecode_function_index_slot_t* slots;
+} iree_vm_bytecode_function_index_t;
+
 // A loaded bytecode module.
 typedef struct {
   // Interface routing to the bytecode module functions.
@@ -70,6 +142,12 @@ typedef struct {
   // A pointer to the bytecode data embedded within the module.
   iree_const_byte_span_t bytecode_data;
 
+  // Per-function flags set once the function has been verified, mapped 1:1
+  // with internal functions. NULL unless the module was loaded with
+  // IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION. Verification is
+  // idempotent so concurrent first calls may both verify without harm.
+  iree_atomic_intptr_t* function_verified_table;
+
   // Allocator this module was allocated with and must be freed with.
   iree_allocator_t allocator;
 
@@ -81,31 +159,28 @@ typedef struct {
   // Type table mapping module type IDs to registered VM types.
   iree_host_size_t type_count;
   iree_vm_type_def_t* type_table;
-} iree_vm_bytecode_module_t;
 
-// A resolved and split import in the module state table.
-//
-// NOTE: a table of these are stored per module per context so ideally we'd
-// only store the absolute minimum information to reduce our fixed overhead.
-// There's a big tradeoff though as a few extra bytes here can avoid non-trivial
-// work per import function invocation.
-typedef struct {
-  // Import function in the source module.
-  iree_vm_function_t function;
+  // Initialized references to rodata segments, shared by all module states.
+  // Right now these don't do much, however we can perform lazy caching and
+  // on-the-fly decompression using this information.
+  iree_host_size_t rodata_ref_count;
+  iree_vm_ro_byte_buffer_t* rodata_ref_table;
 
-  // Pre-parsed argument/result calling convention string fragments.
-  // For example, 0ii.r will be split to arguments=ii and results=r.
-  iree_string_view_t arguments;
-  iree_string_view_t results;
+  // Imports prepared from the signatures declared by the module, with no
+  // function set. States whose resolved functions have matching signatures
+  // share the marshaling plans here instead of building their own.
+  iree_host_size_t import_count;
+  iree_vm_bytecode_import_t* import_table;
 
-  // Precomputed argument/result size requirements for marshaling values.
-  // Only usable for non-variadic signatures. Results are always usable as they
-  // don't support variadic values (yet).
-  uint16_t argument_buffer_size;
-  uint16_t result_buffer_size;
-} iree_vm_bytecode_import_t;
+  // Function name indices for each linkage type.
+  iree_vm_bytecode_function_index_t import_index;
+  iree_vm_bytecode_function_index_t export_index;
+  iree_vm_bytecode_function_index_t internal_index;
+} iree_vm_bytecode_module_t;
 
 // Per-instance module state.
+// Only data that may differ between contexts lives here; read-only data such as
+// rodata references is shared by all states on iree_vm_bytecode_module_t.
 // This is allocated with a provided allocator as a single flat allocation.
 // This struct is a prefix to the allocation pointing into the dynamic offsets
 // of the allocation storage.
@@ -118,13 +193,6 @@ typedef struct {
   iree_host_size_t global_ref_count;
   iree_vm_ref_t* global_ref_table;
 
-  // TODO(benvanik): move to iree_vm_bytecode_module_t if always static.
-  // Initialized references to rodata segments.
-  // Right now these don't do much, however we can perform lazy caching and
-  // on-the-fly decompression using this information.
-  iree_host_size_t rodata_ref_count;
-  iree_vm_ro_byte_buffer_t* rodata_ref_table;
-
   // Resolved function imports.
   iree_host_size_t import_count;
   iree_vm_bytecode_import_t* import_table;
@@ -136,6 +204,10 @@ typedef struct {
 // Begins (or resumes) execution of the current frame and continues until
 // either a yield or return. |out_result| will contain the result status for
 // continuation, if needed.
+//
+// When |call| is NULL execution resumes from the top frame of |stack|, which
+// must have been suspended by a prior dispatch, and the cconv arguments are
+// ignored.
 iree_status_t iree_vm_bytecode_dispatch(iree_vm_stack_t* stack,
                                         iree_vm_bytecode_module_t* module,
                                         const iree_vm_function_call_t* call,
@@ -143,6 +215,24 @@ iree_status_t iree_vm_bytecode_dispatch(iree_vm_stack_t* stack,
                                         iree_string_view_t cconv_results,
                                         iree_vm_execution_result_t* out_result);
 
+// Verifies the internal function with |function_ordinal| and marks it as
+// verified in the module function_verified_table.
+iree_status_t iree_vm_bytecode_module_verify_function(
+    iree_vm_bytecode_module_t* module, iree_host_size_t function_ordinal);
+
+// Verifies the internal function with |function_ordinal| if the module was
+// loaded with lazy function verification and it has not yet been verified.
+// Must be called before any function metadata is used to execute it.
+static inline iree_status_t iree_vm_bytecode_module_ensure_function_verified(
+    iree_vm_bytecode_module_t* module, iree_host_size_t function_ordinal) {
+  iree_atomic_intptr_t* verified_table = module->function_verified_table;
+  if (IREE_LIKELY(!verified_table) ||
+      IREE_LIKELY(iree_atomic_load(&verified_table[function_ordinal]))) {
+    return iree_ok_status();
+  }
+  return iree_vm_bytecode_module_verify_function(module, function_ordinal);
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -18,10 +18,101 @@
 
 #include "iree/vm/bytecode_module.h"
 
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
 #include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/module.h"
+
+// Compiled module embedded here to avoid file IO:
+#include "iree/vm/test/all_bytecode_modules.h"
 
 namespace {
 
-// TODO(benvanik): bytecode_module_test.cc for flatbuffer/module implementation.
+static iree_const_byte_span_t ToSpan(const iree::FileToc& file_toc) {
+  return iree_make_const_byte_span(file_toc.data, file_toc.size);
+}
+
+static iree_status_t CreateModule(iree_const_byte_span_t data,
+                                  iree_vm_bytecode_module_flags_t flags,
+                                  iree_vm_module_t** out_module) {
+  return iree_vm_bytecode_module_create_with_flags(
+      data, flags, iree_allocator_null(), iree_allocator_system(), out_module);
+}
+
+static const iree_vm_bytecode_module_flags_t kTrustedLazyFlags =
+    IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED |
+    IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION;
+
+TEST(BytecodeModuleTest, RejectsTruncatedData) {
+  const auto* module_file = iree::vm::test::all_bytecode_modules_cc_create();
+  iree_const_byte_span_t data =
+      iree_make_const_byte_span(module_file->data, 8);
+  const iree_vm_bytecode_module_flags_t all_flags[] = {
+      IREE_VM_BYTECODE_MODULE_FLAG_NONE, kTrustedLazyFlags};
+  for (iree_vm_bytecode_module_flags_t flags : all_flags) {
+    iree_vm_module_t* module = nullptr;
+    IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                          ::iree::Status(CreateModule(data, flags, &module)));
+    EXPECT_EQ(nullptr, module);
+  }
+}
+
+TEST(BytecodeModuleTest, TrustedRejectsBadIdentifier) {
+  const auto* module_file = iree::vm::test::all_bytecode_modules_cc_create();
+  std::vector<uint8_t> data(module_file->size);
+  std::memcpy(data.data(), module_file->data, data.size());
+  // The file identifier immediately follows the root table offset.
+  std::memcpy(data.data() + sizeof(uint32_t), "XXXX", 4);
+  iree_vm_module_t* module = nullptr;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_INVALID_ARGUMENT,
+      ::iree::Status(CreateModule(
+          iree_make_const_byte_span(data.data(), data.size()),
+          kTrustedLazyFlags, &module)));
+  EXPECT_EQ(nullptr, module);
+}
+
+TEST(BytecodeModuleTest, RejectsLazyWithoutTrusted) {
+  const auto* module_file = iree::vm::test::all_bytecode_modules_cc_create();
+  iree_vm_module_t* module = nullptr;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_INVALID_ARGUMENT,
+      ::iree::Status(CreateModule(
+          ToSpan(module_file[0]),
+          IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION, &module)));
+  EXPECT_EQ(nullptr, module);
+}
+
+// Trusted modules with lazy verification must expose the same interface as
+// when fully verified on load.
+TEST(BytecodeModuleTest, TrustedLazyMatchesVerified) {
+  const auto* module_file = iree::vm::test::all_bytecode_modules_cc_create();
+  for (size_t i = 0; i < iree::vm::test::all_bytecode_modules_cc_size(); ++i) {
+    iree_const_byte_span_t data = ToSpan(module_file[i]);
+    iree_vm_module_t* verified_module = nullptr;
+    IREE_ASSERT_OK(::iree::Status(CreateModule(
+        data, IREE_VM_BYTECODE_MODULE_FLAG_NONE, &verified_module)));
+    iree_vm_module_t* trusted_module = nullptr;
+    IREE_ASSERT_OK(::iree::Status(
+        CreateModule(data, kTrustedLazyFlags, &trusted_module)));
+
+    iree_vm_module_signature_t verified_signature =
+        iree_vm_module_signature(verified_module);
+    iree_vm_module_signature_t trusted_signature =
+        iree_vm_module_signature(trusted_module);
+    EXPECT_EQ(verified_signature.import_function_count,
+              trusted_signature.import_function_count);
+    EXPECT_EQ(verified_signature.export_function_count,
+              trusted_signature.export_function_count);
+    EXPECT_EQ(verified_signature.internal_function_count,
+              trusted_signature.internal_function_count);
+
+    iree_vm_module_release(trusted_module);
+    iree_vm_module_release(verified_module);
+  }
+}
 
 }  // namespace
@@ -27,6 +27,9 @@ struct iree_vm_context {
   iree_allocator_t allocator;
   intptr_t context_id;
 
+  // Profile attached to all stacks executing within the context, if any.
+  iree_vm_profile_t* profile;
+
   bool is_static;
   struct {
     iree_host_size_t count;
@@ -59,9 +62,20 @@ static iree_status_t iree_vm_context_run_function(
   }
 
   iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
   status = module->begin_call(module->self, stack, &call, &result);
 
-  // TODO(benvanik): ensure completed synchronously.
+  // Initializers run synchronously; yields are resumed immediately and there is
+  // nothing to wait on as the context is not yet visible to anyone else.
+  while (iree_status_is_ok(status) &&
+         result.state == IREE_VM_EXECUTION_STATE_YIELDED) {
+    status = module->resume_call(module->self, stack, &result);
+  }
+  if (iree_status_is_ok(status) &&
+      result.state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+    status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "module initializers may not wait");
+  }
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -155,6 +169,7 @@ static void iree_vm_context_release_modules(iree_vm_context_t* context,
   // Run module __deinit functions, if present (in reverse init order).
   IREE_VM_INLINE_STACK_INITIALIZE(
       stack, iree_vm_context_state_resolver(context), context->allocator);
+  iree_vm_stack_set_profile(stack, context->profile);
   for (int i = (int)end; i >= (int)start; --i) {
     iree_vm_module_t* module = context->list.modules[i];
     iree_vm_module_state_t* module_state = context->list.module_states[i];
@@ -258,6 +273,9 @@ static void iree_vm_context_destroy(iree_vm_context_t* context) {
   iree_vm_instance_release(context->instance);
   context->instance = NULL;
 
+  iree_vm_profile_release(context->profile);
+  context->profile = NULL;
+
   iree_allocator_free(context->allocator, context);
 
   IREE_TRACE_ZONE_END(z0);
@@ -293,6 +311,18 @@ iree_vm_context_state_resolver(const iree_vm_context_t* context) {
   return state_resolver;
 }
 
+IREE_API_EXPORT void IREE_API_CALL iree_vm_context_set_profile(
+    iree_vm_context_t* context, iree_vm_profile_t* profile) {
+  iree_vm_profile_retain(profile);
+  iree_vm_profile_release(context->profile);
+  context->profile = profile;
+}
+
+IREE_API_EXPORT iree_vm_profile_t* IREE_API_CALL
+iree_vm_context_profile(const iree_vm_context_t* context) {
+  return context->profile;
+}
+
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_context_resolve_module_state(
     const iree_vm_context_t* context, iree_vm_module_t* module,
@@ -354,6 +384,7 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_context_register_modules(
   // VM stack used to call into module __init methods.
   IREE_VM_INLINE_STACK_INITIALIZE(
       stack, iree_vm_context_state_resolver(context), context->allocator);
+  iree_vm_stack_set_profile(stack, context->profile);
 
   // Retain all modules and allocate their state.
   assert(context->list.capacity >= context->list.count + module_count);
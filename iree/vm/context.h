@@ -18,6 +18,7 @@
 #include "iree/base/api.h"
 #include "iree/vm/instance.h"
 #include "iree/vm/module.h"
+#include "iree/vm/profile.h"
 #include "iree/vm/stack.h"
 
 #ifdef __cplusplus
@@ -70,6 +71,17 @@ iree_vm_context_id(const iree_vm_context_t* context);
 IREE_API_EXPORT iree_vm_state_resolver_t IREE_API_CALL
 iree_vm_context_state_resolver(const iree_vm_context_t* context);
 
+// Attaches |profile| to |context| such that all subsequent invocations made
+// against the context, including module initializers, record into it. The
+// profile is retained by the context. Passing NULL detaches any existing
+// profile.
+IREE_API_EXPORT void IREE_API_CALL iree_vm_context_set_profile(
+    iree_vm_context_t* context, iree_vm_profile_t* profile);
+
+// Returns the profile attached to |context| or NULL if none is attached.
+IREE_API_EXPORT iree_vm_profile_t* IREE_API_CALL
+iree_vm_context_profile(const iree_vm_context_t* context);
+
 // Sets |out_module_state| to the context-specific state for the given |module|.
 // The state is owned by the context and will only be live for as long as the
 // context is.
@@ -14,9 +14,20 @@
 
 #include "iree/vm/invocation.h"
 
+#include <stdbool.h>
+#include <string.h>
+
 #include "iree/base/api.h"
+#include "iree/base/atomics.h"
+#include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 
+#if !defined(IREE_PLATFORM_WINDOWS)
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#endif  // !IREE_PLATFORM_WINDOWS
+
 // Marshals caller arguments from the variant list to the ABI convention.
 static iree_status_t iree_vm_invoke_marshal_inputs(
     iree_string_view_t cconv_arguments, iree_vm_list_t* inputs,
@@ -55,6 +66,13 @@ static iree_status_t iree_vm_invoke_marshal_inputs(
         memcpy(p, &value.i64, sizeof(int64_t));
         p += sizeof(int64_t);
       } break;
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
+        iree_vm_value_t value;
+        IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+            inputs, arg_i, IREE_VM_VALUE_TYPE_F32, &value));
+        memcpy(p, &value.f32, sizeof(float));
+        p += sizeof(float);
+      } break;
       case IREE_VM_CCONV_TYPE_REF: {
         // TODO(benvanik): see if we can't remove this retain by instead relying
         // on the caller still owning the list.
@@ -99,6 +117,11 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
         IREE_RETURN_IF_ERROR(iree_vm_list_set_value(outputs, arg_i, &value));
         p += sizeof(int64_t);
       } break;
+      case IREE_VM_CCONV_TYPE_FLOAT32: {
+        iree_vm_value_t value = iree_vm_value_make_f32(*(float*)p);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(outputs, arg_i, &value));
+        p += sizeof(float);
+      } break;
       case IREE_VM_CCONV_TYPE_REF: {
         IREE_RETURN_IF_ERROR(
             iree_vm_list_set_ref_move(outputs, arg_i, (iree_vm_ref_t*)p));
@@ -109,6 +132,59 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
   return iree_ok_status();
 }
 
+// Sleeps the calling thread before polling a waiting call again based on the
+// number of prior polls that found it still waiting.
+static void iree_vm_wait_backoff(uint32_t wait_attempts);
+
+// Resumes a call that began on |stack| until it completes, backing off while
+// it is waiting on asynchronous imports.
+static iree_status_t iree_vm_resume_until_complete(
+    iree_vm_module_t* module, iree_vm_stack_t* stack,
+    iree_vm_execution_result_t* result) {
+  uint32_t wait_attempts = 0;
+  while (result->state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+    if (result->state == IREE_VM_EXECUTION_STATE_WAITING) {
+      iree_vm_wait_backoff(wait_attempts++);
+    } else {
+      wait_attempts = 0;
+    }
+    IREE_RETURN_IF_ERROR(module->resume_call(module->self, stack, result));
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_call_until_complete(iree_vm_stack_t* stack,
+                            const iree_vm_function_call_t* call,
+                            iree_vm_execution_result_t* out_result) {
+  IREE_ASSERT_ARGUMENT(stack);
+  IREE_ASSERT_ARGUMENT(call);
+  IREE_ASSERT_ARGUMENT(out_result);
+  iree_vm_module_t* module = call->function.module;
+
+  // The caller cannot suspend so there is nothing to gain from deferring.
+  bool async_waits = iree_vm_stack_async_waits(stack);
+  iree_vm_stack_set_async_waits(stack, false);
+
+  // Calls that defer leave the stack and arguments as they were so that they
+  // can be reissued.
+  uint32_t wait_attempts = 0;
+  iree_status_t status = iree_ok_status();
+  while (true) {
+    memset(out_result, 0, sizeof(*out_result));
+    status = module->begin_call(module->self, stack, call, out_result);
+    if (!iree_status_is_deferred(status)) break;
+    iree_status_ignore(status);
+    iree_vm_wait_backoff(++wait_attempts);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_resume_until_complete(module, stack, out_result);
+  }
+
+  iree_vm_stack_set_async_waits(stack, async_waits);
+  return status;
+}
+
 // TODO(benvanik): implement this as an iree_vm_invocation_t sequence.
 static iree_status_t iree_vm_invoke_within(
     iree_vm_context_t* context, iree_vm_stack_t* stack,
@@ -116,6 +192,7 @@ static iree_status_t iree_vm_invoke_within(
     iree_vm_list_t* inputs, iree_vm_list_t* outputs) {
   IREE_ASSERT_ARGUMENT(context);
   IREE_ASSERT_ARGUMENT(stack);
+  iree_vm_stack_set_profile(stack, iree_vm_context_profile(context));
 
   iree_vm_function_signature_t signature =
       iree_vm_function_signature(&function);
@@ -142,16 +219,20 @@ static iree_status_t iree_vm_invoke_within(
   results.data = iree_alloca(results.data_length);
   memset(results.data, 0, results.data_length);
 
-  // Perform execution. Note that for synchronous execution we expect this to
-  // complete without yielding.
+  // Perform execution. Synchronous execution resumes the call on this thread
+  // until it completes should it yield or wait.
   iree_vm_function_call_t call;
   memset(&call, 0, sizeof(call));
   call.function = function;
   call.arguments = arguments;
   call.results = results;
   iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
   iree_status_t status =
       function.module->begin_call(function.module->self, stack, &call, &result);
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_resume_until_complete(function.module, stack, &result);
+  }
   if (!iree_status_is_ok(status)) {
     iree_vm_function_call_release(&call, &signature);
     return status;
@@ -180,3 +261,1083 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invoker_t
+//===----------------------------------------------------------------------===//
+
+// An argument or result of the invoker function within its ABI buffer.
+typedef struct {
+  // Type the list element is marshaled as or IREE_VM_VALUE_TYPE_NONE for refs.
+  iree_vm_value_type_t value_type;
+  // Byte offset of the slot within the arguments or results buffer.
+  iree_host_size_t offset;
+} iree_vm_invoker_slot_t;
+
+struct iree_vm_invoker {
+  iree_atomic_intptr_t ref_count;
+  iree_allocator_t allocator;
+
+  iree_vm_context_t* context;
+  iree_vm_function_signature_t signature;
+  // True if any argument or result is a ref that may need releasing.
+  bool has_refs;
+
+  // Marshaling plan built from the cconv when the invoker is created.
+  // |slots| contains all arguments followed by all results and is stored
+  // immediately after the invoker.
+  iree_host_size_t argument_count;
+  iree_host_size_t result_count;
+  iree_vm_invoker_slot_t* slots;
+
+  // Call with ABI buffers stored immediately after the slots.
+  iree_vm_function_call_t call;
+
+  // Stack reused across calls. Stacks never shrink so once grown to fit the
+  // function no further reallocation is required.
+  iree_vm_stack_t* stack;
+};
+
+// Populates |out_slots| with one slot per type in the non-variadic
+// |cconv_fragment|. The fragment must have been validated with
+// iree_vm_function_call_compute_cconv_fragment_size.
+static void iree_vm_invoker_build_slots(iree_string_view_t cconv_fragment,
+                                        iree_vm_invoker_slot_t* out_slots) {
+  iree_host_size_t offset = 0;
+  for (iree_host_size_t i = 0; i < cconv_fragment.size; ++i) {
+    iree_vm_invoker_slot_t* slot = &out_slots[i];
+    slot->offset = offset;
+    switch (cconv_fragment.data[i]) {
+      case IREE_VM_CCONV_TYPE_INT32:
+        slot->value_type = IREE_VM_VALUE_TYPE_I32;
+        offset += sizeof(int32_t);
+        break;
+      case IREE_VM_CCONV_TYPE_INT64:
+        slot->value_type = IREE_VM_VALUE_TYPE_I64;
+        offset += sizeof(int64_t);
+        break;
+      case IREE_VM_CCONV_TYPE_FLOAT32:
+        slot->value_type = IREE_VM_VALUE_TYPE_F32;
+        offset += sizeof(float);
+        break;
+      case IREE_VM_CCONV_TYPE_REF:
+        slot->value_type = IREE_VM_VALUE_TYPE_NONE;
+        offset += sizeof(iree_vm_ref_t);
+        break;
+    }
+  }
+}
+
+// Marshals caller arguments from the variant list using the invoker plan.
+static iree_status_t iree_vm_invoker_marshal_inputs(iree_vm_invoker_t* invoker,
+                                                    iree_vm_list_t* inputs) {
+  iree_host_size_t input_count = inputs ? iree_vm_list_size(inputs) : 0;
+  if (!inputs && invoker->argument_count > 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "no input provided to a function that has inputs");
+  } else if (input_count != invoker->argument_count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "input list and function mismatch; expected %zu "
+                            "arguments but passed %zu",
+                            invoker->argument_count, input_count);
+  }
+
+  uint8_t* arguments = invoker->call.arguments.data;
+  for (iree_host_size_t i = 0; i < invoker->argument_count; ++i) {
+    const iree_vm_invoker_slot_t* slot = &invoker->slots[i];
+    uint8_t* p = arguments + slot->offset;
+    if (slot->value_type == IREE_VM_VALUE_TYPE_NONE) {
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_get_ref_retain(inputs, i, (iree_vm_ref_t*)p));
+      continue;
+    }
+    iree_vm_value_t value;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_get_value_as(inputs, i, slot->value_type, &value));
+    switch (slot->value_type) {
+      case IREE_VM_VALUE_TYPE_I64:
+        memcpy(p, &value.i64, sizeof(int64_t));
+        break;
+      case IREE_VM_VALUE_TYPE_F32:
+        memcpy(p, &value.f32, sizeof(float));
+        break;
+      default:
+        memcpy(p, &value.i32, sizeof(int32_t));
+        break;
+    }
+  }
+  return iree_ok_status();
+}
+
+// Marshals callee results to the variant list using the invoker plan.
+static iree_status_t iree_vm_invoker_marshal_outputs(iree_vm_invoker_t* invoker,
+                                                     iree_vm_list_t* outputs) {
+  if (!outputs) {
+    if (invoker->result_count > 0) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "no output provided to a function that has outputs");
+    }
+    return iree_ok_status();
+  }
+
+  // Resize the output list to hold all results (and kill anything that may
+  // have been in there). This does not allocate once the list has grown to
+  // hold the results of a prior call.
+  IREE_RETURN_IF_ERROR(iree_vm_list_resize(outputs, 0));
+  IREE_RETURN_IF_ERROR(iree_vm_list_resize(outputs, invoker->result_count));
+
+  uint8_t* results = invoker->call.results.data;
+  const iree_vm_invoker_slot_t* result_slots =
+      invoker->slots + invoker->argument_count;
+  for (iree_host_size_t i = 0; i < invoker->result_count; ++i) {
+    const iree_vm_invoker_slot_t* slot = &result_slots[i];
+    uint8_t* p = results + slot->offset;
+    iree_vm_value_t value;
+    switch (slot->value_type) {
+      case IREE_VM_VALUE_TYPE_NONE:
+        IREE_RETURN_IF_ERROR(
+            iree_vm_list_set_ref_move(outputs, i, (iree_vm_ref_t*)p));
+        continue;
+      case IREE_VM_VALUE_TYPE_I64:
+        value = iree_vm_value_make_i64(*(int64_t*)p);
+        break;
+      case IREE_VM_VALUE_TYPE_F32:
+        value = iree_vm_value_make_f32(*(float*)p);
+        break;
+      default:
+        value = iree_vm_value_make_i32(*(int32_t*)p);
+        break;
+    }
+    IREE_RETURN_IF_ERROR(iree_vm_list_set_value(outputs, i, &value));
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoker_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_allocator_t allocator, iree_vm_invoker_t** out_invoker) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_invoker);
+  *out_invoker = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  iree_host_size_t arguments_size = 0;
+  iree_host_size_t results_size = 0;
+  iree_status_t status = iree_vm_function_call_get_cconv_fragments(
+      &signature, &cconv_arguments, &cconv_results);
+  // NOTE: today we don't support variadic arguments through this interface.
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_function_call_compute_cconv_fragment_size(
+        cconv_arguments, /*segment_size_list=*/NULL, &arguments_size);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_function_call_compute_cconv_fragment_size(
+        cconv_results, /*segment_size_list=*/NULL, &results_size);
+  }
+
+  iree_vm_invoker_t* invoker = NULL;
+  iree_host_size_t slots_size =
+      (cconv_arguments.size + cconv_results.size) *
+      sizeof(iree_vm_invoker_slot_t);
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(
+        allocator,
+        sizeof(*invoker) + slots_size + arguments_size + results_size,
+        (void**)&invoker);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_atomic_store(&invoker->ref_count, 1);
+    invoker->allocator = allocator;
+    invoker->context = context;
+    iree_vm_context_retain(context);
+    invoker->signature = signature;
+    invoker->has_refs =
+        iree_string_view_find_char(signature.calling_convention,
+                                   IREE_VM_CCONV_TYPE_REF,
+                                   0) != IREE_STRING_VIEW_NPOS;
+    invoker->argument_count = cconv_arguments.size;
+    invoker->result_count = cconv_results.size;
+    invoker->slots =
+        (iree_vm_invoker_slot_t*)((uint8_t*)invoker + sizeof(*invoker));
+    iree_vm_invoker_build_slots(cconv_arguments, invoker->slots);
+    iree_vm_invoker_build_slots(cconv_results,
+                                invoker->slots + invoker->argument_count);
+    uint8_t* abi_storage = (uint8_t*)invoker->slots + slots_size;
+    memset(&invoker->call, 0, sizeof(invoker->call));
+    invoker->call.function = function;
+    invoker->call.arguments = iree_make_byte_span(abi_storage, arguments_size);
+    invoker->call.results =
+        iree_make_byte_span(abi_storage + arguments_size, results_size);
+    invoker->stack = NULL;
+    status = iree_vm_stack_allocate(iree_vm_context_state_resolver(context),
+                                    allocator, &invoker->stack);
+    if (!iree_status_is_ok(status)) {
+      iree_vm_invoker_release(invoker);
+      invoker = NULL;
+    }
+  }
+
+  *out_invoker = invoker;
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_vm_invoker_destroy(iree_vm_invoker_t* invoker) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  if (invoker->stack) iree_vm_stack_free(invoker->stack);
+  iree_vm_context_release(invoker->context);
+  iree_allocator_free(invoker->allocator, invoker);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_invoker_retain(iree_vm_invoker_t* invoker) {
+  if (invoker) {
+    iree_atomic_fetch_add(&invoker->ref_count, 1);
+  }
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_invoker_release(iree_vm_invoker_t* invoker) {
+  if (invoker && iree_atomic_fetch_sub(&invoker->ref_count, 1) == 1) {
+    iree_vm_invoker_destroy(invoker);
+  }
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invoker_invoke(iree_vm_invoker_t* invoker, iree_vm_list_t* inputs,
+                       iree_vm_list_t* outputs) {
+  IREE_ASSERT_ARGUMENT(invoker);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Refs left in the buffers by a prior call have already been released so the
+  // buffers only need clearing before marshaling into them.
+  iree_vm_function_call_t* call = &invoker->call;
+  memset(call->arguments.data, 0,
+         call->arguments.data_length + call->results.data_length);
+  iree_status_t status = iree_vm_invoker_marshal_inputs(invoker, inputs);
+
+  iree_vm_module_t* module = call->function.module;
+  if (iree_status_is_ok(status)) {
+    // The profile may have changed since the last call.
+    iree_vm_stack_set_profile(invoker->stack,
+                              iree_vm_context_profile(invoker->context));
+    iree_vm_execution_result_t result;
+    memset(&result, 0, sizeof(result));
+    status = module->begin_call(module->self, invoker->stack, call, &result);
+    if (iree_status_is_ok(status)) {
+      status = iree_vm_resume_until_complete(module, invoker->stack, &result);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_invoker_marshal_outputs(invoker, outputs);
+  } else {
+    // Unwind any frames left by the failed call so the stack can be reused.
+    while (iree_vm_stack_current_frame(invoker->stack)) {
+      iree_status_ignore(iree_vm_stack_function_leave(invoker->stack));
+    }
+  }
+  if (invoker->has_refs) {
+    iree_vm_function_call_release(call, &invoker->signature);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Platform synchronization primitives
+//===----------------------------------------------------------------------===//
+// Minimal wrappers over the platform primitives needed by the invocation pool.
+
+#if defined(IREE_PLATFORM_WINDOWS)
+
+typedef SRWLOCK iree_vm_mutex_t;
+typedef CONDITION_VARIABLE iree_vm_cond_t;
+typedef HANDLE iree_vm_thread_t;
+
+static void iree_vm_mutex_initialize(iree_vm_mutex_t* mutex) {
+  InitializeSRWLock(mutex);
+}
+static void iree_vm_mutex_deinitialize(iree_vm_mutex_t* mutex) {}
+static void iree_vm_mutex_lock(iree_vm_mutex_t* mutex) {
+  AcquireSRWLockExclusive(mutex);
+}
+static void iree_vm_mutex_unlock(iree_vm_mutex_t* mutex) {
+  ReleaseSRWLockExclusive(mutex);
+}
+
+static void iree_vm_cond_initialize(iree_vm_cond_t* cond) {
+  InitializeConditionVariable(cond);
+}
+static void iree_vm_cond_deinitialize(iree_vm_cond_t* cond) {}
+static void iree_vm_cond_signal(iree_vm_cond_t* cond) {
+  WakeConditionVariable(cond);
+}
+static void iree_vm_cond_broadcast(iree_vm_cond_t* cond) {
+  WakeAllConditionVariable(cond);
+}
+
+// Waits on |cond| until signaled or |deadline| elapses.
+// Returns false if the deadline elapsed.
+static bool iree_vm_cond_wait_until(iree_vm_cond_t* cond,
+                                    iree_vm_mutex_t* mutex,
+                                    iree_time_t deadline) {
+  DWORD timeout_ms = INFINITE;
+  if (deadline != IREE_TIME_INFINITE_FUTURE) {
+    iree_time_t now = iree_time_now();
+    if (deadline <= now) return false;
+    timeout_ms = (DWORD)((deadline - now + 999999) / 1000000);
+  }
+  if (SleepConditionVariableSRW(cond, mutex, timeout_ms, 0)) return true;
+  return GetLastError() != ERROR_TIMEOUT;
+}
+
+static void iree_vm_invocation_pool_worker_main(
+    iree_vm_invocation_pool_t* pool);
+
+static DWORD WINAPI iree_vm_thread_start_routine(LPVOID param) {
+  iree_vm_invocation_pool_worker_main((iree_vm_invocation_pool_t*)param);
+  return 0;
+}
+
+static iree_status_t iree_vm_thread_create(iree_vm_invocation_pool_t* pool,
+                                           iree_vm_thread_t* out_thread) {
+  *out_thread = CreateThread(NULL, 0, iree_vm_thread_start_routine, pool, 0,
+                             NULL);
+  if (!*out_thread) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "unable to create worker thread (%u)",
+                            (unsigned)GetLastError());
+  }
+  return iree_ok_status();
+}
+
+static void iree_vm_thread_join(iree_vm_thread_t thread) {
+  WaitForSingleObject(thread, INFINITE);
+  CloseHandle(thread);
+}
+
+static void iree_vm_thread_sleep(iree_duration_t duration_ns) {
+  Sleep((DWORD)(duration_ns / 1000000));
+}
+
+#else
+
+typedef pthread_mutex_t iree_vm_mutex_t;
+typedef pthread_cond_t iree_vm_cond_t;
+typedef pthread_t iree_vm_thread_t;
+
+static void iree_vm_mutex_initialize(iree_vm_mutex_t* mutex) {
+  pthread_mutex_init(mutex, NULL);
+}
+static void iree_vm_mutex_deinitialize(iree_vm_mutex_t* mutex) {
+  pthread_mutex_destroy(mutex);
+}
+static void iree_vm_mutex_lock(iree_vm_mutex_t* mutex) {
+  pthread_mutex_lock(mutex);
+}
+static void iree_vm_mutex_unlock(iree_vm_mutex_t* mutex) {
+  pthread_mutex_unlock(mutex);
+}
+
+static void iree_vm_cond_initialize(iree_vm_cond_t* cond) {
+  pthread_cond_init(cond, NULL);
+}
+static void iree_vm_cond_deinitialize(iree_vm_cond_t* cond) {
+  pthread_cond_destroy(cond);
+}
+static void iree_vm_cond_signal(iree_vm_cond_t* cond) {
+  pthread_cond_signal(cond);
+}
+static void iree_vm_cond_broadcast(iree_vm_cond_t* cond) {
+  pthread_cond_broadcast(cond);
+}
+
+// Waits on |cond| until signaled or |deadline| elapses.
+// Returns false if the deadline elapsed.
+static bool iree_vm_cond_wait_until(iree_vm_cond_t* cond,
+                                    iree_vm_mutex_t* mutex,
+                                    iree_time_t deadline) {
+  if (deadline == IREE_TIME_INFINITE_FUTURE) {
+    pthread_cond_wait(cond, mutex);
+    return true;
+  }
+  if (deadline <= iree_time_now()) return false;
+  // iree_time_t is based on CLOCK_REALTIME which is what pthread condition
+  // variables use by default.
+  struct timespec abs_deadline;
+  abs_deadline.tv_sec = (time_t)(deadline / 1000000000ll);
+  abs_deadline.tv_nsec = (long)(deadline % 1000000000ll);
+  return pthread_cond_timedwait(cond, mutex, &abs_deadline) != ETIMEDOUT;
+}
+
+static void iree_vm_invocation_pool_worker_main(
+    iree_vm_invocation_pool_t* pool);
+
+static void* iree_vm_thread_start_routine(void* param) {
+  iree_vm_invocation_pool_worker_main((iree_vm_invocation_pool_t*)param);
+  return NULL;
+}
+
+static iree_status_t iree_vm_thread_create(iree_vm_invocation_pool_t* pool,
+                                           iree_vm_thread_t* out_thread) {
+  int rc = pthread_create(out_thread, NULL, iree_vm_thread_start_routine, pool);
+  if (rc != 0) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "unable to create worker thread (%d)", rc);
+  }
+  return iree_ok_status();
+}
+
+static void iree_vm_thread_join(iree_vm_thread_t thread) {
+  pthread_join(thread, NULL);
+}
+
+static void iree_vm_thread_sleep(iree_duration_t duration_ns) {
+  struct timespec duration;
+  duration.tv_sec = (time_t)(duration_ns / 1000000000ll);
+  duration.tv_nsec = (long)(duration_ns % 1000000000ll);
+  nanosleep(&duration, NULL);
+}
+
+#endif  // IREE_PLATFORM_WINDOWS
+
+// Bounds on the delay between polls of a waiting call. Waits double from the
+// minimum after the first immediate retry up to the maximum.
+#define IREE_VM_WAIT_BACKOFF_MIN_NS (10 * 1000ll)
+#define IREE_VM_WAIT_BACKOFF_MAX_NS (1000 * 1000ll)
+
+// Returns the delay before polling a waiting call again.
+static iree_duration_t iree_vm_wait_backoff_duration(uint32_t wait_attempts) {
+  if (wait_attempts == 0) return 0;
+  iree_duration_t duration = IREE_VM_WAIT_BACKOFF_MIN_NS;
+  for (uint32_t i = 1;
+       i < wait_attempts && duration < IREE_VM_WAIT_BACKOFF_MAX_NS; ++i) {
+    duration *= 2;
+  }
+  return duration < IREE_VM_WAIT_BACKOFF_MAX_NS ? duration
+                                                : IREE_VM_WAIT_BACKOFF_MAX_NS;
+}
+
+static void iree_vm_wait_backoff(uint32_t wait_attempts) {
+  iree_duration_t duration = iree_vm_wait_backoff_duration(wait_attempts);
+  if (duration > 0) iree_vm_thread_sleep(duration);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_t
+//===----------------------------------------------------------------------===//
+
+typedef enum {
+  // Waiting in a pool queue to begin execution.
+  IREE_VM_INVOCATION_STATE_PENDING = 0,
+  // Executing on a worker (or the creating thread).
+  IREE_VM_INVOCATION_STATE_RUNNING = 1,
+  // Completed (successfully or otherwise); |status| is valid.
+  IREE_VM_INVOCATION_STATE_COMPLETE = 2,
+} iree_vm_invocation_state_t;
+
+struct iree_vm_invocation {
+  iree_atomic_intptr_t ref_count;
+  iree_allocator_t allocator;
+
+  iree_vm_context_t* context;
+  iree_vm_function_t function;
+  iree_vm_list_t* inputs;
+  iree_vm_list_t* outputs;
+  iree_time_t deadline;
+
+  // Intrusive link in the pool queue or waiting list; guarded by the pool
+  // mutex.
+  iree_vm_invocation_t* next;
+  // Number of consecutive polls that found the invocation waiting and the time
+  // at which it should next be polled; guarded by the pool mutex.
+  uint32_t wait_attempts;
+  iree_time_t resume_time;
+
+  // Execution state of a started invocation. Calls may suspend and be resumed
+  // on another worker and so the stack and ABI buffers are owned here instead
+  // of by the native stack of the thread that began the call.
+  iree_vm_stack_t* stack;
+  // True if running on a pool that can suspend the invocation while imports
+  // wait; otherwise imports block the executing thread.
+  bool async_waits;
+  iree_vm_function_signature_t signature;
+  iree_string_view_t cconv_results;
+  iree_vm_function_call_t call;
+
+  // Guards the state below and signals completion.
+  iree_vm_mutex_t mutex;
+  iree_vm_cond_t completion_cond;
+  iree_vm_invocation_state_t state;
+  bool abort_requested;
+  iree_status_t status;
+};
+
+// Releases the execution state of a started invocation, unwinding any frames
+// left on the stack by a suspended call.
+static void iree_vm_invocation_end(iree_vm_invocation_t* invocation) {
+  if (invocation->stack) {
+    iree_vm_stack_free(invocation->stack);
+    invocation->stack = NULL;
+  }
+  if (invocation->call.arguments.data) {
+    iree_vm_function_call_release(&invocation->call, &invocation->signature);
+    iree_allocator_free(invocation->allocator,
+                        invocation->call.arguments.data);
+  }
+  memset(&invocation->call, 0, sizeof(invocation->call));
+}
+
+static void iree_vm_invocation_destroy(iree_vm_invocation_t* invocation) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_invocation_end(invocation);
+  iree_status_ignore(invocation->status);
+  iree_vm_list_release(invocation->outputs);
+  iree_vm_list_release(invocation->inputs);
+  iree_vm_context_release(invocation->context);
+  iree_vm_cond_deinitialize(&invocation->completion_cond);
+  iree_vm_mutex_deinitialize(&invocation->mutex);
+  iree_allocator_free(invocation->allocator, invocation);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Marks the invocation as complete with |status| and wakes all waiters.
+// Must be called with the invocation mutex held.
+static void iree_vm_invocation_complete_locked(iree_vm_invocation_t* invocation,
+                                               iree_status_t status) {
+  invocation->state = IREE_VM_INVOCATION_STATE_COMPLETE;
+  invocation->status = status;
+  iree_vm_cond_broadcast(&invocation->completion_cond);
+}
+
+// Completes a started invocation with |status| after releasing its execution
+// state. Results are discarded if an abort was requested while it was running.
+static void iree_vm_invocation_finish(iree_vm_invocation_t* invocation,
+                                      iree_status_t status) {
+  iree_vm_invocation_end(invocation);
+  iree_vm_mutex_lock(&invocation->mutex);
+  if (invocation->abort_requested) {
+    iree_status_ignore(status);
+    IREE_IGNORE_ERROR(iree_vm_list_resize(invocation->outputs, 0));
+    status = iree_make_status(IREE_STATUS_ABORTED, "invocation aborted");
+  }
+  iree_vm_invocation_complete_locked(invocation, status);
+  iree_vm_mutex_unlock(&invocation->mutex);
+}
+
+// Allocates the execution state of |invocation| and begins the call.
+static iree_status_t iree_vm_invocation_begin(
+    iree_vm_invocation_t* invocation, iree_vm_execution_result_t* out_result) {
+  iree_vm_function_t function = invocation->function;
+  invocation->signature = iree_vm_function_signature(&function);
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  IREE_RETURN_IF_ERROR(iree_vm_function_call_get_cconv_fragments(
+      &invocation->signature, &cconv_arguments, &invocation->cconv_results));
+
+  // Arguments and results share a single allocation. It is never empty so
+  // that a started invocation can be identified by its argument storage.
+  // NOTE: today we don't support variadic arguments through this interface.
+  iree_host_size_t arguments_size = 0;
+  iree_host_size_t results_size = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_function_call_compute_cconv_fragment_size(
+      cconv_arguments, /*segment_size_list=*/NULL, &arguments_size));
+  IREE_RETURN_IF_ERROR(iree_vm_function_call_compute_cconv_fragment_size(
+      invocation->cconv_results, /*segment_size_list=*/NULL, &results_size));
+  uint8_t* abi_storage = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      invocation->allocator, arguments_size + results_size + 1,
+      (void**)&abi_storage));
+  memset(abi_storage, 0, arguments_size + results_size);
+  invocation->call.function = function;
+  invocation->call.arguments = iree_make_byte_span(abi_storage, arguments_size);
+  invocation->call.results =
+      iree_make_byte_span(abi_storage + arguments_size, results_size);
+  IREE_RETURN_IF_ERROR(iree_vm_invoke_marshal_inputs(
+      cconv_arguments, invocation->inputs, invocation->call.arguments));
+
+  IREE_RETURN_IF_ERROR(iree_vm_stack_allocate(
+      iree_vm_context_state_resolver(invocation->context),
+      invocation->allocator, &invocation->stack));
+  iree_vm_stack_set_profile(invocation->stack,
+                            iree_vm_context_profile(invocation->context));
+  iree_vm_stack_set_async_waits(invocation->stack, invocation->async_waits);
+  return function.module->begin_call(function.module->self, invocation->stack,
+                                     &invocation->call, out_result);
+}
+
+// Runs the invocation on the calling thread until it completes or suspends.
+// Pending invocations are begun unless they were aborted or their deadline
+// elapsed and suspended invocations are resumed. Returns the state the
+// invocation was left in.
+static iree_vm_execution_state_t iree_vm_invocation_step(
+    iree_vm_invocation_t* invocation) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_mutex_lock(&invocation->mutex);
+  bool is_pending = invocation->state == IREE_VM_INVOCATION_STATE_PENDING;
+  if (invocation->state == IREE_VM_INVOCATION_STATE_COMPLETE) {
+    // Aborted while pending.
+    iree_vm_mutex_unlock(&invocation->mutex);
+    IREE_TRACE_ZONE_END(z0);
+    return IREE_VM_EXECUTION_STATE_COMPLETE;
+  } else if (is_pending && invocation->deadline != IREE_TIME_INFINITE_FUTURE &&
+             iree_time_now() > invocation->deadline) {
+    iree_vm_invocation_complete_locked(
+        invocation,
+        iree_make_status(IREE_STATUS_DEADLINE_EXCEEDED,
+                         "invocation deadline elapsed before execution"));
+    iree_vm_mutex_unlock(&invocation->mutex);
+    IREE_TRACE_ZONE_END(z0);
+    return IREE_VM_EXECUTION_STATE_COMPLETE;
+  } else if (!is_pending && invocation->abort_requested) {
+    // Aborted while suspended; unwind instead of resuming.
+    iree_vm_mutex_unlock(&invocation->mutex);
+    iree_vm_invocation_finish(invocation, iree_ok_status());
+    IREE_TRACE_ZONE_END(z0);
+    return IREE_VM_EXECUTION_STATE_COMPLETE;
+  }
+  invocation->state = IREE_VM_INVOCATION_STATE_RUNNING;
+  iree_vm_mutex_unlock(&invocation->mutex);
+
+  iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
+  iree_status_t status;
+  if (is_pending) {
+    status = iree_vm_invocation_begin(invocation, &result);
+  } else {
+    iree_vm_module_t* module = invocation->function.module;
+    status = module->resume_call(module->self, invocation->stack, &result);
+  }
+  if (iree_status_is_ok(status) &&
+      result.state != IREE_VM_EXECUTION_STATE_COMPLETE) {
+    IREE_TRACE_ZONE_END(z0);
+    return result.state;
+  }
+
+  // Read back the outputs from the result buffer.
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_invoke_marshal_outputs(invocation->cconv_results,
+                                            invocation->call.results,
+                                            invocation->outputs);
+  }
+  iree_vm_invocation_finish(invocation, status);
+
+  IREE_TRACE_ZONE_END(z0);
+  return IREE_VM_EXECUTION_STATE_COMPLETE;
+}
+
+// Executes the invocation on the calling thread until it completes.
+static void iree_vm_invocation_execute(iree_vm_invocation_t* invocation) {
+  uint32_t wait_attempts = 0;
+  while (true) {
+    iree_vm_execution_state_t state = iree_vm_invocation_step(invocation);
+    if (state == IREE_VM_EXECUTION_STATE_COMPLETE) break;
+    if (state == IREE_VM_EXECUTION_STATE_WAITING) {
+      iree_vm_wait_backoff(wait_attempts++);
+    } else {
+      wait_attempts = 0;
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_pool_t
+//===----------------------------------------------------------------------===//
+
+struct iree_vm_invocation_pool {
+  iree_atomic_intptr_t ref_count;
+  iree_allocator_t allocator;
+
+  // Guards the queues and shutdown flag.
+  iree_vm_mutex_t mutex;
+  // Signaled when invocations are queued or the pool is shutting down.
+  iree_vm_cond_t work_cond;
+  bool shutdown;
+  // FIFO of retained invocations that are pending or have yielded.
+  iree_vm_invocation_t* queue_head;
+  iree_vm_invocation_t* queue_tail;
+  // Unordered list of retained invocations waiting on asynchronous imports.
+  // Each is polled by resuming it once its resume_time has elapsed.
+  iree_vm_invocation_t* waiting_head;
+
+  iree_host_size_t worker_count;
+  iree_vm_thread_t workers[];
+};
+
+// Appends |invocation| to the pool queue, transferring the caller reference.
+// Must be called with the pool mutex held.
+static void iree_vm_invocation_pool_enqueue_locked(
+    iree_vm_invocation_pool_t* pool, iree_vm_invocation_t* invocation) {
+  invocation->next = NULL;
+  if (pool->queue_tail) {
+    pool->queue_tail->next = invocation;
+  } else {
+    pool->queue_head = invocation;
+  }
+  pool->queue_tail = invocation;
+  iree_vm_cond_signal(&pool->work_cond);
+}
+
+// Returns the next invocation to run, blocking until one is available.
+// Waiting invocations that are due to be polled are taken before queued ones
+// so that a stream of yielding invocations cannot starve them.
+// Returns NULL if the pool is shutting down.
+// Must be called with the pool mutex held.
+static iree_vm_invocation_t* iree_vm_invocation_pool_dequeue_locked(
+    iree_vm_invocation_pool_t* pool) {
+  while (!pool->shutdown) {
+    iree_time_t wake_time = IREE_TIME_INFINITE_FUTURE;
+    if (pool->waiting_head) {
+      iree_time_t now = iree_time_now();
+      iree_vm_invocation_t** prev_next = &pool->waiting_head;
+      for (iree_vm_invocation_t* invocation = pool->waiting_head; invocation;
+           prev_next = &invocation->next, invocation = invocation->next) {
+        if (invocation->resume_time <= now) {
+          *prev_next = invocation->next;
+          invocation->next = NULL;
+          return invocation;
+        }
+        if (invocation->resume_time < wake_time) {
+          wake_time = invocation->resume_time;
+        }
+      }
+    }
+    iree_vm_invocation_t* invocation = pool->queue_head;
+    if (invocation) {
+      pool->queue_head = invocation->next;
+      if (!pool->queue_head) pool->queue_tail = NULL;
+      invocation->next = NULL;
+      return invocation;
+    }
+    iree_vm_cond_wait_until(&pool->work_cond, &pool->mutex, wake_time);
+  }
+  return NULL;
+}
+
+static void iree_vm_invocation_pool_worker_main(
+    iree_vm_invocation_pool_t* pool) {
+  while (true) {
+    iree_vm_mutex_lock(&pool->mutex);
+    iree_vm_invocation_t* invocation =
+        iree_vm_invocation_pool_dequeue_locked(pool);
+    iree_vm_mutex_unlock(&pool->mutex);
+    if (!invocation) break;  // shutdown
+
+    iree_vm_execution_state_t state = iree_vm_invocation_step(invocation);
+    if (state == IREE_VM_EXECUTION_STATE_COMPLETE) {
+      // Drop the reference held by the queue.
+      iree_vm_invocation_release(invocation);
+      continue;
+    }
+
+    // Suspended; hand the queue reference back to the pool so that other
+    // invocations can run on this worker in the meantime.
+    iree_vm_mutex_lock(&pool->mutex);
+    if (pool->shutdown) {
+      iree_vm_mutex_unlock(&pool->mutex);
+      iree_vm_invocation_finish(
+          invocation, iree_make_status(IREE_STATUS_ABORTED,
+                                       "invocation pool destroyed"));
+      iree_vm_invocation_release(invocation);
+      continue;
+    }
+    if (state == IREE_VM_EXECUTION_STATE_WAITING) {
+      invocation->resume_time =
+          iree_time_now() +
+          iree_vm_wait_backoff_duration(invocation->wait_attempts++);
+      invocation->next = pool->waiting_head;
+      pool->waiting_head = invocation;
+    } else {
+      invocation->wait_attempts = 0;
+      iree_vm_invocation_pool_enqueue_locked(pool, invocation);
+    }
+    iree_vm_mutex_unlock(&pool->mutex);
+  }
+}
+
+// Aborts and releases all invocations in the |list| taken from the pool.
+static void iree_vm_invocation_pool_abort_list(iree_vm_invocation_t* list) {
+  while (list) {
+    iree_vm_invocation_t* invocation = list;
+    list = invocation->next;
+    invocation->next = NULL;
+    iree_vm_mutex_lock(&invocation->mutex);
+    iree_vm_invocation_state_t state = invocation->state;
+    if (state == IREE_VM_INVOCATION_STATE_PENDING) {
+      iree_vm_invocation_complete_locked(
+          invocation, iree_make_status(IREE_STATUS_ABORTED,
+                                       "invocation pool destroyed"));
+    }
+    iree_vm_mutex_unlock(&invocation->mutex);
+    if (state == IREE_VM_INVOCATION_STATE_RUNNING) {
+      // Suspended while running; unwind its stack.
+      iree_vm_invocation_finish(
+          invocation, iree_make_status(IREE_STATUS_ABORTED,
+                                       "invocation pool destroyed"));
+    }
+    iree_vm_invocation_release(invocation);
+  }
+}
+
+// Stops all workers after aborting any invocations still pending or suspended.
+static void iree_vm_invocation_pool_shutdown(iree_vm_invocation_pool_t* pool,
+                                             iree_host_size_t worker_count) {
+  iree_vm_mutex_lock(&pool->mutex);
+  pool->shutdown = true;
+  iree_vm_invocation_t* pending_list = pool->queue_head;
+  iree_vm_invocation_t* waiting_list = pool->waiting_head;
+  pool->queue_head = pool->queue_tail = NULL;
+  pool->waiting_head = NULL;
+  iree_vm_cond_broadcast(&pool->work_cond);
+  iree_vm_mutex_unlock(&pool->mutex);
+
+  iree_vm_invocation_pool_abort_list(pending_list);
+  iree_vm_invocation_pool_abort_list(waiting_list);
+
+  for (iree_host_size_t i = 0; i < worker_count; ++i) {
+    iree_vm_thread_join(pool->workers[i]);
+  }
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_pool_create(
+    iree_host_size_t worker_count, iree_allocator_t allocator,
+    iree_vm_invocation_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  if (worker_count == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invocation pools require at least one worker");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_invocation_pool_t* pool = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      allocator, sizeof(*pool) + worker_count * sizeof(pool->workers[0]),
+      (void**)&pool);
+  if (!iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  iree_atomic_store(&pool->ref_count, 1);
+  pool->allocator = allocator;
+  iree_vm_mutex_initialize(&pool->mutex);
+  iree_vm_cond_initialize(&pool->work_cond);
+  pool->shutdown = false;
+  pool->queue_head = pool->queue_tail = NULL;
+  pool->waiting_head = NULL;
+  pool->worker_count = worker_count;
+
+  iree_host_size_t started_count = 0;
+  for (; started_count < worker_count; ++started_count) {
+    status = iree_vm_thread_create(pool, &pool->workers[started_count]);
+    if (!iree_status_is_ok(status)) break;
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_vm_invocation_pool_shutdown(pool, started_count);
+    iree_vm_cond_deinitialize(&pool->work_cond);
+    iree_vm_mutex_deinitialize(&pool->mutex);
+    iree_allocator_free(allocator, pool);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  *out_pool = pool;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_vm_invocation_pool_destroy(iree_vm_invocation_pool_t* pool) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_invocation_pool_shutdown(pool, pool->worker_count);
+  iree_vm_cond_deinitialize(&pool->work_cond);
+  iree_vm_mutex_deinitialize(&pool->mutex);
+  iree_allocator_free(pool->allocator, pool);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_invocation_pool_retain(iree_vm_invocation_pool_t* pool) {
+  if (pool) {
+    iree_atomic_fetch_add(&pool->ref_count, 1);
+  }
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_invocation_pool_release(iree_vm_invocation_pool_t* pool) {
+  if (pool && iree_atomic_fetch_sub(&pool->ref_count, 1) == 1) {
+    iree_vm_invocation_pool_destroy(pool);
+  }
+}
+
+// Appends |invocation| to the pool queue, retaining it until it is executed.
+static iree_status_t iree_vm_invocation_pool_enqueue(
+    iree_vm_invocation_pool_t* pool, iree_vm_invocation_t* invocation) {
+  iree_vm_mutex_lock(&pool->mutex);
+  if (pool->shutdown) {
+    iree_vm_mutex_unlock(&pool->mutex);
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "invocation pool is shutting down");
+  }
+  iree_vm_invocation_retain(invocation);
+  iree_vm_invocation_pool_enqueue_locked(pool, invocation);
+  iree_vm_mutex_unlock(&pool->mutex);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_t API
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
+    iree_allocator_t allocator, iree_vm_invocation_t** out_invocation) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_invocation);
+  *out_invocation = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_list_t* outputs = NULL;
+  iree_status_t status = iree_vm_list_create(
+      /*element_type=*/NULL, /*initial_capacity=*/0, allocator, &outputs);
+  iree_vm_invocation_t* invocation = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(allocator, sizeof(*invocation),
+                                   (void**)&invocation);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_vm_list_release(outputs);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_atomic_store(&invocation->ref_count, 1);
+  invocation->allocator = allocator;
+  invocation->context = context;
+  iree_vm_context_retain(context);
+  invocation->function = function;
+  // The input list is only read during marshaling but retaining it requires
+  // a mutable pointer.
+  invocation->inputs = (iree_vm_list_t*)inputs;
+  iree_vm_list_retain(invocation->inputs);
+  invocation->outputs = outputs;
+  invocation->deadline = policy ? policy->deadline : IREE_TIME_INFINITE_FUTURE;
+  invocation->next = NULL;
+  invocation->wait_attempts = 0;
+  invocation->resume_time = IREE_TIME_INFINITE_PAST;
+  invocation->stack = NULL;
+  invocation->async_waits = policy && policy->pool;
+  memset(&invocation->signature, 0, sizeof(invocation->signature));
+  invocation->cconv_results = iree_string_view_empty();
+  memset(&invocation->call, 0, sizeof(invocation->call));
+  iree_vm_mutex_initialize(&invocation->mutex);
+  iree_vm_cond_initialize(&invocation->completion_cond);
+  invocation->state = IREE_VM_INVOCATION_STATE_PENDING;
+  invocation->abort_requested = false;
+  invocation->status = iree_ok_status();
+
+  if (policy && policy->pool) {
+    status = iree_vm_invocation_pool_enqueue(policy->pool, invocation);
+  } else {
+    iree_vm_invocation_execute(invocation);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_invocation = invocation;
+  } else {
+    iree_vm_invocation_release(invocation);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_retain(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  iree_atomic_fetch_add(&invocation->ref_count, 1);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_release(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (iree_atomic_fetch_sub(&invocation->ref_count, 1) == 1) {
+    iree_vm_invocation_destroy(invocation);
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_query_status(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  iree_status_t status = iree_ok_status();
+  iree_vm_mutex_lock(&invocation->mutex);
+  if (invocation->state != IREE_VM_INVOCATION_STATE_COMPLETE) {
+    status = iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+  } else if (!iree_status_is_ok(invocation->status)) {
+    status = iree_status_clone(invocation->status);
+  }
+  iree_vm_mutex_unlock(&invocation->mutex);
+  return status;
+}
+
+IREE_API_EXPORT const iree_vm_list_t* IREE_API_CALL
+iree_vm_invocation_output(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  iree_vm_mutex_lock(&invocation->mutex);
+  bool succeeded = invocation->state == IREE_VM_INVOCATION_STATE_COMPLETE &&
+                   iree_status_is_ok(invocation->status);
+  iree_vm_mutex_unlock(&invocation->mutex);
+  return succeeded ? invocation->outputs : NULL;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_await(
+    iree_vm_invocation_t* invocation, iree_time_t deadline) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_mutex_lock(&invocation->mutex);
+  while (invocation->state != IREE_VM_INVOCATION_STATE_COMPLETE) {
+    if (!iree_vm_cond_wait_until(&invocation->completion_cond,
+                                 &invocation->mutex, deadline)) {
+      break;
+    }
+  }
+  bool completed = invocation->state == IREE_VM_INVOCATION_STATE_COMPLETE;
+  iree_vm_mutex_unlock(&invocation->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  if (!completed) {
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+  return iree_vm_invocation_query_status(invocation);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_abort(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  iree_vm_mutex_lock(&invocation->mutex);
+  switch (invocation->state) {
+    case IREE_VM_INVOCATION_STATE_PENDING:
+      // Still queued; the worker that dequeues it will skip it.
+      iree_vm_invocation_complete_locked(
+          invocation,
+          iree_make_status(IREE_STATUS_ABORTED, "invocation aborted"));
+      break;
+    case IREE_VM_INVOCATION_STATE_RUNNING:
+      // We can't preempt the VM; unwind the next time it is resumed or discard
+      // the results when it returns.
+      invocation->abort_requested = true;
+      break;
+    default:
+      break;
+  }
+  iree_vm_mutex_unlock(&invocation->mutex);
+  return iree_ok_status();
+}
@@ -27,9 +27,77 @@ extern "C" {
 #endif  // __cplusplus
 
 typedef struct iree_vm_invocation iree_vm_invocation_t;
-typedef struct iree_vm_invocation_policy iree_vm_invocation_policy_t;
+typedef struct iree_vm_invocation_pool iree_vm_invocation_pool_t;
+typedef struct iree_vm_invoker iree_vm_invoker_t;
+
+// Controls how an invocation is scheduled relative to other invocations.
+typedef struct iree_vm_invocation_policy {
+  // Pool of worker threads used to execute asynchronous invocations created
+  // with iree_vm_invocation_create. When NULL the invocation is executed on the
+  // calling thread before iree_vm_invocation_create returns.
+  iree_vm_invocation_pool_t* pool;
+
+  // Absolute deadline by which the invocation must have started executing.
+  // Invocations still pending when the deadline elapses complete with
+  // IREE_STATUS_DEADLINE_EXCEEDED without running. Use
+  // IREE_TIME_INFINITE_FUTURE to disable.
+  //
+  // The deadline is only checked when a worker dequeues the invocation to
+  // begin it. It is not checked at VM yield points (loop back-edges, calls)
+  // or when a suspended invocation is resumed: once a function has started
+  // it runs to completion even if the deadline elapses. Callers that need to
+  // bound the total latency should use the deadline passed to
+  // iree_vm_invocation_await and iree_vm_invocation_abort.
+  iree_time_t deadline;
+} iree_vm_invocation_policy_t;
+
+// Returns a default policy that executes invocations on the calling thread
+// without a deadline.
+static inline iree_vm_invocation_policy_t iree_vm_invocation_policy_default() {
+  iree_vm_invocation_policy_t policy;
+  policy.pool = NULL;
+  policy.deadline = IREE_TIME_INFINITE_FUTURE;
+  return policy;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_pool_t
+//===----------------------------------------------------------------------===//
+
+// Creates a pool of |worker_count| threads that execute queued invocations in
+// FIFO order. Each invocation owns its own VM stack so any number of
+// invocations against the same context may be in flight at once; functions
+// invoked concurrently must be safe to run concurrently (such as not racing on
+// mutable module globals).
+//
+// Invocations are multiplexed onto the workers: an invocation that yields
+// (vm.yield) is requeued behind other runnable invocations and one that is
+// waiting on an asynchronous import (such as hal.semaphore.await) is parked
+// and polled with a bounded backoff, freeing its worker in the meantime.
+//
+// The pool retains all queued invocations and releasing the pool will block
+// until any running invocations have suspended or completed. Invocations that
+// are still pending or suspended when the pool is destroyed complete with
+// IREE_STATUS_ABORTED.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_pool_create(
+    iree_host_size_t worker_count, iree_allocator_t allocator,
+    iree_vm_invocation_pool_t** out_pool);
+
+// Retains the given |pool| for the caller.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_invocation_pool_retain(iree_vm_invocation_pool_t* pool);
+
+// Releases the given |pool| from the caller.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_invocation_pool_release(iree_vm_invocation_pool_t* pool);
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invoke
+//===----------------------------------------------------------------------===//
 
 // Synchronously invokes a function in the VM.
+// Should the function yield or wait it is resumed on the calling thread until
+// it completes.
 //
 // |policy| is used to schedule the invocation relative to other pending or
 // in-flight invocations. It may be omitted to leave the behavior up to the
@@ -42,12 +110,79 @@ typedef struct iree_vm_invocation_policy iree_vm_invocation_policy_t;
 // |outputs| is populated after the function completes execution with the
 // output values and objects of the function. List ownership remains with the
 // caller.
+//
+// Callers invoking the same function repeatedly should prefer
+// iree_vm_invoker_t to avoid per-call setup.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy, iree_vm_list_t* inputs,
     iree_vm_list_t* outputs, iree_allocator_t allocator);
 
-// TODO(benvanik): document and implement.
+// Synchronously issues |call| on |stack| and runs it to completion on the
+// calling thread. For use by callers that cannot suspend themselves, such as
+// modules generated by the VM C target calling their imports.
+//
+// Imports called are asked to block instead of deferring. Calls that still
+// defer are retried, and calls that yield or wait are resumed until complete,
+// with the same backoff iree_vm_invoke uses.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_call_until_complete(iree_vm_stack_t* stack,
+                            const iree_vm_function_call_t* call,
+                            iree_vm_execution_result_t* out_result);
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invoker_t
+//===----------------------------------------------------------------------===//
+
+// Creates a reusable invoker that synchronously invokes |function| in
+// |context| each time iree_vm_invoker_invoke is called.
+//
+// The invoker holds everything iree_vm_invoke otherwise rebuilds per call: a
+// marshaling plan precomputed from the calling convention so that no cconv
+// string is parsed per call, the ABI argument/result buffers, and a VM stack
+// that keeps any growth from prior calls. Steady-state invocations of the same
+// function perform no allocations beyond those made by the function itself.
+//
+// Invokers are not thread-safe; use one per thread that invokes the function.
+//
+// |out_invoker| must be released by the caller.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoker_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_allocator_t allocator, iree_vm_invoker_t** out_invoker);
+
+// Retains the given |invoker| for the caller.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_invoker_retain(iree_vm_invoker_t* invoker);
+
+// Releases the given |invoker| from the caller.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_invoker_release(iree_vm_invoker_t* invoker);
+
+// Synchronously invokes the function of |invoker| as with iree_vm_invoke.
+// Should the function yield or wait it is resumed on the calling thread until
+// it completes.
+//
+// |inputs| must match the signature of the function and |outputs| is resized
+// to hold the results. List ownership remains with the caller.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invoker_invoke(iree_vm_invoker_t* invoker, iree_vm_list_t* inputs,
+                       iree_vm_list_t* outputs);
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_t
+//===----------------------------------------------------------------------===//
+
+// Asynchronously invokes a function in the VM.
+//
+// When |policy| specifies a pool the invocation is queued on it and this
+// returns immediately; otherwise it executes on the calling thread prior to
+// returning. Use iree_vm_invocation_await to wait for completion and
+// iree_vm_invocation_output to access the results.
+//
+// |inputs| is retained by the invocation until it completes and must not be
+// modified by the caller while the invocation is pending.
+//
+// |out_invocation| must be released by the caller.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
@@ -89,6 +224,11 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_await(
 
 // Attempts to abort the invocation if it is in-flight.
 // A no-op if the invocation has already completed.
+//
+// Pending invocations are removed from their pool without running. Functions
+// that have already begun executing are not preempted; they are unwound the
+// next time they are resumed after suspending or run to completion and have
+// their results discarded, with the invocation reporting IREE_STATUS_ABORTED.
 IREE_API_EXPORT iree_status_t IREE_API_CALL
 iree_vm_invocation_abort(iree_vm_invocation_t* invocation);
 
@@ -17,12 +17,13 @@
 #include "iree/base/alignment.h"
 
 // Size of each iree_vm_value_type_t in bytes.
-static const iree_host_size_t kValueTypeSizes[5] = {
+static const iree_host_size_t kValueTypeSizes[6] = {
     0,  // IREE_VM_VALUE_TYPE_NONE
     1,  // IREE_VM_VALUE_TYPE_I8
     2,  // IREE_VM_VALUE_TYPE_I16
     4,  // IREE_VM_VALUE_TYPE_I32
     8,  // IREE_VM_VALUE_TYPE_I64
+    4,  // IREE_VM_VALUE_TYPE_F32
 };
 static_assert(IREE_VM_VALUE_TYPE_COUNT ==
                   (sizeof(kValueTypeSizes) / sizeof(kValueTypeSizes[0])),
@@ -253,75 +254,117 @@ iree_vm_list_resize(iree_vm_list_t* list, iree_host_size_t new_size) {
   return iree_ok_status();
 }
 
-static void iree_vm_list_convert_value_type(
+// Converts |source_value| to |target_value_type|. Integers are sign-extended or
+// truncated and conversions between integers and floats are numeric (as with
+// the VM cast ops); floats outside of the range of an integer type saturate
+// and NaN converts to 0. Returns IREE_STATUS_INVALID_ARGUMENT if the types
+// cannot be converted.
+static iree_status_t iree_vm_list_convert_value_type(
     const iree_vm_value_t* source_value, iree_vm_value_type_t target_value_type,
     iree_vm_value_t* out_value) {
   if (target_value_type == source_value->type) {
     memcpy(out_value, source_value, sizeof(*out_value));
-    return;
+    return iree_ok_status();
   }
   out_value->type = target_value_type;
   out_value->i64 = 0;
   switch (source_value->type) {
     default:
-      return;
+      break;
     case IREE_VM_VALUE_TYPE_I8:
       switch (target_value_type) {
         case IREE_VM_VALUE_TYPE_I16:
           out_value->i16 = (int16_t)source_value->i8;
-          return;
+          return iree_ok_status();
         case IREE_VM_VALUE_TYPE_I32:
           out_value->i32 = (int32_t)source_value->i8;
-          return;
+          return iree_ok_status();
         case IREE_VM_VALUE_TYPE_I64:
           out_value->i64 = (int64_t)source_value->i8;
-          return;
+          return iree_ok_status();
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i8;
+          return iree_ok_status();
         default:
-          return;
+          break;
       }
+      break;
     case IREE_VM_VALUE_TYPE_I16:
       switch (target_value_type) {
         case IREE_VM_VALUE_TYPE_I8:
           out_value->i8 = (int8_t)source_value->i16;
-          return;
+          return iree_ok_status();
         case IREE_VM_VALUE_TYPE_I32:
           out_value->i32 = (int32_t)source_value->i16;
-          return;
+          return iree_ok_status();
         case IREE_VM_VALUE_TYPE_I64:
           out_value->i64 = (int64_t)source_value->i16;
-          return;
+          return iree_ok_status();
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i16;
+          return iree_ok_status();
         default:
-          return;
+          break;
       }
+      break;
     case IREE_VM_VALUE_TYPE_I32:
       switch (target_value_type) {
         case IREE_VM_VALUE_TYPE_I8:
           out_value->i8 = (int8_t)source_value->i32;
-          return;
+          return iree_ok_status();
         case IREE_VM_VALUE_TYPE_I16:
           out_value->i16 = (int16_t)source_value->i32;
-          return;
+          return iree_ok_status();
         case IREE_VM_VALUE_TYPE_I64:
           out_value->i64 = (int64_t)source_value->i32;
-          return;
+          return iree_ok_status();
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i32;
+          return iree_ok_status();
         default:
-          return;
+          break;
       }
+      break;
     case IREE_VM_VALUE_TYPE_I64:
       switch (target_value_type) {
         case IREE_VM_VALUE_TYPE_I8:
           out_value->i8 = (int8_t)source_value->i64;
-          return;
+          return iree_ok_status();
         case IREE_VM_VALUE_TYPE_I16:
           out_value->i16 = (int16_t)source_value->i64;
-          return;
+          return iree_ok_status();
         case IREE_VM_VALUE_TYPE_I32:
           out_value->i32 = (int32_t)source_value->i64;
-          return;
+          return iree_ok_status();
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i64;
+          return iree_ok_status();
         default:
-          return;
+          break;
       }
+      break;
+    case IREE_VM_VALUE_TYPE_F32:
+      switch (target_value_type) {
+        case IREE_VM_VALUE_TYPE_I8:
+          out_value->i8 = iree_vm_cast_f32_si8(source_value->f32);
+          return iree_ok_status();
+        case IREE_VM_VALUE_TYPE_I16:
+          out_value->i16 = iree_vm_cast_f32_si16(source_value->f32);
+          return iree_ok_status();
+        case IREE_VM_VALUE_TYPE_I32:
+          out_value->i32 = iree_vm_cast_f32_si32(source_value->f32);
+          return iree_ok_status();
+        case IREE_VM_VALUE_TYPE_I64:
+          out_value->i64 = iree_vm_cast_f32_si64(source_value->f32);
+          return iree_ok_status();
+        default:
+          break;
+      }
+      break;
   }
+  return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                          "cannot convert value of type %d to type %d",
+                          (int)source_value->type, (int)target_value_type);
 }
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL
@@ -415,8 +458,7 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_get_value_as(
       return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                               "list does not store values");
   }
-  iree_vm_list_convert_value_type(&value, value_type, out_value);
-  return iree_ok_status();
+  return iree_vm_list_convert_value_type(&value, value_type, out_value);
 }
 
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_set_value(
@@ -440,7 +482,8 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_set_value(
                               "list cannot store values");
   }
   iree_vm_value_t converted_value;
-  iree_vm_list_convert_value_type(value, target_type, &converted_value);
+  IREE_RETURN_IF_ERROR(
+      iree_vm_list_convert_value_type(value, target_type, &converted_value));
   uintptr_t element_ptr = (uintptr_t)list->storage + i * list->element_size;
   switch (list->storage_mode) {
     case IREE_VM_LIST_STORAGE_MODE_VALUE: {
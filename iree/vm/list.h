@@ -113,14 +113,17 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_get_value(
 
 // Returns the value of the element at the given index. If the specified
 // |value_type| differs from the list storage type the value will be converted
-// using the value type semantics (such as sign/zero extend, etc).
+// using the value type semantics (such as sign/zero extend, etc). Conversions
+// between integer and f32 values are numeric. Returns
+// IREE_STATUS_INVALID_ARGUMENT if the value cannot be converted.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_get_value_as(
     const iree_vm_list_t* list, iree_host_size_t i,
     iree_vm_value_type_t value_type, iree_vm_value_t* out_value);
 
 // Sets the value of the element at the given index. If the specified |value|
 // type differs from the list storage type the value will be converted using the
-// value type semantics (such as sign/zero extend, etc).
+// value type semantics (such as sign/zero extend, etc). Returns
+// IREE_STATUS_INVALID_ARGUMENT if the value cannot be converted.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_list_set_value(
     iree_vm_list_t* list, iree_host_size_t i, const iree_vm_value_t* value);
 
@@ -14,6 +14,8 @@
 
 #include "iree/vm/list.h"
 
+#include <limits>
+
 #include "iree/base/api.h"
 #include "iree/base/ref_ptr.h"
 #include "iree/testing/gtest.h"
@@ -116,6 +118,65 @@ TEST_F(VMListTest, UsageI32) {
   iree_vm_list_release(list);
 }
 
+// Tests that values are converted between integer and f32 storage and that
+// values of unknown type are rejected.
+TEST_F(VMListTest, ConvertValues) {
+  iree_vm_type_def_t element_type =
+      iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I32);
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_list_create(&element_type, 2, iree_allocator_system(), &list));
+  IREE_ASSERT_OK(iree_vm_list_resize(list, 2));
+
+  iree_vm_value_t f32_value = iree_vm_value_make_f32(-3.75f);
+  IREE_ASSERT_OK(iree_vm_list_set_value(list, 0, &f32_value));
+  iree_vm_value_t value;
+  IREE_ASSERT_OK(
+      iree_vm_list_get_value_as(list, 0, IREE_VM_VALUE_TYPE_I32, &value));
+  EXPECT_EQ(IREE_VM_VALUE_TYPE_I32, value.type);
+  EXPECT_EQ(-3, value.i32);
+  IREE_ASSERT_OK(
+      iree_vm_list_get_value_as(list, 0, IREE_VM_VALUE_TYPE_F32, &value));
+  EXPECT_EQ(IREE_VM_VALUE_TYPE_F32, value.type);
+  EXPECT_EQ(-3.0f, value.f32);
+
+  iree_vm_value_t none_value;
+  memset(&none_value, 0, sizeof(none_value));
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            iree_status_consume_code(
+                iree_vm_list_set_value(list, 1, &none_value)));
+  EXPECT_EQ(IREE_STATUS_INVALID_ARGUMENT,
+            iree_status_consume_code(iree_vm_list_get_value_as(
+                list, 1, IREE_VM_VALUE_TYPE_NONE, &value)));
+
+  iree_vm_list_release(list);
+}
+
+// Tests that f32 values that are NaN or out of range of the integer storage
+// type saturate instead of invoking undefined behavior.
+TEST_F(VMListTest, ConvertValuesSaturate) {
+  iree_vm_type_def_t element_type =
+      iree_vm_type_def_make_value_type(IREE_VM_VALUE_TYPE_I32);
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_list_create(&element_type, 3, iree_allocator_system(), &list));
+  IREE_ASSERT_OK(iree_vm_list_resize(list, 3));
+
+  const float f32_values[3] = {std::numeric_limits<float>::quiet_NaN(), 3.0e9f,
+                               -std::numeric_limits<float>::infinity()};
+  const int32_t i32_values[3] = {0, INT32_MAX, INT32_MIN};
+  for (int i = 0; i < 3; ++i) {
+    iree_vm_value_t f32_value = iree_vm_value_make_f32(f32_values[i]);
+    IREE_ASSERT_OK(iree_vm_list_set_value(list, i, &f32_value));
+    iree_vm_value_t value;
+    IREE_ASSERT_OK(
+        iree_vm_list_get_value_as(list, i, IREE_VM_VALUE_TYPE_I32, &value));
+    EXPECT_EQ(i32_values[i], value.i32);
+  }
+
+  iree_vm_list_release(list);
+}
+
 // Tests simple ref object list usage, mainly just for demonstration.
 // Stores ref object type A elements only, equivalent to `!vm.list<!vm.ref<A>>`.
 TEST_F(VMListTest, UsageRef) {
@@ -204,6 +204,7 @@ typedef struct {
 
 #define IREE_VM_CCONV_TYPE_INT32 'i'
 #define IREE_VM_CCONV_TYPE_INT64 'I'
+#define IREE_VM_CCONV_TYPE_FLOAT32 'f'
 #define IREE_VM_CCONV_TYPE_REF 'r'
 #define IREE_VM_CCONV_TYPE_SPAN_START '['
 #define IREE_VM_CCONV_TYPE_SPAN_END ']'
@@ -245,14 +246,25 @@ IREE_API_EXPORT void IREE_API_CALL
 iree_vm_function_call_release(iree_vm_function_call_t* call,
                               const iree_vm_function_signature_t* signature);
 
+// Describes how execution of a call stopped.
+enum iree_vm_execution_state_e {
+  // The call ran to completion and its results have been written.
+  IREE_VM_EXECUTION_STATE_COMPLETE = 0,
+  // The call voluntarily yielded (such as with vm.yield) and may be resumed
+  // immediately.
+  IREE_VM_EXECUTION_STATE_YIELDED = 1,
+  // The call is waiting on an asynchronous import that returned
+  // IREE_STATUS_DEFERRED. Resuming retries the import and may return WAITING
+  // again if the import still cannot make progress.
+  IREE_VM_EXECUTION_STATE_WAITING = 2,
+};
+typedef uint32_t iree_vm_execution_state_t;
+
 // Results of an iree_vm_module_execute request.
 typedef struct {
-  // TODO(benvanik): yield information.
-  // Yield modes:
-  // - yield (yield instruction)
-  // - await (with 1+ wait handles)
-  // - break
-  int reserved;
+  // State of the call when execution returned to the caller. Any state other
+  // than COMPLETE requires one or more calls to resume_call on the same stack.
+  iree_vm_execution_state_t state;
 } iree_vm_execution_result_t;
 
 // Defines an interface that can be used to reflect and execute functions on a
@@ -308,12 +320,14 @@ typedef struct iree_vm_module {
 
   // Begins a function call with the given |call| arguments.
   // Execution may yield in the case of asynchronous code and require one or
-  // more calls to the resume method to complete.
+  // more calls to the resume method to complete. The results buffer of |call|
+  // must remain valid until the call completes.
   iree_status_t(IREE_API_PTR* begin_call)(
       void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
       iree_vm_execution_result_t* out_result);
 
   // Resumes execution of a previously-yielded call.
+  // Execution continues from the top frame of |stack| and may yield again.
   iree_status_t(IREE_API_PTR* resume_call)(
       void* self, iree_vm_stack_t* stack,
       iree_vm_execution_result_t* out_result);
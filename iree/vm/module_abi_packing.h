@@ -579,6 +579,34 @@ struct DispatchFunctor {
   }
 };
 
+// A DispatchFunctor specialization for methods that take the calling stack as
+// their first parameter. The stack is not part of the calling convention.
+template <typename Owner, typename Results, typename... Params>
+struct DispatchFunctorWithStack {
+  using FnPtr = StatusOr<Results> (Owner::*)(iree_vm_stack_t*, Params...);
+
+  static Status Call(void (Owner::*ptr)(), Owner* self, iree_vm_stack_t* stack,
+                     const iree_vm_function_call_t* call,
+                     iree_vm_execution_result_t* out_result) {
+    IREE_ASSIGN_OR_RETURN(
+        auto params, impl::Unpacker::LoadSequence<Params...>(call->arguments));
+    IREE_ASSIGN_OR_RETURN(
+        auto results,
+        ApplyFn(reinterpret_cast<FnPtr>(ptr), self, stack, std::move(params),
+                std::make_index_sequence<sizeof...(Params)>()));
+    impl::result_ptr_t result_ptr = call->results.data;
+    impl::ResultPack<Results>::Store(result_ptr, std::move(results));
+    return OkStatus();
+  }
+
+  template <typename T, size_t... I>
+  static StatusOr<Results> ApplyFn(FnPtr ptr, Owner* self,
+                                   iree_vm_stack_t* stack, T&& params,
+                                   std::index_sequence<I...>) {
+    return (self->*ptr)(stack, std::move(std::get<I>(params))...);
+  }
+};
+
 // A DispatchFunctor specialization for methods with no return values.
 template <typename Owner, typename... Params>
 struct DispatchFunctorVoid {
@@ -623,6 +651,20 @@ constexpr NativeFunction<Owner> MakeNativeFunction(
           &dispatch_functor_t::Call};
 }
 
+// Overload for methods that need the calling stack, such as to check
+// iree_vm_stack_async_waits before deferring.
+template <typename Owner, typename Result, typename... Params>
+constexpr NativeFunction<Owner> MakeNativeFunction(
+    absl::string_view name,
+    StatusOr<Result> (Owner::*fn)(iree_vm_stack_t*, Params...)) {
+  using dispatch_functor_t =
+      packing::DispatchFunctorWithStack<Owner, Result, Params...>;
+  return {{name.data(), name.size()},
+          packing::cconv_storage<Result, Params...>::value(),
+          (void (Owner::*)())fn,
+          &dispatch_functor_t::Call};
+}
+
 template <typename Owner, typename... Params>
 constexpr NativeFunction<Owner> MakeNativeFunction(
     absl::string_view name, Status (Owner::*fn)(Params...)) {
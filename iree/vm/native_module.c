@@ -271,6 +271,7 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_resolve_import(
 static iree_status_t IREE_API_PTR iree_vm_native_module_begin_call(
     void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
     iree_vm_execution_result_t* out_result) {
+  memset(out_result, 0, sizeof(*out_result));
   iree_vm_native_module_t* module = (iree_vm_native_module_t*)self;
   if (IREE_UNLIKELY(call->function.linkage !=
                     IREE_VM_FUNCTION_LINKAGE_EXPORT) ||
@@ -302,6 +303,8 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_begin_call(
   iree_status_t status = function_ptr->shim(stack, call, function_ptr->target,
                                             module, module_state, out_result);
   if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+    // Leave the frame so that a caller can reissue deferred calls.
+    IREE_IGNORE_ERROR(iree_vm_stack_function_leave(stack));
     iree_string_view_t module_name = iree_vm_native_module_name(module);
     iree_string_view_t function_name = iree_string_view_empty();
     iree_status_ignore(iree_vm_native_module_get_export_function(
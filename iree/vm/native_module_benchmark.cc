@@ -12,9 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <array>
+
 #include "benchmark/benchmark.h"
 #include "iree/base/api.h"
 #include "iree/base/logging.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
 #include "iree/vm/module.h"
 #include "iree/vm/native_module.h"
 #include "iree/vm/native_module_test.h"
@@ -22,6 +26,67 @@
 
 namespace {
 
-// TODO(benvanik): native module benchmarks.
+// Benchmarks calling the given (i32)->i32 function through the module
+// interface in the same way as imports are called from other modules.
+static iree_status_t RunFunction(benchmark::State& state,
+                                 iree_string_view_t function_name,
+                                 int batch_size = 1) {
+  iree_vm_instance_t* instance = NULL;
+  IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
+
+  iree_vm_module_t* module_a = NULL;
+  IREE_CHECK_OK(module_a_create(iree_allocator_system(), &module_a));
+  iree_vm_module_t* module_b = NULL;
+  IREE_CHECK_OK(module_b_create(iree_allocator_system(), &module_b));
+
+  std::array<iree_vm_module_t*, 2> modules = {module_a, module_b};
+  iree_vm_context_t* context = NULL;
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      instance, modules.data(), modules.size(), iree_allocator_system(),
+      &context));
+
+  iree_vm_function_t function;
+  IREE_CHECK_OK(
+      iree_vm_context_resolve_function(context, function_name, &function));
+
+  int32_t arg0 = 1;
+  int32_t ret0 = 0;
+  iree_vm_function_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.function = function;
+  call.arguments = iree_make_byte_span(&arg0, sizeof(arg0));
+  call.results = iree_make_byte_span(&ret0, sizeof(ret0));
+
+  IREE_VM_INLINE_STACK_INITIALIZE(
+      stack, iree_vm_context_state_resolver(context), iree_allocator_system());
+  while (state.KeepRunningBatch(batch_size)) {
+    iree_vm_execution_result_t result;
+    IREE_CHECK_OK(function.module->begin_call(function.module->self, stack,
+                                              &call, &result));
+    benchmark::DoNotOptimize(ret0);
+  }
+  iree_vm_stack_deinitialize(stack);
+
+  iree_vm_module_release(module_a);
+  iree_vm_module_release(module_b);
+  iree_vm_context_release(context);
+  iree_vm_instance_release(instance);
+
+  return iree_ok_status();
+}
+
+// Measures the cost of a single native function call.
+static void BM_CallNativeFunc(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, iree_make_cstring_view("module_a.add_1")));
+}
+BENCHMARK(BM_CallNativeFunc);
+
+// Measures the cost of a native function calling two imported native
+// functions.
+static void BM_CallNativeFuncWithImports(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, iree_make_cstring_view("module_b.entry"),
+                            /*batch_size=*/3));
+}
+BENCHMARK(BM_CallNativeFuncWithImports);
 
 }  // namespace
@@ -235,12 +235,18 @@ class NativeModule {
         /*frame_cleanup_fn=*/nullptr, &callee_frame));
 
     auto* state = FromStatePointer(callee_frame->module_state);
-    IREE_RETURN_IF_ERROR(info.call(info.ptr, state, stack, call, out_result),
-                         "while invoking C++ function %s.%.*s", module->name_,
-                         (int)info.name.size, info.name.data);
+    Status status = info.call(info.ptr, state, stack, call, out_result);
+    if (IREE_UNLIKELY(!status.ok())) {
+      // Leave the frame so that a caller can reissue deferred calls.
+      IREE_IGNORE_ERROR(iree_vm_stack_function_leave(stack));
+      // Deferrals are control flow and not errors and must not be annotated.
+      if (status.code() == StatusCode::kDeferred) return status.release();
+      IREE_RETURN_IF_ERROR(std::move(status),
+                           "while invoking C++ function %s.%.*s", module->name_,
+                           (int)info.name.size, info.name.data);
+    }
 
     return iree_vm_stack_function_leave(stack);
-    ;
   }
 
   const char* name_;
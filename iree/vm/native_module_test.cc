@@ -26,9 +26,25 @@
 namespace iree {
 namespace {
 
-// Test suite that uses module_a and module_b defined in native_module_test.h.
-// Both modules are put in a context and the module_b.entry function can be
-// executed with RunFunction.
+// Forwards to the system allocator while counting allocations.
+struct CountingAllocator {
+  static iree_status_t Alloc(void* self, iree_allocation_mode_t mode,
+                             iree_host_size_t byte_length, void** out_ptr) {
+    ++static_cast<CountingAllocator*>(self)->allocation_count;
+    return iree_allocator_system_allocate(nullptr, mode, byte_length, out_ptr);
+  }
+  static void Free(void* self, void* ptr) {
+    iree_allocator_system_free(nullptr, ptr);
+  }
+
+  iree_allocator_t allocator() { return {this, Alloc, Free}; }
+
+  int allocation_count = 0;
+};
+
+// Test suite that uses the modules defined in native_module_test.h.
+// All modules are put in a context and their functions (such as module_b.entry)
+// can be executed with RunFunction.
 class VMNativeModuleTest : public ::testing::Test {
  protected:
   virtual void SetUp() {
@@ -40,11 +56,13 @@ class VMNativeModuleTest : public ::testing::Test {
     IREE_CHECK_OK(module_a_create(iree_allocator_system(), &module_a));
     iree_vm_module_t* module_b = nullptr;
     IREE_CHECK_OK(module_b_create(iree_allocator_system(), &module_b));
+    iree_vm_module_t* module_c = nullptr;
+    IREE_CHECK_OK(module_c_create(iree_allocator_system(), &module_c));
 
     // Create the context with both modules and perform runtime linkage.
     // Imports from module_a -> module_b will be resolved and per-context state
     // will be allocated.
-    std::vector<iree_vm_module_t*> modules = {module_a, module_b};
+    std::vector<iree_vm_module_t*> modules = {module_a, module_b, module_c};
     IREE_CHECK_OK(iree_vm_context_create_with_modules(
         instance_, modules.data(), modules.size(), iree_allocator_system(),
         &context_));
@@ -52,6 +70,7 @@ class VMNativeModuleTest : public ::testing::Test {
     // No longer need the modules as the context retains them.
     iree_vm_module_release(module_a);
     iree_vm_module_release(module_b);
+    iree_vm_module_release(module_c);
   }
 
   virtual void TearDown() {
@@ -65,8 +84,7 @@ class VMNativeModuleTest : public ::testing::Test {
     // multiple calls will be made.
     iree_vm_function_t function;
     IREE_RETURN_IF_ERROR(
-        iree_vm_context_resolve_function(
-            context_, iree_make_cstring_view("module_b.entry"), &function),
+        iree_vm_context_resolve_function(context_, function_name, &function),
         "unable to resolve entry point");
 
     // Setup I/O lists and pass in the argument. The result list will be
@@ -94,6 +112,89 @@ class VMNativeModuleTest : public ::testing::Test {
     return ret0_value.i32;
   }
 
+  // Creates a reusable invoker for |function_name| along with I/O lists that
+  // are reused across calls. All are allocated from |allocator|. The invoker
+  // must be released by the caller.
+  StatusOr<iree_vm_invoker_t*> CreateInvoker(
+      iree_string_view_t function_name, iree_allocator_t allocator,
+      iree_vm_list_t** out_input_list, iree_vm_list_t** out_output_list) {
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_context_resolve_function(context_, function_name, &function),
+        "unable to resolve entry point");
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                             allocator, out_input_list));
+    IREE_RETURN_IF_ERROR(iree_vm_list_resize(*out_input_list, 1));
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                             allocator, out_output_list));
+    iree_vm_invoker_t* invoker = nullptr;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_invoker_create(context_, function, allocator, &invoker));
+    return invoker;
+  }
+
+  // Like RunFunction but invokes the function of |invoker| with the lists
+  // returned from CreateInvoker.
+  StatusOr<int32_t> RunInvoker(iree_vm_invoker_t* invoker,
+                               iree_vm_list_t* input_list,
+                               iree_vm_list_t* output_list, int32_t arg0) {
+    auto arg0_value = iree_vm_value_make_i32(arg0);
+    IREE_RETURN_IF_ERROR(iree_vm_list_set_value(input_list, 0, &arg0_value));
+    IREE_RETURN_IF_ERROR(
+        iree_vm_invoker_invoke(invoker, input_list, output_list));
+    iree_vm_value_t ret0_value;
+    IREE_RETURN_IF_ERROR(iree_vm_list_get_value(output_list, 0, &ret0_value));
+    return ret0_value.i32;
+  }
+
+  // Like RunFunction but issues an asynchronous invocation with |policy|.
+  StatusOr<int32_t> RunFunctionAsync(
+      iree_string_view_t function_name, int32_t arg0,
+      const iree_vm_invocation_policy_t& policy) {
+    IREE_ASSIGN_OR_RETURN(iree_vm_invocation_t * invocation,
+                          BeginFunctionAsync(function_name, arg0, policy));
+    return AwaitFunctionAsync(invocation);
+  }
+
+  // Issues an asynchronous invocation with |policy| and returns it without
+  // waiting for it to complete. Must be passed to AwaitFunctionAsync.
+  StatusOr<iree_vm_invocation_t*> BeginFunctionAsync(
+      iree_string_view_t function_name, int32_t arg0,
+      const iree_vm_invocation_policy_t& policy) {
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_context_resolve_function(context_, function_name, &function),
+        "unable to resolve entry point");
+
+    vm::ref<iree_vm_list_t> input_list;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(
+        /*element_type=*/nullptr, 1, iree_allocator_system(), &input_list));
+    auto arg0_value = iree_vm_value_make_i32(arg0);
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_push_value(input_list.get(), &arg0_value));
+
+    iree_vm_invocation_t* invocation = nullptr;
+    IREE_RETURN_IF_ERROR(iree_vm_invocation_create(
+        context_, function, &policy, input_list.get(), iree_allocator_system(),
+        &invocation));
+    return invocation;
+  }
+
+  // Waits for and releases an |invocation| from BeginFunctionAsync.
+  StatusOr<int32_t> AwaitFunctionAsync(iree_vm_invocation_t* invocation) {
+    Status status =
+        iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_FUTURE);
+    iree_vm_value_t ret0_value;
+    if (status.ok()) {
+      status = iree_vm_list_get_value(
+          const_cast<iree_vm_list_t*>(iree_vm_invocation_output(invocation)),
+          0, &ret0_value);
+    }
+    IREE_IGNORE_ERROR(iree_vm_invocation_release(invocation));
+    IREE_RETURN_IF_ERROR(status);
+    return ret0_value.i32;
+  }
+
  private:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_context_t* context_ = nullptr;
@@ -111,5 +212,111 @@ TEST_F(VMNativeModuleTest, Example) {
   ASSERT_EQ(v2, 8);
 }
 
+// Tests that calls through a warmed-up invoker do not allocate.
+TEST_F(VMNativeModuleTest, ReusedInvoker) {
+  CountingAllocator counting_allocator;
+  vm::ref<iree_vm_list_t> input_list;
+  vm::ref<iree_vm_list_t> output_list;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      iree_vm_invoker_t * invoker,
+      CreateInvoker(iree_make_cstring_view("module_b.entry"),
+                    counting_allocator.allocator(), &input_list,
+                    &output_list));
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v0, RunInvoker(invoker, input_list.get(), output_list.get(), 1));
+  ASSERT_EQ(v0, 1);
+  int allocation_count = counting_allocator.allocation_count;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v1, RunInvoker(invoker, input_list.get(), output_list.get(), 2));
+  ASSERT_EQ(v1, 4);
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v2, RunInvoker(invoker, input_list.get(), output_list.get(), 3));
+  ASSERT_EQ(v2, 8);
+  EXPECT_EQ(allocation_count, counting_allocator.allocation_count);
+  iree_vm_invoker_release(invoker);
+}
+
+// Tests that calls that suspend through a warmed-up invoker do not allocate.
+TEST_F(VMNativeModuleTest, ReusedInvokerSuspending) {
+  CountingAllocator counting_allocator;
+  vm::ref<iree_vm_list_t> input_list;
+  vm::ref<iree_vm_list_t> output_list;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      iree_vm_invoker_t * invoker,
+      CreateInvoker(iree_make_cstring_view("module_c.countdown"),
+                    counting_allocator.allocator(), &input_list,
+                    &output_list));
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v0, RunInvoker(invoker, input_list.get(), output_list.get(), 0));
+  ASSERT_EQ(v0, 0);
+  int allocation_count = counting_allocator.allocation_count;
+  for (int32_t i = 1; i < 4; ++i) {
+    IREE_ASSERT_OK_AND_ASSIGN(
+        int32_t v, RunInvoker(invoker, input_list.get(), output_list.get(), i));
+    ASSERT_EQ(v, i);
+  }
+  EXPECT_EQ(allocation_count, counting_allocator.allocation_count);
+  iree_vm_invoker_release(invoker);
+}
+
+TEST_F(VMNativeModuleTest, AsyncInvocation) {
+  iree_vm_invocation_pool_t* pool = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_pool_create(
+      /*worker_count=*/2, iree_allocator_system(), &pool));
+  iree_vm_invocation_policy_t policy = iree_vm_invocation_policy_default();
+  policy.pool = pool;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v0,
+      RunFunctionAsync(iree_make_cstring_view("module_b.entry"), 1, policy));
+  ASSERT_EQ(v0, 1);
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v1,
+      RunFunctionAsync(iree_make_cstring_view("module_b.entry"), 2, policy));
+  ASSERT_EQ(v1, 4);
+  iree_vm_invocation_pool_release(pool);
+}
+
+TEST_F(VMNativeModuleTest, AsyncInvocationDeadlineElapsed) {
+  iree_vm_invocation_pool_t* pool = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_pool_create(
+      /*worker_count=*/1, iree_allocator_system(), &pool));
+  iree_vm_invocation_policy_t policy = iree_vm_invocation_policy_default();
+  policy.pool = pool;
+  policy.deadline = IREE_TIME_INFINITE_PAST;
+  EXPECT_TRUE(IsDeadlineExceeded(
+      RunFunctionAsync(iree_make_cstring_view("module_b.entry"), 1, policy)
+          .status()));
+  iree_vm_invocation_pool_release(pool);
+}
+
+TEST_F(VMNativeModuleTest, SuspendingInvocation) {
+  // Synchronous invocations resume the function on the calling thread.
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v0, RunFunction(iree_make_cstring_view("module_c.countdown"), 5));
+  ASSERT_EQ(v0, 5);
+}
+
+TEST_F(VMNativeModuleTest, AsyncSuspendingInvocations) {
+  // A single worker multiplexes all of the invocations as they suspend.
+  iree_vm_invocation_pool_t* pool = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_pool_create(
+      /*worker_count=*/1, iree_allocator_system(), &pool));
+  iree_vm_invocation_policy_t policy = iree_vm_invocation_policy_default();
+  policy.pool = pool;
+  std::vector<iree_vm_invocation_t*> invocations;
+  for (int32_t i = 0; i < 4; ++i) {
+    IREE_ASSERT_OK_AND_ASSIGN(
+        iree_vm_invocation_t * invocation,
+        BeginFunctionAsync(iree_make_cstring_view("module_c.countdown"), i * 3,
+                           policy));
+    invocations.push_back(invocation);
+  }
+  for (int32_t i = 0; i < invocations.size(); ++i) {
+    IREE_ASSERT_OK_AND_ASSIGN(int32_t v, AwaitFunctionAsync(invocations[i]));
+    EXPECT_EQ(v, i * 3);
+  }
+  iree_vm_invocation_pool_release(pool);
+}
+
 }  // namespace
 }  // namespace iree
@@ -310,3 +310,87 @@ static iree_status_t module_b_create(iree_allocator_t allocator,
   return iree_vm_native_module_create(&interface, &module_b_descriptor_,
                                       allocator, out_module);
 }
+
+//===----------------------------------------------------------------------===//
+// module_c
+//===----------------------------------------------------------------------===//
+// A module that implements its own begin_call and resume_call to demonstrate
+// functions that suspend execution. The state of a suspended call is kept in
+// its frame storage on the VM stack so that it can be resumed on any thread.
+
+// Frame storage of module_c.countdown.
+typedef struct {
+  int32_t remaining;
+  int32_t value;
+  int32_t* out_ret0;
+} module_c_countdown_frame_t;
+
+// Runs module_c.countdown until it suspends or completes.
+static iree_status_t module_c_countdown_step(
+    iree_vm_stack_t* stack, iree_vm_execution_result_t* out_result) {
+  module_c_countdown_frame_t* frame_storage =
+      (module_c_countdown_frame_t*)iree_vm_stack_frame_storage(
+          iree_vm_stack_current_frame(stack));
+  if (frame_storage->remaining == 0) {
+    *frame_storage->out_ret0 = frame_storage->value;
+    out_result->state = IREE_VM_EXECUTION_STATE_COMPLETE;
+    return iree_vm_stack_function_leave(stack);
+  }
+  // Alternate between yielding and waiting.
+  out_result->state = (frame_storage->remaining-- % 2)
+                          ? IREE_VM_EXECUTION_STATE_YIELDED
+                          : IREE_VM_EXECUTION_STATE_WAITING;
+  return iree_ok_status();
+}
+
+// vm.import @module_c.countdown(%arg0 : i32) -> i32
+// Suspends |arg0| times before returning |arg0|.
+static iree_status_t IREE_API_PTR
+module_c_begin_call(void* self, iree_vm_stack_t* stack,
+                    const iree_vm_function_call_t* call,
+                    iree_vm_execution_result_t* out_result) {
+  iree_vm_stack_frame_t* callee_frame = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter(
+      stack, &call->function, IREE_VM_STACK_FRAME_NATIVE,
+      sizeof(module_c_countdown_frame_t), /*frame_cleanup_fn=*/NULL,
+      &callee_frame));
+  module_c_countdown_frame_t* frame_storage =
+      (module_c_countdown_frame_t*)iree_vm_stack_frame_storage(callee_frame);
+  memcpy(&frame_storage->value, call->arguments.data, sizeof(int32_t));
+  frame_storage->remaining = frame_storage->value;
+  frame_storage->out_ret0 = (int32_t*)call->results.data;
+  return module_c_countdown_step(stack, out_result);
+}
+
+static iree_status_t IREE_API_PTR
+module_c_resume_call(void* self, iree_vm_stack_t* stack,
+                     iree_vm_execution_result_t* out_result) {
+  return module_c_countdown_step(stack, out_result);
+}
+
+static const iree_vm_native_export_descriptor_t module_c_exports_[] = {
+    {iree_make_cstring_view("countdown"), iree_make_cstring_view("0i.i"), 0,
+     NULL},
+};
+static const iree_vm_native_module_descriptor_t module_c_descriptor_ = {
+    iree_make_cstring_view("module_c"),
+    0,
+    NULL,
+    IREE_ARRAYSIZE(module_c_exports_),
+    module_c_exports_,
+    0,
+    NULL,
+    0,
+    NULL,
+};
+
+static iree_status_t module_c_create(iree_allocator_t allocator,
+                                     iree_vm_module_t** out_module) {
+  // NOTE: this module has neither shared or per-context module state.
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, NULL));
+  interface.begin_call = module_c_begin_call;
+  interface.resume_call = module_c_resume_call;
+  return iree_vm_native_module_create(&interface, &module_c_descriptor_,
+                                      allocator, out_module);
+}
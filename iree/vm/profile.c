@@ -0,0 +1,369 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/vm/profile.h"
+
+#include <string.h>
+
+#include "iree/base/atomics.h"
+#include "iree/base/tracing.h"
+
+// Minimum capacity of the function table once the first function is entered.
+#define IREE_VM_PROFILE_MIN_FUNCTION_CAPACITY 16
+
+struct iree_vm_profile {
+  iree_atomic_intptr_t ref_count;
+  iree_allocator_t allocator;
+
+  // Held while recorders merge their counters into the profile. Merges are
+  // short and only happen when execution stops so a spin lock is sufficient.
+  iree_atomic_intptr_t merge_lock;
+
+  // Executed op counts indexed by [opcode_set * 256 + opcode].
+  uint64_t opcode_counts[IREE_VM_PROFILE_OPCODE_SET_COUNT * 256];
+
+  // Per-function counters in the order functions were first entered. Modules
+  // of all functions in the table are retained.
+  iree_host_size_t function_count;
+  iree_host_size_t function_capacity;
+  iree_vm_profile_function_stats_t* functions;
+
+  // Open-addressed hash table mapping functions to their index in |functions|.
+  // Each slot holds the index + 1 or 0 if empty. Always 2x |function_capacity|
+  // so that the load factor stays under 1/2.
+  int32_t* function_slots;
+};
+
+static void iree_vm_profile_lock(iree_vm_profile_t* profile) {
+  while (iree_atomic_exchange(&profile->merge_lock, 1)) {
+  }
+}
+
+static void iree_vm_profile_unlock(iree_vm_profile_t* profile) {
+  iree_atomic_store(&profile->merge_lock, 0);
+}
+
+static void iree_vm_profile_clear_functions(iree_vm_profile_t* profile) {
+  for (iree_host_size_t i = 0; i < profile->function_count; ++i) {
+    iree_vm_module_release(profile->functions[i].function.module);
+  }
+  profile->function_count = 0;
+  if (profile->function_slots) {
+    memset(profile->function_slots, 0,
+           2 * profile->function_capacity * sizeof(int32_t));
+  }
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_profile_create(
+    iree_allocator_t allocator, iree_vm_profile_t** out_profile) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT_ARGUMENT(out_profile);
+  *out_profile = NULL;
+
+  iree_vm_profile_t* profile = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(allocator, sizeof(*profile), (void**)&profile);
+  if (iree_status_is_ok(status)) {
+    memset(profile, 0, sizeof(*profile));
+    iree_atomic_store(&profile->ref_count, 1);
+    profile->allocator = allocator;
+    *out_profile = profile;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_vm_profile_destroy(iree_vm_profile_t* profile) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_profile_clear_functions(profile);
+  iree_allocator_free(profile->allocator, profile->functions);
+  iree_allocator_free(profile->allocator, profile->function_slots);
+  iree_allocator_free(profile->allocator, profile);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_retain(iree_vm_profile_t* profile) {
+  if (profile) {
+    iree_atomic_fetch_add(&profile->ref_count, 1);
+  }
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_release(iree_vm_profile_t* profile) {
+  if (profile && iree_atomic_fetch_sub(&profile->ref_count, 1) == 1) {
+    iree_vm_profile_destroy(profile);
+  }
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_reset(iree_vm_profile_t* profile) {
+  iree_vm_profile_lock(profile);
+  memset(profile->opcode_counts, 0, sizeof(profile->opcode_counts));
+  iree_vm_profile_clear_functions(profile);
+  iree_vm_profile_unlock(profile);
+}
+
+IREE_API_EXPORT uint64_t IREE_API_CALL
+iree_vm_profile_opcode_count(const iree_vm_profile_t* profile,
+                             iree_vm_profile_opcode_set_t opcode_set,
+                             uint8_t opcode) {
+  if (opcode_set >= IREE_VM_PROFILE_OPCODE_SET_COUNT) return 0;
+  return profile->opcode_counts[opcode_set * 256 + opcode];
+}
+
+IREE_API_EXPORT iree_host_size_t IREE_API_CALL
+iree_vm_profile_function_count(const iree_vm_profile_t* profile) {
+  return profile->function_count;
+}
+
+IREE_API_EXPORT const iree_vm_profile_function_stats_t* IREE_API_CALL
+iree_vm_profile_function_stats(const iree_vm_profile_t* profile,
+                               iree_host_size_t index) {
+  if (index >= profile->function_count) return NULL;
+  return &profile->functions[index];
+}
+
+static uint32_t iree_vm_profile_function_hash(
+    const iree_vm_function_t* function) {
+  uintptr_t module = (uintptr_t)function->module;
+  uint32_t hash = (uint32_t)(module >> 4) ^ (uint32_t)(module >> 32);
+  hash ^= ((uint32_t)function->linkage << 16) | function->ordinal;
+  // Finalizer from MurmurHash3 to spread the ordinal bits.
+  hash ^= hash >> 16;
+  hash *= 0x85EBCA6Bu;
+  hash ^= hash >> 13;
+  hash *= 0xC2B2AE35u;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+static bool iree_vm_profile_function_equal(const iree_vm_function_t* lhs,
+                                           const iree_vm_function_t* rhs) {
+  return lhs->module == rhs->module && lhs->linkage == rhs->linkage &&
+         lhs->ordinal == rhs->ordinal;
+}
+
+// Inserts |index| into the hash table slots of |profile|.
+static void iree_vm_profile_insert_slot(iree_vm_profile_t* profile,
+                                        int32_t index) {
+  iree_host_size_t slot_mask = 2 * profile->function_capacity - 1;
+  iree_host_size_t slot =
+      iree_vm_profile_function_hash(&profile->functions[index].function) &
+      slot_mask;
+  while (profile->function_slots[slot]) slot = (slot + 1) & slot_mask;
+  profile->function_slots[slot] = index + 1;
+}
+
+// Grows the function table of |profile| to hold at least one more function.
+static iree_status_t iree_vm_profile_grow_functions(
+    iree_vm_profile_t* profile) {
+  iree_host_size_t new_capacity =
+      profile->function_capacity ? profile->function_capacity * 2
+                                 : IREE_VM_PROFILE_MIN_FUNCTION_CAPACITY;
+  int32_t* new_slots = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      profile->allocator, 2 * new_capacity * sizeof(int32_t),
+      (void**)&new_slots));
+  iree_status_t status = iree_allocator_realloc(
+      profile->allocator,
+      new_capacity * sizeof(iree_vm_profile_function_stats_t),
+      (void**)&profile->functions);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(profile->allocator, new_slots);
+    return status;
+  }
+  iree_allocator_free(profile->allocator, profile->function_slots);
+  memset(new_slots, 0, 2 * new_capacity * sizeof(int32_t));
+  profile->function_slots = new_slots;
+  profile->function_capacity = new_capacity;
+  for (iree_host_size_t i = 0; i < profile->function_count; ++i) {
+    iree_vm_profile_insert_slot(profile, (int32_t)i);
+  }
+  return iree_ok_status();
+}
+
+// Returns the index of |function| in the function table of |profile|,
+// inserting it if it has not yet been entered.
+static iree_status_t iree_vm_profile_lookup_function(
+    iree_vm_profile_t* profile, const iree_vm_function_t* function,
+    int32_t* out_index) {
+  if (profile->function_capacity) {
+    iree_host_size_t slot_mask = 2 * profile->function_capacity - 1;
+    iree_host_size_t slot = iree_vm_profile_function_hash(function) & slot_mask;
+    while (profile->function_slots[slot]) {
+      int32_t index = profile->function_slots[slot] - 1;
+      if (iree_vm_profile_function_equal(&profile->functions[index].function,
+                                         function)) {
+        *out_index = index;
+        return iree_ok_status();
+      }
+      slot = (slot + 1) & slot_mask;
+    }
+  }
+
+  if (profile->function_count == profile->function_capacity) {
+    IREE_RETURN_IF_ERROR(iree_vm_profile_grow_functions(profile));
+  }
+  int32_t index = (int32_t)profile->function_count++;
+  iree_vm_profile_function_stats_t* stats = &profile->functions[index];
+  memset(stats, 0, sizeof(*stats));
+  stats->function = *function;
+  iree_vm_module_retain(stats->function.module);
+  iree_vm_profile_insert_slot(profile, index);
+  *out_index = index;
+  return iree_ok_status();
+}
+
+// Adds the counters in |source| to |target| and clears them in |source|.
+// Functions in |source| keep their indices so that recorders referencing them
+// remain valid.
+static void iree_vm_profile_merge(iree_vm_profile_t* target,
+                                  iree_vm_profile_t* source) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_profile_lock(target);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(source->opcode_counts);
+       ++i) {
+    target->opcode_counts[i] += source->opcode_counts[i];
+  }
+  memset(source->opcode_counts, 0, sizeof(source->opcode_counts));
+  for (iree_host_size_t i = 0; i < source->function_count; ++i) {
+    iree_vm_profile_function_stats_t* source_stats = &source->functions[i];
+    if (!source_stats->call_count && !source_stats->op_count &&
+        !source_stats->inclusive_time && !source_stats->exclusive_time) {
+      continue;
+    }
+    int32_t index = IREE_VM_PROFILE_FUNCTION_INDEX_NONE;
+    iree_status_t status = iree_vm_profile_lookup_function(
+        target, &source_stats->function, &index);
+    if (iree_status_is_ok(status)) {
+      iree_vm_profile_function_stats_t* target_stats =
+          &target->functions[index];
+      target_stats->call_count += source_stats->call_count;
+      target_stats->op_count += source_stats->op_count;
+      target_stats->inclusive_time += source_stats->inclusive_time;
+      target_stats->exclusive_time += source_stats->exclusive_time;
+    } else {
+      // Profiling is best-effort; the counters are dropped.
+      iree_status_ignore(status);
+    }
+    source_stats->call_count = 0;
+    source_stats->op_count = 0;
+    source_stats->inclusive_time = 0;
+    source_stats->exclusive_time = 0;
+  }
+  iree_vm_profile_unlock(target);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_vm_profile_recorder_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT void IREE_API_CALL iree_vm_profile_recorder_initialize(
+    iree_vm_profile_t* profile, iree_vm_profile_recorder_t* out_recorder) {
+  memset(out_recorder, 0, sizeof(*out_recorder));
+  out_recorder->function_index = IREE_VM_PROFILE_FUNCTION_INDEX_NONE;
+  if (!profile) return;
+  iree_vm_profile_t* local_profile = NULL;
+  iree_status_t status =
+      iree_vm_profile_create(profile->allocator, &local_profile);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return;
+  }
+  iree_vm_profile_retain(profile);
+  out_recorder->profile = profile;
+  out_recorder->local_profile = local_profile;
+  out_recorder->opcode_counts = local_profile->opcode_counts;
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_recorder_deinitialize(iree_vm_profile_recorder_t* recorder) {
+  if (!recorder->local_profile) return;
+  iree_vm_profile_merge(recorder->profile, recorder->local_profile);
+  iree_vm_profile_release(recorder->local_profile);
+  iree_vm_profile_release(recorder->profile);
+  memset(recorder, 0, sizeof(*recorder));
+  recorder->function_index = IREE_VM_PROFILE_FUNCTION_INDEX_NONE;
+}
+
+// Charges the time and ops since the last charge to the current function.
+static void iree_vm_profile_recorder_charge(
+    iree_vm_profile_recorder_t* recorder) {
+  iree_duration_t now = recorder->execution_time;
+  if (recorder->execution_depth > 0) {
+    now += iree_time_now() - recorder->execution_start_time;
+  }
+  if (recorder->function_index != IREE_VM_PROFILE_FUNCTION_INDEX_NONE) {
+    iree_vm_profile_function_stats_t* stats =
+        &recorder->local_profile->functions[recorder->function_index];
+    stats->exclusive_time += now - recorder->charge_time;
+    stats->op_count += recorder->pending_op_count;
+  }
+  recorder->pending_op_count = 0;
+  recorder->charge_time = now;
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_recorder_start(iree_vm_profile_recorder_t* recorder) {
+  if (recorder->execution_depth++ > 0) return;
+  recorder->execution_start_time = iree_time_now();
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_recorder_stop(iree_vm_profile_recorder_t* recorder) {
+  iree_vm_profile_recorder_charge(recorder);
+  if (--recorder->execution_depth > 0) return;
+  recorder->execution_time = recorder->charge_time;
+  iree_vm_profile_merge(recorder->profile, recorder->local_profile);
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_recorder_abort(iree_vm_profile_recorder_t* recorder) {
+  recorder->function_index = IREE_VM_PROFILE_FUNCTION_INDEX_NONE;
+  recorder->pending_op_count = 0;
+}
+
+IREE_API_EXPORT void IREE_API_CALL iree_vm_profile_recorder_enter(
+    iree_vm_profile_recorder_t* recorder, const iree_vm_function_t* function,
+    int32_t* out_function_index, int32_t* out_parent_index,
+    iree_duration_t* out_enter_time) {
+  iree_vm_profile_recorder_charge(recorder);
+  int32_t function_index = IREE_VM_PROFILE_FUNCTION_INDEX_NONE;
+  iree_status_t status = iree_vm_profile_lookup_function(
+      recorder->local_profile, function, &function_index);
+  if (iree_status_is_ok(status)) {
+    ++recorder->local_profile->functions[function_index].call_count;
+  } else {
+    // Profiling is best-effort; the function is dropped from the profile.
+    iree_status_ignore(status);
+  }
+  *out_function_index = function_index;
+  *out_parent_index = recorder->function_index;
+  *out_enter_time = recorder->charge_time;
+  recorder->function_index = function_index;
+}
+
+IREE_API_EXPORT void IREE_API_CALL iree_vm_profile_recorder_leave(
+    iree_vm_profile_recorder_t* recorder, int32_t function_index,
+    int32_t parent_index, iree_duration_t enter_time) {
+  iree_vm_profile_recorder_charge(recorder);
+  if (function_index != IREE_VM_PROFILE_FUNCTION_INDEX_NONE) {
+    recorder->local_profile->functions[function_index].inclusive_time +=
+        recorder->charge_time - enter_time;
+  }
+  recorder->function_index = parent_index;
+}
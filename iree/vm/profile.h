@@ -0,0 +1,229 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// See iree/base/api.h for documentation on the API conventions used.
+
+#ifndef IREE_VM_PROFILE_H_
+#define IREE_VM_PROFILE_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/vm/module.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Enables support for recording execution into an iree_vm_profile_t attached
+// to a VM stack. When disabled (the default) any attached profile is ignored
+// by the bytecode dispatcher and no per-op overhead is incurred. CMake builds
+// can enable it with -DIREE_ENABLE_VM_PROFILING=ON and Bazel builds with
+// --define=IREE_VM_PROFILING=1.
+#ifndef IREE_VM_PROFILING_ENABLE
+#define IREE_VM_PROFILING_ENABLE 0
+#endif  // IREE_VM_PROFILING_ENABLE
+
+// Bytecode opcode tables. Ops in extension tables are encoded with a prefix op
+// in the core table and share opcode values with other tables.
+enum {
+  IREE_VM_PROFILE_OPCODE_SET_CORE = 0,
+  IREE_VM_PROFILE_OPCODE_SET_EXT_I64 = 1,
+  IREE_VM_PROFILE_OPCODE_SET_EXT_F32 = 2,
+  IREE_VM_PROFILE_OPCODE_SET_COUNT = 3,
+};
+typedef uint32_t iree_vm_profile_opcode_set_t;
+
+// Execution counters for a single function.
+//
+// Times are measured in nanoseconds of wall time spent executing on a VM stack
+// and exclude any time the stack was suspended. Inclusive time covers the
+// function and all of its callees and is counted once per active frame; time in
+// recursive calls will be counted multiple times. Exclusive time covers only
+// the function itself and sums to the total profiled time across all functions.
+typedef struct {
+  // Function the counters are for. For imports this is the resolved callee.
+  iree_vm_function_t function;
+  // Total number of times the function was entered.
+  uint64_t call_count;
+  // Total number of bytecode ops executed within the function itself. Always
+  // 0 for native functions.
+  uint64_t op_count;
+  // Total time spent in the function including callees.
+  iree_duration_t inclusive_time;
+  // Total time spent in the function excluding callees.
+  iree_duration_t exclusive_time;
+} iree_vm_profile_function_stats_t;
+
+// Counters recorded while executing VM functions.
+//
+// A profile is attached to a context with iree_vm_context_set_profile and will
+// receive counters for all invocations made against the context. Counting is
+// done per bytecode opcode and per function, including imports called from
+// bytecode.
+//
+// Invocations recording into the same profile may run concurrently: each
+// stack counts into its own recorder and merges the counters into the profile
+// when execution on the stack stops. Queries and resets must not be made while
+// invocations recording into the profile are in-flight.
+typedef struct iree_vm_profile iree_vm_profile_t;
+
+// Creates a new empty profile.
+// |out_profile| must be released by the caller.
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_profile_create(
+    iree_allocator_t allocator, iree_vm_profile_t** out_profile);
+
+// Retains the given |profile| for the caller.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_retain(iree_vm_profile_t* profile);
+
+// Releases the given |profile| from the caller.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_release(iree_vm_profile_t* profile);
+
+// Clears all counters in |profile|.
+// Must not be called while an invocation recording into the profile is
+// in-flight.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_reset(iree_vm_profile_t* profile);
+
+// Returns the number of executed ops in |opcode_set| with the given |opcode|.
+IREE_API_EXPORT uint64_t IREE_API_CALL
+iree_vm_profile_opcode_count(const iree_vm_profile_t* profile,
+                             iree_vm_profile_opcode_set_t opcode_set,
+                             uint8_t opcode);
+
+// Returns the total number of functions with counters in |profile|.
+IREE_API_EXPORT iree_host_size_t IREE_API_CALL
+iree_vm_profile_function_count(const iree_vm_profile_t* profile);
+
+// Returns the counters of the function at |index| in |profile|. Functions are
+// ordered by when they were first entered. The returned pointer is only valid
+// until the next invocation recording into the profile.
+IREE_API_EXPORT const iree_vm_profile_function_stats_t* IREE_API_CALL
+iree_vm_profile_function_stats(const iree_vm_profile_t* profile,
+                               iree_host_size_t index);
+
+//===----------------------------------------------------------------------===//
+// iree_vm_profile_recorder_t
+//===----------------------------------------------------------------------===//
+// Used by module implementations to record execution into a profile. Each VM
+// stack with a profile attached has its own recorder that tracks the function
+// currently being charged with time and ops.
+//
+// Time is charged lazily at transitions (function entry and exit and the start
+// and end of execution) to whichever function was running since the previous
+// transition. Executed ops are accumulated in the recorder and charged along
+// with the time.
+
+// A sentinel function index used when no function is being charged.
+#define IREE_VM_PROFILE_FUNCTION_INDEX_NONE (-1)
+
+typedef struct {
+  // Profile receiving the counters when execution stops.
+  iree_vm_profile_t* profile;
+
+  // Profile private to the recorder that counters are accumulated in until
+  // they are merged into |profile|. Function indices are into this profile.
+  // NULL if the recorder is inactive.
+  iree_vm_profile_t* local_profile;
+
+  // Flattened [opcode_set * 256 + opcode] counter table within
+  // |local_profile|.
+  uint64_t* opcode_counts;
+
+  // Number of nested executions on the stack. The clock only runs while
+  // nonzero.
+  int32_t execution_depth;
+
+  // Time the outermost execution started.
+  iree_time_t execution_start_time;
+
+  // Total execution time prior to |execution_start_time|.
+  iree_duration_t execution_time;
+
+  // Execution time at which time was last charged.
+  iree_duration_t charge_time;
+
+  // Index of the function currently being charged or
+  // IREE_VM_PROFILE_FUNCTION_INDEX_NONE.
+  int32_t function_index;
+
+  // Ops executed since ops were last charged.
+  uint64_t pending_op_count;
+} iree_vm_profile_recorder_t;
+
+// Initializes |out_recorder| to record into |profile|.
+// Profiling is best-effort; if the recorder could not be allocated it is left
+// inactive and iree_vm_profile_recorder_is_active returns false.
+IREE_API_EXPORT void IREE_API_CALL iree_vm_profile_recorder_initialize(
+    iree_vm_profile_t* profile, iree_vm_profile_recorder_t* out_recorder);
+
+// Merges any remaining counters and deinitializes |recorder|.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_recorder_deinitialize(iree_vm_profile_recorder_t* recorder);
+
+// Returns true if |recorder| is recording into a profile.
+static inline bool iree_vm_profile_recorder_is_active(
+    const iree_vm_profile_recorder_t* recorder) {
+  return recorder->local_profile != NULL;
+}
+
+// Starts the clock when beginning execution on the stack of |recorder|.
+// Must be balanced with a call to iree_vm_profile_recorder_stop. Nested
+// executions (such as a native import calling back into bytecode) are counted
+// once.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_recorder_start(iree_vm_profile_recorder_t* recorder);
+
+// Stops the clock when execution on the stack of |recorder| completes or is
+// suspended and charges the current function. The current function is kept
+// such that it continues to be charged when execution is resumed. Stopping the
+// outermost execution merges the counters into the profile.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_recorder_stop(iree_vm_profile_recorder_t* recorder);
+
+// Stops charging the current function without recording its exit. Used when
+// the stack is unwound after a failure without leaving each frame normally.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_profile_recorder_abort(iree_vm_profile_recorder_t* recorder);
+
+// Records entry into |function| and begins charging it.
+// |out_function_index|, |out_parent_index|, and |out_enter_time| must be kept
+// by the caller and passed to iree_vm_profile_recorder_leave. If the function
+// cannot be tracked (out of memory) the function is not charged.
+IREE_API_EXPORT void IREE_API_CALL iree_vm_profile_recorder_enter(
+    iree_vm_profile_recorder_t* recorder, const iree_vm_function_t* function,
+    int32_t* out_function_index, int32_t* out_parent_index,
+    iree_duration_t* out_enter_time);
+
+// Records exit from the function previously entered with
+// iree_vm_profile_recorder_enter and resumes charging its parent.
+IREE_API_EXPORT void IREE_API_CALL iree_vm_profile_recorder_leave(
+    iree_vm_profile_recorder_t* recorder, int32_t function_index,
+    int32_t parent_index, iree_duration_t enter_time);
+
+// Counts one executed op of |opcode| in |opcode_set|.
+static inline void iree_vm_profile_recorder_count_op(
+    iree_vm_profile_recorder_t* recorder,
+    iree_vm_profile_opcode_set_t opcode_set, uint8_t opcode) {
+  ++recorder->opcode_counts[opcode_set * 256 + opcode];
+  ++recorder->pending_op_count;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_VM_PROFILE_H_
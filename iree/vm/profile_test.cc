@@ -0,0 +1,242 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/vm/profile.h"
+
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/module.h"
+
+namespace {
+
+class VMProfileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    destroy_count_ = 0;
+    IREE_CHECK_OK(iree_vm_module_initialize(&module_, this));
+    module_.destroy = +[](void* self) {
+      ++static_cast<VMProfileTest*>(self)->destroy_count_;
+    };
+    IREE_CHECK_OK(iree_vm_profile_create(iree_allocator_system(), &profile_));
+    iree_vm_profile_recorder_initialize(profile_, &recorder_);
+  }
+
+  void TearDown() override {
+    iree_vm_profile_recorder_deinitialize(&recorder_);
+    iree_vm_profile_release(profile_);
+    if (module_owned_) iree_vm_module_release(&module_);
+  }
+
+  iree_vm_function_t MakeFunction(uint16_t ordinal) {
+    return {&module_, IREE_VM_FUNCTION_LINKAGE_INTERNAL, ordinal};
+  }
+
+  // Finds the counters for |function| or returns nullptr if not present.
+  const iree_vm_profile_function_stats_t* FindStats(
+      const iree_vm_function_t& function) {
+    for (iree_host_size_t i = 0; i < iree_vm_profile_function_count(profile_);
+         ++i) {
+      auto* stats = iree_vm_profile_function_stats(profile_, i);
+      if (stats->function.module == function.module &&
+          stats->function.linkage == function.linkage &&
+          stats->function.ordinal == function.ordinal) {
+        return stats;
+      }
+    }
+    return nullptr;
+  }
+
+  iree_vm_module_t module_;
+  bool module_owned_ = true;
+  int destroy_count_ = 0;
+  iree_vm_profile_t* profile_ = nullptr;
+  iree_vm_profile_recorder_t recorder_;
+};
+
+// Tests that ops and calls are charged to the function executing them.
+TEST_F(VMProfileTest, NestedCalls) {
+  auto function_a = MakeFunction(0);
+  auto function_b = MakeFunction(1);
+
+  iree_vm_profile_recorder_start(&recorder_);
+  int32_t a_index, a_parent;
+  iree_duration_t a_time;
+  iree_vm_profile_recorder_enter(&recorder_, &function_a, &a_index, &a_parent,
+                                 &a_time);
+  iree_vm_profile_recorder_count_op(&recorder_,
+                                    IREE_VM_PROFILE_OPCODE_SET_CORE, 1);
+  for (int i = 0; i < 2; ++i) {
+    int32_t b_index, b_parent;
+    iree_duration_t b_time;
+    iree_vm_profile_recorder_enter(&recorder_, &function_b, &b_index,
+                                   &b_parent, &b_time);
+    EXPECT_EQ(a_index, b_parent);
+    iree_vm_profile_recorder_count_op(&recorder_,
+                                      IREE_VM_PROFILE_OPCODE_SET_EXT_I64, 2);
+    iree_vm_profile_recorder_leave(&recorder_, b_index, b_parent, b_time);
+  }
+  iree_vm_profile_recorder_count_op(&recorder_,
+                                    IREE_VM_PROFILE_OPCODE_SET_CORE, 1);
+  iree_vm_profile_recorder_leave(&recorder_, a_index, a_parent, a_time);
+  iree_vm_profile_recorder_stop(&recorder_);
+
+  EXPECT_EQ(IREE_VM_PROFILE_FUNCTION_INDEX_NONE, a_parent);
+  ASSERT_EQ(2, iree_vm_profile_function_count(profile_));
+  auto* stats_a = FindStats(function_a);
+  auto* stats_b = FindStats(function_b);
+  ASSERT_NE(nullptr, stats_a);
+  ASSERT_NE(nullptr, stats_b);
+  EXPECT_EQ(1, stats_a->call_count);
+  EXPECT_EQ(2, stats_a->op_count);
+  EXPECT_EQ(2, stats_b->call_count);
+  EXPECT_EQ(2, stats_b->op_count);
+  EXPECT_EQ(stats_a->inclusive_time,
+            stats_a->exclusive_time + stats_b->inclusive_time);
+  EXPECT_EQ(stats_b->inclusive_time, stats_b->exclusive_time);
+  EXPECT_EQ(2, iree_vm_profile_opcode_count(
+                   profile_, IREE_VM_PROFILE_OPCODE_SET_CORE, 1));
+  EXPECT_EQ(2, iree_vm_profile_opcode_count(
+                   profile_, IREE_VM_PROFILE_OPCODE_SET_EXT_I64, 2));
+  EXPECT_EQ(0, iree_vm_profile_opcode_count(
+                   profile_, IREE_VM_PROFILE_OPCODE_SET_EXT_I64, 1));
+}
+
+// Tests that time is not charged while execution is stopped (suspended).
+TEST_F(VMProfileTest, SuspendedTimeExcluded) {
+  auto function = MakeFunction(0);
+  iree_vm_profile_recorder_start(&recorder_);
+  int32_t index, parent;
+  iree_duration_t time;
+  iree_vm_profile_recorder_enter(&recorder_, &function, &index, &parent,
+                                 &time);
+  iree_vm_profile_recorder_stop(&recorder_);
+  auto* stats = FindStats(function);
+  ASSERT_NE(nullptr, stats);
+  iree_duration_t exclusive_time = stats->exclusive_time;
+
+  // Nothing is charged while stopped.
+  iree_time_t deadline = iree_time_now() + 1000000;
+  while (iree_time_now() < deadline) {
+  }
+  EXPECT_EQ(exclusive_time, FindStats(function)->exclusive_time);
+
+  iree_vm_profile_recorder_start(&recorder_);
+  iree_vm_profile_recorder_leave(&recorder_, index, parent, time);
+  iree_vm_profile_recorder_stop(&recorder_);
+  stats = FindStats(function);
+  EXPECT_LT(stats->inclusive_time, 1000000);
+  EXPECT_EQ(stats->inclusive_time, stats->exclusive_time);
+}
+
+// Tests that many functions can be tracked and are looked up consistently.
+TEST_F(VMProfileTest, ManyFunctions) {
+  iree_vm_profile_recorder_start(&recorder_);
+  for (int pass = 0; pass < 2; ++pass) {
+    for (uint16_t i = 0; i < 100; ++i) {
+      auto function = MakeFunction(i);
+      int32_t index, parent;
+      iree_duration_t time;
+      iree_vm_profile_recorder_enter(&recorder_, &function, &index, &parent,
+                                     &time);
+      EXPECT_EQ(i, index);
+      iree_vm_profile_recorder_leave(&recorder_, index, parent, time);
+    }
+  }
+  iree_vm_profile_recorder_stop(&recorder_);
+  ASSERT_EQ(100, iree_vm_profile_function_count(profile_));
+  for (uint16_t i = 0; i < 100; ++i) {
+    auto* stats = iree_vm_profile_function_stats(profile_, i);
+    EXPECT_EQ(i, stats->function.ordinal);
+    EXPECT_EQ(2, stats->call_count);
+  }
+}
+
+// Tests that resetting clears counters and releases modules.
+TEST_F(VMProfileTest, Reset) {
+  auto function = MakeFunction(0);
+  iree_vm_profile_recorder_start(&recorder_);
+  int32_t index, parent;
+  iree_duration_t time;
+  iree_vm_profile_recorder_enter(&recorder_, &function, &index, &parent,
+                                 &time);
+  iree_vm_profile_recorder_count_op(&recorder_,
+                                    IREE_VM_PROFILE_OPCODE_SET_CORE, 7);
+  iree_vm_profile_recorder_leave(&recorder_, index, parent, time);
+  iree_vm_profile_recorder_stop(&recorder_);
+  ASSERT_EQ(1, iree_vm_profile_function_count(profile_));
+
+  // The profile retains the module until reset.
+  iree_vm_profile_recorder_deinitialize(&recorder_);
+  iree_vm_module_release(&module_);
+  module_owned_ = false;
+  EXPECT_EQ(0, destroy_count_);
+  iree_vm_profile_reset(profile_);
+  EXPECT_EQ(1, destroy_count_);
+  EXPECT_EQ(0, iree_vm_profile_function_count(profile_));
+  EXPECT_EQ(0, iree_vm_profile_opcode_count(
+                   profile_, IREE_VM_PROFILE_OPCODE_SET_CORE, 7));
+}
+
+// Tests that recorders on multiple threads can share a profile.
+TEST_F(VMProfileTest, ConcurrentRecorders) {
+  constexpr int kThreadCount = 4;
+  constexpr int kCallCount = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([this, t]() {
+      iree_vm_profile_recorder_t recorder;
+      iree_vm_profile_recorder_initialize(profile_, &recorder);
+      auto shared_function = MakeFunction(0);
+      auto thread_function = MakeFunction(static_cast<uint16_t>(1 + t));
+      for (int i = 0; i < kCallCount; ++i) {
+        iree_vm_profile_recorder_start(&recorder);
+        int32_t a_index, a_parent;
+        iree_duration_t a_time;
+        iree_vm_profile_recorder_enter(&recorder, &shared_function, &a_index,
+                                       &a_parent, &a_time);
+        iree_vm_profile_recorder_count_op(&recorder,
+                                          IREE_VM_PROFILE_OPCODE_SET_CORE, 1);
+        int32_t b_index, b_parent;
+        iree_duration_t b_time;
+        iree_vm_profile_recorder_enter(&recorder, &thread_function, &b_index,
+                                       &b_parent, &b_time);
+        iree_vm_profile_recorder_leave(&recorder, b_index, b_parent, b_time);
+        iree_vm_profile_recorder_leave(&recorder, a_index, a_parent, a_time);
+        iree_vm_profile_recorder_stop(&recorder);
+      }
+      iree_vm_profile_recorder_deinitialize(&recorder);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  ASSERT_EQ(1 + kThreadCount, iree_vm_profile_function_count(profile_));
+  auto* shared_stats = FindStats(MakeFunction(0));
+  ASSERT_NE(nullptr, shared_stats);
+  EXPECT_EQ(kThreadCount * kCallCount, shared_stats->call_count);
+  EXPECT_EQ(kThreadCount * kCallCount, shared_stats->op_count);
+  for (int t = 0; t < kThreadCount; ++t) {
+    auto* thread_stats = FindStats(MakeFunction(static_cast<uint16_t>(1 + t)));
+    ASSERT_NE(nullptr, thread_stats);
+    EXPECT_EQ(kCallCount, thread_stats->call_count);
+  }
+  EXPECT_EQ(kThreadCount * kCallCount,
+            iree_vm_profile_opcode_count(profile_,
+                                         IREE_VM_PROFILE_OPCODE_SET_CORE, 1));
+}
+
+}  // namespace
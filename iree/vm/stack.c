@@ -125,6 +125,11 @@
 // but otherwise leave as small as we can to avoid overallocation.
 #define IREE_VM_STACK_GROWTH_FACTOR 2
 
+// Number of module states cached per stack. Contexts rarely have more than a
+// handful of modules so a small fully-associative cache covers nearly all
+// module transitions without querying the state resolver.
+#define IREE_VM_STACK_MODULE_STATE_CACHE_SIZE 4
+
 // A private stack frame header that allows us to walk the linked list of
 // frames without exposing their exact structure through the API. This makes it
 // easier for us to add/version additional information or hide implementation
@@ -183,9 +188,27 @@ struct iree_vm_stack {
   bool owns_frame_storage;
 
   // Resolves a module to a module state within a context.
-  // This will be called on function entry whenever module transitions occur.
+  // This will be called on function entry whenever module transitions occur
+  // and the module state is not found in |module_state_cache|.
   iree_vm_state_resolver_t state_resolver;
 
+  // Recently resolved module states. Entries are never invalidated as module
+  // states live as long as the context the stack resolves against. Replaced in
+  // round-robin order starting at |module_state_cache_next|.
+  struct {
+    iree_vm_module_t* module;
+    iree_vm_module_state_t* module_state;
+  } module_state_cache[IREE_VM_STACK_MODULE_STATE_CACHE_SIZE];
+  uint32_t module_state_cache_next;
+
+  // Profile receiving execution counters, if any, and the recorder tracking
+  // the function being charged on this stack.
+  iree_vm_profile_t* profile;
+  iree_vm_profile_recorder_t profile_recorder;
+
+  // True if imports may return IREE_STATUS_DEFERRED instead of blocking.
+  bool async_waits;
+
   // Allocator used for dynamic stack allocations. May be the null allocator
   // if growth is prohibited.
   iree_allocator_t allocator;
@@ -237,6 +260,10 @@ iree_vm_stack_deinitialize(iree_vm_stack_t* stack) {
     iree_status_ignore(iree_vm_stack_function_leave(stack));
   }
 
+  iree_vm_profile_recorder_deinitialize(&stack->profile_recorder);
+  iree_vm_profile_release(stack->profile);
+  stack->profile = NULL;
+
   if (stack->owns_frame_storage) {
     iree_allocator_free(stack->allocator, stack->frame_storage);
   }
@@ -293,8 +320,48 @@ iree_vm_stack_parent_frame(iree_vm_stack_t* stack) {
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_query_module_state(
     iree_vm_stack_t* stack, iree_vm_module_t* module,
     iree_vm_module_state_t** out_module_state) {
-  return stack->state_resolver.query_module_state(stack->state_resolver.self,
-                                                  module, out_module_state);
+  for (int i = 0; i < IREE_VM_STACK_MODULE_STATE_CACHE_SIZE; ++i) {
+    if (stack->module_state_cache[i].module == module && module) {
+      *out_module_state = stack->module_state_cache[i].module_state;
+      return iree_ok_status();
+    }
+  }
+  IREE_RETURN_IF_ERROR(stack->state_resolver.query_module_state(
+      stack->state_resolver.self, module, out_module_state));
+  uint32_t i = stack->module_state_cache_next;
+  stack->module_state_cache[i].module = module;
+  stack->module_state_cache[i].module_state = *out_module_state;
+  stack->module_state_cache_next =
+      (i + 1) % IREE_VM_STACK_MODULE_STATE_CACHE_SIZE;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_stack_set_profile(iree_vm_stack_t* stack, iree_vm_profile_t* profile) {
+  VMCHECK(!stack->top);
+  if (stack->profile == profile) return;
+  iree_vm_profile_retain(profile);
+  iree_vm_profile_release(stack->profile);
+  stack->profile = profile;
+  iree_vm_profile_recorder_deinitialize(&stack->profile_recorder);
+  iree_vm_profile_recorder_initialize(profile, &stack->profile_recorder);
+}
+
+IREE_API_EXPORT iree_vm_profile_recorder_t* IREE_API_CALL
+iree_vm_stack_profile_recorder(iree_vm_stack_t* stack) {
+  return iree_vm_profile_recorder_is_active(&stack->profile_recorder)
+             ? &stack->profile_recorder
+             : NULL;
+}
+
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_stack_set_async_waits(iree_vm_stack_t* stack, bool async_waits) {
+  stack->async_waits = async_waits;
+}
+
+IREE_API_EXPORT bool IREE_API_CALL
+iree_vm_stack_async_waits(const iree_vm_stack_t* stack) {
+  return stack->async_waits;
 }
 
 // Attempts to grow the stack store to hold at least |minimum_capacity|.
@@ -386,7 +453,8 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_function_enter(
   }
 
   // Try to reuse the same module state if the caller and callee are from the
-  // same module. Otherwise, query the state from the registered handler.
+  // same module. Otherwise, look the state up in the stack cache and only query
+  // the registered handler on a miss.
   iree_vm_stack_frame_header_t* caller_frame_header = stack->top;
   iree_vm_stack_frame_t* caller_frame =
       caller_frame_header ? &caller_frame_header->frame : NULL;
@@ -394,8 +462,8 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_function_enter(
   if (caller_frame && caller_frame->function.module == function->module) {
     module_state = caller_frame->module_state;
   } else if (function->module != NULL) {
-    IREE_RETURN_IF_ERROR(stack->state_resolver.query_module_state(
-        stack->state_resolver.self, function->module, &module_state));
+    IREE_RETURN_IF_ERROR(iree_vm_stack_query_module_state(
+        stack, function->module, &module_state));
   }
 
   // Bump pointer and get real stack pointer offsets.
@@ -439,5 +507,11 @@ iree_vm_stack_function_leave(iree_vm_stack_t* stack) {
   stack->frame_storage_size -= stack->top->frame_size;
   stack->top = stack->top->parent;
 
+  // Once the stack is empty no function is running regardless of whether the
+  // frames were left normally or unwound after a failure.
+  if (!stack->top && stack->profile) {
+    iree_vm_profile_recorder_abort(&stack->profile_recorder);
+  }
+
   return iree_ok_status();
 }
@@ -21,6 +21,7 @@
 #include "iree/base/alignment.h"
 #include "iree/base/api.h"
 #include "iree/vm/module.h"
+#include "iree/vm/profile.h"
 #include "iree/vm/ref.h"
 
 #ifdef __cplusplus
@@ -192,6 +193,33 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_stack_query_module_state(
     iree_vm_stack_t* stack, iree_vm_module_t* module,
     iree_vm_module_state_t** out_module_state);
 
+// Attaches |profile| to |stack| such that execution on the stack is recorded
+// into it. The profile is retained until the stack is deinitialized or another
+// profile is attached. Passing NULL detaches any existing profile. Must only be
+// called while the stack is empty.
+//
+// Counters are accumulated privately by the stack and merged into |profile|
+// each time execution on the stack stops, so any number of stacks may record
+// into the same profile concurrently.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_stack_set_profile(iree_vm_stack_t* stack, iree_vm_profile_t* profile);
+
+// Returns the recorder used by module implementations to record execution into
+// the profile attached to |stack| or NULL if no profile is attached.
+IREE_API_EXPORT iree_vm_profile_recorder_t* IREE_API_CALL
+iree_vm_stack_profile_recorder(iree_vm_stack_t* stack);
+
+// Sets whether imports called on |stack| may return IREE_STATUS_DEFERRED
+// instead of blocking while waiting on asynchronous work. Only callers that
+// can suspend the call and run other work until it is resumed (such as
+// iree_vm_invocation_pool_t workers) should enable this. Disabled by default.
+IREE_API_EXPORT void IREE_API_CALL
+iree_vm_stack_set_async_waits(iree_vm_stack_t* stack, bool async_waits);
+
+// Returns true if imports called on |stack| may defer instead of blocking.
+IREE_API_EXPORT bool IREE_API_CALL
+iree_vm_stack_async_waits(const iree_vm_stack_t* stack);
+
 // Enters into the given |function| and returns the callee stack frame.
 // May invalidate any pointers to stack frames and the only pointer that can be
 // assumed valid after return is the one in |out_callee_frame|.
@@ -186,6 +186,42 @@ TEST(VMStackTest, ModuleStateQueries) {
   iree_vm_stack_deinitialize(stack);
 }
 
+// Tests that module states are cached across module transitions.
+TEST(VMStackTest, ModuleStateCaching) {
+  iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, state_resolver,
+                                  iree_allocator_system());
+
+  module_a_state_resolve_count = 0;
+  module_b_state_resolve_count = 0;
+
+  // [A (queried), B (queried), A (cached), B (cached)]
+  iree_vm_function_t function_a = {MODULE_A_SENTINEL,
+                                   IREE_VM_FUNCTION_LINKAGE_INTERNAL, 0};
+  iree_vm_function_t function_b = {MODULE_B_SENTINEL,
+                                   IREE_VM_FUNCTION_LINKAGE_INTERNAL, 1};
+  for (int i = 0; i < 2; ++i) {
+    iree_vm_stack_frame_t* frame_a = nullptr;
+    IREE_EXPECT_OK(iree_vm_stack_function_enter(
+        stack, &function_a, IREE_VM_STACK_FRAME_NATIVE, 0, NULL, &frame_a));
+    EXPECT_EQ(MODULE_A_STATE_SENTINEL, frame_a->module_state);
+    iree_vm_stack_frame_t* frame_b = nullptr;
+    IREE_EXPECT_OK(iree_vm_stack_function_enter(
+        stack, &function_b, IREE_VM_STACK_FRAME_NATIVE, 0, NULL, &frame_b));
+    EXPECT_EQ(MODULE_B_STATE_SENTINEL, frame_b->module_state);
+  }
+  EXPECT_EQ(1, module_a_state_resolve_count);
+  EXPECT_EQ(1, module_b_state_resolve_count);
+
+  iree_vm_module_state_t* module_state = nullptr;
+  IREE_EXPECT_OK(iree_vm_stack_query_module_state(stack, MODULE_A_SENTINEL,
+                                                  &module_state));
+  EXPECT_EQ(MODULE_A_STATE_SENTINEL, module_state);
+  EXPECT_EQ(1, module_a_state_resolve_count);
+
+  iree_vm_stack_deinitialize(stack);
+}
+
 // Tests that module state query failures propagate to callers correctly.
 TEST(VMStackTest, ModuleStateQueryFailure) {
   iree_vm_state_resolver_t state_resolver = {
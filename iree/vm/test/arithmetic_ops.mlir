@@ -14,4 +14,58 @@ vm.module @arithmetic_ops {
     vm.return
   }
 
+  //===--------------------------------------------------------------------===//
+  // I32 Arithmetic with immediates
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_add_i32_imm
+  vm.func @test_add_i32_imm() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %c2 = vm.const.i32 2 : i32
+    %v = vm.add.i32 %c1dno, %c2 : i32
+    %c3 = vm.const.i32 3 : i32
+    vm.check.eq %v, %c3, "1+2=3" : i32
+    vm.return
+  }
+
+  vm.export @test_sub_i32_imm
+  vm.func @test_sub_i32_imm() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %c3 = vm.const.i32 3 : i32
+    %v = vm.sub.i32 %c1dno, %c3 : i32
+    %cn2 = vm.const.i32 -2 : i32
+    vm.check.eq %v, %cn2, "1-3=-2" : i32
+    vm.return
+  }
+
+  vm.export @test_mul_i32_imm
+  vm.func @test_mul_i32_imm() {
+    %c3 = vm.const.i32 3 : i32
+    %c3dno = iree.do_not_optimize(%c3) : i32
+    %cn2 = vm.const.i32 -2 : i32
+    %v = vm.mul.i32 %cn2, %c3dno : i32
+    %cn6 = vm.const.i32 -6 : i32
+    vm.check.eq %v, %cn6, "-2*3=-6" : i32
+    vm.return
+  }
+
+  vm.export @test_bitwise_i32_imm
+  vm.func @test_bitwise_i32_imm() {
+    %c240 = vm.const.i32 240 : i32
+    %c240dno = iree.do_not_optimize(%c240) : i32
+    %c60 = vm.const.i32 60 : i32
+    %v0 = vm.and.i32 %c240dno, %c60 : i32
+    %c48 = vm.const.i32 48 : i32
+    vm.check.eq %v0, %c48, "240&60=48" : i32
+    %v1 = vm.or.i32 %c240dno, %c60 : i32
+    %c252 = vm.const.i32 252 : i32
+    vm.check.eq %v1, %c252, "240|60=252" : i32
+    %v2 = vm.xor.i32 %c240dno, %c60 : i32
+    %c204 = vm.const.i32 204 : i32
+    vm.check.eq %v2, %c204, "240^60=204" : i32
+    vm.return
+  }
+
 }
@@ -0,0 +1,208 @@
+vm.module @arithmetic_ops_f32 {
+
+  //===--------------------------------------------------------------------===//
+  // F32 Arithmetic
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_add_f32
+  vm.func @test_add_f32() {
+    %c1 = vm.const.f32 1.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.add.f32 %c1dno, %c1dno : f32
+    %c2 = vm.const.f32 3.0 : f32
+    vm.check.eq %v, %c2, "1.5+1.5=3" : f32
+    vm.return
+  }
+
+  vm.export @test_sub_f32
+  vm.func @test_sub_f32() {
+    %c1 = vm.const.f32 3.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 2.5 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.sub.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 0.5 : f32
+    vm.check.eq %v, %c3, "3.0-2.5=0.5" : f32
+    vm.return
+  }
+
+  vm.export @test_mul_f32
+  vm.func @test_mul_f32() {
+    %c1 = vm.const.f32 2.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.mul.f32 %c1dno, %c1dno : f32
+    %c2 = vm.const.f32 6.25 : f32
+    vm.check.eq %v, %c2, "2.5*2.5=6.25" : f32
+    vm.return
+  }
+
+  vm.export @test_div_f32
+  vm.func @test_div_f32() {
+    %c1 = vm.const.f32 4.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 -2.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.div.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 -2.0 : f32
+    vm.check.eq %v, %c3, "4.0/-2.0=-2.0" : f32
+    vm.return
+  }
+
+  vm.export @test_rem_f32
+  vm.func @test_rem_f32() {
+    %c1 = vm.const.f32 -3.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 -2.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.rem.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 -1.0 : f32
+    vm.check.eq %v, %c3, "-3.0%-2.0=-1.0" : f32
+    vm.return
+  }
+
+  vm.export @test_abs_f32
+  vm.func @test_abs_f32() {
+    %c1 = vm.const.f32 -1.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.abs.f32 %c1dno : f32
+    %c2 = vm.const.f32 1.0 : f32
+    vm.check.eq %v, %c2, "abs(-1.0)=1.0" : f32
+    vm.return
+  }
+
+  vm.export @test_neg_f32
+  vm.func @test_neg_f32() {
+    %c1 = vm.const.f32 -1.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.neg.f32 %c1dno : f32
+    %c2 = vm.const.f32 1.0 : f32
+    vm.check.eq %v, %c2, "neg(-1.0)=1.0" : f32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // F32 Casting
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cast_si32_f32
+  vm.func @test_cast_si32_f32() {
+    %c1 = vm.const.i32 -2 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %v = vm.cast.si32.f32 %c1dno : i32 -> f32
+    %c2 = vm.const.f32 -2.0 : f32
+    vm.check.eq %v, %c2, "cast signed integer to a floating-point value" : f32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_si32
+  vm.func @test_cast_f32_si32() {
+    %c1 = vm.const.f32 -2.75 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.cast.f32.si32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 -2 : i32
+    vm.check.eq %v, %c2, "cast floating-point value to a signed integer" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_si32_nan
+  vm.func @test_cast_f32_si32_nan() {
+    %zero = vm.const.f32.zero : f32
+    %zerodno = iree.do_not_optimize(%zero) : f32
+    %nan = vm.div.f32 %zerodno, %zerodno : f32
+    %v = vm.cast.f32.si32 %nan : f32 -> i32
+    %c0 = vm.const.i32 0 : i32
+    vm.check.eq %v, %c0, "cast NaN to a signed integer" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_si32_saturate
+  vm.func @test_cast_f32_si32_saturate() {
+    %c1 = vm.const.f32 3.0e9 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v1 = vm.cast.f32.si32 %c1dno : f32 -> i32
+    %max = vm.const.i32 2147483647 : i32
+    vm.check.eq %v1, %max, "cast 3e9 to a signed integer" : i32
+    %c2 = vm.const.f32 -3.0e9 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v2 = vm.cast.f32.si32 %c2dno : f32 -> i32
+    %min = vm.const.i32 -2147483648 : i32
+    vm.check.eq %v2, %min, "cast -3e9 to a signed integer" : i32
+    %one = vm.const.f32 1.0 : f32
+    %onedno = iree.do_not_optimize(%one) : f32
+    %zero = vm.const.f32.zero : f32
+    %zerodno = iree.do_not_optimize(%zero) : f32
+    %inf = vm.div.f32 %onedno, %zerodno : f32
+    %v3 = vm.cast.f32.si32 %inf : f32 -> i32
+    vm.check.eq %v3, %max, "cast +inf to a signed integer" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_ui32
+  vm.func @test_cast_f32_ui32() {
+    %c1 = vm.const.f32 2.75 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v1 = vm.cast.f32.ui32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 2 : i32
+    vm.check.eq %v1, %c2, "cast 2.75 to an unsigned integer" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_ui32_saturate
+  vm.func @test_cast_f32_ui32_saturate() {
+    %c1 = vm.const.f32 -1.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v1 = vm.cast.f32.ui32 %c1dno : f32 -> i32
+    %c0 = vm.const.i32 0 : i32
+    vm.check.eq %v1, %c0, "cast -1.5 to an unsigned integer" : i32
+    %c2 = vm.const.f32 5.0e9 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v2 = vm.cast.f32.ui32 %c2dno : f32 -> i32
+    %max = vm.const.i32 -1 : i32
+    vm.check.eq %v2, %max, "cast 5e9 to an unsigned integer" : i32
+    %zero = vm.const.f32.zero : f32
+    %zerodno = iree.do_not_optimize(%zero) : f32
+    %nan = vm.div.f32 %zerodno, %zerodno : f32
+    %v3 = vm.cast.f32.ui32 %nan : f32 -> i32
+    vm.check.eq %v3, %c0, "cast NaN to an unsigned integer" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // F32 Comparison
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lt_f32
+  vm.func @test_cmp_lt_f32() {
+    %c1 = vm.const.f32 -2.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 2.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %actual = vm.cmp.lt.f32 %c1dno, %c2dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "-2.0 < 2.0" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gte_f32
+  vm.func @test_cmp_gte_f32() {
+    %c1 = vm.const.f32 -2.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 2.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %actual = vm.cmp.gte.f32 %c1dno, %c2dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "-2.0 >= 2.0" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_nz_f32
+  vm.func @test_cmp_nz_f32() {
+    %c1 = vm.const.f32 -0.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %actual = vm.cmp.nz.f32 %c1dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "-0.0 is zero" : i32
+    vm.return
+  }
+
+}
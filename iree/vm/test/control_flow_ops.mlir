@@ -41,4 +41,80 @@ vm.module @control_flow_ops {
     vm.return
   }
 
+  //===--------------------------------------------------------------------===//
+  // vm.yield
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_yield
+  vm.func @test_yield() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    vm.yield
+    vm.check.eq %c1, %c1dno, "registers changed across yield" : i32
+    vm.return
+  }
+
+  vm.export @test_yield_in_callee
+  vm.func @test_yield_in_callee() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %0 = vm.call @_yield_and_return(%c1dno) : (i32) -> i32
+    vm.check.eq %0, %c1, "result changed across yield" : i32
+    vm.return
+  }
+
+  vm.func @_yield_and_return(%arg0 : i32) -> i32 {
+    vm.yield
+    vm.return %arg0 : i32
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cond_br with comparisons
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cond_br_cmp_loop
+  vm.func @test_cond_br_cmp_loop() {
+    %c0 = vm.const.i32 0 : i32
+    %c1 = vm.const.i32 1 : i32
+    %c10 = vm.const.i32 10 : i32
+    %c10dno = iree.do_not_optimize(%c10) : i32
+    vm.br ^loop(%c0, %c0 : i32, i32)
+  ^loop(%i : i32, %sum : i32):
+    %sum_next = vm.add.i32 %sum, %i : i32
+    %i_next = vm.add.i32 %i, %c1 : i32
+    %cmp = vm.cmp.lt.i32.s %i_next, %c10dno : i32
+    vm.cond_br %cmp, ^loop(%i_next, %sum_next : i32, i32),
+                     ^exit(%sum_next : i32)
+  ^exit(%result : i32):
+    %c45 = vm.const.i32 45 : i32
+    vm.check.eq %result, %c45, "sum of [0, 10) = 45" : i32
+    vm.return
+  }
+
+  vm.export @test_cond_br_cmp_preds
+  vm.func @test_cond_br_cmp_preds() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %cn1 = vm.const.i32 -1 : i32
+    %cn1dno = iree.do_not_optimize(%cn1) : i32
+    %eq = vm.cmp.eq.i32 %c1dno, %cn1dno : i32
+    vm.cond_br %eq, ^fail, ^bb1
+  ^bb1:
+    %ne = vm.cmp.ne.i32 %c1dno, %cn1dno : i32
+    vm.cond_br %ne, ^bb2, ^fail
+  ^bb2:
+    // -1 < 1 when signed.
+    %lt_s = vm.cmp.lt.i32.s %cn1dno, %c1dno : i32
+    vm.cond_br %lt_s, ^bb3, ^fail
+  ^bb3:
+    // 0xFFFFFFFF > 1 when unsigned.
+    %lt_u = vm.cmp.lt.i32.u %cn1dno, %c1dno : i32
+    vm.cond_br %lt_u, ^fail, ^bb4
+  ^bb4:
+    vm.return
+  ^fail:
+    %code = vm.const.i32 2 : i32
+    vm.fail %code, "unexpected branch taken"
+  }
+
 }
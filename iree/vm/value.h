@@ -15,6 +15,7 @@
 #ifndef IREE_VM_VALUE_H_
 #define IREE_VM_VALUE_H_
 
+#include <math.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -33,8 +34,10 @@ typedef enum {
   IREE_VM_VALUE_TYPE_I32 = 3,
   // int64_t.
   IREE_VM_VALUE_TYPE_I64 = 4,
+  // float.
+  IREE_VM_VALUE_TYPE_F32 = 5,
 
-  IREE_VM_VALUE_TYPE_MAX = IREE_VM_VALUE_TYPE_I64,
+  IREE_VM_VALUE_TYPE_MAX = IREE_VM_VALUE_TYPE_F32,
   IREE_VM_VALUE_TYPE_COUNT = IREE_VM_VALUE_TYPE_MAX + 1,
 } iree_vm_value_type_t;
 
@@ -49,6 +52,7 @@ typedef struct iree_vm_value {
     int16_t i16;
     int32_t i32;
     int64_t i64;
+    float f32;
 
     uint8_t value_storage[IREE_VM_VALUE_STORAGE_SIZE];  // max size of all value
                                                         // types
@@ -69,6 +73,54 @@ static inline iree_vm_value_t iree_vm_value_make_i64(int64_t value) {
   return result;
 }
 
+static inline iree_vm_value_t iree_vm_value_make_f32(float value) {
+  iree_vm_value_t result;
+  result.type = IREE_VM_VALUE_TYPE_F32;
+  result.f32 = value;
+  return result;
+}
+
+// Converts |value| to an integer with the semantics of the VM cast ops:
+// values are truncated toward zero, values outside of the range of the result
+// type saturate to its minimum or maximum, and NaN produces 0.
+//
+// The range checks are required as a plain C cast of an out-of-range float is
+// undefined behavior. The bounds are powers of two and exactly representable.
+
+static inline int8_t iree_vm_cast_f32_si8(float value) {
+  if (isnan(value)) return 0;
+  if (value <= -128.0f) return INT8_MIN;
+  if (value >= 128.0f) return INT8_MAX;
+  return (int8_t)value;
+}
+
+static inline int16_t iree_vm_cast_f32_si16(float value) {
+  if (isnan(value)) return 0;
+  if (value <= -32768.0f) return INT16_MIN;
+  if (value >= 32768.0f) return INT16_MAX;
+  return (int16_t)value;
+}
+
+static inline int32_t iree_vm_cast_f32_si32(float value) {
+  if (isnan(value)) return 0;
+  if (value <= -2147483648.0f) return INT32_MIN;
+  if (value >= 2147483648.0f) return INT32_MAX;
+  return (int32_t)value;
+}
+
+static inline uint32_t iree_vm_cast_f32_ui32(float value) {
+  if (isnan(value) || value <= 0.0f) return 0;
+  if (value >= 4294967296.0f) return UINT32_MAX;
+  return (uint32_t)value;
+}
+
+static inline int64_t iree_vm_cast_f32_si64(float value) {
+  if (isnan(value)) return 0;
+  if (value <= -9223372036854775808.0f) return INT64_MIN;
+  if (value >= 9223372036854775808.0f) return INT64_MAX;
+  return (int64_t)value;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
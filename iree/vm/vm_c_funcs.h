@@ -12,11 +12,286 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#ifndef IREE_COMPILER_DIALECT_VM_TARGET_C_VM_C_FUNCS_H_
-#define IREE_COMPILER_DIALECT_VM_TARGET_C_VM_C_FUNCS_H_
+// Runtime support functions for modules generated by the VM C target
+// (--iree-vm-ir-to-c-module). Each VM op is implemented with the same
+// semantics as its handler in iree/vm/bytecode_dispatch.c.
+
+#ifndef IREE_VM_VM_C_FUNCS_H_
+#define IREE_VM_VM_C_FUNCS_H_
 
 #include <stdint.h>
+#include <string.h>
+
+#include "iree/base/alignment.h"
+#include "iree/base/api.h"
+#include "iree/vm/builtin_types.h"
+#include "iree/vm/invocation.h"
+#include "iree/vm/list.h"
+#include "iree/vm/module.h"
+#include "iree/vm/ref.h"
+#include "iree/vm/stack.h"
+
+//===----------------------------------------------------------------------===//
+// Globals
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_global_load_i32(const uint8_t* rwdata,
+                                         uint32_t byte_offset) {
+  int32_t value;
+  memcpy(&value, rwdata + byte_offset, sizeof(value));
+  return value;
+}
+
+static inline void vm_global_store_i32(uint8_t* rwdata, uint32_t byte_offset,
+                                       int32_t value) {
+  memcpy(rwdata + byte_offset, &value, sizeof(value));
+}
+
+//===----------------------------------------------------------------------===//
+// Constants
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_const_i32(int32_t a) { return a; }
+
+static inline int32_t vm_const_i32_zero(void) { return 0; }
+
+// Initializes |buffer| to reference the static rodata array |data|. The buffer
+// is owned by the module state and holds one reference for its lifetime so
+// that it is never destroyed; as with bytecode modules refs to it must not
+// outlive the module state.
+static inline void vm_rodata_initialize(iree_vm_ro_byte_buffer_t* buffer,
+                                        const uint8_t* data,
+                                        iree_host_size_t data_length) {
+  iree_atomic_store(&buffer->ref_object.counter, 1);
+  buffer->data = iree_make_const_byte_span(data, data_length);
+  buffer->destroy = NULL;
+}
+
+static inline iree_status_t vm_const_ref_rodata(
+    iree_vm_ro_byte_buffer_t* buffer, iree_vm_ref_t* out_ref) {
+  return iree_vm_ref_wrap_retain(buffer, iree_vm_ro_byte_buffer_type_id(),
+                                 out_ref);
+}
+
+//===----------------------------------------------------------------------===//
+// Lists
+//===----------------------------------------------------------------------===//
+
+static inline iree_status_t vm_list_deref(iree_vm_ref_t* list_ref,
+                                          iree_vm_list_t** out_list) {
+  *out_list = iree_vm_list_deref(list_ref);
+  if (IREE_UNLIKELY(!*out_list)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+  }
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_list_alloc(iree_vm_type_def_t element_type,
+                                          int32_t initial_capacity,
+                                          iree_allocator_t allocator,
+                                          iree_vm_ref_t* out_list_ref) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_list_create(
+      &element_type, (uint32_t)initial_capacity, allocator, &list));
+  return iree_vm_ref_wrap_assign(list, iree_vm_list_type_id(), out_list_ref);
+}
+
+static inline iree_status_t vm_list_reserve(iree_vm_ref_t* list_ref,
+                                            int32_t minimum_capacity) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  return iree_vm_list_reserve(list, (uint32_t)minimum_capacity);
+}
+
+static inline iree_status_t vm_list_size(iree_vm_ref_t* list_ref,
+                                         int32_t* out_size) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  *out_size = (int32_t)iree_vm_list_size(list);
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_list_resize(iree_vm_ref_t* list_ref,
+                                           int32_t new_size) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  return iree_vm_list_resize(list, (uint32_t)new_size);
+}
+
+static inline iree_status_t vm_list_get_i32(iree_vm_ref_t* list_ref,
+                                            int32_t index, int32_t* out_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  iree_vm_value_t value;
+  IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+      list, (uint32_t)index, IREE_VM_VALUE_TYPE_I32, &value));
+  *out_value = value.i32;
+  return iree_ok_status();
+}
+
+static inline iree_status_t vm_list_set_i32(iree_vm_ref_t* list_ref,
+                                            int32_t index, int32_t raw_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  iree_vm_value_t value = iree_vm_value_make_i32(raw_value);
+  return iree_vm_list_set_value(list, (uint32_t)index, &value);
+}
+
+static inline iree_status_t vm_list_get_ref(iree_vm_ref_t* list_ref,
+                                            int32_t index,
+                                            iree_vm_ref_t* out_value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  return iree_vm_list_get_ref_retain(list, (uint32_t)index, out_value);
+}
+
+static inline iree_status_t vm_list_set_ref(iree_vm_ref_t* list_ref,
+                                            int32_t index,
+                                            iree_vm_ref_t* value) {
+  iree_vm_list_t* list = NULL;
+  IREE_RETURN_IF_ERROR(vm_list_deref(list_ref, &list));
+  return iree_vm_list_set_ref_retain(list, (uint32_t)index, value);
+}
+
+//===----------------------------------------------------------------------===//
+// Conditional assignment
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_select_i32(int32_t condition, int32_t true_value,
+                                    int32_t false_value) {
+  return condition ? true_value : false_value;
+}
+
+//===----------------------------------------------------------------------===//
+// Native integer arithmetic
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_add_i32(int32_t a, int32_t b) { return a + b; }
+static inline int32_t vm_sub_i32(int32_t a, int32_t b) { return a - b; }
+static inline int32_t vm_mul_i32(int32_t a, int32_t b) { return a * b; }
+static inline int32_t vm_div_i32s(int32_t a, int32_t b) { return a / b; }
+static inline int32_t vm_div_i32u(int32_t a, int32_t b) {
+  return (int32_t)((uint32_t)a / (uint32_t)b);
+}
+static inline int32_t vm_rem_i32s(int32_t a, int32_t b) { return a % b; }
+static inline int32_t vm_rem_i32u(int32_t a, int32_t b) {
+  return (int32_t)((uint32_t)a % (uint32_t)b);
+}
+static inline int32_t vm_not_i32(int32_t a) {
+  return (int32_t)(~((uint32_t)a));
+}
+static inline int32_t vm_and_i32(int32_t a, int32_t b) { return a & b; }
+static inline int32_t vm_or_i32(int32_t a, int32_t b) { return a | b; }
+static inline int32_t vm_xor_i32(int32_t a, int32_t b) { return a ^ b; }
+
+//===----------------------------------------------------------------------===//
+// Casting and type conversion/emulation
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_trunc_i32_i8(int32_t a) {
+  return (int32_t)((uint8_t)a);
+}
+static inline int32_t vm_trunc_i32_i16(int32_t a) {
+  return (int32_t)((uint16_t)a);
+}
+static inline int32_t vm_ext_i8_i32s(int32_t a) {
+  return (int32_t)((int8_t)a);
+}
+static inline int32_t vm_ext_i8_i32u(int32_t a) {
+  return (int32_t)((uint8_t)a);
+}
+static inline int32_t vm_ext_i16_i32s(int32_t a) {
+  return (int32_t)((int16_t)a);
+}
+static inline int32_t vm_ext_i16_i32u(int32_t a) {
+  return (int32_t)((uint16_t)a);
+}
+
+//===----------------------------------------------------------------------===//
+// Native bitwise shifts and rotates
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_shl_i32(int32_t a, int8_t amount) {
+  return (int32_t)((uint32_t)a << amount);
+}
+static inline int32_t vm_shr_i32s(int32_t a, int8_t amount) {
+  return a >> amount;
+}
+static inline int32_t vm_shr_i32u(int32_t a, int8_t amount) {
+  return (int32_t)((uint32_t)a >> amount);
+}
+
+//===----------------------------------------------------------------------===//
+// Comparison ops
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_cmp_eq_i32(int32_t a, int32_t b) {
+  return (a == b) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_i32(int32_t a, int32_t b) {
+  return (a != b) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_i32s(int32_t a, int32_t b) {
+  return (a < b) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_i32u(int32_t a, int32_t b) {
+  return ((uint32_t)a < (uint32_t)b) ? 1 : 0;
+}
+static inline int32_t vm_cmp_nz_i32(int32_t a) { return (a != 0) ? 1 : 0; }
+
+static inline int32_t vm_cmp_eq_ref(iree_vm_ref_t* a, iree_vm_ref_t* b) {
+  return iree_vm_ref_equal(a, b) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_ref(iree_vm_ref_t* a, iree_vm_ref_t* b) {
+  return iree_vm_ref_equal(a, b) ? 0 : 1;
+}
+static inline int32_t vm_cmp_nz_ref(iree_vm_ref_t* a) {
+  return a->ptr != NULL ? 1 : 0;
+}
+
+//===----------------------------------------------------------------------===//
+// Control flow ops
+//===----------------------------------------------------------------------===//
+
+static inline iree_status_t vm_fail(int32_t status_code,
+                                    iree_string_view_t message) {
+  if (status_code == 0) return iree_ok_status();
+  return iree_status_allocate((iree_status_code_t)status_code, "<vm>", 0,
+                              message);
+}
+
+// Calls an imported |function| with arguments and results marshaled into
+// buffers using the VM calling convention (see iree/vm/module.h).
+// Generated modules execute synchronously so the import is run to completion
+// before returning, blocking the calling thread if it needs to wait.
+static inline iree_status_t vm_call_import(iree_vm_stack_t* stack,
+                                           const iree_vm_function_t* function,
+                                           uint8_t* arguments,
+                                           iree_host_size_t arguments_size,
+                                           uint8_t* results,
+                                           iree_host_size_t results_size) {
+  iree_vm_function_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.function = *function;
+  call.arguments = iree_make_byte_span(arguments, arguments_size);
+  call.results = iree_make_byte_span(results, results_size);
+  iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
+  return iree_vm_call_until_complete(stack, &call, &result);
+}
+
+//===----------------------------------------------------------------------===//
+// Calling convention marshaling
+//===----------------------------------------------------------------------===//
+
+static inline int32_t vm_abi_load_i32(const uint8_t* p) {
+  int32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
 
-inline int32_t vm_add_i32(int32_t a, int32_t b) { return a + b; }
+static inline void vm_abi_store_i32(uint8_t* p, int32_t value) {
+  memcpy(p, &value, sizeof(value));
+}
 
-#endif  // IREE_COMPILER_DIALECT_VM_TARGET_C_VM_C_FUNCS_H_
+#endif  // IREE_VM_VM_C_FUNCS_H_